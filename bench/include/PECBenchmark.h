@@ -0,0 +1,103 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CBenchmark_H__
+#define __PE_CBenchmark_H__
+
+#include <string>
+#include <functional>
+#include "PETypes.h"
+
+namespace PE
+{
+
+/**
+ * Minimal benchmark harness: repeats one round of work till minimal time is spent
+ * and reports time per operation.
+ */
+class CBenchmark
+{
+public:
+   /**
+    * One round of measured work
+    * @return   count of operations done in the round
+    */
+   typedef std::function<uint64_t()> TRound;
+   /**
+    * Result of one benchmark
+    */
+   struct SResult
+   {
+      std::string Name;
+      /**
+       * Count of operations over all rounds
+       */
+      uint64_t Operations;
+      /**
+       * Spent time in [s]
+       */
+      double Seconds;
+      /**
+       * Time per operation in [ns]
+       */
+      double NsPerOp;
+   };
+
+   /**
+    * Constructor
+    *
+    * @param  minTime   minimal measured time per benchmark in [s]
+    */
+   explicit CBenchmark(const double& minTime = 0.5);
+   /**
+    * Runs one warm up round and measured rounds
+    * @return   result of the benchmark
+    *
+    * @param  name    name of the benchmark
+    * @param  round   measured work
+    */
+   const SResult& Run(const std::string& name, const TRound& round);
+   /**
+    * Prints all results as table
+    */
+   void Print() const;
+   /**
+    * Writes all results as JSON object {"benchmarks": [{"name", "operations", "seconds", "ns_per_op"}, ...]}
+    * @return   true if file is written
+    *
+    * @param  fileName   name of JSON file
+    */
+   bool WriteJson(const std::string& fileName) const;
+   /**
+    * Returns all results in order of running
+    */
+   const std::vector<SResult>& GetResults() const;
+   /**
+    * Keeps value alive, so compiler can not remove its calculation
+    */
+   static void Keep(const double& value);
+
+private:
+   /**
+    * Minimal measured time per benchmark in [s]
+    */
+   double m_MinTime;
+   /**
+    * Results in order of running
+    */
+   std::vector<SResult> m_Results;
+};
+
+} //namespace PE
+
+#endif //__PE_CBenchmark_H__
@@ -0,0 +1,108 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include "PECBenchmark.h"
+
+
+using namespace PE;
+
+
+static volatile double s_Sink = 0;
+
+
+PE::CBenchmark::CBenchmark(const double& minTime)
+: m_MinTime(minTime)
+{
+}
+
+
+const CBenchmark::SResult& PE::CBenchmark::Run(const std::string& name, const TRound& round)
+{
+   SResult result;
+   result.Name       = name;
+   result.Operations = 0;
+   result.Seconds    = 0;
+   result.NsPerOp    = 0;
+
+   round(); //warm up caches and allocations
+
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   do
+   {
+      result.Operations += round();
+      result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+   }
+   while ( m_MinTime > result.Seconds );
+
+   if ( 0 < result.Operations )
+   {
+      result.NsPerOp = result.Seconds * 1e9 / result.Operations;
+   }
+   m_Results.push_back(result);
+   return m_Results.back();
+}
+
+
+void PE::CBenchmark::Print() const
+{
+   printf("%-40s %14s %10s %12s\n", "benchmark", "operations", "time [s]", "[ns/op]");
+   for ( size_t i = 0; i < m_Results.size(); ++i )
+   {
+      const SResult& result = m_Results[i];
+      printf("%-40s %14llu %10.3f %12.2f\n", result.Name.c_str(), static_cast<unsigned long long>(result.Operations), result.Seconds, result.NsPerOp);
+   }
+}
+
+
+bool PE::CBenchmark::WriteJson(const std::string& fileName) const
+{
+   FILE* file = fopen(fileName.c_str(), "w");
+   if ( NULL == file )
+   {
+      return false;
+   }
+   fprintf(file, "{\n   \"benchmarks\": [");
+   for ( size_t i = 0; i < m_Results.size(); ++i )
+   {
+      const SResult& result = m_Results[i];
+      std::string name;
+      for ( size_t c = 0; c < result.Name.size(); ++c )
+      {
+         //names are plain text, control characters are not expected
+         if ( '"' == result.Name[c] || '\\' == result.Name[c] )
+         {
+            name += '\\';
+         }
+         name += result.Name[c];
+      }
+      fprintf(file, "%s\n      { \"name\": \"%s\", \"operations\": %llu, \"seconds\": %.6f, \"ns_per_op\": %.4f }",
+              ( 0 < i ) ? "," : "", name.c_str(), static_cast<unsigned long long>(result.Operations), result.Seconds, result.NsPerOp);
+   }
+   fprintf(file, "\n   ]\n}\n");
+   return 0 == fclose(file);
+}
+
+
+const std::vector<CBenchmark::SResult>& PE::CBenchmark::GetResults() const
+{
+   return m_Results;
+}
+
+
+void PE::CBenchmark::Keep(const double& value)
+{
+   s_Sink = value;
+}
@@ -0,0 +1,143 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Calibration benchmark: runs recorded odometer and speed through COdometerEx
+ * and reports cost per sensor sample, cost of one step of CCalibration and CRlsCalibration
+ * with normalisation of their results.
+ *
+ * Usage:
+ *    pe_bench_calibration [track] [minTime]
+ *
+ * Calibration is read once per second of the track like it is done by fusion,
+ * final base, scale and calibration status are printed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "PECBenchmark.h"
+#include "PECTrack.h"
+#include "PECOdometerEx.h"
+#include "PECCalibration.h"
+#include "PECRlsCalibration.h"
+#include "PECNormalisation.h"
+
+
+static const char* DEFAULT_TRACK = PE_BENCH_TRACKS_DIR "ODO_40ms_60sec_GNSS_100ms_32sec.txt";
+
+static const uint32_t STEPS = 63;
+
+
+/**
+ * Adds one calibration step: ref in [1..8], raw = ref * 10 + 11 with small noise
+ */
+template <typename TCalibration>
+static void AddStep(TCalibration& calib, uint32_t step)
+{
+   double ref = 1 + ( step * 7 ) % 8;
+   calib.AddRef(ref);
+   calib.AddRaw(ref * 10 + 11 + 0.01 * ( ( step * 13 ) % 5 ));
+}
+
+
+/**
+ * Runs STEPS calibration steps and normalises their bias/base and scale
+ * @return   count of steps
+ */
+template <typename TCalibration>
+static uint64_t RunSteps(TCalibration& calib)
+{
+   PE::CNormalisation bias;
+   PE::CNormalisation scale;
+   for ( uint32_t i = 0; i < STEPS; ++i )
+   {
+      AddStep(calib, i);
+      if ( calib.Recalculate() )
+      {
+         bias.AddSensor(calib.GetBias());
+         scale.AddSensor(calib.GetScale());
+      }
+   }
+   PE::CBenchmark::Keep(bias.GetMean() + scale.GetMean());
+   return static_cast<uint64_t>(STEPS);
+}
+
+
+/**
+ * Runs whole track through odometer
+ * @return   count of sensor samples
+ */
+static uint64_t RunTrack(const PE::CTrack& track, PE::COdometerEx<>& odo)
+{
+   uint64_t samples = 0;
+   double nextRead = 0;
+   for ( size_t i = 0; i < track.GetSize(); ++i )
+   {
+      const PE::STrackEvent& event = track[i];
+      if ( PE::EVENT_SPEED == event.Type )
+      {
+         odo.AddSpeed(event.Timestamp, event.Values[0], event.Values[1]);
+      }
+      else if ( PE::EVENT_ODO == event.Type )
+      {
+         odo.AddTicks(event.Timestamp, event.Values[0], true);
+         ++samples;
+         if ( nextRead <= event.Timestamp )
+         {
+            nextRead = event.Timestamp + 1.0;
+            PE::CBenchmark::Keep(odo.Base() + odo.Scale() + odo.CalibratedTo());
+         }
+      }
+   }
+   return samples;
+}
+
+
+int main(int argc, char *argv[])
+{
+   const char* fileName = ( 1 < argc ) ? argv[1] : DEFAULT_TRACK;
+   double      minTime  = ( 2 < argc ) ? atof(argv[2]) : 0.5;
+
+   PE::CTrack track;
+   if ( false == track.LoadText(fileName) || 0 == track.GetSize() )
+   {
+      printf("Can not read track %s\n", fileName);
+      return 1;
+   }
+
+   PE::CBenchmark bench(minTime);
+   bench.Run("COdometerEx", [&track]()
+   {
+      PE::COdometerEx<> odo(0.100, 0.010, 0, 343, 2, 0.040, 0.002, 0, 2047);
+      return RunTrack(track, odo);
+   });
+
+   PE::COdometerEx<> odo(0.100, 0.010, 0, 343, 2, 0.040, 0.002, 0, 2047);
+   RunTrack(track, odo);
+   printf("base %.6f scale %.9f calibrated %.2f%%\n", odo.Base(), odo.Scale(), odo.CalibratedTo());
+
+   bench.Run("CCalibration step", []()
+   {
+      PE::CCalibration calib;
+      return RunSteps(calib);
+   });
+   bench.Run("CRlsCalibration step", []()
+   {
+      PE::CRlsCalibration calib;
+      return RunSteps(calib);
+   });
+   bench.Print();
+   return 0;
+}
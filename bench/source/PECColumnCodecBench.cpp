@@ -0,0 +1,140 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Column codec benchmark: timestamps in [ms], odometer ticks and speeds of the recorded track are repeated
+ * till requested count of laps, encoded by CColumnCodec and decoded again.
+ * Compression ratio to raw doubles of the native track file, encode and decode cost per value
+ * and decode throughput of decoded int64_t values are reported.
+ *
+ * Usage:
+ *    pe_bench_column_codec [laps] [minTime]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "PECBenchmark.h"
+#include "PECColumnCodec.h"
+#include "PECTrack.h"
+
+
+static const char* SOURCE_TRACK = PE_BENCH_TRACKS_DIR "ODO_40ms_60sec_GNSS_100ms_32sec.txt";
+
+static const uint32_t DEFAULT_LAPS = 100;
+
+/**
+ * Column of the track
+ */
+struct SColumn
+{
+   std::string Name;
+   std::vector<int64_t> Values;
+   std::vector<uint8_t> Data;
+};
+
+
+/**
+ * Adds column of events of the type, laps follow each other like one long drive
+ * @return   false if column is not integer
+ */
+static bool AddColumn(const PE::CTrack& track, PE::TEventType type, int32_t value, const double& scale, const std::string& name,
+                      uint32_t laps, std::vector<SColumn>& columns)
+{
+   std::vector<double> lap;
+   for ( size_t i = 0; i < track.GetSize(); ++i )
+   {
+      if ( PE::EVENT_COUNT == type || type == track[i].Type )
+      {
+         lap.push_back(( 0 > value ) ? track[i].Timestamp : track[i].Values[value]);
+      }
+   }
+   SColumn column;
+   column.Name = name;
+   std::vector<int64_t> integers;
+   if ( lap.empty() || false == PE::CColumnCodec::ToIntegers(lap.data(), lap.size(), scale, integers) )
+   {
+      return false;
+   }
+   const int64_t shift = integers.back() - integers.front() + ( integers.back() - integers.front() ) / static_cast<int64_t>(integers.size());
+   for ( uint32_t l = 0; l < laps; ++l )
+   {
+      for ( size_t i = 0; i < integers.size(); ++i )
+      {
+         column.Values.push_back(integers[i] + l * shift);
+      }
+   }
+   columns.push_back(column);
+   return true;
+}
+
+
+int main(int argc, char *argv[])
+{
+   const uint32_t laps    = ( 1 < argc ) ? static_cast<uint32_t>(atoi(argv[1])) : DEFAULT_LAPS;
+   const double   minTime = ( 2 < argc ) ? atof(argv[2]) : 0.5;
+   PE::CTrack track;
+   std::vector<SColumn> columns;
+   if ( 0 == laps || false == track.LoadText(SOURCE_TRACK)
+        || false == AddColumn(track, PE::EVENT_COUNT, -1, 1000, "all timestamps [ms]", laps, columns)
+        || false == AddColumn(track, PE::EVENT_ODO, -1, 1000, "ODO timestamps [ms]", laps, columns)
+        || false == AddColumn(track, PE::EVENT_ODO, 0, 1, "ODO ticks", laps, columns)
+        || false == AddColumn(track, PE::EVENT_SPEED, -1, 1000, "SPEED timestamps [ms]", laps, columns)
+        || false == AddColumn(track, PE::EVENT_SPEED, 0, 100, "SPEED speeds [cm/s]", laps, columns) )
+   {
+      printf("Can not prepare columns of %s\n", SOURCE_TRACK);
+      return 1;
+   }
+
+   PE::CBenchmark bench(minTime);
+   for ( size_t c = 0; c < columns.size(); ++c )
+   {
+      SColumn& column = columns[c];
+      bench.Run("encode " + column.Name + " per value", [&column]()
+      {
+         PE::CColumnCodec::Encode(column.Values.data(), column.Values.size(), column.Data);
+         return static_cast<uint64_t>(column.Values.size());
+      });
+      std::vector<int64_t> decoded;
+      bench.Run("decode " + column.Name + " per value", [&column, &decoded]()
+      {
+         PE::CColumnCodec::Decode(column.Data.data(), column.Data.size(), decoded);
+         PE::CBenchmark::Keep(static_cast<double>(decoded.back()));
+         return static_cast<uint64_t>(decoded.size());
+      });
+      if ( decoded != column.Values )
+      {
+         printf("Decoded column %s differs\n", column.Name.c_str());
+         return 1;
+      }
+   }
+   bench.Print();
+
+   const std::vector<PE::CBenchmark::SResult>& results = bench.GetResults();
+#ifdef __SSE2__
+   printf("\nunpacking: SSE2, laps %u\n", laps);
+#else
+   printf("\nunpacking: scalar, laps %u\n", laps);
+#endif
+   printf("%-28s %10s %12s %10s %12s %12s\n", "column", "values", "encoded [B]", "ratio", "B/value", "decode GB/s");
+   for ( size_t c = 0; c < columns.size(); ++c )
+   {
+      const SColumn& column = columns[c];
+      const double raw = static_cast<double>(column.Values.size() * sizeof(double));
+      printf("%-28s %10zu %12zu %10.1f %12.3f %12.2f\n", column.Name.c_str(), column.Values.size(), column.Data.size(),
+             raw / column.Data.size(), static_cast<double>(column.Data.size()) / column.Values.size(),
+             sizeof(int64_t) / results[2 * c + 1].NsPerOp);
+   }
+   return 0;
+}
@@ -0,0 +1,499 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Fusion engines benchmark: circle scenarios of PECFusionSensorTest (10 m/s, 18 deg/s left turn,
+ * one circle per 20 s, start at 50/10 with heading 90) are fused by CFusionSensor and CEkfFusion.
+ * Cost per sensor sample and accuracy against true circle are reported.
+ *
+ * Usage:
+ *    pe_bench_fusion [laps] [minTime]
+ *
+ * DoFusion() is called once per second. Accuracy is root mean square of position error
+ * and heading error after each DoFusion() and position error after the last one.
+ * Input to pose latency of incremental mode of CFusionSensor is measured per Add*() call.
+ * Positions delayed by 0.5 s are fused by CFusionSensor without and with history of checkpoints.
+ * CParticleFusion runs the noisy scenario with 1k, 10k and 100k particles, cost is reported per update
+ * (one tick of 10Hz sensors, DoFusion() once per second).
+ * Geodesic between consecutive positions is measured by separate calls and by TOOLS::ToGeodesic().
+ * Offline CSmoother runs over the noisy scenario of at least 50 laps as one segment and split at anchors,
+ * cost is reported per fused step (one step per tick).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <algorithm>
+#include "PECBenchmark.h"
+#include "PECFusionSensor.h"
+#include "PECEkfFusion.h"
+#include "PECSmoother.h"
+#include "PECParticleFusion.h"
+#include "PETools.h"
+
+
+static const double SPEED     = 10.0;
+static const double ANG_SPEED = 18.0;
+static const double HEADING   = 90.0;
+static const double RATE      = 10.0;
+static const PE::SPosition START(50.0, 10.0, 0.1);
+
+
+/**
+ * One sensor sample of the scenario
+ */
+struct SSample
+{
+   enum TType { POSITION, HEADING, SPEED, ANG_SPEED };
+   uint32_t Tick;
+   double Timestamp;
+   TType Type;
+   PE::SPosition Position;
+   PE::SBasicSensor Sensor;
+};
+
+
+/**
+ * Noise of the scenario, zero for exact sensors of the unit test scenarios
+ */
+struct SNoise
+{
+   double Position;
+   double Heading;
+   double Speed;
+   double AngSpeed;
+   /**
+    * Scale error of speed and angular speed sensors
+    */
+   double Scale;
+};
+
+
+/**
+ * True heading at timestamp
+ */
+static double GetHeading(const double& timestamp)
+{
+   return PE::TOOLS::ToHeading(HEADING, ANG_SPEED * timestamp);
+}
+
+
+/**
+ * True position at timestamp, chord of the circle from the start
+ */
+static PE::SPosition GetPosition(const double& timestamp)
+{
+   const double radius = SPEED / PE::TOOLS::ToRadians(ANG_SPEED);
+   const double halfTurn = ANG_SPEED * timestamp / 2;
+   const double chord = 2 * radius * fabs(sin(PE::TOOLS::ToRadians(halfTurn)));
+   const double chordHeading = ( sin(PE::TOOLS::ToRadians(halfTurn)) < 0 ) ? PE::TOOLS::ToHeading(HEADING, halfTurn + 180.0) : PE::TOOLS::ToHeading(HEADING, halfTurn);
+   return PE::TOOLS::ToPosition(START, chord, chordHeading);
+}
+
+
+/**
+ * Gaussian noise by Box-Muller transformation of deterministic generator
+ */
+static double GetNoise(uint32_t& seed, const double& deviation)
+{
+   if ( 0.0 == deviation )
+   {
+      return 0.0;
+   }
+   seed = seed * 1103515245 + 12345;
+   const double u1 = ( ( seed >> 8 ) + 1.0 ) / 16777217.0;
+   seed = seed * 1103515245 + 12345;
+   const double u2 = ( seed >> 8 ) / 16777216.0;
+   return deviation * sqrt(-2.0 * log(u1)) * cos(2.0 * PE::PI * u2);
+}
+
+
+/**
+ * Creates samples of the scenario
+ */
+static std::vector<SSample> CreateScenario(uint32_t laps, bool position, bool heading, bool speeds, const SNoise& noise)
+{
+   std::vector<SSample> samples;
+   uint32_t seed = 777;
+   const uint32_t count = static_cast<uint32_t>( laps * 360.0 / ANG_SPEED * RATE );
+   for ( uint32_t i = 1; i <= count; ++i )
+   {
+      SSample sample;
+      sample.Tick = i;
+      sample.Timestamp = i / RATE;
+      if ( speeds )
+      {
+         sample.Type = SSample::SPEED;
+         sample.Sensor = PE::SBasicSensor(SPEED * noise.Scale + GetNoise(seed, noise.Speed), 0.1 + noise.Speed);
+         samples.push_back(sample);
+         sample.Type = SSample::ANG_SPEED;
+         sample.Sensor = PE::SBasicSensor(ANG_SPEED * noise.Scale + GetNoise(seed, noise.AngSpeed), 0.1 + noise.AngSpeed);
+         samples.push_back(sample);
+      }
+      if ( heading )
+      {
+         sample.Type = SSample::HEADING;
+         sample.Sensor = PE::SBasicSensor(PE::TOOLS::ToHeading(GetHeading(sample.Timestamp), GetNoise(seed, noise.Heading)), 0.1 + noise.Heading);
+         samples.push_back(sample);
+      }
+      if ( position && 0 == i % static_cast<uint32_t>( RATE ) )
+      {
+         const double north = GetNoise(seed, noise.Position);
+         const double east = GetNoise(seed, noise.Position);
+         sample.Type = SSample::POSITION;
+         sample.Position = PE::TOOLS::ToPosition(PE::TOOLS::ToPosition(GetPosition(sample.Timestamp), north, 0.0), east, 90.0);
+         sample.Position.HorizontalAcc = 0.1 + noise.Position;
+         samples.push_back(sample);
+      }
+   }
+   return samples;
+}
+
+
+/**
+ * Delays positions by count of ticks, timestamps of positions are not changed
+ */
+static std::vector<SSample> DelayPositions(const std::vector<SSample>& samples, uint32_t ticks)
+{
+   std::vector<SSample> delayed(samples);
+   for ( size_t i = 0; i < delayed.size(); ++i )
+   {
+      if ( SSample::POSITION == delayed[i].Type )
+      {
+         delayed[i].Tick += ticks;
+      }
+   }
+   std::stable_sort(delayed.begin(), delayed.end(), [](const SSample& lhs, const SSample& rhs) { return lhs.Tick < rhs.Tick; });
+   return delayed;
+}
+
+
+/**
+ * Accuracy of one run
+ */
+struct SAccuracy
+{
+   double PositionRms;
+   double HeadingRms;
+   double PositionLast;
+   uint32_t Rewinds;
+   uint32_t Replays;
+};
+
+
+/**
+ * Enables history of out of sequence sensors, only CFusionSensor supports it
+ */
+static void SetHistory(PE::CFusionSensor& fusion, uint32_t depth)
+{
+   fusion.SetHistory(depth);
+}
+static void SetHistory(PE::CEkfFusion&, uint32_t)
+{
+}
+static void GetRewinds(const PE::CFusionSensor& fusion, SAccuracy& accuracy)
+{
+   accuracy.Rewinds = fusion.GetRewindCount();
+   accuracy.Replays = fusion.GetReplayCount();
+}
+static void GetRewinds(const PE::CEkfFusion&, SAccuracy&)
+{
+}
+
+
+/**
+ * Runs all samples through the fusion, DoFusion() is called once per second
+ */
+template <typename TFusion>
+static SAccuracy RunScenario(TFusion& fusion, const std::vector<SSample>& samples)
+{
+   SAccuracy accuracy = { 0.0, 0.0, 0.0, 0, 0 };
+   uint32_t fusions = 0;
+   for ( size_t i = 0; i < samples.size(); ++i )
+   {
+      const SSample& sample = samples[i];
+      switch ( sample.Type )
+      {
+         case SSample::POSITION:  fusion.AddPosition(sample.Timestamp, sample.Position); break;
+         case SSample::HEADING:   fusion.AddHeading(sample.Timestamp, sample.Sensor);    break;
+         case SSample::SPEED:     fusion.AddSpeed(sample.Timestamp, sample.Sensor);      break;
+         case SSample::ANG_SPEED: fusion.AddAngSpeed(sample.Timestamp, sample.Sensor);   break;
+      }
+      const bool endOfTick = ( i + 1 == samples.size() || samples[i + 1].Tick != sample.Tick );
+      if ( endOfTick && 0 == sample.Tick % static_cast<uint32_t>( RATE ) )
+      {
+         fusion.DoFusion();
+         const PE::SPosition truth = GetPosition(fusion.GetTimestamp());
+         const double error = PE::TOOLS::ToDistance(truth.Latitude, truth.Longitude, fusion.GetPosition().Latitude, fusion.GetPosition().Longitude);
+         const double headingError = PE::TOOLS::ToAngle(GetHeading(fusion.GetTimestamp()), fusion.GetHeading().Value);
+         accuracy.PositionRms += error * error;
+         accuracy.HeadingRms += headingError * headingError;
+         accuracy.PositionLast = error;
+         ++fusions;
+      }
+   }
+   accuracy.PositionRms = sqrt(accuracy.PositionRms / fusions);
+   accuracy.HeadingRms = sqrt(accuracy.HeadingRms / fusions);
+   return accuracy;
+}
+
+
+/**
+ * Runs all samples through the fusion created with start of the scenario
+ */
+template <typename TFusion>
+static SAccuracy RunScenario(const std::vector<SSample>& samples, uint32_t history = 0)
+{
+   TFusion fusion(0.0, START, PE::SBasicSensor(HEADING, 0.1), PE::SBasicSensor(ANG_SPEED, 0.1), PE::SBasicSensor(SPEED, 0.1));
+   SetHistory(fusion, history);
+   SAccuracy accuracy = RunScenario(fusion, samples);
+   GetRewinds(fusion, accuracy);
+   return accuracy;
+}
+
+
+/**
+ * Runs all samples through particle filter
+ */
+static SAccuracy RunParticles(const std::vector<SSample>& samples, uint32_t particleCount, uint32_t threadCount)
+{
+   PE::CParticleFusion fusion(0.0, START, PE::SBasicSensor(HEADING, 0.1), PE::SBasicSensor(ANG_SPEED, 0.1), PE::SBasicSensor(SPEED, 0.1),
+                              particleCount, threadCount);
+   return RunScenario(fusion, samples);
+}
+
+
+/**
+ * Adds all samples to the smoother
+ */
+static void AddSamples(PE::CSmoother& smoother, const std::vector<SSample>& samples)
+{
+   for ( size_t i = 0; i < samples.size(); ++i )
+   {
+      const SSample& sample = samples[i];
+      switch ( sample.Type )
+      {
+         case SSample::POSITION:  smoother.AddPosition(sample.Timestamp, sample.Position); break;
+         case SSample::HEADING:   smoother.AddHeading(sample.Timestamp, sample.Sensor);    break;
+         case SSample::SPEED:     smoother.AddSpeed(sample.Timestamp, sample.Sensor);      break;
+         case SSample::ANG_SPEED: smoother.AddAngSpeed(sample.Timestamp, sample.Sensor);   break;
+      }
+   }
+}
+
+
+/**
+ * Root mean square of position error of all steps, fused or smoothed
+ */
+static double GetPositionRms(const PE::CSmoother& smoother, bool smoothed)
+{
+   double rms = 0.0;
+   for ( uint32_t i = 0; i < smoother.GetSize(); ++i )
+   {
+      const PE::CSmoother::SState& state = smoothed ? smoother.GetSmoothed(i) : smoother.GetFused(i);
+      const PE::SPosition truth = GetPosition(state.Timestamp);
+      const double error = PE::TOOLS::ToDistance(truth.Latitude, truth.Longitude, state.Position.Latitude, state.Position.Longitude);
+      rms += error * error;
+   }
+   return sqrt(rms / smoother.GetSize());
+}
+
+
+/**
+ * Measures duration of each Add*() call of CFusionSensor in incremental mode without latency budget,
+ * pose of the previous timestamp is available after the call
+ * @return   durations in [ns] sorted ascending
+ */
+static std::vector<double> MeasureIncrementalLatency(const std::vector<SSample>& samples)
+{
+   PE::CFusionSensor fusion(0.0, START, PE::SBasicSensor(HEADING, 0.1), PE::SBasicSensor(ANG_SPEED, 0.1), PE::SBasicSensor(SPEED, 0.1));
+   fusion.SetIncremental(true);
+   std::vector<double> durations(samples.size());
+   for ( size_t i = 0; i < samples.size(); ++i )
+   {
+      const SSample& sample = samples[i];
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      switch ( sample.Type )
+      {
+         case SSample::POSITION:  fusion.AddPosition(sample.Timestamp, sample.Position); break;
+         case SSample::HEADING:   fusion.AddHeading(sample.Timestamp, sample.Sensor);    break;
+         case SSample::SPEED:     fusion.AddSpeed(sample.Timestamp, sample.Sensor);      break;
+         case SSample::ANG_SPEED: fusion.AddAngSpeed(sample.Timestamp, sample.Sensor);   break;
+      }
+      durations[i] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+   }
+   PE::CBenchmark::Keep(fusion.GetPosition().Latitude);
+   std::sort(durations.begin(), durations.end());
+   return durations;
+}
+
+
+int main(int argc, char *argv[])
+{
+   const uint32_t laps    = ( 1 < argc ) ? static_cast<uint32_t>(atoi(argv[1])) : 1;
+   const double   minTime = ( 2 < argc ) ? atof(argv[2]) : 0.5;
+   if ( 0 == laps )
+   {
+      printf("Wrong count of laps\n");
+      return 1;
+   }
+
+   const SNoise exact = { 0.0, 0.0, 0.0, 0.0, 1.0 };
+   const SNoise noisy = { 3.0, 2.0, 0.3, 1.0, 1.0 };
+   const SNoise drift = { 0.0, 0.0, 0.0, 0.0, 1.02 };
+   struct SScenario
+   {
+      const char* Name;
+      std::vector<SSample> Samples;
+   };
+   SScenario scenarios[] = {
+      { "position 1Hz",        CreateScenario(laps, true,  false, false, exact) },
+      { "speeds 10Hz",         CreateScenario(laps, false, false, true,  exact) },
+      { "full set",            CreateScenario(laps, true,  true,  true,  exact) },
+      { "full set with noise", CreateScenario(laps, true,  true,  true,  noisy) }
+   };
+   const uint32_t count = sizeof(scenarios) / sizeof(scenarios[0]);
+
+   PE::CBenchmark bench(minTime);
+   std::vector<SAccuracy> accuracies;
+   char name[64];
+   for ( uint32_t i = 0; i < count; ++i )
+   {
+      const std::vector<SSample>& samples = scenarios[i].Samples;
+      snprintf(name, sizeof(name), "CFusionSensor %s", scenarios[i].Name);
+      accuracies.push_back(RunScenario<PE::CFusionSensor>(samples));
+      bench.Run(name, [&]()
+      {
+         PE::CBenchmark::Keep(RunScenario<PE::CFusionSensor>(samples).PositionLast);
+         return static_cast<uint64_t>(samples.size());
+      });
+
+      snprintf(name, sizeof(name), "CEkfFusion %s", scenarios[i].Name);
+      accuracies.push_back(RunScenario<PE::CEkfFusion>(samples));
+      bench.Run(name, [&]()
+      {
+         PE::CBenchmark::Keep(RunScenario<PE::CEkfFusion>(samples).PositionLast);
+         return static_cast<uint64_t>(samples.size());
+      });
+   }
+
+   //exact positions delayed by 0.5 s, odometry with 2% scale error, history of 40 items covers 4 s
+   const std::vector<SSample> delayed = DelayPositions(CreateScenario(laps, true, true, true, drift), 5);
+   const uint32_t depth = 4 * static_cast<uint32_t>( RATE );
+   accuracies.push_back(RunScenario<PE::CFusionSensor>(delayed));
+   bench.Run("CFusionSensor delayed positions", [&]()
+   {
+      PE::CBenchmark::Keep(RunScenario<PE::CFusionSensor>(delayed).PositionLast);
+      return static_cast<uint64_t>(delayed.size());
+   });
+   accuracies.push_back(RunScenario<PE::CFusionSensor>(delayed, depth));
+   bench.Run("CFusionSensor delayed positions history", [&]()
+   {
+      PE::CBenchmark::Keep(RunScenario<PE::CFusionSensor>(delayed, depth).PositionLast);
+      return static_cast<uint64_t>(delayed.size());
+   });
+
+   const size_t withHistory = accuracies.size() - 1;
+
+   //runtime of particle filter per update (one tick of 10Hz sensors) by particle count
+   const std::vector<SSample>& noisySamples = scenarios[count - 1].Samples;
+   const uint64_t ticks = noisySamples.back().Tick;
+   const uint32_t particleCounts[] = { 1000, 10000, 100000 };
+   for ( uint32_t i = 0; i < 3; ++i )
+   {
+      for ( uint32_t threads = 1; threads <= 2; ++threads )
+      {
+         //0 - hardware threads
+         const uint32_t threadCount = ( 1 == threads ) ? 1 : 0;
+         snprintf(name, sizeof(name), "CParticleFusion %u %s per update", particleCounts[i], ( 1 == threads ) ? "1 thread" : "threads");
+         accuracies.push_back(RunParticles(noisySamples, particleCounts[i], threadCount));
+         bench.Run(name, [&]()
+         {
+            PE::CBenchmark::Keep(RunParticles(noisySamples, particleCounts[i], threadCount).PositionLast);
+            return ticks;
+         });
+      }
+   }
+
+   //offline smoothing of the noisy scenario, anchors are all positions (0.1 + 3.0 m accuracy)
+   PE::CSmoother smoother(0.0, START, PE::SBasicSensor(HEADING, 0.1), PE::SBasicSensor(ANG_SPEED, 0.1), PE::SBasicSensor(SPEED, 0.1));
+   AddSamples(smoother, CreateScenario(std::max(laps, 50u), true, true, true, noisy));
+   uint32_t segments = 0;
+   bench.Run("CSmoother whole track", [&]()
+   {
+      smoother.Smooth(1, 0.0);
+      return static_cast<uint64_t>(smoother.GetSize());
+   });
+   const double wholeRms = GetPositionRms(smoother, true);
+   bench.Run("CSmoother segments", [&]()
+   {
+      segments = smoother.Smooth(0);
+      return static_cast<uint64_t>(smoother.GetSize());
+   });
+
+   //geodesic between fused and measured position of one step: separate calls of fusion tools before and shared result
+   const std::vector<SSample>& positions = scenarios[0].Samples;
+   bench.Run("geodesic 3x ToDistance + ToHeading", [&]()
+   {
+      for ( size_t i = 1; i < positions.size(); ++i )
+      {
+         const PE::SPosition& first = positions[i - 1].Position;
+         const PE::SPosition& last = positions[i].Position;
+         PE::CBenchmark::Keep(PE::TOOLS::ToDistance(first.Latitude, first.Longitude, last.Latitude, last.Longitude)
+                            + PE::TOOLS::ToDistance(first.Latitude, first.Longitude, last.Latitude, last.Longitude)
+                            + PE::TOOLS::ToHeading(first.Latitude, first.Longitude, last.Latitude, last.Longitude)
+                            + PE::TOOLS::ToDistance(first.Latitude, first.Longitude, last.Latitude, last.Longitude));
+      }
+      return static_cast<uint64_t>(positions.size() - 1);
+   });
+   bench.Run("geodesic ToGeodesic", [&]()
+   {
+      for ( size_t i = 1; i < positions.size(); ++i )
+      {
+         const PE::SPosition& first = positions[i - 1].Position;
+         const PE::SPosition& last = positions[i].Position;
+         const PE::TOOLS::SGeodesic geodesic = PE::TOOLS::ToGeodesic(first.Latitude, first.Longitude, last.Latitude, last.Longitude);
+         PE::CBenchmark::Keep(geodesic.Distance + geodesic.Heading);
+      }
+      return static_cast<uint64_t>(positions.size() - 1);
+   });
+
+   bench.Print();
+   printf("\nsmoother steps %u, segments %u, position rms [m]: fused %.4f, whole track %.4f, segments %.4f\n",
+          smoother.GetSize(), segments, GetPositionRms(smoother, false), wholeRms, GetPositionRms(smoother, true));
+   printf("\n%-40s %12s %12s %12s %12s\n", "accuracy", "ops/s", "pos rms [m]", "last [m]", "head rms [deg]");
+   for ( size_t i = 0; i < accuracies.size(); ++i )
+   {
+      const PE::CBenchmark::SResult& result = bench.GetResults()[i];
+      printf("%-40s %12.0f %12.4f %12.4f %12.4f\n", result.Name.c_str(), 1e9 / result.NsPerOp,
+             accuracies[i].PositionRms, accuracies[i].PositionLast, accuracies[i].HeadingRms);
+   }
+
+   const double rewindCost = ( bench.GetResults()[withHistory].NsPerOp - bench.GetResults()[withHistory - 1].NsPerOp )
+                             * delayed.size() / accuracies[withHistory].Rewinds;
+   printf("\nrewinds %u, fused items per rewind %.1f, cost per rewind %.0f ns\n", accuracies[withHistory].Rewinds,
+          static_cast<double>(accuracies[withHistory].Replays) / accuracies[withHistory].Rewinds, rewindCost);
+
+   printf("\n%-40s %12s %12s %12s\n", "incremental latency per Add*()", "median [ns]", "p99 [ns]", "max [ns]");
+   for ( uint32_t i = 0; i < count; ++i )
+   {
+      MeasureIncrementalLatency(scenarios[i].Samples);   //warm up
+      const std::vector<double> durations = MeasureIncrementalLatency(scenarios[i].Samples);
+      printf("%-40s %12.0f %12.0f %12.0f\n", scenarios[i].Name, durations[durations.size() / 2],
+             durations[durations.size() * 99 / 100], durations.back());
+   }
+   return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Fleet normalisation benchmark: one tick of samples of many vehicles is added to
+ * array of CNormalisation objects and to CNormalisationBank, cost per sample is reported.
+ *
+ * Usage:
+ *    pe_bench_normalisation [vehicles] [minTime]
+ *
+ * Samples of the tick are in random vehicle order, sorted order is measured too.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include "PECBenchmark.h"
+#include "PECNormalisation.h"
+#include "PECNormalisationBank.h"
+
+
+static const uint32_t DEFAULT_VEHICLES = 100000;
+
+
+int main(int argc, char *argv[])
+{
+   const uint32_t vehicles = ( 1 < argc ) ? static_cast<uint32_t>(atoi(argv[1])) : DEFAULT_VEHICLES;
+   const double   minTime  = ( 2 < argc ) ? atof(argv[2]) : 0.5;
+   if ( 0 == vehicles )
+   {
+      printf("Wrong count of vehicles\n");
+      return 1;
+   }
+
+   //one sample per vehicle and tick, random order
+   std::vector<uint32_t> indices(vehicles);
+   std::vector<double> values(vehicles);
+   uint32_t seed = 12345;
+   for ( uint32_t i = 0; i < vehicles; ++i )
+   {
+      indices[i] = i;
+   }
+   for ( uint32_t i = vehicles - 1; i > 0; --i )
+   {
+      seed = seed * 1103515245 + 12345;
+      std::swap(indices[i], indices[( seed >> 8 ) % ( i + 1 )]);
+   }
+   for ( uint32_t i = 0; i < vehicles; ++i )
+   {
+      seed = seed * 1103515245 + 12345;
+      values[i] = 10.0 + static_cast<double>( ( seed >> 16 ) % 1000 ) / 1000.0;
+   }
+   std::vector<uint32_t> sortedIndices(vehicles);
+   for ( uint32_t i = 0; i < vehicles; ++i )
+   {
+      sortedIndices[i] = i;
+   }
+
+   PE::CBenchmark bench(minTime);
+   char name[64];
+
+   std::vector<PE::CNormalisation> norms(vehicles);
+   snprintf(name, sizeof(name), "CNormalisation[%u] random", vehicles);
+   bench.Run(name, [&]()
+   {
+      for ( uint32_t i = 0; i < vehicles; ++i )
+      {
+         norms[indices[i]].AddSensor(values[i]);
+      }
+      PE::CBenchmark::Keep(norms[0].GetMean());
+      return static_cast<uint64_t>(vehicles);
+   });
+
+   PE::CNormalisationBank bank(vehicles);
+   snprintf(name, sizeof(name), "CNormalisationBank(%u) random", vehicles);
+   bench.Run(name, [&]()
+   {
+      bank.AddSensorBatch(indices, values);
+      PE::CBenchmark::Keep(bank.GetMean(0));
+      return static_cast<uint64_t>(vehicles);
+   });
+
+   snprintf(name, sizeof(name), "CNormalisation[%u] sorted", vehicles);
+   bench.Run(name, [&]()
+   {
+      for ( uint32_t i = 0; i < vehicles; ++i )
+      {
+         norms[i].AddSensor(values[i]);
+      }
+      PE::CBenchmark::Keep(norms[0].GetMean());
+      return static_cast<uint64_t>(vehicles);
+   });
+
+   snprintf(name, sizeof(name), "CNormalisationBank(%u) sorted", vehicles);
+   bench.Run(name, [&]()
+   {
+      bank.AddSensorBatch(sortedIndices, values);
+      PE::CBenchmark::Keep(bank.GetMean(0));
+      return static_cast<uint64_t>(vehicles);
+   });
+
+   bench.Print();
+   return 0;
+}
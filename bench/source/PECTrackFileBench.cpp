@@ -0,0 +1,257 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Track file benchmark: recorded text track is repeated till requested count of laps,
+ * stored as text and native track file, then both are loaded and cost per record or event is reported.
+ * Seek of the native file by its seek index is compared with reading of all events till the same position.
+ * Text track is read line by line like before CTrackReader (getline() and AddLine()), by streaming
+ * CTrackReader and by CTrack::LoadText(), which collects events of CTrackReader.
+ *
+ * Usage:
+ *    pe_bench_track_file [laps] [minTime]
+ *
+ * Files are written into current directory and removed at the end, they are read from page cache,
+ * so the native file is limited by memory bandwidth and the text file by parsing.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include "PECBenchmark.h"
+#include "PECTrack.h"
+#include "PECTrackFile.h"
+#include "PECTrackReader.h"
+#include "PETools.h"
+
+
+static const char* SOURCE_TRACK = PE_BENCH_TRACKS_DIR "ODO_40ms_60sec_GNSS_100ms_32sec.txt";
+
+static const char* TEXT_TRACK = "pe_bench_track.txt";
+
+static const char* NATIVE_TRACK = "pe_bench_track.petrk";
+
+static const uint32_t DEFAULT_LAPS = 500;
+
+/**
+ * Time shift of one lap in [ms], longer than the recorded track
+ */
+static const uint64_t LAP_TIME = 100000;
+
+
+/**
+ * Writes source track laps times one after another
+ * @return   true if file was written
+ */
+static bool WriteText(uint32_t laps)
+{
+   std::ifstream source(SOURCE_TRACK);
+   std::vector<std::string> lines;
+   std::string line;
+   while ( std::getline(source, line) )
+   {
+      lines.push_back(line);
+   }
+
+   std::ofstream target(TEXT_TRACK, std::ios::out | std::ios::trunc);
+   for ( uint32_t lap = 0; lap < laps; ++lap )
+   {
+      for ( size_t i = 0; i < lines.size(); ++i )
+      {
+         size_t comma = lines[i].find(',');
+         if ( std::string::npos != comma )
+         {
+            uint64_t ts = strtoull(lines[i].c_str(), NULL, 10) + lap * LAP_TIME;
+            target << ts << lines[i].substr(comma) << '\n';
+         }
+      }
+   }
+   target.close();
+   return false == lines.empty() && false == target.fail();
+}
+
+
+/**
+ * Reads all columns of the file
+ * @return   sum of values to keep them alive
+ */
+static double ScanColumns(const PE::CTrackFile& file)
+{
+   double sum = 0;
+   for ( uint32_t t = 0; t < PE::EVENT_COUNT; ++t )
+   {
+      const PE::TEventType type = static_cast<PE::TEventType>(t);
+      const size_t count = file.GetCount(type);
+      if ( 0 == count )
+      {
+         continue;
+      }
+      const double* timestamps = file.GetTimestamps(type);
+      for ( size_t i = 0; i < count; ++i )
+      {
+         sum += timestamps[i];
+      }
+      for ( uint32_t v = 0; v < PE::CTrackFile::GetValueCount(type); ++v )
+      {
+         const double* values = file.GetValues(type, v);
+         const uint64_t* validity = file.GetValidity(type, v);
+         for ( size_t i = 0; i < count; ++i )
+         {
+            sum += values[i];
+         }
+         for ( size_t i = 0; i < ( count + 63 ) / 64; ++i )
+         {
+            sum += static_cast<double>(validity[i] & 1);
+         }
+      }
+   }
+   return sum;
+}
+
+
+static uint64_t GetFileSize(const char* fileName)
+{
+   std::ifstream file(fileName, std::ios::in | std::ios::binary | std::ios::ate);
+   return static_cast<uint64_t>(file.tellg());
+}
+
+
+int main(int argc, char *argv[])
+{
+   const uint32_t laps    = ( 1 < argc ) ? static_cast<uint32_t>(atoi(argv[1])) : DEFAULT_LAPS;
+   const double   minTime = ( 2 < argc ) ? atof(argv[2]) : 0.5;
+   if ( 0 == laps )
+   {
+      printf("Wrong count of laps\n");
+      return 1;
+   }
+
+   PE::CTrack track;
+   if ( false == WriteText(laps) || false == track.LoadText(TEXT_TRACK) || false == PE::CTrackFile::Store(NATIVE_TRACK, track) )
+   {
+      printf("Can not prepare tracks from %s\n", SOURCE_TRACK);
+      return 1;
+   }
+   const uint64_t events = track.GetSize();
+   track.Clean();
+   PE::CTrackReader counter;
+   PE::STrackEvent event;
+   counter.Open(TEXT_TRACK);
+   while ( counter.Next(event) )
+   {
+   }
+   const uint64_t records = counter.GetRecordCount();
+   counter.Close();
+
+   PE::CBenchmark bench(minTime);
+   bench.Run("text getline + AddLine per record", [records]()
+   {
+      PE::CTrack text;
+      std::ifstream file(TEXT_TRACK);
+      std::string line;
+      while ( std::getline(file, line) )
+      {
+         text.AddLine(line);
+      }
+      PE::CBenchmark::Keep(static_cast<double>(text.GetSize()));
+      return records;
+   });
+   bench.Run("text CTrackReader per record", []()
+   {
+      PE::CTrackReader reader;
+      PE::STrackEvent event;
+      double sum = 0;
+      reader.Open(TEXT_TRACK);
+      while ( reader.Next(event) )
+      {
+         sum += event.Values[0];
+      }
+      PE::CBenchmark::Keep(sum);
+      return reader.GetRecordCount();
+   });
+   bench.Run("text CTrack::LoadText per record", [records]()
+   {
+      PE::CTrack text;
+      text.LoadText(TEXT_TRACK);
+      PE::CBenchmark::Keep(static_cast<double>(text.GetSize()));
+      return records;
+   });
+   bench.Run("native Open per file", []()
+   {
+      PE::CTrackFile file;
+      file.Open(NATIVE_TRACK);
+      PE::CBenchmark::Keep(static_cast<double>(file.GetSize()));
+      return static_cast<uint64_t>(1);
+   });
+   bench.Run("native Open + scan columns per event", [events]()
+   {
+      PE::CTrackFile file;
+      file.Open(NATIVE_TRACK);
+      PE::CBenchmark::Keep(ScanColumns(file));
+      return events;
+   });
+   bench.Run("native Open + ToTrack per event", [events]()
+   {
+      PE::CTrackFile file;
+      PE::CTrack native;
+      file.Open(NATIVE_TRACK);
+      file.ToTrack(native);
+      PE::CBenchmark::Keep(static_cast<double>(native.GetSize()));
+      return events;
+   });
+   PE::CTrackFile seekFile;
+   seekFile.Open(NATIVE_TRACK);
+   const double lastTimestamp = laps * LAP_TIME / 1000.0;
+   bench.Run("native Seek per seek", [&seekFile, lastTimestamp]()
+   {
+      PE::CTrackFile::SCursor cursor;
+      double sum = 0;
+      for ( uint32_t i = 0; i < 1000; ++i )
+      {
+         seekFile.Seek(lastTimestamp * i / 1000.0, cursor);
+         sum += static_cast<double>(cursor.Index);
+      }
+      PE::CBenchmark::Keep(sum);
+      return static_cast<uint64_t>(1000);
+   });
+   bench.Run("native Next till the middle per seek", [&seekFile, lastTimestamp]()
+   {
+      PE::CTrackFile::SCursor cursor;
+      PE::STrackEvent event;
+      while ( seekFile.Next(cursor, event) && event.Timestamp < lastTimestamp / 2 )
+      {
+      }
+      PE::CBenchmark::Keep(static_cast<double>(cursor.Index));
+      return static_cast<uint64_t>(1);
+   });
+   seekFile.Close();
+   bench.Print();
+
+   const uint64_t textSize   = GetFileSize(TEXT_TRACK);
+   const uint64_t nativeSize = GetFileSize(NATIVE_TRACK);
+   const std::vector<PE::CBenchmark::SResult>& results = bench.GetResults();
+   printf("\nrecords %llu, events %llu, text %.1f MB, native %.1f MB\n", static_cast<unsigned long long>(records),
+          static_cast<unsigned long long>(events), textSize / 1e6, nativeSize / 1e6);
+   printf("\n%-40s %14s %10s\n", "text", "records/s", "GB/s");
+   for ( uint32_t i = 0; i < 3; ++i )
+   {
+      printf("%-40s %14.0f %10.3f\n", results[i].Name.c_str(), 1e9 / results[i].NsPerOp, textSize / ( results[i].NsPerOp * records ));
+   }
+   printf("native scan %.3f GB/s\n", nativeSize / ( results[4].NsPerOp * events ));
+
+   remove(TEXT_TRACK);
+   remove(NATIVE_TRACK);
+   return 0;
+}
@@ -0,0 +1,292 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * End-to-end pipeline benchmark: recorded track is loaded into memory once and replayed
+ * through COdometerEx, CGyroscope and CFusionSensor like one vehicle stream, looped given count of laps.
+ *
+ * Usage:
+ *    pe_bench_pipeline [track] [laps]
+ *
+ * SPEED and ODO calibrate the odometer, HEADING and GYRO the gyroscope. Reference sensors and calibrated
+ * odometer speed and gyroscope angular speed are added to the fusion, DoFusion() is called once per second
+ * of the track. Laps follow each other like one long drive, objects are created once before the first lap.
+ *
+ * Reported per input sample (event of the track):
+ *    realtime factor    track time divided by replay time, i.e. count of streams one core sustains
+ *    cycles             CPU cycles by perf counter, time stamp counter cycles if perf is not available
+ *    allocations        heap allocations counted by interposed malloc()/calloc()/realloc()
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "PECTrack.h"
+#include "PECOdometerEx.h"
+#include "PECGyroscope.h"
+#include "PECFusionSensor.h"
+
+
+static const char* DEFAULT_TRACK = PE_BENCH_TRACKS_DIR "ODO_40ms_60sec_GNSS_100ms_32sec.txt";
+
+static const uint32_t DEFAULT_LAPS = 1000;
+
+
+#ifdef __GLIBC__
+/**
+ * Allocator interposed in front of glibc: counts heap allocations of the whole process.
+ * The benchmark is single threaded, so the counter is not atomic.
+ */
+static uint64_t s_Allocations = 0;
+
+extern "C"
+{
+   void* __libc_malloc(size_t size);
+   void* __libc_calloc(size_t count, size_t size);
+   void* __libc_realloc(void* pointer, size_t size);
+
+   void* malloc(size_t size)
+   {
+      ++s_Allocations;
+      return __libc_malloc(size);
+   }
+
+   void* calloc(size_t count, size_t size)
+   {
+      ++s_Allocations;
+      return __libc_calloc(count, size);
+   }
+
+   void* realloc(void* pointer, size_t size)
+   {
+      ++s_Allocations;
+      return __libc_realloc(pointer, size);
+   }
+}
+
+static uint64_t GetAllocations()
+{
+   return s_Allocations;
+}
+#else
+static uint64_t GetAllocations()
+{
+   return 0;
+}
+#endif
+
+
+/**
+ * Counter of CPU cycles of this thread, perf counter or time stamp counter as fallback
+ */
+class CCycleCounter
+{
+public:
+   CCycleCounter()
+   : m_Perf(-1)
+   {
+#ifdef __linux__
+      perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_CPU_CYCLES;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      m_Perf = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+   }
+
+   ~CCycleCounter()
+   {
+#ifdef __linux__
+      if ( 0 <= m_Perf )
+      {
+         close(m_Perf);
+      }
+#endif
+   }
+
+   /**
+    * Returns source of cycles, NULL if cycles are not available
+    */
+   const char* GetSource() const
+   {
+#if defined(__x86_64__) || defined(__i386__)
+      return ( 0 <= m_Perf ) ? "perf" : "tsc";
+#else
+      return ( 0 <= m_Perf ) ? "perf" : NULL;
+#endif
+   }
+
+   uint64_t Get() const
+   {
+#ifdef __linux__
+      uint64_t cycles = 0;
+      if ( 0 <= m_Perf && sizeof(cycles) == read(m_Perf, &cycles, sizeof(cycles)) )
+      {
+         return cycles;
+      }
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+      return __rdtsc();
+#else
+      return 0;
+#endif
+   }
+
+private:
+   CCycleCounter(const CCycleCounter&);
+   CCycleCounter& operator=(const CCycleCounter&);
+
+   int m_Perf;
+};
+
+
+/**
+ * Pipeline of one vehicle stream
+ */
+struct SPipeline
+{
+   SPipeline()
+   : Odometer(0, 343, 2, 0, 2047)
+   , Gyroscope(0, 360, 2, 0, 65535)
+   , Fusion(0, PE::SPosition(), PE::SBasicSensor(0, 1), PE::SBasicSensor(0, 1), PE::SBasicSensor(0, 1))
+   , NextFusion(0)
+   , Fusions(0)
+   , OdoSpeeds(0)
+   , AngSpeeds(0)
+   {
+   }
+
+   PE::COdometerEx<> Odometer;
+   PE::CGyroscope<> Gyroscope;
+   PE::CFusionSensor Fusion;
+   double NextFusion;
+   uint64_t Fusions;
+   uint64_t OdoSpeeds;
+   uint64_t AngSpeeds;
+};
+
+
+/**
+ * Replays one lap of the track shifted by offset
+ */
+static void RunLap(const PE::CTrack& track, const double& offset, SPipeline& pipeline)
+{
+   for ( size_t i = 0; i < track.GetSize(); ++i )
+   {
+      const PE::STrackEvent& event = track[i];
+      const double timestamp = event.Timestamp + offset;
+      switch ( event.Type )
+      {
+         case PE::EVENT_POSITION:
+            pipeline.Fusion.AddPosition(timestamp, PE::SPosition(event.Values[0], event.Values[1], event.Values[2]));
+            break;
+         case PE::EVENT_HEADING:
+            pipeline.Gyroscope.AddHeading(timestamp, event.Values[0], event.Values[1]);
+            pipeline.Fusion.AddHeading(timestamp, PE::SBasicSensor(event.Values[0], event.Values[1]));
+            break;
+         case PE::EVENT_SPEED:
+            pipeline.Odometer.AddSpeed(timestamp, event.Values[0], event.Values[1]);
+            pipeline.Fusion.AddSpeed(timestamp, PE::SBasicSensor(event.Values[0], event.Values[1]));
+            break;
+         case PE::EVENT_GYRO:
+            if ( pipeline.Gyroscope.AddGyro(timestamp, event.Values[0], true) && 0 < pipeline.Gyroscope.CalibratedTo() )
+            {
+               pipeline.Fusion.AddAngSpeed(timestamp, PE::SBasicSensor(pipeline.Gyroscope.Value(), pipeline.Gyroscope.Accuracy()));
+               ++pipeline.AngSpeeds;
+            }
+            break;
+         case PE::EVENT_ODO:
+            if ( pipeline.Odometer.AddTicks(timestamp, event.Values[0], true) && 0 < pipeline.Odometer.CalibratedTo() )
+            {
+               pipeline.Fusion.AddSpeed(timestamp, PE::SBasicSensor(pipeline.Odometer.Value(), pipeline.Odometer.Accuracy()));
+               ++pipeline.OdoSpeeds;
+            }
+            break;
+         default:
+            break;
+      }
+      if ( pipeline.NextFusion <= timestamp )
+      {
+         pipeline.Fusion.DoFusion();
+         pipeline.NextFusion = timestamp + 1.0;
+         ++pipeline.Fusions;
+      }
+   }
+}
+
+
+int main(int argc, char *argv[])
+{
+   const char*    fileName = ( 1 < argc ) ? argv[1] : DEFAULT_TRACK;
+   const uint32_t laps     = ( 2 < argc ) ? static_cast<uint32_t>(atoi(argv[2])) : DEFAULT_LAPS;
+
+   PE::CTrack track;
+   if ( 0 == laps || false == track.LoadText(fileName) || 0 == track.GetSize() )
+   {
+      printf("Can not read track %s\n", fileName);
+      return 1;
+   }
+   //next lap starts one mean interval after the last event
+   const double lapDuration = ( track[track.GetSize() - 1].Timestamp - track[0].Timestamp ) * track.GetSize() / ( track.GetSize() - 1 );
+
+   CCycleCounter counter;
+   const uint64_t setupAllocations = GetAllocations();
+   SPipeline pipeline;
+   const uint64_t pipelineAllocations = GetAllocations() - setupAllocations;
+
+   const uint64_t allocations = GetAllocations();
+   const uint64_t cycles = counter.Get();
+   const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   for ( uint32_t lap = 0; lap < laps; ++lap )
+   {
+      RunLap(track, lap * lapDuration, pipeline);
+   }
+   const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+   const uint64_t spentCycles = counter.Get() - cycles;
+   const uint64_t spentAllocations = GetAllocations() - allocations;
+
+   const uint64_t samples = static_cast<uint64_t>(track.GetSize()) * laps;
+   const double driven = lapDuration * laps;
+   printf("track: %s, %zu samples, %.1f s, %u laps\n", fileName, track.GetSize(), lapDuration, laps);
+   printf("pipeline: %llu odometer speeds, %llu gyroscope angular speeds, %llu fusions, %llu allocations on creation\n",
+          static_cast<unsigned long long>(pipeline.OdoSpeeds), static_cast<unsigned long long>(pipeline.AngSpeeds),
+          static_cast<unsigned long long>(pipeline.Fusions), static_cast<unsigned long long>(pipelineAllocations));
+   printf("%-24s %14.1f\n", "realtime factor", driven / seconds);
+   printf("%-24s %14.2f\n", "ns/sample", seconds * 1e9 / samples);
+   if ( NULL != counter.GetSource() )
+   {
+      printf("%-24s %14.1f (%s)\n", "cycles/sample", static_cast<double>(spentCycles) / samples, counter.GetSource());
+   }
+#ifdef __GLIBC__
+   printf("%-24s %14.4f (%llu)\n", "allocations/sample", static_cast<double>(spentAllocations) / samples,
+          static_cast<unsigned long long>(spentAllocations));
+#endif
+   printf("final: base %.6f scale %.9f calibrated %.2f%%, speed %.3f m/s\n", pipeline.Odometer.Base(), pipeline.Odometer.Scale(),
+          pipeline.Odometer.CalibratedTo(), pipeline.Fusion.GetSpeed().Value);
+   return 0;
+}
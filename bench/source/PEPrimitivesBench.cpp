@@ -0,0 +1,254 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Primitives benchmark: cost of one call of PE::TOOLS and PE::FUSION functions and of CFusionSensor::DoFusion().
+ *
+ * Usage:
+ *    pe_bench_primitives [minTime] [json]
+ *
+ * Inputs are samples of a drive at 10Hz: 10 m/s with 18 deg/s left turn like circle scenarios of PECFusionSensorTest,
+ * with noise of 3 m for positions, 2 deg for headings and 0.2 m/s for speeds. Each function is called once
+ * per sample of the drive, so branches and values change like on the road. Results are written into JSON file if given.
+ * DoFusion() is measured once per second of the drive, after adding 10 samples of each sensor.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "PECBenchmark.h"
+#include "PECFusionSensor.h"
+#include "PEFusionTools.h"
+#include "PETools.h"
+
+
+static const double   SPEED     = 10.0;
+static const double   ANG_SPEED = 18.0;
+static const double   HEADING   = 90.0;
+static const double   RATE      = 10.0;
+static const uint32_t SAMPLES   = 1024;
+static const PE::SPosition START(52.5, 13.4, 0.1);
+
+
+/**
+ * One sample of the drive, true and measured values
+ */
+struct SSample
+{
+   double Timestamp;
+   PE::SPosition Position;
+   PE::SPosition Measured;
+   PE::SBasicSensor Heading;
+   PE::SBasicSensor Speed;
+   PE::SBasicSensor AngSpeed;
+};
+
+
+/**
+ * Returns uniform noise in [-amplitude, amplitude]
+ */
+static double GetNoise(const double& amplitude)
+{
+   return amplitude * ( 2.0 * rand() / RAND_MAX - 1.0 );
+}
+
+
+/**
+ * Builds drive samples along the circle
+ */
+static std::vector<SSample> GetDrive()
+{
+   srand(7);
+   std::vector<SSample> drive(SAMPLES);
+   PE::SPosition position = START;
+   double heading = HEADING;
+   for ( uint32_t i = 0; i < SAMPLES; ++i )
+   {
+      SSample& sample = drive[i];
+      sample.Timestamp = i / RATE;
+      sample.Position  = position;
+      const std::pair<double, double> noise = PE::TOOLS::ToPosition(position.Latitude, position.Longitude, GetNoise(3.0), GetNoise(180.0) + 180.0);
+      sample.Measured  = PE::SPosition(noise.first, noise.second, 3.0);
+      sample.Heading   = PE::SBasicSensor(PE::TOOLS::ToHeading(heading, GetNoise(2.0)), 2.0);
+      sample.Speed     = PE::SBasicSensor(SPEED + GetNoise(0.2), 0.2);
+      sample.AngSpeed  = PE::SBasicSensor(ANG_SPEED + GetNoise(0.5), 0.5);
+      position = PE::TOOLS::ToPosition(position, SPEED / RATE, heading);
+      heading  = PE::TOOLS::ToHeading(heading, -ANG_SPEED / RATE);
+   }
+   return drive;
+}
+
+
+int main(int argc, char *argv[])
+{
+   const double minTime = ( 1 < argc ) ? atof(argv[1]) : 0.5;
+   const std::vector<SSample> drive = GetDrive();
+   const double dt = 1.0 / RATE;
+   PE::CBenchmark bench(minTime);
+
+   bench.Run("TOOLS::ToDistance", [&drive]()
+   {
+      double sum = 0;
+      for ( uint32_t i = 1; i < SAMPLES; ++i )
+      {
+         sum += PE::TOOLS::ToDistance(drive[i - 1].Measured.Latitude, drive[i - 1].Measured.Longitude,
+                                      drive[i].Measured.Latitude, drive[i].Measured.Longitude);
+      }
+      PE::CBenchmark::Keep(sum);
+      return static_cast<uint64_t>(SAMPLES - 1);
+   });
+   bench.Run("TOOLS::ToDistance with heading", [&drive]()
+   {
+      double sum = 0;
+      for ( uint32_t i = 1; i < SAMPLES; ++i )
+      {
+         sum += PE::TOOLS::ToDistance(drive[i - 1].Heading.Value, drive[i - 1].Measured.Latitude, drive[i - 1].Measured.Longitude,
+                                      drive[i].Measured.Latitude, drive[i].Measured.Longitude);
+      }
+      PE::CBenchmark::Keep(sum);
+      return static_cast<uint64_t>(SAMPLES - 1);
+   });
+   bench.Run("TOOLS::ToHeading", [&drive]()
+   {
+      double sum = 0;
+      for ( uint32_t i = 1; i < SAMPLES; ++i )
+      {
+         sum += PE::TOOLS::ToHeading(drive[i - 1].Measured.Latitude, drive[i - 1].Measured.Longitude,
+                                     drive[i].Measured.Latitude, drive[i].Measured.Longitude);
+      }
+      PE::CBenchmark::Keep(sum);
+      return static_cast<uint64_t>(SAMPLES - 1);
+   });
+   bench.Run("TOOLS::ToGeodesic", [&drive]()
+   {
+      double sum = 0;
+      for ( uint32_t i = 1; i < SAMPLES; ++i )
+      {
+         const PE::TOOLS::SGeodesic geodesic = PE::TOOLS::ToGeodesic(drive[i - 1].Measured.Latitude, drive[i - 1].Measured.Longitude,
+                                                                     drive[i].Measured.Latitude, drive[i].Measured.Longitude);
+         sum += geodesic.Distance + geodesic.Heading;
+      }
+      PE::CBenchmark::Keep(sum);
+      return static_cast<uint64_t>(SAMPLES - 1);
+   });
+   bench.Run("TOOLS::ToPosition", [&drive]()
+   {
+      double sum = 0;
+      for ( uint32_t i = 0; i < SAMPLES; ++i )
+      {
+         const PE::SPosition position = PE::TOOLS::ToPosition(drive[i].Measured, drive[i].Speed.Value * 0.1, drive[i].Heading.Value);
+         sum += position.Latitude + position.Longitude;
+      }
+      PE::CBenchmark::Keep(sum);
+      return static_cast<uint64_t>(SAMPLES);
+   });
+   bench.Run("TOOLS::Transform3D", [&drive]()
+   {
+      double sum = 0;
+      for ( uint32_t i = 0; i < SAMPLES; ++i )
+      {
+         //acceleration of the turn in vehicle frame, mounting angles vary with the sample
+         double x = drive[i].Speed.Value;
+         double y = drive[i].Speed.Value * PE::TOOLS::ToRadians(drive[i].AngSpeed.Value);
+         double z = 9.81;
+         PE::TOOLS::Transform3D(x, y, z, drive[i].Heading.Accuracy, drive[i].AngSpeed.Value * 0.1, drive[i].Heading.Value);
+         sum += x + y + z;
+      }
+      PE::CBenchmark::Keep(sum);
+      return static_cast<uint64_t>(SAMPLES);
+   });
+   bench.Run("FUSION::PredictPosition", [&drive, dt]()
+   {
+      double sum = 0;
+      for ( uint32_t i = 0; i < SAMPLES; ++i )
+      {
+         const PE::SPosition position = PE::FUSION::PredictPosition(dt, drive[i].Heading, drive[i].AngSpeed, drive[i].Measured, drive[i].Speed);
+         sum += position.Latitude + position.HorizontalAcc;
+      }
+      PE::CBenchmark::Keep(sum);
+      return static_cast<uint64_t>(SAMPLES);
+   });
+   bench.Run("FUSION::PredictSpeed", [&drive, dt]()
+   {
+      double sum = 0;
+      for ( uint32_t i = 1; i < SAMPLES; ++i )
+      {
+         sum += PE::FUSION::PredictSpeed(dt, drive[i - 1].Measured, drive[i].Measured, drive[i].AngSpeed).Value;
+      }
+      PE::CBenchmark::Keep(sum);
+      return static_cast<uint64_t>(SAMPLES - 1);
+   });
+   bench.Run("FUSION::MergeSensor", [&drive]()
+   {
+      double sum = 0;
+      for ( uint32_t i = 1; i < SAMPLES; ++i )
+      {
+         sum += PE::FUSION::MergeSensor(drive[i - 1].Speed, drive[i].Speed).Value;
+      }
+      PE::CBenchmark::Keep(sum);
+      return static_cast<uint64_t>(SAMPLES - 1);
+   });
+   bench.Run("FUSION::MergeHeading", [&drive]()
+   {
+      double sum = 0;
+      for ( uint32_t i = 1; i < SAMPLES; ++i )
+      {
+         sum += PE::FUSION::MergeHeading(drive[i - 1].Heading, drive[i].Heading).Value;
+      }
+      PE::CBenchmark::Keep(sum);
+      return static_cast<uint64_t>(SAMPLES - 1);
+   });
+   bench.Run("FUSION::MergePosition", [&drive]()
+   {
+      double sum = 0;
+      for ( uint32_t i = 0; i < SAMPLES; ++i )
+      {
+         sum += PE::FUSION::MergePosition(drive[i].Position, drive[i].Measured).Latitude;
+      }
+      PE::CBenchmark::Keep(sum);
+      return static_cast<uint64_t>(SAMPLES);
+   });
+
+   PE::CFusionSensor fusion(0.0, START, PE::SBasicSensor(HEADING, 0.1), PE::SBasicSensor(ANG_SPEED, 0.1), PE::SBasicSensor(SPEED, 0.1));
+   double offset = 0;
+   bench.Run("CFusionSensor::DoFusion per 1s at 10Hz", [&drive, &fusion, &offset]()
+   {
+      const uint32_t seconds = static_cast<uint32_t>(SAMPLES / RATE);
+      for ( uint32_t s = 0; s < seconds; ++s )
+      {
+         for ( uint32_t i = s * RATE; i < ( s + 1 ) * RATE; ++i )
+         {
+            const double timestamp = offset + drive[i].Timestamp;
+            fusion.AddPosition(timestamp, drive[i].Measured);
+            fusion.AddHeading(timestamp, drive[i].Heading);
+            fusion.AddSpeed(timestamp, drive[i].Speed);
+            fusion.AddAngSpeed(timestamp, drive[i].AngSpeed);
+         }
+         fusion.DoFusion();
+      }
+      //next round drives the circle again later, so timestamps keep increasing
+      offset += SAMPLES / RATE;
+      PE::CBenchmark::Keep(fusion.GetPosition().Latitude);
+      return static_cast<uint64_t>(seconds);
+   });
+
+   bench.Print();
+   if ( 2 < argc && false == bench.WriteJson(argv[2]) )
+   {
+      printf("Can not write %s\n", argv[2]);
+      return 1;
+   }
+   return 0;
+}
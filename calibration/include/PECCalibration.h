@@ -15,6 +15,7 @@
 #define __PE_CCalibration_H__
 
 #include "PETypes.h"
+#include "PECNormalisation.h"
 
 namespace PE
 {
@@ -34,6 +35,11 @@ namespace PE
 class CCalibration
 {
 public:
+   /**
+    * Normalisation of bias/base and scale which fits to the calibration
+    */
+   typedef CNormalisation TNormalisation;
+
    /**
     * Constructor of calibration
     */
@@ -62,14 +68,36 @@ public:
    const double& GetScale() const;
    /**
     * Calculates bias/base and scale of raw value.
+    * @return         true if bias/base and scale are valid
     */
-   void Recalculate();
+   bool Recalculate();
    /**
     * Clean all data since last Recalculate call
     */
    void CleanLastStep();
 
+   /**
+    * Sums of reference and raw data at the end of one step
+    */
+   struct SStep
+   {
+      double   SumRef;
+      double   SumRaw;
+      uint32_t Index;
+   };
+   /**
+    * Calculates bias/base and scale between two steps
+    * @return         true if bias/base and scale are valid, otherwise both are NaN
+    *
+    * @param  before   sums of previous step
+    * @param  now      sums of current step
+    * @param  bias     calculated bias/base
+    * @param  scale    calculated scale
+    */
+   static bool CalculateBaseScale(const SStep& before, const SStep& now, double& bias, double& scale);
+
 private:
+
    /**
     * Summ of all reference data before calculation - SUM(N)
     */
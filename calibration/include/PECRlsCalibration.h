@@ -0,0 +1,139 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CRlsCalibration_H__
+#define __PE_CRlsCalibration_H__
+
+#include "PETypes.h"
+#include "PECRobustNormalisation.h"
+
+class PECRlsCalibrationTest; //to get possibility for test class
+
+namespace PE
+{
+
+/**
+ * Recursive least squares calibration with exponential forgetting
+ *
+ * Reference is fitted as linear function of raw value:
+ *
+ *   ref = a * raw + b,  scale = a,  bias = -b / a
+ *
+ * Each Recalculate() call updates the fit by mean values of the step with constant cost,
+ * older steps are weighted by forgetting^age. So the calibration follows slow drift
+ * (e.g. temperature drift of gyroscope bias) with memory of about 1 / (1 - forgetting) steps.
+ * Results are normalised over a window, otherwise normalisation would average away the followed drift.
+ */
+class CRlsCalibration
+{
+   friend class ::PECRlsCalibrationTest;
+
+public:
+   /**
+    * Normalisation of bias/base and scale which fits to the calibration
+    */
+   typedef CRobustNormalisation TNormalisation;
+
+   /**
+    * Constructor
+    *
+    * @param  forgetting   forgetting factor in range (0..1], 1 - all steps have same weight
+    */
+   explicit CRlsCalibration(const double& forgetting = DEFAULT_FORGETTING);
+   /**
+    * Adds new reference value to the calibration
+    *
+    * @param  ref      reference value
+    */
+   void AddRef( const double& ref );
+   /**
+    * Adds new raw value to the calibration
+    *
+    * @param  raw     raw value
+    */
+   void AddRaw( const double& raw );
+   /**
+    * Returns bias/base of the calibration
+    * @return         bias/base or NaN if there is no valid data
+    */
+   const double& GetBias() const;
+   /**
+    * Returns scale of the calibration
+    * @return         scale or NaN if there is no valid data
+    */
+   const double& GetScale() const;
+   /**
+    * Updates the fit by current step
+    * @return         true if bias/base and scale were updated by the step
+    */
+   bool Recalculate();
+   /**
+    * Clean all data since last Recalculate call
+    */
+   void CleanLastStep();
+   /**
+    * Returns forgetting factor
+    */
+   const double& GetForgetting() const;
+
+   /**
+    * Default forgetting factor, memory of about 1000 steps
+    */
+   static const double DEFAULT_FORGETTING;
+   /**
+    * Initial covariance of the fit, upper limit of its trace
+    */
+   static const double MAX_COVARIANCE;
+
+private:
+   /**
+    * Forgetting factor
+    */
+   double m_Forgetting;
+   /**
+    * Summ of reference data of current step
+    */
+   double m_Sum_Ref;
+   /**
+    * Summ of raw data of current step
+    */
+   double m_Sum_Raw;
+   /**
+    * Count of raw data of current step
+    */
+   uint32_t m_Index;
+   /**
+    * Count of steps in the fit
+    */
+   uint32_t m_Steps;
+   /**
+    * Coefficients of the fit: a, b
+    */
+   double m_Theta[2];
+   /**
+    * Covariance of the fit: P00, P01(=P10), P11
+    */
+   double m_P[3];
+   /**
+    * Bias of the raw data
+    */
+   double m_Bias;
+   /**
+    * Scale of the raw data
+    */
+   double m_Scale;
+};
+
+} //namespace PE
+
+#endif //__PE_CRlsCalibration_H__
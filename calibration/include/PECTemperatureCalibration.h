@@ -0,0 +1,220 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CTemperatureCalibration_H__
+#define __PE_CTemperatureCalibration_H__
+
+#include <vector>
+#include "PETypes.h"
+#include "PECCalibration.h"
+#include "PECNormalisation.h"
+
+class PECTemperatureCalibrationTest; //to get possibility for test class
+
+namespace PE
+{
+
+/**
+ * Calibration store with separate calibration for each temperature bin
+ *
+ * Each bin has own calibration sums and own normalisation of bias/base and scale,
+ * bins are kept in flat array and selected by temperature in O(1).
+ * Bias/base and scale of sparse bin are interpolated between its direct neighbours,
+ * so values learned during previous warm up are available immediately.
+ *
+ * Normalisation of bins could be stored and restored by GetBin() and SetBin().
+ */
+class CTemperatureCalibration
+{
+   friend class ::PECTemperatureCalibrationTest;
+
+public:
+   /**
+    * Normalisation of bias/base and scale which fits to the calibration
+    */
+   typedef CNormalisation TNormalisation;
+
+   /**
+    * Calibration data of one temperature bin
+    */
+   struct SBin
+   {
+      /**
+       * Calibration sums of previous step
+       */
+      CCalibration::SStep Before;
+      /**
+       * Calibration sums of current step
+       */
+      CCalibration::SStep Now;
+      /**
+       * Normalisation of bias/base
+       */
+      CNormalisation Bias;
+      /**
+       * Normalisation of scale
+       */
+      CNormalisation Scale;
+   };
+
+   /**
+    * Constructor
+    *
+    * @param  minTemperature   lowest temperature of the table in [C], lower temperatures go to first bin
+    * @param  maxTemperature   highest temperature of the table in [C], higher temperatures go to last bin
+    * @param  binWidth         temperature range of one bin in [C]
+    */
+   CTemperatureCalibration( const double& minTemperature = DEFAULT_MIN_TEMPERATURE,
+                            const double& maxTemperature = DEFAULT_MAX_TEMPERATURE,
+                            const double& binWidth = DEFAULT_BIN_WIDTH );
+   /**
+    * Selects bin of the temperature for following steps
+    *
+    * @param  temperature   temperature in [C], NaN keeps the last bin
+    */
+   void SetTemperature( const double& temperature );
+   /**
+    * Adds new reference value to the calibration of current bin
+    *
+    * @param  ref      reference value
+    */
+   void AddRef( const double& ref );
+   /**
+    * Adds new raw value to the calibration of current bin
+    *
+    * @param  raw     raw value
+    */
+   void AddRaw( const double& raw );
+   /**
+    * Returns normalised bias/base of current temperature
+    * @return         bias/base or NaN if there is no valid data
+    */
+   const double& GetBias() const;
+   /**
+    * Returns normalised scale of current temperature
+    * @return         scale or NaN if there is no valid data
+    */
+   const double& GetScale() const;
+   /**
+    * Closes current step and updates normalisation of current bin
+    * @return         true if bias/base and scale were updated by the step
+    */
+   bool Recalculate();
+   /**
+    * Clean all data of current bin since last Recalculate call
+    */
+   void CleanLastStep();
+   /**
+    * Returns mean linear deviation of bias/base of current temperature
+    */
+   const double& GetBiasMld() const;
+   /**
+    * Returns mean linear deviation of scale of current temperature
+    */
+   const double& GetScaleMld() const;
+   /**
+    * Returns calibration status of bias/base of current temperature in %
+    */
+   const double& GetReliable() const;
+   /**
+    * Returns count of bins
+    */
+   uint32_t GetBinCount() const;
+   /**
+    * Returns index of the bin of temperature
+    *
+    * @param  temperature   temperature in [C]
+    */
+   uint32_t GetBinIndex( const double& temperature ) const;
+   /**
+    * Returns bin by index
+    *
+    * @param  index   index of the bin, has to be less then GetBinCount()
+    */
+   const SBin& GetBin( uint32_t index ) const;
+   /**
+    * Restores normalisation of the bin, e.g. from previous driving cycle
+    *
+    * @param  index   index of the bin, has to be less then GetBinCount()
+    * @param  bias    normalisation of bias/base
+    * @param  scale   normalisation of scale
+    */
+   void SetBin( uint32_t index, const CNormalisation& bias, const CNormalisation& scale );
+
+   static const double DEFAULT_MIN_TEMPERATURE;
+   static const double DEFAULT_MAX_TEMPERATURE;
+   static const double DEFAULT_BIN_WIDTH;
+   /**
+    * Temperature which is used till first SetTemperature() call
+    */
+   static const double DEFAULT_TEMPERATURE;
+   /**
+    * Bins with less normalised values are interpolated from neighbours
+    */
+   static const double MIN_BIN_SAMPLES;
+
+private:
+   /**
+    * Checks if bin has enough normalised values
+    */
+   bool IsDense( uint32_t index ) const;
+   /**
+    * Updates bias/base and scale of current temperature
+    */
+   void Lookup();
+
+   /**
+    * Lowest temperature of the table in [C]
+    */
+   double m_MinTemperature;
+   /**
+    * Temperature range of one bin in [C]
+    */
+   double m_BinWidth;
+   /**
+    * Temperature bins
+    */
+   std::vector<SBin> m_Bins;
+   /**
+    * Current temperature in [C]
+    */
+   double m_Temperature;
+   /**
+    * Index of current bin
+    */
+   uint32_t m_Current;
+   /**
+    * Bias/base of current temperature
+    */
+   double m_Bias;
+   /**
+    * Scale of current temperature
+    */
+   double m_Scale;
+   /**
+    * Mean linear deviation of bias/base of current temperature
+    */
+   double m_BiasMld;
+   /**
+    * Mean linear deviation of scale of current temperature
+    */
+   double m_ScaleMld;
+   /**
+    * Calibration status of bias/base of current temperature in %
+    */
+   double m_Reliable;
+};
+
+} //namespace PE
+
+#endif //__PE_CTemperatureCalibration_H__
@@ -56,18 +56,17 @@ const double& PE::CCalibration::GetScale() const
 }
 
 
-void PE::CCalibration::Recalculate()
+bool PE::CCalibration::Recalculate()
 {
    if ( 0 == m_Index_before )
    {
       m_Sum_Ref_before = m_Sum_Ref_now;
       m_Sum_Raw_before = m_Sum_Raw_now;
       m_Index_before   = m_Index_now;
+      return false;
    }
-   else
-   {
-      CalculateBaseScale();
-   }
+   CalculateBaseScale();
+   return ( false == PE::isnan(m_Bias) );
 }
 
 
@@ -81,22 +80,33 @@ void PE::CCalibration::CleanLastStep()
 
 void PE::CCalibration::CalculateBaseScale()
 {
-   double divisor = ( m_Index_before * m_Sum_Ref_now - m_Index_now * m_Sum_Ref_before );
+   SStep before = { m_Sum_Ref_before, m_Sum_Raw_before, m_Index_before };
+   SStep now    = { m_Sum_Ref_now, m_Sum_Raw_now, m_Index_now };
+   if ( CalculateBaseScale(before, now, m_Bias, m_Scale) )
+   {
+      m_Sum_Ref_before = m_Sum_Ref_now;
+      m_Sum_Raw_before = m_Sum_Raw_now;
+      m_Index_before   = m_Index_now;
+   }
+}
+
+
+bool PE::CCalibration::CalculateBaseScale(const SStep& before, const SStep& now, double& bias, double& scale)
+{
+   double divisor = ( before.Index * now.SumRef - now.Index * before.SumRef );
    if ( false == isepsilon( divisor ) )
    {
-      m_Bias = ( m_Sum_Ref_now * m_Sum_Raw_before - m_Sum_Raw_now * m_Sum_Ref_before ) / divisor;
+      bias = ( now.SumRef * before.SumRaw - now.SumRaw * before.SumRef ) / divisor;
 
-      divisor = m_Sum_Raw_now - m_Bias * m_Index_now;
+      divisor = now.SumRaw - bias * now.Index;
 
       if ( false == isepsilon( divisor ) )
       {
-         m_Scale = m_Sum_Ref_now / divisor;
-         m_Sum_Ref_before = m_Sum_Ref_now;
-         m_Sum_Raw_before = m_Sum_Raw_now;
-         m_Index_before   = m_Index_now;
-         return;
+         scale = now.SumRef / divisor;
+         return true;
       }
    }
-   m_Bias  = std::numeric_limits<double>::quiet_NaN();
-   m_Scale = std::numeric_limits<double>::quiet_NaN();
+   bias  = std::numeric_limits<double>::quiet_NaN();
+   scale = std::numeric_limits<double>::quiet_NaN();
+   return false;
 }
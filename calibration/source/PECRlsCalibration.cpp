@@ -0,0 +1,131 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include "PECRlsCalibration.h"
+
+
+using namespace PE;
+
+
+const double PE::CRlsCalibration::DEFAULT_FORGETTING = 0.999;
+const double PE::CRlsCalibration::MAX_COVARIANCE     = 1000000.0;
+
+
+PE::CRlsCalibration::CRlsCalibration(const double& forgetting)
+: m_Forgetting( ( 0.0 < forgetting && 1.0 >= forgetting ) ? forgetting : DEFAULT_FORGETTING )
+, m_Sum_Ref(0.0)
+, m_Sum_Raw(0.0)
+, m_Index(0)
+, m_Steps(0)
+, m_Bias(std::numeric_limits<double>::quiet_NaN())
+, m_Scale(std::numeric_limits<double>::quiet_NaN())
+{
+   m_Theta[0] = 0.0;
+   m_Theta[1] = 0.0;
+   m_P[0] = MAX_COVARIANCE;
+   m_P[1] = 0.0;
+   m_P[2] = MAX_COVARIANCE;
+}
+
+
+void PE::CRlsCalibration::AddRef( const double& ref )
+{
+   m_Sum_Ref += ref;
+}
+
+
+void PE::CRlsCalibration::AddRaw( const double& raw )
+{
+   m_Sum_Raw += raw;
+   ++m_Index;
+}
+
+
+const double& PE::CRlsCalibration::GetBias() const
+{
+   return m_Bias;
+}
+
+
+const double& PE::CRlsCalibration::GetScale() const
+{
+   return m_Scale;
+}
+
+
+bool PE::CRlsCalibration::Recalculate()
+{
+   if ( 0 == m_Index )
+   {
+      return false;
+   }
+   double raw = m_Sum_Raw / m_Index;
+   double ref = m_Sum_Ref / m_Index;
+   m_Sum_Ref = 0.0;
+   m_Sum_Raw = 0.0;
+   m_Index   = 0;
+
+   //x = [raw, 1],  Px = P * x,  k = Px / (forgetting + x'Px)
+   double px0 = m_P[0] * raw + m_P[1];
+   double px1 = m_P[1] * raw + m_P[2];
+   double divisor = m_Forgetting + raw * px0 + px1;
+   if ( isepsilon( divisor ) )
+   {
+      return false;
+   }
+   double k0 = px0 / divisor;
+   double k1 = px1 / divisor;
+
+   double error = ref - ( m_Theta[0] * raw + m_Theta[1] );
+   m_Theta[0] += k0 * error;
+   m_Theta[1] += k1 * error;
+
+   //P = ( P - k * x'P ) / forgetting
+   m_P[0] = ( m_P[0] - k0 * px0 ) / m_Forgetting;
+   m_P[1] = ( m_P[1] - k0 * px1 ) / m_Forgetting;
+   m_P[2] = ( m_P[2] - k1 * px1 ) / m_Forgetting;
+
+   //without excitation (constant raw) forgetting blows up covariance, keep it bounded
+   double trace = m_P[0] + m_P[2];
+   if ( 2 * MAX_COVARIANCE < trace )
+   {
+      double ratio = 2 * MAX_COVARIANCE / trace;
+      m_P[0] *= ratio;
+      m_P[1] *= ratio;
+      m_P[2] *= ratio;
+   }
+
+   ++m_Steps;
+   if ( 2 > m_Steps || isepsilon( m_Theta[0] ) )
+   {
+      return false;
+   }
+   m_Scale = m_Theta[0];
+   m_Bias  = -m_Theta[1] / m_Theta[0];
+   return true;
+}
+
+
+void PE::CRlsCalibration::CleanLastStep()
+{
+   m_Sum_Ref = 0.0;
+   m_Sum_Raw = 0.0;
+   m_Index   = 0;
+}
+
+
+const double& PE::CRlsCalibration::GetForgetting() const
+{
+   return m_Forgetting;
+}
@@ -0,0 +1,226 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <math.h>
+#include <algorithm>
+#include "PECTemperatureCalibration.h"
+
+
+using namespace PE;
+
+
+const double PE::CTemperatureCalibration::DEFAULT_MIN_TEMPERATURE = -40.0;
+const double PE::CTemperatureCalibration::DEFAULT_MAX_TEMPERATURE = 85.0;
+const double PE::CTemperatureCalibration::DEFAULT_BIN_WIDTH       = 5.0;
+const double PE::CTemperatureCalibration::DEFAULT_TEMPERATURE     = 20.0;
+const double PE::CTemperatureCalibration::MIN_BIN_SAMPLES         = 10.0;
+
+
+PE::CTemperatureCalibration::CTemperatureCalibration( const double& minTemperature, const double& maxTemperature, const double& binWidth )
+: m_MinTemperature(minTemperature)
+, m_BinWidth( ( EPSILON < binWidth ) ? binWidth : DEFAULT_BIN_WIDTH )
+, m_Temperature(DEFAULT_TEMPERATURE)
+, m_Current(0)
+, m_Bias(std::numeric_limits<double>::quiet_NaN())
+, m_Scale(std::numeric_limits<double>::quiet_NaN())
+, m_BiasMld(std::numeric_limits<double>::quiet_NaN())
+, m_ScaleMld(std::numeric_limits<double>::quiet_NaN())
+, m_Reliable(0.0)
+{
+   uint32_t count = 1;
+   if ( maxTemperature > minTemperature )
+   {
+      count = static_cast<uint32_t>( ceil( ( maxTemperature - minTemperature ) / m_BinWidth ) );
+   }
+   SBin bin;
+   bin.Before.SumRef = bin.Now.SumRef = 0.0;
+   bin.Before.SumRaw = bin.Now.SumRaw = 0.0;
+   bin.Before.Index  = bin.Now.Index  = 0;
+   m_Bins.assign(( 0 < count ) ? count : 1, bin);
+   m_Current = GetBinIndex(m_Temperature);
+}
+
+
+void PE::CTemperatureCalibration::SetTemperature( const double& temperature )
+{
+   if ( false == PE::isnan(temperature) )
+   {
+      m_Temperature = temperature;
+      m_Current = GetBinIndex(temperature);
+      Lookup();
+   }
+}
+
+
+void PE::CTemperatureCalibration::AddRef( const double& ref )
+{
+   m_Bins[m_Current].Now.SumRef += ref;
+}
+
+
+void PE::CTemperatureCalibration::AddRaw( const double& raw )
+{
+   SBin& bin = m_Bins[m_Current];
+   bin.Now.SumRaw += raw;
+   ++bin.Now.Index;
+}
+
+
+const double& PE::CTemperatureCalibration::GetBias() const
+{
+   return m_Bias;
+}
+
+
+const double& PE::CTemperatureCalibration::GetScale() const
+{
+   return m_Scale;
+}
+
+
+bool PE::CTemperatureCalibration::Recalculate()
+{
+   SBin& bin = m_Bins[m_Current];
+   if ( 0 == bin.Before.Index )
+   {
+      bin.Before = bin.Now;
+      return false;
+   }
+   double bias;
+   double scale;
+   if ( false == CCalibration::CalculateBaseScale(bin.Before, bin.Now, bias, scale) )
+   {
+      return false;
+   }
+   bin.Before = bin.Now;
+   bin.Bias.AddSensor(bias);
+   bin.Scale.AddSensor(scale);
+   Lookup();
+   return true;
+}
+
+
+void PE::CTemperatureCalibration::CleanLastStep()
+{
+   SBin& bin = m_Bins[m_Current];
+   bin.Now = bin.Before;
+}
+
+
+const double& PE::CTemperatureCalibration::GetBiasMld() const
+{
+   return m_BiasMld;
+}
+
+
+const double& PE::CTemperatureCalibration::GetScaleMld() const
+{
+   return m_ScaleMld;
+}
+
+
+const double& PE::CTemperatureCalibration::GetReliable() const
+{
+   return m_Reliable;
+}
+
+
+uint32_t PE::CTemperatureCalibration::GetBinCount() const
+{
+   return static_cast<uint32_t>(m_Bins.size());
+}
+
+
+uint32_t PE::CTemperatureCalibration::GetBinIndex( const double& temperature ) const
+{
+   double position = floor( ( temperature - m_MinTemperature ) / m_BinWidth );
+   if ( 0.0 >= position )
+   {
+      return 0;
+   }
+   if ( m_Bins.size() <= position )
+   {
+      return static_cast<uint32_t>(m_Bins.size() - 1);
+   }
+   return static_cast<uint32_t>(position);
+}
+
+
+const CTemperatureCalibration::SBin& PE::CTemperatureCalibration::GetBin( uint32_t index ) const
+{
+   return m_Bins[index];
+}
+
+
+void PE::CTemperatureCalibration::SetBin( uint32_t index, const CNormalisation& bias, const CNormalisation& scale )
+{
+   m_Bins[index].Bias  = bias;
+   m_Bins[index].Scale = scale;
+   Lookup();
+}
+
+
+bool PE::CTemperatureCalibration::IsDense( uint32_t index ) const
+{
+   return ( MIN_BIN_SAMPLES <= m_Bins[index].Bias.GetSampleCount() );
+}
+
+
+void PE::CTemperatureCalibration::Lookup()
+{
+   const SBin* left  = ( 0 < m_Current && IsDense(m_Current - 1) ) ? &m_Bins[m_Current - 1] : 0;
+   const SBin* right = ( m_Current + 1 < m_Bins.size() && IsDense(m_Current + 1) ) ? &m_Bins[m_Current + 1] : 0;
+   const SBin& bin   = m_Bins[m_Current];
+
+   if ( IsDense(m_Current) || ( 0 == left && 0 == right ) )
+   {
+      if ( 0 < bin.Bias.GetSampleCount() )
+      {
+         m_Bias     = bin.Bias.GetMean();
+         m_Scale    = bin.Scale.GetMean();
+         m_BiasMld  = bin.Bias.GetMld();
+         m_ScaleMld = bin.Scale.GetMld();
+         m_Reliable = bin.Bias.GetReliable();
+      }
+      else
+      {
+         m_Bias     = std::numeric_limits<double>::quiet_NaN();
+         m_Scale    = std::numeric_limits<double>::quiet_NaN();
+         m_BiasMld  = std::numeric_limits<double>::quiet_NaN();
+         m_ScaleMld = std::numeric_limits<double>::quiet_NaN();
+         m_Reliable = 0.0;
+      }
+   }
+   else if ( 0 != left && 0 != right )
+   {
+      //linear interpolation between centres of neighbouring bins
+      double leftCentre = m_MinTemperature + ( m_Current - 0.5 ) * m_BinWidth;
+      double ratio = ( m_Temperature - leftCentre ) / ( 2 * m_BinWidth );
+      ratio = ( 0.0 > ratio ) ? 0.0 : ( ( 1.0 < ratio ) ? 1.0 : ratio );
+      m_Bias     = left->Bias.GetMean()  + ratio * ( right->Bias.GetMean()  - left->Bias.GetMean() );
+      m_Scale    = left->Scale.GetMean() + ratio * ( right->Scale.GetMean() - left->Scale.GetMean() );
+      m_BiasMld  = std::max(left->Bias.GetMld(), right->Bias.GetMld());
+      m_ScaleMld = std::max(left->Scale.GetMld(), right->Scale.GetMld());
+      m_Reliable = std::min(left->Bias.GetReliable(), right->Bias.GetReliable());
+   }
+   else
+   {
+      const SBin* neighbour = ( 0 != left ) ? left : right;
+      m_Bias     = neighbour->Bias.GetMean();
+      m_Scale    = neighbour->Scale.GetMean();
+      m_BiasMld  = neighbour->Bias.GetMld();
+      m_ScaleMld = neighbour->Scale.GetMld();
+      m_Reliable = neighbour->Bias.GetReliable();
+   }
+}
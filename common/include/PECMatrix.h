@@ -0,0 +1,220 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CMatrix_H__
+#define __PE_CMatrix_H__
+
+#include <math.h>
+#include "PETypes.h"
+
+namespace PE
+{
+
+/**
+ * Matrix of fixed size with values stored row by row inside of the object.
+ *
+ * Dimensions are template parameters, so all loops have constant trip count and
+ * could be unrolled by compiler, matrices of filters live on the stack and never allocate memory.
+ */
+template <uint32_t ROWS, uint32_t COLS>
+class CMatrix
+{
+public:
+   /**
+    * Constructor, all values are zero
+    */
+   CMatrix()
+   {
+      for ( uint32_t i = 0; i < ROWS * COLS; ++i )
+      {
+         m_Values[i] = 0.0;
+      }
+   }
+   /**
+    * Returns identity matrix, values outside of the main diagonal are zero
+    */
+   static CMatrix Identity()
+   {
+      CMatrix result;
+      for ( uint32_t i = 0; i < ROWS && i < COLS; ++i )
+      {
+         result(i, i) = 1.0;
+      }
+      return result;
+   }
+   /**
+    * Returns count of rows
+    */
+   static uint32_t GetRows()
+   {
+      return ROWS;
+   }
+   /**
+    * Returns count of columns
+    */
+   static uint32_t GetCols()
+   {
+      return COLS;
+   }
+   /**
+    * Returns value by row and column
+    */
+   double& operator()(uint32_t row, uint32_t col)
+   {
+      return m_Values[row * COLS + col];
+   }
+   const double& operator()(uint32_t row, uint32_t col) const
+   {
+      return m_Values[row * COLS + col];
+   }
+   /**
+    * Sum of two matrices
+    */
+   CMatrix operator+(const CMatrix& other) const
+   {
+      CMatrix result;
+      for ( uint32_t i = 0; i < ROWS * COLS; ++i )
+      {
+         result.m_Values[i] = m_Values[i] + other.m_Values[i];
+      }
+      return result;
+   }
+   /**
+    * Difference of two matrices
+    */
+   CMatrix operator-(const CMatrix& other) const
+   {
+      CMatrix result;
+      for ( uint32_t i = 0; i < ROWS * COLS; ++i )
+      {
+         result.m_Values[i] = m_Values[i] - other.m_Values[i];
+      }
+      return result;
+   }
+   /**
+    * Product with scalar
+    */
+   CMatrix operator*(const double& factor) const
+   {
+      CMatrix result;
+      for ( uint32_t i = 0; i < ROWS * COLS; ++i )
+      {
+         result.m_Values[i] = m_Values[i] * factor;
+      }
+      return result;
+   }
+   /**
+    * Product of two matrices
+    */
+   template <uint32_t OTHER_COLS>
+   CMatrix<ROWS, OTHER_COLS> operator*(const CMatrix<COLS, OTHER_COLS>& other) const
+   {
+      CMatrix<ROWS, OTHER_COLS> result;
+      for ( uint32_t row = 0; row < ROWS; ++row )
+      {
+         for ( uint32_t k = 0; k < COLS; ++k )
+         {
+            const double value = (*this)(row, k);
+            for ( uint32_t col = 0; col < OTHER_COLS; ++col )
+            {
+               result(row, col) += value * other(k, col);
+            }
+         }
+      }
+      return result;
+   }
+   /**
+    * Returns transposed matrix
+    */
+   CMatrix<COLS, ROWS> Transpose() const
+   {
+      CMatrix<COLS, ROWS> result;
+      for ( uint32_t row = 0; row < ROWS; ++row )
+      {
+         for ( uint32_t col = 0; col < COLS; ++col )
+         {
+            result(col, row) = (*this)(row, col);
+         }
+      }
+      return result;
+   }
+   /**
+    * Calculates inverse of square matrix by Gauss-Jordan elimination with partial pivoting
+    * @return   false if matrix is singular, result is not changed in this case
+    *
+    * @param  result   inverse matrix
+    */
+   bool Invert(CMatrix& result) const
+   {
+      static_assert(ROWS == COLS, "only square matrix could be inverted");
+      CMatrix left = *this;
+      CMatrix right = Identity();
+      for ( uint32_t col = 0; col < COLS; ++col )
+      {
+         uint32_t pivot = col;
+         for ( uint32_t row = col + 1; row < ROWS; ++row )
+         {
+            if ( fabs(left(row, col)) > fabs(left(pivot, col)) )
+            {
+               pivot = row;
+            }
+         }
+         if ( 0.0 == left(pivot, col) )
+         {
+            return false;
+         }
+         if ( pivot != col )
+         {
+            for ( uint32_t k = 0; k < COLS; ++k )
+            {
+               double value = left(col, k);
+               left(col, k) = left(pivot, k);
+               left(pivot, k) = value;
+               value = right(col, k);
+               right(col, k) = right(pivot, k);
+               right(pivot, k) = value;
+            }
+         }
+         const double factor = 1.0 / left(col, col);
+         for ( uint32_t k = 0; k < COLS; ++k )
+         {
+            left(col, k) *= factor;
+            right(col, k) *= factor;
+         }
+         for ( uint32_t row = 0; row < ROWS; ++row )
+         {
+            if ( row != col )
+            {
+               const double scale = left(row, col);
+               for ( uint32_t k = 0; k < COLS; ++k )
+               {
+                  left(row, k) -= scale * left(col, k);
+                  right(row, k) -= scale * right(col, k);
+               }
+            }
+         }
+      }
+      result = right;
+      return true;
+   }
+
+private:
+   /**
+    * Values row by row
+    */
+   double m_Values[ROWS * COLS];
+};
+
+} //namespace PE
+
+#endif //__PE_CMatrix_H__
@@ -0,0 +1,179 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CRingBuffer_H__
+#define __PE_CRingBuffer_H__
+
+#include <vector>
+#include "PETypes.h"
+
+namespace PE
+{
+
+/**
+ * Queue of fixed capacity, all items are allocated by constructor.
+ * Adding and removing of items never allocates memory.
+ *
+ * Item type has to be default constructible and assignable.
+ */
+template <typename T>
+class CRingBuffer
+{
+public:
+   /**
+    * Constructor
+    *
+    * @param  capacity   maximal count of items, at least 1
+    */
+   explicit CRingBuffer(uint32_t capacity)
+      : m_Items( ( 0 < capacity ) ? capacity : 1 )
+      , m_Front(0)
+      , m_Size(0)
+   {
+   }
+   /**
+    * Returns maximal count of items
+    */
+   uint32_t GetCapacity() const
+   {
+      return static_cast<uint32_t>( m_Items.size() );
+   }
+   /**
+    * Returns count of items
+    */
+   uint32_t GetSize() const
+   {
+      return m_Size;
+   }
+   /**
+    * Returns true if there are no items
+    */
+   bool IsEmpty() const
+   {
+      return 0 == m_Size;
+   }
+   /**
+    * Returns true if no item could be added
+    */
+   bool IsFull() const
+   {
+      return m_Items.size() == m_Size;
+   }
+   /**
+    * Adds item at the end
+    * @return   false if buffer is full, item is not added in this case
+    *
+    * @param  item   new item
+    */
+   bool PushBack(const T& item)
+   {
+      if ( IsFull() )
+      {
+         return false;
+      }
+      m_Items[Wrap(m_Front + m_Size)] = item;
+      ++m_Size;
+      return true;
+   }
+   /**
+    * Removes the oldest item, does nothing if buffer is empty
+    */
+   void PopFront()
+   {
+      if ( 0 < m_Size )
+      {
+         m_Front = Wrap(m_Front + 1);
+         --m_Size;
+      }
+   }
+   /**
+    * Removes the newest item, does nothing if buffer is empty
+    */
+   void PopBack()
+   {
+      if ( 0 < m_Size )
+      {
+         --m_Size;
+      }
+   }
+   /**
+    * Removes all items
+    */
+   void Clean()
+   {
+      m_Front = 0;
+      m_Size = 0;
+   }
+   /**
+    * Returns the oldest item, buffer has not to be empty
+    */
+   T& Front()
+   {
+      return m_Items[m_Front];
+   }
+   const T& Front() const
+   {
+      return m_Items[m_Front];
+   }
+   /**
+    * Returns the newest item, buffer has not to be empty
+    */
+   T& Back()
+   {
+      return m_Items[Wrap(m_Front + m_Size - 1)];
+   }
+   const T& Back() const
+   {
+      return m_Items[Wrap(m_Front + m_Size - 1)];
+   }
+   /**
+    * Returns item by index from the oldest one
+    *
+    * @param  index   index of the item, has to be less then GetSize()
+    */
+   T& operator[](uint32_t index)
+   {
+      return m_Items[Wrap(m_Front + index)];
+   }
+   const T& operator[](uint32_t index) const
+   {
+      return m_Items[Wrap(m_Front + index)];
+   }
+
+private:
+   /**
+    * Returns storage index of position which could be up to twice capacity
+    */
+   uint32_t Wrap(uint32_t position) const
+   {
+      const uint32_t capacity = static_cast<uint32_t>( m_Items.size() );
+      return ( position >= capacity ) ? position - capacity : position;
+   }
+
+   /**
+    * Storage of the items
+    */
+   std::vector<T> m_Items;
+   /**
+    * Storage index of the oldest item
+    */
+   uint32_t m_Front;
+   /**
+    * Count of items
+    */
+   uint32_t m_Size;
+};
+
+} //namespace PE
+
+#endif //__PE_CRingBuffer_H__
@@ -0,0 +1,107 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CThreadPool_H__
+#define __PE_CThreadPool_H__
+
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "PETypes.h"
+
+class PECThreadPoolTest; //to get possibility for test class
+
+namespace PE
+{
+
+/**
+ * Simple pool of worker threads for offline processing (tools, tuning, smoothing).
+ * Tasks are executed in order of adding by first free worker.
+ */
+class CThreadPool
+{
+   friend class ::PECThreadPoolTest;
+
+public:
+   /**
+    * Task to be executed by worker
+    */
+   typedef std::function<void()> TTask;
+   /**
+    * Constructor starts all worker threads
+    *
+    * @param  threadCount   count of worker threads, 0 means count of hardware threads
+    */
+   explicit CThreadPool(uint32_t threadCount = 0);
+   /**
+    * Destructor waits for all added tasks and stops workers
+    */
+   ~CThreadPool();
+   /**
+    * Adds new task for execution
+    *
+    * @param  task   task to be executed
+    */
+   void Add(const TTask& task);
+   /**
+    * Blocks till all added tasks are executed
+    */
+   void Wait();
+   /**
+    * Returns count of worker threads
+    */
+   uint32_t GetSize() const;
+
+private:
+   CThreadPool(const CThreadPool&);
+   CThreadPool& operator=(const CThreadPool&);
+   /**
+    * Main loop of worker thread
+    */
+   void Worker();
+
+   /**
+    * Worker threads
+    */
+   std::vector<std::thread> m_Threads;
+   /**
+    * Tasks waiting for execution
+    */
+   std::deque<TTask> m_Tasks;
+   /**
+    * Count of tasks in execution
+    */
+   uint32_t m_Active;
+   /**
+    * True if workers have to finish
+    */
+   bool m_IsStopped;
+   /**
+    * Protects tasks queue and counters
+    */
+   std::mutex m_Mutex;
+   /**
+    * Signals new task or stop to workers
+    */
+   std::condition_variable m_TaskAdded;
+   /**
+    * Signals completion of all tasks
+    */
+   std::condition_variable m_TasksDone;
+};
+
+} //namespace PE
+
+#endif //__PE_CThreadPool_H__
@@ -62,6 +62,32 @@ double ToDistance(const double& firstLatitude, const double& firstLongitude, con
  * @return                 distance in meters
  */
 double ToDistance(const double& firstHeading, const double& firstLatitude, const double& firstLongitude, const double& lastLatitude, const double& lastLongitude);
+/**
+ * Distance and heading between two coordinates
+ */
+struct SGeodesic
+{
+   /**
+    * Distance in meters, same like ToDistance()
+    */
+   double Distance;
+   /**
+    * Heading from first to last coordinate in degrees, same like ToHeading()
+    */
+   double Heading;
+};
+/**
+ * Calculates distance and heading between two coordinates at once.
+ * Radians and cosines of both latitudes are calculated once for both values,
+ * results are the same like of ToDistance() and ToHeading().
+ *
+ * @param firstLatitude    Latitude of first position in degrees
+ * @param firstLongitude   Longitude of first position in degrees
+ * @param lastLatitude     Latitude of last position in degrees
+ * @param lastLongitude    Longitude of last position in degrees
+ * @return                 distance in meters and heading in degrees
+ */
+SGeodesic ToGeodesic(const double& firstLatitude, const double& firstLongitude, const double& lastLatitude, const double& lastLongitude);
 /**
  * Calculates angle between two headings.
  * It takes always the shortest way
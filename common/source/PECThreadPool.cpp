@@ -0,0 +1,106 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include "PECThreadPool.h"
+
+
+using namespace PE;
+
+
+PE::CThreadPool::CThreadPool(uint32_t threadCount)
+: m_Active(0)
+, m_IsStopped(false)
+{
+   if ( 0 == threadCount )
+   {
+      threadCount = std::thread::hardware_concurrency();
+   }
+   if ( 0 == threadCount )
+   {
+      threadCount = 1;
+   }
+   for ( uint32_t i = 0; i < threadCount; ++i )
+   {
+      m_Threads.push_back(std::thread(&CThreadPool::Worker, this));
+   }
+}
+
+
+PE::CThreadPool::~CThreadPool()
+{
+   Wait();
+   {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_IsStopped = true;
+   }
+   m_TaskAdded.notify_all();
+   for ( uint32_t i = 0; i < m_Threads.size(); ++i )
+   {
+      m_Threads[i].join();
+   }
+}
+
+
+void PE::CThreadPool::Add(const TTask& task)
+{
+   {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Tasks.push_back(task);
+   }
+   m_TaskAdded.notify_one();
+}
+
+
+void PE::CThreadPool::Wait()
+{
+   std::unique_lock<std::mutex> lock(m_Mutex);
+   while ( false == m_Tasks.empty() || 0 < m_Active )
+   {
+      m_TasksDone.wait(lock);
+   }
+}
+
+
+uint32_t PE::CThreadPool::GetSize() const
+{
+   return m_Threads.size();
+}
+
+
+void PE::CThreadPool::Worker()
+{
+   std::unique_lock<std::mutex> lock(m_Mutex);
+   while ( true )
+   {
+      while ( false == m_IsStopped && m_Tasks.empty() )
+      {
+         m_TaskAdded.wait(lock);
+      }
+      if ( m_Tasks.empty() )
+      {
+         return; //stopped and nothing to do
+      }
+      TTask task = m_Tasks.front();
+      m_Tasks.pop_front();
+      ++m_Active;
+      lock.unlock();
+      task();
+      lock.lock();
+      --m_Active;
+      if ( m_Tasks.empty() && 0 == m_Active )
+      {
+         m_TasksDone.notify_all();
+      }
+   }
+}
@@ -46,6 +46,25 @@ double PE::TOOLS::ToDistance(const double& firstLatitude, const double& firstLon
 }
 
 
+TOOLS::SGeodesic PE::TOOLS::ToGeodesic(const double& firstLatitude, const double& firstLongitude, const double& lastLatitude, const double& lastLongitude)
+{
+   double rLat1 = ToRadians(firstLatitude);
+   double rLat2 = ToRadians(lastLatitude);
+   double rLon1 = ToRadians(firstLongitude);
+   double rLon2 = ToRadians(lastLongitude);
+   double cosLat1 = cos(rLat1);
+   double cosLat2 = cos(rLat2);
+   double dLat = rLat2-rLat1;
+   double dLon = rLon2-rLon1;
+   double a = pow(sin(dLat/2),2) + cosLat1*cosLat2*pow(sin(dLon/2),2);
+   double rBearing = atan2( sin(dLon) * cosLat2, cosLat1 * sin(rLat2) - sin(rLat1) * cosLat2 * cos(dLon));
+   SGeodesic geodesic;
+   geodesic.Distance = 2 * atan2( sqrt(a), sqrt(1-a)) * EARTH_RADIUS_M;
+   geodesic.Heading  = fmod(ToDegrees(rBearing) + 360, 360.0);
+   return geodesic;
+}
+
+
 double PE::TOOLS::ToDistance(const double& firstHeading, const double& firstLatitude, const double& firstLongitude, const double& lastLatitude, const double& lastLongitude)
 {
    double secondHeading = ToHeading(firstLatitude, firstLongitude, lastLatitude, lastLongitude);
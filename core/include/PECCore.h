@@ -14,6 +14,15 @@
 #ifndef __PE_CCore_H__
 #define __PE_CCore_H__
 #include <string>
+#include <stdint.h>
+#include "PESSensorStats.h"
+#include "PECOdometerEx.h"
+#include "PECGyroscope.h"
+
+namespace PE
+{
+   class CRecorder;
+}
 
 /**
  * class PECCore core functionality of Position Engine
@@ -32,6 +41,15 @@ public:
     * Destructor
     */
    ~PECCore();
+   /**
+    * Allocates instance aligned like counters of its sensors, operator new of C++11 does not align it
+    * @return   NULL if there is no memory
+    */
+   static void* operator new(size_t size) noexcept;
+   /**
+    * Frees instance allocated by operator new
+    */
+   static void operator delete(void* instance) noexcept;
    /**
    * Initialises and starts position engine
    * @return   true if it started with no error
@@ -84,6 +102,15 @@ public:
     * @param[in] gyro        raw gyroscope sensors data dimention does not matter
     */
    void SendGyro( const double& timestamp, const double& gyro);
+   /**
+    * Sends new gyroscope - angular velocity of the object with temperature of the sensor
+    *
+    * @param[in] timestamp     timestamp of given sensors data in seconds
+    * @param[in] gyro          raw gyroscope sensors data dimention does not matter
+    * @param[in] temperature   temperature of the gyroscope in degrees Celsius, NaN if unknown.
+    *                          It is ignored by the engine and not recorded, like SendGyro() without temperature
+    */
+   void SendGyro( const double& timestamp, const double& gyro, const double& temperature);
    /**
     * Sends new odometer - ticks count of the wheel
     *
@@ -131,11 +158,52 @@ public:
     * @param[out] reliable   percentage indicator of calibration status in (0%..100%)
     */
    bool ReceiveOdoStatus( double& bias, double& scale, double& reliable);
+   /**
+    * Starts recording of all sent sensors data into native track file, previous recording is stopped
+    * @return   true if recording started
+    *
+    * @param[in] fileName   name of the native track file
+    */
+   bool StartRecording( const std::string& fileName);
+   /**
+    * Stops recording and writes native track file
+    * @return   true if recording was started and track file is written
+    */
+   bool StopRecording();
+   /**
+    * Receives status of recording since its start
+    * @return   true if recording is started
+    *
+    * @param[out] recorded   count of recorded sensors data
+    * @param[out] dropped    count of dropped sensors data because writing of the track file falls behind
+    * @param[out] written    count of sensors data written into journal of the track file
+    */
+   bool ReceiveRecorderStatus( uint64_t& recorded, uint64_t& dropped, uint64_t& written);
+   /**
+    * Receives counters of accepted and rejected sensors data by reason since start
+    * @return   true if counters are received
+    *
+    * @param[out] odoStats    counters of odometer (reference: speed, sensor: odometer ticks)
+    * @param[out] gyroStats   counters of gyroscope (reference: heading, sensor: gyroscope)
+    */
+   bool ReceiveStats( PE::SSensorStats& odoStats, PE::SSensorStats& gyroStats);
 private:
    /**
     * Current configuration string
     */
    std::string m_Cfg_Str;
+   /**
+    * Recorder of sent sensors data, NULL if recording was never started
+    */
+   PE::CRecorder* m_Recorder;
+   /**
+    * Odometer calibrated by sent speeds, rates of speed and odometer are detected
+    */
+   PE::COdometerEx<> m_Odometer;
+   /**
+    * Gyroscope calibrated by sent headings, rates of heading and gyroscope are detected
+    */
+   PE::CGyroscope<> m_Gyroscope;
 };
 
 #endif //__PE_CCore_H__
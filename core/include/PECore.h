@@ -14,6 +14,8 @@
 #ifndef __PE_Core_H__
 #define __PE_Core_H__
 
+#include <stdint.h>
+#include "PESSensorStats.h"
 
 
 #ifdef __cplusplus
@@ -93,6 +95,17 @@
     * @param[in] gyro        raw gyroscope sensors data dimention does not matter
     */
    bool PESendGyro(PECCore* core, const double& timestamp, const double& gyro);
+   /**
+    * Sends new gyroscope - angular velocity of the object with temperature of the sensor
+    * @return   true if gyroscope was sent with no error
+    *
+   * @param[in] core       pointer to the position engine instance
+    * @param[in] timestamp   timestamp of given sensors data in seconds
+    * @param[in] gyro        raw gyroscope sensors data dimention does not matter
+    * @param[in] temperature temperature of the gyroscope in degrees Celsius, NaN if unknown.
+    *                        It is ignored by the engine and not recorded, like PESendGyro()
+    */
+   bool PESendGyroEx(PECCore* core, const double& timestamp, const double& gyro, const double& temperature);
    /**
     * Sends new odometer - ticks count of the wheel
     * @return   true if odometer was sent with no error
@@ -146,6 +159,42 @@
     * @param[out] reliable   percentage indicator of calibration status in (0%..100%)
     */
    bool PEReceiveOdoStatus(PECCore* core, double& base, double& scale, double& reliable);
+   /**
+    * Starts recording of all sent sensors data of the instance into native track file,
+    * sending of sensors data is not delayed by recording
+    * @return true if recording started
+    *
+    * @param[in] core       pointer to the position engine instance
+    * @param[in] fileName   name of the native track file, "<fileName>.part" is written during recording
+    */
+   bool PEStartRecording(PECCore* core, const char* fileName);
+   /**
+    * Stops recording and writes native track file, recording is stopped by PEStop() too
+    * @return true if recording was started and track file is written
+    *
+    * @param[in] core   pointer to the position engine instance
+    */
+   bool PEStopRecording(PECCore* core);
+   /**
+    * Receives status of recording since its start
+    * @return true if recording is started
+    *
+    * @param[in] core        pointer to the position engine instance
+    * @param[out] recorded   count of recorded sensors data
+    * @param[out] dropped    count of dropped sensors data because writing of the track file falls behind
+    * @param[out] written    count of sensors data written into journal of the track file
+    */
+   bool PEReceiveRecorderStatus(PECCore* core, uint64_t& recorded, uint64_t& dropped, uint64_t& written);
+   /**
+    * Receives counters of accepted and rejected sensors data by reason (range, interval, accuracy, validity),
+    * calibration steps and resets of uncompleted calibration steps since start of the instance
+    * @return true if counters are received
+    *
+    * @param[in] core         pointer to the position engine instance
+    * @param[out] odoStats    counters of odometer (reference: PESendSpeed, sensor: PESendOdo)
+    * @param[out] gyroStats   counters of gyroscope (reference: PESendHeading, sensor: PESendGyro)
+    */
+   bool PEReceiveStats(PECCore* core, PE::SSensorStats& odoStats, PE::SSensorStats& gyroStats);
 
 #ifdef __cplusplus
    }
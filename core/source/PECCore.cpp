@@ -11,15 +11,50 @@
  * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
  * See the License for more information.
  */
+#include <stdlib.h>
+#include <limits>
 #include "PECCore.h"
+#include "PECRecorder.h"
+
+/**
+ * Operation limits of the sensors of the engine
+ */
+static const double SPEED_MIN              = 0.0;
+static const double SPEED_MAX              = 343.0; //sound speed ~1235km/h
+static const double SPEED_ACCURACY_RATIO   = 2.0;
+static const double ODO_MIN                = 0.0;
+static const double ODO_MAX                = std::numeric_limits<uint32_t>::max();
+static const double HEADING_MIN            = 0.0;
+static const double HEADING_MAX            = 360.0;
+static const double HEADING_ACCURACY_RATIO = 2.0;
+static const double GYRO_MIN               = -static_cast<double>(std::numeric_limits<uint32_t>::max());
+static const double GYRO_MAX               = std::numeric_limits<uint32_t>::max();
 
 PECCore::PECCore()
+: m_Recorder(NULL)
+, m_Odometer(SPEED_MIN, SPEED_MAX, SPEED_ACCURACY_RATIO, ODO_MIN, ODO_MAX)
+, m_Gyroscope(HEADING_MIN, HEADING_MAX, HEADING_ACCURACY_RATIO, GYRO_MIN, GYRO_MAX)
 {
 }
 
 
 PECCore::~PECCore()
 {
+   //recording is stopped and its track file written
+   delete m_Recorder;
+}
+
+
+void* PECCore::operator new(size_t size) noexcept
+{
+   void* instance = NULL;
+   return ( 0 == posix_memalign(&instance, alignof(PECCore), size) ) ? instance : NULL;
+}
+
+
+void PECCore::operator delete(void* instance) noexcept
+{
+   free(instance);
 }
 
 
@@ -48,26 +83,57 @@ void PECCore::Calculate()
 
 void PECCore::SendCoordinates( const double& timestamp, const double& latitude, const double& longitude, const double& accuracy)
 {
+   if ( NULL != m_Recorder )
+   {
+      m_Recorder->Record(PE::STrackEvent(timestamp, PE::EVENT_POSITION, latitude, longitude, accuracy));
+   }
 }
 
 
 void PECCore::SendHeading( const double& timestamp, const double& heading, const double& accuracy)
 {
+   m_Gyroscope.AddHeading(timestamp, heading, accuracy);
+   if ( NULL != m_Recorder )
+   {
+      m_Recorder->Record(PE::STrackEvent(timestamp, PE::EVENT_HEADING, heading, accuracy));
+   }
 }
 
 
-void PECCore::SendSpeed( const double& timestamp, const double& speed, const double& accuracy/* maybe not needed */)
+void PECCore::SendSpeed( const double& timestamp, const double& speed, const double& accuracy)
 {
+   m_Odometer.AddSpeed(timestamp, speed, accuracy);
+   if ( NULL != m_Recorder )
+   {
+      m_Recorder->Record(PE::STrackEvent(timestamp, PE::EVENT_SPEED, speed, accuracy));
+   }
 }
 
 
 void PECCore::SendGyro( const double& timestamp, const double& gyro)
 {
+   SendGyro(timestamp, gyro, std::numeric_limits<double>::quiet_NaN());
+}
+
+
+void PECCore::SendGyro( const double& timestamp, const double& gyro, const double& )
+{
+   //temperature is ignored, native track file has no temperature column
+   m_Gyroscope.AddGyro(timestamp, gyro, true);
+   if ( NULL != m_Recorder )
+   {
+      m_Recorder->Record(PE::STrackEvent(timestamp, PE::EVENT_GYRO, gyro));
+   }
 }
 
 
 void PECCore::SendOdo( const double& timestamp, const double& odo)
 {
+   m_Odometer.AddTicks(timestamp, odo, true);
+   if ( NULL != m_Recorder )
+   {
+      m_Recorder->Record(PE::STrackEvent(timestamp, PE::EVENT_ODO, odo));
+   }
 }
 
 
@@ -93,3 +159,41 @@ bool PECCore::ReceiveOdoStatus( double& bias, double& scale, double& reliable)
 {
    return true;
 }
+
+
+bool PECCore::StartRecording( const std::string& fileName)
+{
+   //ring is allocated once, not on the sample path
+   if ( NULL == m_Recorder )
+   {
+      m_Recorder = new PE::CRecorder();
+   }
+   return m_Recorder->Start(fileName);
+}
+
+
+bool PECCore::StopRecording()
+{
+   return ( NULL != m_Recorder ) && m_Recorder->Stop();
+}
+
+
+bool PECCore::ReceiveRecorderStatus( uint64_t& recorded, uint64_t& dropped, uint64_t& written)
+{
+   if ( NULL == m_Recorder || false == m_Recorder->IsStarted() )
+   {
+      return false;
+   }
+   recorded = m_Recorder->GetRecordCount();
+   dropped = m_Recorder->GetDropCount();
+   written = m_Recorder->GetWriteCount();
+   return true;
+}
+
+
+bool PECCore::ReceiveStats( PE::SSensorStats& odoStats, PE::SSensorStats& gyroStats)
+{
+   odoStats = m_Odometer.Stats();
+   gyroStats = m_Gyroscope.Stats();
+   return true;
+}
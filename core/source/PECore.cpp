@@ -24,7 +24,12 @@ static std::string m_last_cfg;
 
 PECCore* PEStart(const char* cfg)
 {
-   PETInstanceList::iterator it = m_list.insert(new PECCore()).first;
+   PECCore* core = new PECCore();
+   if ( NULL == core )
+   {
+      return NULL;
+   }
+   PETInstanceList::iterator it = m_list.insert(core).first;
    (*it)->Start(std::string(cfg));
    return *it;
 }
@@ -116,6 +121,18 @@ bool PESendGyro(PECCore* core, const double& timestamp, const double& gyro)
 }
 
 
+bool PESendGyroEx(PECCore* core, const double& timestamp, const double& gyro, const double& temperature)
+{
+   PETInstanceList::iterator it = m_list.find(core);
+   if ( m_list.end() != it )
+   {
+      (*it)->SendGyro(timestamp,gyro,temperature);
+      return true;
+   }
+   return false;
+}
+
+
 bool PESendOdo(PECCore* core, const double& timestamp, const double& odo)
 {
    PETInstanceList::iterator it = m_list.find(core);
@@ -170,3 +187,47 @@ bool PEReceiveOdoStatus(PECCore* core, double& base, double& scale, double& reli
    }
    return false;
 }
+
+
+bool PEStartRecording(PECCore* core, const char* fileName)
+{
+   PETInstanceList::iterator it = m_list.find(core);
+   if ( m_list.end() != it && 0 != fileName )
+   {
+      return (*it)->StartRecording(std::string(fileName));
+   }
+   return false;
+}
+
+
+bool PEStopRecording(PECCore* core)
+{
+   PETInstanceList::iterator it = m_list.find(core);
+   if ( m_list.end() != it )
+   {
+      return (*it)->StopRecording();
+   }
+   return false;
+}
+
+
+bool PEReceiveRecorderStatus(PECCore* core, uint64_t& recorded, uint64_t& dropped, uint64_t& written)
+{
+   PETInstanceList::iterator it = m_list.find(core);
+   if ( m_list.end() != it )
+   {
+      return (*it)->ReceiveRecorderStatus(recorded, dropped, written);
+   }
+   return false;
+}
+
+
+bool PEReceiveStats(PECCore* core, PE::SSensorStats& odoStats, PE::SSensorStats& gyroStats)
+{
+   PETInstanceList::iterator it = m_list.find(core);
+   if ( m_list.end() != it )
+   {
+      return (*it)->ReceiveStats(odoStats, gyroStats);
+   }
+   return false;
+}
@@ -0,0 +1,284 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CEkfFusion_H__
+#define __PE_CEkfFusion_H__
+
+#include "PETypes.h"
+#include "PESPosition.h"
+#include "PESBasicSensor.h"
+#include "PECRingBuffer.h"
+#include "PECMatrix.h"
+#include "PECFusionSensor.h"
+
+class PECEkfFusionTest; //to get possibility for test class
+
+namespace PE
+{
+/**
+ * Extended Kalman filter fusion with the same interface like CFusionSensor.
+ *
+ * State is [north, east, heading, speed, angSpeed] with constant turn rate and velocity motion model.
+ * North and east are offsets in meter from the latest position, the filter is recentered after
+ * each step, so position is kept as latitude/longitude and linearisation is done around zero offset.
+ * Accuracies of all sensors are used as standard deviations, returned accuracies are square roots of
+ * diagonal of the covariance matrix (horizontal accuracy is mean of north and east variances).
+ *
+ * Sensor items are fused one by one in order of adding, items with the same timestamp are fused
+ * sequentially instead of merging. Heading, speed and angular velocity which are invalid on construction
+ * are returned invalid till first direct measurement.
+ */
+class CEkfFusion
+{
+
+friend class ::PECEkfFusionTest;
+
+public:
+   /**
+    * Dimension of the state vector
+    */
+   static const uint32_t STATE_SIZE = 5;
+   /**
+    * Indices of the state vector
+    */
+   enum TStateIndex
+   {
+      STATE_NORTH     = 0,   ///< offset to north from latest position in meter
+      STATE_EAST      = 1,   ///< offset to east from latest position in meter
+      STATE_HEADING   = 2,   ///< heading in degree
+      STATE_SPEED     = 3,   ///< linear velocity in meter/seconds
+      STATE_ANG_SPEED = 4    ///< angular velocity in degree/second, turning left("+")
+   };
+   typedef CMatrix<STATE_SIZE, STATE_SIZE> TCovariance;
+   /**
+    * Constructor
+    *
+    * @param timestamp    timestamp in seconds
+    * @param position     based position
+    * @param heading      heading of based position in degree (0 - Nord, 90 - East, 180 - South, 270 - West)
+    * @param angSpeed     angular velocity in degree/second turning left("+") - positive, turning right("-") - negative
+    * @param speed        linear velocity in meter/seconds
+    * @param capacity     maximal count of sensor items between DoFusion() calls,
+    *                     memory of the queue is allocated once by constructor
+    * @param policy       handling of new sensor item if queue is full
+    */
+   CEkfFusion(const double& timestamp, const SPosition& position, const SBasicSensor& heading, const SBasicSensor& angSpeed, const SBasicSensor& speed,
+              uint32_t capacity = CFusionSensor::DEFAULT_CAPACITY, CFusionSensor::TOverflowPolicy policy = CFusionSensor::OVERFLOW_FUSE);
+   /**
+    * Adds new position.
+    *
+    * @param timestamp    timestamp in seconds
+    * @param position     position information
+    */
+   void AddPosition(const double& timestamp, const SPosition& position);
+   /**
+    * Adds new heading.
+    *
+    * @param timestamp    timestamp in seconds
+    * @param heading      heading in degree (0 - Nord, 90 - East, 180 - South, 270 - West)
+    */
+   void AddHeading(const double& timestamp, const SBasicSensor& heading);
+   /**
+    * Adds new linear velocity
+    *
+    * @param timestamp    timestamp in seconds
+    * @param speed        linear velocity in meter/seconds
+    */
+   void AddSpeed(const double& timestamp, const SBasicSensor& speed);
+   /**
+    * Adds new angular velocity
+    *
+    * @param timestamp    timestamp in seconds
+    * @param angSpeed     angular velocity in degree/second turning left("+") - positive, turning right("-") - negative
+    */
+   void AddAngSpeed(const double& timestamp, const SBasicSensor& angSpeed);
+   /**
+    * Returns timestamp of latest fusioned position in seconds
+    */
+   const double& GetTimestamp() const;
+   /**
+    * Returns heading of latest fusioned position in degree
+    */
+   const SBasicSensor& GetHeading() const;
+   /**
+    * Returns latest fusioned position
+    */
+   const SPosition& GetPosition() const;
+   /**
+    * Returns latest fusioned speed
+    */
+   const SBasicSensor& GetSpeed() const;
+   /**
+    * Returns speed predicted to timestamp, invalid for timestamp older than latest fusion
+    *
+    * @param timestamp    timestamp of predicted speed in seconds
+    */
+   const SBasicSensor GetSpeed(const double& timestamp) const;
+   /**
+    * Returns latest fusioned angular velocity
+    */
+   const SBasicSensor& GetAngSpeed() const;
+   /**
+    * Returns angular velocity predicted to timestamp, invalid for timestamp older than latest fusion
+    *
+    * @param timestamp    timestamp of predicted angular velocity in seconds
+    */
+   const SBasicSensor GetAngSpeed(const double& timestamp) const;
+   /**
+    * Returns covariance matrix of the latest fusion
+    */
+   const TCovariance& GetCovariance() const;
+   /**
+    * Fuses all available sensors into current position
+    */
+   void DoFusion();
+   /**
+    * Returns count of sensor items which were fused or dropped because of full queue
+    */
+   uint32_t GetOverflowCount() const;
+
+   /**
+    * Standard deviation of linear acceleration noise in m/s^2
+    */
+   static const double SPEED_NOISE;
+   /**
+    * Standard deviation of angular acceleration noise in deg/s^2
+    */
+   static const double ANG_SPEED_NOISE;
+   /**
+    * Standard deviation of heading noise in deg/s^0.5 (model error of the turn)
+    */
+   static const double HEADING_NOISE;
+   /**
+    * Standard deviation of position noise in m/s^0.5 (model error of the chord)
+    */
+   static const double POSITION_NOISE;
+   /**
+    * Standard deviation used for invalid start values
+    */
+   static const double UNKNOWN_ACCURACY;
+
+private:
+   /**
+    * Type of sensor in the queue item
+    */
+   enum TSensor
+   {
+      SENSOR_POSITION  = 0,
+      SENSOR_HEADING   = 1,
+      SENSOR_SPEED     = 2,
+      SENSOR_ANG_SPEED = 3
+   };
+   /**
+    * One measurement waiting for fusion
+    */
+   struct SSensorItem
+   {
+      SSensorItem()
+         : timestamp(0)
+         , type(SENSOR_POSITION)
+      {}
+
+      SSensorItem(const double& ts, TSensor tp, const SPosition& pos, const SBasicSensor& sen)
+         : timestamp(ts)
+         , type(tp)
+         , position(pos)
+         , sensor(sen)
+      {}
+
+      double timestamp;
+      TSensor type;
+      SPosition position;
+      SBasicSensor sensor;
+   };
+
+   typedef CRingBuffer<SSensorItem> TSensorsList;
+   typedef CMatrix<STATE_SIZE, 1> TStateVector;
+
+   /**
+    * Appends item if its timestamp is not older than the last one
+    */
+   void Insert(const SSensorItem& item);
+   /**
+    * Predicts and updates state by one measurement
+    */
+   void DoOneItemFusion(const SSensorItem& item);
+   /**
+    * Moves state to timestamp by motion model
+    */
+   void Predict(const double& timestamp);
+   /**
+    * Updates state by measurement of linear function of the state
+    *
+    * @param observation   measurement matrix
+    * @param innovation    measurement minus measured part of the state
+    * @param noise         covariance of the measurement
+    */
+   template <uint32_t SIZE>
+   void Update(const CMatrix<SIZE, STATE_SIZE>& observation, const CMatrix<SIZE, 1>& innovation, const CMatrix<SIZE, SIZE>& noise);
+   /**
+    * Updates state by one measured value
+    *
+    * @param index        index of the measured state
+    * @param innovation   measurement minus state
+    * @param accuracy     accuracy of the measurement
+    */
+   void UpdateValue(uint32_t index, const double& innovation, const double& accuracy);
+   /**
+    * Updates state by position measurement
+    */
+   void UpdatePosition(const SPosition& position);
+   /**
+    * Sets state value by first measurement, covariance of the state is reset to the measurement
+    */
+   void InitValue(uint32_t index, const double& value, const double& accuracy);
+   /**
+    * Applies state correction and recenters position
+    */
+   void ApplyCorrection(const TStateVector& correction);
+   /**
+    * Copies state and covariance into outputs
+    */
+   void UpdateOutputs();
+
+   double m_Timestamp;
+   /**
+    * State, north and east offsets are always zero after recentering
+    */
+   TStateVector m_State;
+   SPosition m_Position;
+   SBasicSensor m_Heading;
+   SBasicSensor m_AngSpeed;
+   SBasicSensor m_Speed;
+   /**
+    * Covariance of [north, east, heading, speed, angSpeed]
+    */
+   TCovariance m_Covariance;
+   /**
+    * States which have been initialised or measured
+    */
+   bool m_PositionValid;
+   bool m_HeadingValid;
+   bool m_SpeedValid;
+   bool m_AngSpeedValid;
+   /**
+    * Sensor items waiting for fusion in order of adding
+    */
+   TSensorsList m_SensorsList;
+   CFusionSensor::TOverflowPolicy m_OverflowPolicy;
+   uint32_t m_OverflowCount;
+};
+
+
+} //namespace PE
+#endif //__PE_CEkfFusion_H__
@@ -17,6 +17,7 @@
 #include "PETypes.h"
 #include "PESPosition.h"
 #include "PESBasicSensor.h"
+#include "PECRingBuffer.h"
 
 class PECFusionSensorTest; //to get possibility for test class
 
@@ -34,6 +35,18 @@ class CFusionSensor
 friend class ::PECFusionSensorTest;
 
 public:
+   /**
+    * Handling of new sensor item if queue of sensor items is full
+    */
+   enum TOverflowPolicy
+   {
+      OVERFLOW_FUSE        = 0,   ///< the oldest item is fused immediately, result is the same like with unlimited queue
+      OVERFLOW_DROP_OLDEST = 1    ///< the oldest item is dropped without fusion
+   };
+   /**
+    * Default capacity of sensor items queue
+    */
+   static const uint32_t DEFAULT_CAPACITY = 256;
    /**
     * Constructor 
     *
@@ -42,8 +55,12 @@ public:
     * @param heading      heading of based position in degree (0 - Nord, 90 - East, 180 - South, 270 - West)
     * @param angSpeed     angular velocity in degree/second turning left("+") - positive, turning right("-") - negative
     * @param speed        linear velocity in meter/seconds
+    * @param capacity     maximal count of sensor items with different timestamps between DoFusion() calls,
+    *                     memory of the queue is allocated once by constructor
+    * @param policy       handling of new sensor item if queue is full
     */
-   CFusionSensor(const double& timestamp, const SPosition& position, const SBasicSensor& heading, const SBasicSensor& angSpeed, const SBasicSensor& speed);
+   CFusionSensor(const double& timestamp, const SPosition& position, const SBasicSensor& heading, const SBasicSensor& angSpeed, const SBasicSensor& speed,
+                 uint32_t capacity = DEFAULT_CAPACITY, TOverflowPolicy policy = OVERFLOW_FUSE);
    /**
     * Adds new position.
     *
@@ -124,6 +141,65 @@ public:
    double GetWholeDistance() const;
 
    double GetWholeRotation() const;
+   /**
+    * Returns count of sensor items which were fused or dropped because of full queue
+    */
+   uint32_t GetOverflowCount() const;
+   /**
+    * Source of current time in seconds, used for latency budget of incremental mode
+    */
+   typedef double (*TClock)();
+   /**
+    * Switches incremental mode on or off, queued sensor items are fused by switching.
+    *
+    * In incremental mode sensor item is fused as soon as its timestamp is final: item with newer
+    * timestamp is added or latency budget is spent. Sensors with timestamp of pending item are merged
+    * into it till then. Sensors with timestamp of already fused item are dropped and counted as late.
+    * DoFusion() fuses pending item immediately.
+    *
+    * @param incremental     true to fuse each sensor item without waiting for DoFusion()
+    * @param latencyBudget   maximal wait in seconds for sensors with the same timestamp,
+    *                        0 - no limit, pending item waits for newer timestamp or DoFusion()
+    * @param clock           source of current time, monotonic clock if not provided
+    */
+   void SetIncremental(bool incremental, const double& latencyBudget = 0.0, TClock clock = 0);
+   /**
+    * Returns true if incremental mode is on
+    */
+   bool IsIncremental() const;
+   /**
+    * Fuses pending sensor item of incremental mode if its latency budget is spent.
+    * Add*() calls do it too, so polling is needed only if sensors could stop. Does nothing without budget.
+    */
+   void Poll();
+   /**
+    * Returns count of sensors dropped in incremental mode because their timestamp was fused already
+    */
+   uint32_t GetLateCount() const;
+   /**
+    * Enables fusion of out of sequence sensors, e.g. delayed GNSS position.
+    *
+    * State before each fused sensor item is kept in ring of checkpoints together with the item.
+    * Sensor older than latest fused or queued item rewinds state to the checkpoint before its timestamp
+    * and fuses it together with all newer items again (queued items are fused first), so cost of one
+    * late sensor is bounded by depth of the history. Sensor older than the oldest checkpoint is dropped.
+    * Memory of the history is allocated by this call.
+    *
+    * @param depth   maximal count of checkpoints, 0 - out of sequence sensors are ignored
+    */
+   void SetHistory(uint32_t depth);
+   /**
+    * Returns count of out of sequence sensors which were fused by rewind
+    */
+   uint32_t GetRewindCount() const;
+   /**
+    * Returns count of sensor items fused again by all rewinds
+    */
+   uint32_t GetReplayCount() const;
+   /**
+    * Returns count of out of sequence sensors dropped because they are older than history
+    */
+   uint32_t GetTooOldCount() const;
 
 private:
    /**
@@ -131,6 +207,10 @@ private:
     */
    struct SSensorItem
    {
+      SSensorItem()
+         : timestamp(0)
+      {}
+
       SSensorItem(const double& ts, const SPosition& pos, const SBasicSensor& head, const SBasicSensor& sp, const SBasicSensor& asp)
          : timestamp(ts)
          , position (pos)
@@ -146,7 +226,29 @@ private:
       SBasicSensor angSpeed;
    };
 
-   typedef std::vector<SSensorItem> TSensorsList;
+   typedef CRingBuffer<SSensorItem> TSensorsList;
+
+   /**
+    * Fusion state before the fusion of sensor item
+    */
+   struct SCheckpoint
+   {
+      SCheckpoint()
+         : timestamp(0)
+      {}
+
+      double timestamp;
+      SPosition position;
+      SBasicSensor heading;
+      SBasicSensor angSpeed;
+      SBasicSensor speed;
+      /**
+       * Sensor item fused after the checkpoint
+       */
+      SSensorItem item;
+   };
+
+   typedef CRingBuffer<SCheckpoint> TCheckpoints;
 
    /**
     * The timestamp of the latest position in seconds
@@ -173,7 +275,83 @@ private:
 
    double m_Rotation;
 
+   /**
+    * Sensor items waiting for fusion in order of timestamps
+    */
    TSensorsList m_SensorsList;
+   /**
+    * Handling of new sensor item if queue is full
+    */
+   TOverflowPolicy m_OverflowPolicy;
+   /**
+    * Count of sensor items which were fused or dropped because of full queue
+    */
+   uint32_t m_OverflowCount;
+   /**
+    * Incremental mode is on
+    */
+   bool m_Incremental;
+   /**
+    * Maximal wait in seconds for sensors with the same timestamp in incremental mode, 0 - no limit
+    */
+   double m_LatencyBudget;
+   /**
+    * Source of current time
+    */
+   TClock m_Clock;
+   /**
+    * Clock time of adding of the pending sensor item in incremental mode
+    */
+   double m_PendingSince;
+   /**
+    * Count of sensors dropped in incremental mode because their timestamp was fused already
+    */
+   uint32_t m_LateCount;
+   /**
+    * Maximal count of checkpoints, 0 if out of sequence sensors are ignored
+    */
+   uint32_t m_HistoryDepth;
+   /**
+    * Checkpoints of latest fused sensor items in order of timestamps
+    */
+   TCheckpoints m_History;
+   /**
+    * Sensor items to fuse again by rewind, allocated together with history
+    */
+   TSensorsList m_Replay;
+   uint32_t m_RewindCount;
+   uint32_t m_ReplayCount;
+   uint32_t m_TooOldCount;
+   /**
+    * Inserts sensor item: new timestamp is added at the end of the queue,
+    * valid sensors of the same timestamp like the last item are merged into it, older timestamps are ignored
+    *
+    * @param item   sensor item, invalid sensors of the item are ignored
+    */
+   void Insert(const SSensorItem& item);
+   /**
+    * Inserts sensor item in incremental mode: pending item is fused if item has newer timestamp,
+    * item becomes pending or is merged into pending one, then latency budget is checked
+    *
+    * @param item   sensor item, invalid sensors of the item are ignored
+    */
+   void InsertIncremental(const SSensorItem& item);
+   /**
+    * Merges valid sensors of item into target item
+    */
+   static void MergeItem(SSensorItem& target, const SSensorItem& item);
+   /**
+    * Returns true if item is older than latest fused or queued item and history is enabled
+    */
+   bool IsOutOfSequence(const SSensorItem& item) const;
+   /**
+    * Restores checkpoint before timestamp of the item and fuses item and all newer items again
+    */
+   void Rewind(const SSensorItem& item);
+   /**
+    * Returns monotonic time in seconds
+    */
+   static double GetMonotonicTime();
    /**
     * Fused position based on one sensor item information
     */
@@ -0,0 +1,345 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CParticleFusion_H__
+#define __PE_CParticleFusion_H__
+
+#include <vector>
+#include <functional>
+#include "PETypes.h"
+#include "PESPosition.h"
+#include "PESBasicSensor.h"
+#include "PECRingBuffer.h"
+
+class PECParticleFusionTest; //to get possibility for test class
+
+namespace PE
+{
+
+class CThreadPool;
+
+/**
+ * Particle filter fusion with the same interface like CFusionSensor.
+ *
+ * Particle is position as north/east offset in meter from reference position and heading as unit vector,
+ * all particles are stored as parallel arrays. Speed and angular velocity are merged like by CFusionSensor
+ * and move particles by the chord model of FUSION::PredictPosition() with noise per particle.
+ * Loops run over blocks of BLOCK_SIZE particles without branches and trigonometric calls, so they are
+ * vectorized by compiler: common turn is rotated by precalculated sine and cosine, turn noise of particle
+ * by polynomial. Noise is taken from a precalculated table of normal values at random offset.
+ *
+ * Likelihood of position and heading is Student-t with 3 degrees of freedom instead of Gaussian:
+ * outliers like GNSS multipath reduce weight of particles only polynomially, so second hypothesis
+ * survives till next measurements decide between them. Particles are resampled systematically
+ * if effective count drops below half. Weighting, resampling and means are done by chunks
+ * of particles in parallel on CThreadPool if more than one thread is requested.
+ *
+ * Sensor items are fused one by one in order of adding, outputs are updated by DoFusion().
+ */
+class CParticleFusion
+{
+
+friend class ::PECParticleFusionTest;
+
+public:
+   /**
+    * Count of particles processed by one loop, particle count is rounded up to it
+    */
+   static const uint32_t BLOCK_SIZE = 64;
+   /**
+    * Default count of particles
+    */
+   static const uint32_t DEFAULT_PARTICLE_COUNT = 1024;
+   /**
+    * Maximal count of sensor items between DoFusion() calls, the oldest item is fused on overflow
+    */
+   static const uint32_t CAPACITY = 256;
+   /**
+    * Standard deviation of position noise in m/s^0.5
+    */
+   static const double POSITION_NOISE;
+   /**
+    * Standard deviation of heading noise in deg/s^0.5
+    */
+   static const double HEADING_NOISE;
+   /**
+    * Standard deviation of angular velocity if it is unknown in deg/s
+    */
+   static const double UNKNOWN_ANG_SPEED_NOISE;
+   /**
+    * Particles are resampled if effective count is below this part of particle count
+    */
+   static const double RESAMPLE_THRESHOLD;
+   /**
+    * Reference position is moved to mean of particles if it is farther in meter
+    */
+   static const double RECENTER_DISTANCE;
+   /**
+    * Constructor
+    *
+    * @param timestamp       timestamp in seconds
+    * @param position        based position, particles are spread by its accuracy
+    * @param heading         heading of based position in degree (0 - Nord, 90 - East, 180 - South, 270 - West),
+    *                        particles are spread over the circle if it is invalid
+    * @param angSpeed        angular velocity in degree/second turning left("+") - positive, turning right("-") - negative
+    * @param speed           linear velocity in meter/seconds
+    * @param particleCount   count of particles, rounded up to BLOCK_SIZE
+    * @param threadCount     count of threads for particles, 0 - count of hardware threads, 1 - without thread pool
+    */
+   CParticleFusion(const double& timestamp, const SPosition& position, const SBasicSensor& heading, const SBasicSensor& angSpeed, const SBasicSensor& speed,
+                   uint32_t particleCount = DEFAULT_PARTICLE_COUNT, uint32_t threadCount = 1);
+   /**
+    * Destructor stops thread pool
+    */
+   ~CParticleFusion();
+   /**
+    * Adds new position.
+    *
+    * @param timestamp    timestamp in seconds
+    * @param position     position information
+    */
+   void AddPosition(const double& timestamp, const SPosition& position);
+   /**
+    * Adds new heading.
+    *
+    * @param timestamp    timestamp in seconds
+    * @param heading      heading in degree (0 - Nord, 90 - East, 180 - South, 270 - West)
+    */
+   void AddHeading(const double& timestamp, const SBasicSensor& heading);
+   /**
+    * Adds new linear velocity
+    *
+    * @param timestamp    timestamp in seconds
+    * @param speed        linear velocity in meter/seconds
+    */
+   void AddSpeed(const double& timestamp, const SBasicSensor& speed);
+   /**
+    * Adds new angular velocity
+    *
+    * @param timestamp    timestamp in seconds
+    * @param angSpeed     angular velocity in degree/second turning left("+") - positive, turning right("-") - negative
+    */
+   void AddAngSpeed(const double& timestamp, const SBasicSensor& angSpeed);
+   /**
+    * Returns timestamp of latest fusioned position in seconds
+    */
+   const double& GetTimestamp() const;
+   /**
+    * Returns heading of latest fusioned position in degree, mean direction of particles
+    */
+   const SBasicSensor& GetHeading() const;
+   /**
+    * Returns latest fusioned position, weighted mean of particles
+    */
+   const SPosition& GetPosition() const;
+   /**
+    * Returns latest fusioned speed
+    */
+   const SBasicSensor& GetSpeed() const;
+   /**
+    * Returns speed predicted to timestamp, invalid for timestamp older than latest fusion
+    *
+    * @param timestamp    timestamp of predicted speed in seconds
+    */
+   const SBasicSensor GetSpeed(const double& timestamp) const;
+   /**
+    * Returns latest fusioned angular velocity
+    */
+   const SBasicSensor& GetAngSpeed() const;
+   /**
+    * Returns angular velocity predicted to timestamp, invalid for timestamp older than latest fusion
+    *
+    * @param timestamp    timestamp of predicted angular velocity in seconds
+    */
+   const SBasicSensor GetAngSpeed(const double& timestamp) const;
+   /**
+    * Fuses all available sensors into particles and updates outputs
+    */
+   void DoFusion();
+   /**
+    * Returns count of particles
+    */
+   uint32_t GetParticleCount() const;
+   /**
+    * Returns count of resamplings
+    */
+   uint32_t GetResampleCount() const;
+   /**
+    * Returns count of sensor items which were fused because of full queue
+    */
+   uint32_t GetOverflowCount() const;
+
+private:
+   CParticleFusion(const CParticleFusion&);
+   CParticleFusion& operator=(const CParticleFusion&);
+
+   /**
+    * Type of sensor in the queue item
+    */
+   enum TSensor
+   {
+      SENSOR_POSITION  = 0,
+      SENSOR_HEADING   = 1,
+      SENSOR_SPEED     = 2,
+      SENSOR_ANG_SPEED = 3
+   };
+   /**
+    * One measurement waiting for fusion
+    */
+   struct SSensorItem
+   {
+      SSensorItem()
+         : timestamp(0)
+         , type(SENSOR_POSITION)
+      {}
+
+      SSensorItem(const double& ts, TSensor tp, const SPosition& pos, const SBasicSensor& sen)
+         : timestamp(ts)
+         , type(tp)
+         , position(pos)
+         , sensor(sen)
+      {}
+
+      double timestamp;
+      TSensor type;
+      SPosition position;
+      SBasicSensor sensor;
+   };
+   /**
+    * Parameters of one prediction common for all particles
+    */
+   struct SMotion
+   {
+      double CosHalfTurn;     ///< cosine of half of the common turn
+      double SinHalfTurn;     ///< sine of half of the common turn
+      double HalfTurnNoise;   ///< deviation of half of the turn in radian
+      double Distance;        ///< common distance in meter
+      double DistanceNoise;   ///< deviation of distance in meter
+      double PositionNoise;   ///< deviation of north and east in meter
+      const double* Noise[4]; ///< normal noise of turn, distance, north and east
+   };
+   /**
+    * Sums of one chunk of particles, padded to own cache lines
+    */
+   struct SSums
+   {
+      double Weight;
+      double WeightSquare;
+      double North;
+      double East;
+      double NorthSquare;
+      double EastSquare;
+      double DirNorth;
+      double DirEast;
+      double Padding[8];
+   };
+   typedef CRingBuffer<SSensorItem> TSensorsList;
+   typedef std::function<void(uint32_t chunk, uint32_t first, uint32_t last)> TChunkTask;
+
+   /**
+    * Appends item if its timestamp is not older than the last one
+    */
+   void Insert(const SSensorItem& item);
+   /**
+    * Predicts particles to timestamp of item and weights them by the measurement
+    */
+   void DoOneItemFusion(const SSensorItem& item);
+   /**
+    * Moves particles by speed and angular velocity
+    */
+   void Predict(const double& deltaTimestamp);
+   /**
+    * Weights particles by position measurement, the first valid position spreads particles around it
+    */
+   void UpdatePosition(const SPosition& position);
+   /**
+    * Weights particles by heading measurement
+    */
+   void UpdateHeading(const SBasicSensor& heading);
+   /**
+    * Normalizes weights or resamples particles by the weight sums of chunks
+    */
+   void Normalize();
+   /**
+    * Systematic resampling, chunks write disjoint ranges of the new particles
+    */
+   void Resample(const double& totalWeight);
+   /**
+    * Calculates weighted means into outputs and moves reference position if needed
+    */
+   void UpdateOutputs();
+   /**
+    * Runs task for all chunks of particles, in parallel if thread pool exists
+    */
+   void ForEachChunk(const TChunkTask& task);
+   /**
+    * Spreads particles around reference position, weights are equal
+    */
+   void SpreadPositions(const double& accuracy);
+   /**
+    * Returns pointer to noise table at random offset, particle count of values is available
+    */
+   const double* GetNoise();
+   /**
+    * Returns uniform random value [0, 1)
+    */
+   double GetRandom();
+   /**
+    * Block operations, count of particles is BLOCK_SIZE
+    */
+   static void PredictBlock(double* __restrict north, double* __restrict east, double* __restrict dirNorth, double* __restrict dirEast,
+                            const SMotion& motion, uint32_t offset);
+   static void WeightBlock(double* __restrict weight, const double* __restrict north, const double* __restrict east,
+                           const double& north0, const double& east0, const double& scale, SSums& sums);
+
+   double m_Timestamp;
+   SPosition m_Position;
+   SBasicSensor m_Heading;
+   SBasicSensor m_AngSpeed;
+   SBasicSensor m_Speed;
+   /**
+    * Position of zero north/east offset
+    */
+   SPosition m_Reference;
+   bool m_PositionValid;
+   uint32_t m_Count;
+   /**
+    * Particles, the second set is target of resampling
+    */
+   std::vector<double> m_North;
+   std::vector<double> m_East;
+   std::vector<double> m_DirNorth;
+   std::vector<double> m_DirEast;
+   std::vector<double> m_Weight;
+   std::vector<double> m_NextNorth;
+   std::vector<double> m_NextEast;
+   std::vector<double> m_NextDirNorth;
+   std::vector<double> m_NextDirEast;
+   /**
+    * Standard normal values, two times more than particles
+    */
+   std::vector<double> m_Noise;
+   uint32_t m_Seed;
+   /**
+    * Sums of chunks, one chunk per thread
+    */
+   std::vector<SSums> m_Sums;
+   CThreadPool* m_Pool;
+   TSensorsList m_SensorsList;
+   uint32_t m_ResampleCount;
+   uint32_t m_OverflowCount;
+};
+
+
+} //namespace PE
+#endif //__PE_CParticleFusion_H__
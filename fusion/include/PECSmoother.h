@@ -0,0 +1,192 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CSmoother_H__
+#define __PE_CSmoother_H__
+
+#include <vector>
+#include "PETypes.h"
+#include "PESPosition.h"
+#include "PESBasicSensor.h"
+
+class PECSmootherTest; //to get possibility for test class
+
+namespace PE
+{
+/**
+ * Offline smoother of whole track, Rauch-Tung-Striebel style.
+ *
+ * Forward pass is the same fusion step like CFusionSensor::DoOneItemFusion() built on FUSION::Predict*()
+ * and FUSION::Merge*(), predicted and fused state of each step is stored. Backward pass corrects each fused
+ * state by difference between smoothed and predicted next state, gain of each value is ratio of
+ * fused and predicted variances (accuracies are used as standard deviations).
+ *
+ * Forward pass is causal and runs sequentially. Track is split at anchors (steps with accurate position)
+ * where smoothed state is close to fused one, so backward passes of segments are independent and run
+ * in parallel on CThreadPool. Backward pass of each segment starts with fused state of its last step.
+ */
+class CSmoother
+{
+
+friend class ::PECSmootherTest;
+
+public:
+   /**
+    * State of one step
+    */
+   struct SState
+   {
+      double Timestamp;
+      SPosition Position;
+      SBasicSensor Heading;
+      SBasicSensor AngSpeed;
+      SBasicSensor Speed;
+   };
+   /**
+    * Default maximal horizontal accuracy of anchor position in meter
+    */
+   static const double DEFAULT_ANCHOR_ACCURACY;
+   /**
+    * Default minimal count of steps of one segment
+    */
+   static const uint32_t DEFAULT_SEGMENT_LENGTH = 1024;
+   /**
+    * Constructor
+    *
+    * @param timestamp    timestamp of start state in seconds
+    * @param position     start position
+    * @param heading      start heading in degree (0 - Nord, 90 - East, 180 - South, 270 - West)
+    * @param angSpeed     start angular velocity in degree/second turning left("+") - positive, turning right("-") - negative
+    * @param speed        start linear velocity in meter/seconds
+    */
+   CSmoother(const double& timestamp, const SPosition& position, const SBasicSensor& heading, const SBasicSensor& angSpeed, const SBasicSensor& speed);
+   /**
+    * Adds new position, sensors have to be added in order of timestamps.
+    *
+    * @param timestamp    timestamp in seconds
+    * @param position     position information
+    */
+   void AddPosition(const double& timestamp, const SPosition& position);
+   /**
+    * Adds new heading.
+    *
+    * @param timestamp    timestamp in seconds
+    * @param heading      heading in degree
+    */
+   void AddHeading(const double& timestamp, const SBasicSensor& heading);
+   /**
+    * Adds new linear velocity
+    *
+    * @param timestamp    timestamp in seconds
+    * @param speed        linear velocity in meter/seconds
+    */
+   void AddSpeed(const double& timestamp, const SBasicSensor& speed);
+   /**
+    * Adds new angular velocity
+    *
+    * @param timestamp    timestamp in seconds
+    * @param angSpeed     angular velocity in degree/second
+    */
+   void AddAngSpeed(const double& timestamp, const SBasicSensor& angSpeed);
+   /**
+    * Runs forward and backward passes over all added sensors
+    * @return   count of segments smoothed in parallel
+    *
+    * @param threadCount       count of worker threads, 0 - count of hardware threads, 1 - without thread pool
+    * @param anchorAccuracy    maximal horizontal accuracy of position which could split the track
+    * @param segmentLength     minimal count of steps of one segment
+    */
+   uint32_t Smooth(uint32_t threadCount = 0, const double& anchorAccuracy = DEFAULT_ANCHOR_ACCURACY, uint32_t segmentLength = DEFAULT_SEGMENT_LENGTH);
+   /**
+    * Returns count of steps, one step per timestamp of added sensors
+    */
+   uint32_t GetSize() const;
+   /**
+    * Returns causal fused state of step like CFusionSensor provides it
+    */
+   const SState& GetFused(uint32_t index) const;
+   /**
+    * Returns smoothed state of step, valid after Smooth()
+    */
+   const SState& GetSmoothed(uint32_t index) const;
+
+private:
+   /**
+    * All sensors of one timestamp
+    */
+   struct SSensorItem
+   {
+      double Timestamp;
+      SPosition Position;
+      SBasicSensor Heading;
+      SBasicSensor Speed;
+      SBasicSensor AngSpeed;
+   };
+   /**
+    * Appends sensor item or merges it into the last item of the same timestamp, older items are ignored
+    */
+   void Insert(const SSensorItem& item);
+   /**
+    * Fuses sensor item into state like CFusionSensor::DoOneItemFusion()
+    *
+    * @param state       fused state of previous step, fused state of this step on return
+    * @param predicted   state predicted to timestamp of item before merging with sensors
+    * @param item        sensors of the step
+    */
+   static void ForwardStep(SState& state, SState& predicted, const SSensorItem& item);
+   /**
+    * Smoothes steps [first, last), smoothed state of step last is used as it is
+    */
+   void BackwardPass(uint32_t first, uint32_t last);
+   /**
+    * Returns last steps of segments: anchors and last step of the track, anchors keep fused state
+    */
+   std::vector<uint32_t> GetSegments(const double& anchorAccuracy, uint32_t segmentLength) const;
+   /**
+    * Returns fused value corrected by difference of smoothed and predicted next values
+    */
+   static SBasicSensor SmoothSensor(const SBasicSensor& fused, const SBasicSensor& predicted, const SBasicSensor& next);
+   /**
+    * Returns smoother gain, ratio of fused and predicted variances limited by 1
+    */
+   static double GetGain(const double& fusedAccuracy, const double& predictedAccuracy);
+   /**
+    * Returns accuracy of smoothed value, not worse than fused one
+    */
+   static double GetAccuracy(const double& gain, const double& fusedAccuracy, const double& predictedAccuracy, const double& nextAccuracy);
+
+   /**
+    * Start state
+    */
+   SState m_Start;
+   /**
+    * Sensors in order of timestamps
+    */
+   std::vector<SSensorItem> m_Items;
+   /**
+    * State predicted to each step from previous fused state
+    */
+   std::vector<SState> m_Predicted;
+   /**
+    * Fused state of each step
+    */
+   std::vector<SState> m_Fused;
+   /**
+    * Smoothed state of each step
+    */
+   std::vector<SState> m_Smoothed;
+};
+
+
+} //namespace PE
+#endif //__PE_CSmoother_H__
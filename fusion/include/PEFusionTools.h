@@ -17,6 +17,7 @@
 #include "PETypes.h"
 #include "PESPosition.h"
 #include "PESBasicSensor.h"
+#include "PETools.h"
 
 namespace PE {
 namespace FUSION {
@@ -59,6 +60,19 @@ SBasicSensor PredictHeading(const double& deltaTimestamp, const SBasicSensor& he
  */
 SBasicSensor PredictHeading(const double& deltaTimestamp, const SPosition& positionFirst, const SPosition& positionLast, const SBasicSensor& heading);
 
+/**
+ * Predicts new heading based on knowed old and new positions and geodesic between them.
+ * Callers which need distance or heading between positions too calculate the geodesic once.
+ *
+ * @param deltaTimestamp      delta timestamp between old and new positions
+ * @param positionFirst       old position
+ * @param positionLast        new position
+ * @param geodesic            distance and heading from old to new position (TOOLS::ToGeodesic())
+ * @param heading             previouse heading
+ * @return                    predicted heading
+ */
+SBasicSensor PredictHeading(const double& deltaTimestamp, const SPosition& positionFirst, const SPosition& positionLast, const TOOLS::SGeodesic& geodesic, const SBasicSensor& heading);
+
 /**
  * Predicts new position based on knowed start heading, angular velocity, linear speed, delta time and original position.
  *
@@ -82,6 +96,18 @@ SPosition PredictPosition(const double& deltaTimestamp, const SBasicSensor& head
  */
 SBasicSensor PredictSpeed(const double& deltaTimestamp, const SPosition& positionFirst, const SPosition& positionLast, const SBasicSensor& angSpeed);
 
+/**
+ * Predicts new linear speed based on knowed delta time, angular velocity, old and new positions and geodesic between them.
+ *
+ * @param deltaTimestamp   delta timestamp between old and new positions
+ * @param positionFirst    old position
+ * @param positionLast     new position
+ * @param geodesic         distance and heading from old to new position (TOOLS::ToGeodesic())
+ * @param angSpeed         angular velocity
+ * @return                 predicted linear speed
+ */
+SBasicSensor PredictSpeed(const double& deltaTimestamp, const SPosition& positionFirst, const SPosition& positionLast, const TOOLS::SGeodesic& geodesic, const SBasicSensor& angSpeed);
+
 /**
  * Predicts new angular velocity based on knowed delta time, old and new headings.
  *
@@ -0,0 +1,397 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <math.h>
+#include "PECEkfFusion.h"
+#include "PETools.h"
+
+
+using namespace PE;
+
+
+const uint32_t PE::CEkfFusion::STATE_SIZE;
+const double PE::CEkfFusion::SPEED_NOISE      = 0.5;
+const double PE::CEkfFusion::ANG_SPEED_NOISE  = 1.0;
+const double PE::CEkfFusion::HEADING_NOISE    = 0.1;
+const double PE::CEkfFusion::POSITION_NOISE   = 0.1;
+const double PE::CEkfFusion::UNKNOWN_ACCURACY = 1000.0;
+
+
+PE::CEkfFusion::CEkfFusion(const double& timestamp, const SPosition& position, const SBasicSensor& heading, const SBasicSensor& angSpeed, const SBasicSensor& speed,
+                           uint32_t capacity, CFusionSensor::TOverflowPolicy policy)
+: m_Timestamp(timestamp)
+, m_Position(position)
+, m_PositionValid(position.IsValid())
+, m_HeadingValid(heading.IsValid())
+, m_SpeedValid(speed.IsValid())
+, m_AngSpeedValid(angSpeed.IsValid())
+, m_SensorsList(capacity)
+, m_OverflowPolicy(policy)
+, m_OverflowCount(0)
+{
+   m_Covariance(STATE_NORTH, STATE_NORTH)         = m_PositionValid ? position.HorizontalAcc * position.HorizontalAcc : UNKNOWN_ACCURACY * UNKNOWN_ACCURACY;
+   m_Covariance(STATE_EAST, STATE_EAST)           = m_Covariance(STATE_NORTH, STATE_NORTH);
+   m_State(STATE_HEADING, 0)                      = m_HeadingValid ? heading.Value : 0.0;
+   m_Covariance(STATE_HEADING, STATE_HEADING)     = m_HeadingValid ? heading.Accuracy * heading.Accuracy : UNKNOWN_ACCURACY * UNKNOWN_ACCURACY;
+   m_State(STATE_SPEED, 0)                        = m_SpeedValid ? speed.Value : 0.0;
+   m_Covariance(STATE_SPEED, STATE_SPEED)         = m_SpeedValid ? speed.Accuracy * speed.Accuracy : UNKNOWN_ACCURACY * UNKNOWN_ACCURACY;
+   m_State(STATE_ANG_SPEED, 0)                    = m_AngSpeedValid ? angSpeed.Value : 0.0;
+   m_Covariance(STATE_ANG_SPEED, STATE_ANG_SPEED) = m_AngSpeedValid ? angSpeed.Accuracy * angSpeed.Accuracy : UNKNOWN_ACCURACY * UNKNOWN_ACCURACY;
+   UpdateOutputs();
+}
+
+
+void PE::CEkfFusion::AddPosition(const double& timestamp, const SPosition& position)
+{
+   if ( position.IsValid() )
+   {
+      Insert(SSensorItem(timestamp, SENSOR_POSITION, position, SBasicSensor()));
+   }
+}
+
+
+void PE::CEkfFusion::AddHeading(const double& timestamp, const SBasicSensor& heading)
+{
+   if ( heading.IsValid() )
+   {
+      Insert(SSensorItem(timestamp, SENSOR_HEADING, SPosition(), heading));
+   }
+}
+
+
+void PE::CEkfFusion::AddSpeed(const double& timestamp, const SBasicSensor& speed)
+{
+   if ( speed.IsValid() )
+   {
+      Insert(SSensorItem(timestamp, SENSOR_SPEED, SPosition(), speed));
+   }
+}
+
+
+void PE::CEkfFusion::AddAngSpeed(const double& timestamp, const SBasicSensor& angSpeed)
+{
+   if ( angSpeed.IsValid() )
+   {
+      Insert(SSensorItem(timestamp, SENSOR_ANG_SPEED, SPosition(), angSpeed));
+   }
+}
+
+
+void PE::CEkfFusion::Insert(const SSensorItem& item)
+{
+   if ( m_SensorsList.IsEmpty() || item.timestamp >= m_SensorsList.Back().timestamp )
+   {
+      if ( m_SensorsList.IsFull() )
+      {
+         if ( CFusionSensor::OVERFLOW_FUSE == m_OverflowPolicy )
+         {
+            DoOneItemFusion(m_SensorsList.Front());
+         }
+         m_SensorsList.PopFront();
+         ++m_OverflowCount;
+      }
+      m_SensorsList.PushBack(item);
+   }
+}
+
+
+const double& PE::CEkfFusion::GetTimestamp() const
+{
+   return m_Timestamp;
+}
+
+
+const SBasicSensor& PE::CEkfFusion::GetHeading() const
+{
+   return m_Heading;
+}
+
+
+const SPosition& PE::CEkfFusion::GetPosition() const
+{
+   return m_Position;
+}
+
+
+const SBasicSensor& PE::CEkfFusion::GetSpeed() const
+{
+   return m_Speed;
+}
+
+
+const SBasicSensor PE::CEkfFusion::GetSpeed(const double& timestamp) const
+{
+   if ( m_Timestamp > timestamp || false == m_SpeedValid )
+   {
+      return SBasicSensor();
+   }
+   const double variance = m_Covariance(STATE_SPEED, STATE_SPEED) + SPEED_NOISE * SPEED_NOISE * ( timestamp - m_Timestamp );
+   return SBasicSensor(m_State(STATE_SPEED, 0), sqrt(variance));
+}
+
+
+const SBasicSensor& PE::CEkfFusion::GetAngSpeed() const
+{
+   return m_AngSpeed;
+}
+
+
+const SBasicSensor PE::CEkfFusion::GetAngSpeed(const double& timestamp) const
+{
+   if ( m_Timestamp > timestamp || false == m_AngSpeedValid )
+   {
+      return SBasicSensor();
+   }
+   const double variance = m_Covariance(STATE_ANG_SPEED, STATE_ANG_SPEED) + ANG_SPEED_NOISE * ANG_SPEED_NOISE * ( timestamp - m_Timestamp );
+   return SBasicSensor(m_State(STATE_ANG_SPEED, 0), sqrt(variance));
+}
+
+
+const CEkfFusion::TCovariance& PE::CEkfFusion::GetCovariance() const
+{
+   return m_Covariance;
+}
+
+
+void PE::CEkfFusion::DoFusion()
+{
+   for ( uint32_t i = 0; i < m_SensorsList.GetSize(); ++i )
+   {
+      DoOneItemFusion(m_SensorsList[i]);
+   }
+   m_SensorsList.Clean();
+}
+
+
+uint32_t PE::CEkfFusion::GetOverflowCount() const
+{
+   return m_OverflowCount;
+}
+
+
+void PE::CEkfFusion::DoOneItemFusion(const SSensorItem& item)
+{
+   if ( m_Timestamp <= item.timestamp )
+   {
+      Predict(item.timestamp);
+      switch ( item.type )
+      {
+         case SENSOR_POSITION:
+            UpdatePosition(item.position);
+            break;
+         case SENSOR_HEADING:
+            if ( m_HeadingValid )
+            {
+               UpdateValue(STATE_HEADING, TOOLS::ToAngle(item.sensor.Value, m_State(STATE_HEADING, 0)), item.sensor.Accuracy);
+            }
+            else
+            {
+               InitValue(STATE_HEADING, item.sensor.Value, item.sensor.Accuracy);
+               m_HeadingValid = true;
+            }
+            break;
+         case SENSOR_SPEED:
+            if ( m_SpeedValid )
+            {
+               UpdateValue(STATE_SPEED, item.sensor.Value - m_State(STATE_SPEED, 0), item.sensor.Accuracy);
+            }
+            else
+            {
+               InitValue(STATE_SPEED, item.sensor.Value, item.sensor.Accuracy);
+               m_SpeedValid = true;
+            }
+            break;
+         case SENSOR_ANG_SPEED:
+            if ( m_AngSpeedValid )
+            {
+               UpdateValue(STATE_ANG_SPEED, item.sensor.Value - m_State(STATE_ANG_SPEED, 0), item.sensor.Accuracy);
+            }
+            else
+            {
+               InitValue(STATE_ANG_SPEED, item.sensor.Value, item.sensor.Accuracy);
+               m_AngSpeedValid = true;
+            }
+            break;
+      }
+      UpdateOutputs();
+   }
+}
+
+
+void PE::CEkfFusion::Predict(const double& timestamp)
+{
+   const double deltaTimestamp = timestamp - m_Timestamp;
+   if ( 0 < deltaTimestamp )
+   {
+      //invalid states are not used by the model, so they stay uncorrelated with valid ones
+      const double speed    = m_SpeedValid ? m_State(STATE_SPEED, 0) : 0.0;
+      const double angSpeed = m_AngSpeedValid ? m_State(STATE_ANG_SPEED, 0) : 0.0;
+      const double heading  = m_State(STATE_HEADING, 0);
+
+      //movement along the chord of the arch like FUSION::PredictPosition()
+      const double halfTurn     = angSpeed / 2 * deltaTimestamp;
+      const double omega        = TOOLS::ToRadians(halfTurn);
+      const double sinc         = ( 0 != omega ) ? sin(omega) / omega : 1.0;
+      const double sincDerivate = ( 0 != omega ) ? ( omega * cos(omega) - sin(omega) ) / ( omega * omega ) : 0.0;
+      const double hordaHeading = TOOLS::ToHeading(heading, halfTurn);
+      const double horda        = speed * deltaTimestamp * sinc;
+      const double cosHeading   = cos(TOOLS::ToRadians(hordaHeading));
+      const double sinHeading   = sin(TOOLS::ToRadians(hordaHeading));
+      const double toRadians    = TOOLS::ToRadians(1.0);
+
+      TCovariance jacobian = TCovariance::Identity();
+      if ( m_PositionValid && m_HeadingValid )
+      {
+         jacobian(STATE_NORTH, STATE_HEADING) = -horda * sinHeading * toRadians;
+         jacobian(STATE_EAST,  STATE_HEADING) =  horda * cosHeading * toRadians;
+         if ( m_SpeedValid )
+         {
+            jacobian(STATE_NORTH, STATE_SPEED) = deltaTimestamp * sinc * cosHeading;
+            jacobian(STATE_EAST,  STATE_SPEED) = deltaTimestamp * sinc * sinHeading;
+         }
+         if ( m_AngSpeedValid )
+         {
+            const double hordaByAngSpeed = speed * deltaTimestamp * sincDerivate * toRadians * deltaTimestamp / 2;
+            const double turnByAngSpeed  = horda * toRadians * deltaTimestamp / 2;
+            jacobian(STATE_NORTH, STATE_ANG_SPEED) = hordaByAngSpeed * cosHeading + turnByAngSpeed * sinHeading;
+            jacobian(STATE_EAST,  STATE_ANG_SPEED) = hordaByAngSpeed * sinHeading - turnByAngSpeed * cosHeading;
+         }
+      }
+      if ( m_HeadingValid && m_AngSpeedValid )
+      {
+         jacobian(STATE_HEADING, STATE_ANG_SPEED) = -deltaTimestamp;
+      }
+
+      TCovariance noise;
+      noise(STATE_NORTH, STATE_NORTH)         = POSITION_NOISE * POSITION_NOISE * deltaTimestamp;
+      noise(STATE_EAST, STATE_EAST)           = POSITION_NOISE * POSITION_NOISE * deltaTimestamp;
+      noise(STATE_HEADING, STATE_HEADING)     = HEADING_NOISE * HEADING_NOISE * deltaTimestamp;
+      noise(STATE_SPEED, STATE_SPEED)         = SPEED_NOISE * SPEED_NOISE * deltaTimestamp;
+      noise(STATE_ANG_SPEED, STATE_ANG_SPEED) = ANG_SPEED_NOISE * ANG_SPEED_NOISE * deltaTimestamp;
+
+      m_Covariance = jacobian * m_Covariance * jacobian.Transpose() + noise;
+
+      if ( m_PositionValid && m_HeadingValid )
+      {
+         m_Position = TOOLS::ToPosition(m_Position, horda, hordaHeading);
+      }
+      if ( m_HeadingValid )
+      {
+         m_State(STATE_HEADING, 0) = TOOLS::ToHeading(heading, angSpeed * deltaTimestamp);
+      }
+      m_Timestamp = timestamp;
+   }
+}
+
+
+template <uint32_t SIZE>
+void PE::CEkfFusion::Update(const CMatrix<SIZE, STATE_SIZE>& observation, const CMatrix<SIZE, 1>& innovation, const CMatrix<SIZE, SIZE>& noise)
+{
+   const CMatrix<STATE_SIZE, SIZE> crossCovariance = m_Covariance * observation.Transpose();
+   CMatrix<SIZE, SIZE> inverse;
+   if ( ( observation * crossCovariance + noise ).Invert(inverse) )
+   {
+      const CMatrix<STATE_SIZE, SIZE> gain = crossCovariance * inverse;
+      //Joseph form keeps covariance symmetric and positive
+      const TCovariance factor = TCovariance::Identity() - gain * observation;
+      m_Covariance = factor * m_Covariance * factor.Transpose() + gain * noise * gain.Transpose();
+      ApplyCorrection(gain * innovation);
+   }
+}
+
+
+void PE::CEkfFusion::UpdateValue(uint32_t index, const double& innovation, const double& accuracy)
+{
+   CMatrix<1, STATE_SIZE> observation;
+   observation(0, index) = 1.0;
+   CMatrix<1, 1> measured;
+   measured(0, 0) = innovation;
+   CMatrix<1, 1> noise;
+   noise(0, 0) = accuracy * accuracy;
+   Update(observation, measured, noise);
+}
+
+
+void PE::CEkfFusion::UpdatePosition(const SPosition& position)
+{
+   if ( false == m_PositionValid )
+   {
+      m_Position = position;
+      InitValue(STATE_NORTH, 0.0, position.HorizontalAcc);
+      InitValue(STATE_EAST, 0.0, position.HorizontalAcc);
+      m_PositionValid = true;
+      return;
+   }
+
+   const double distance = TOOLS::ToDistance(m_Position.Latitude, m_Position.Longitude, position.Latitude, position.Longitude);
+   const double heading  = ( 0 < distance ) ? TOOLS::ToRadians(TOOLS::ToHeading(m_Position.Latitude, m_Position.Longitude, position.Latitude, position.Longitude)) : 0.0;
+
+   CMatrix<2, STATE_SIZE> observation;
+   observation(0, STATE_NORTH) = 1.0;
+   observation(1, STATE_EAST)  = 1.0;
+   CMatrix<2, 1> measured;
+   measured(0, 0) = distance * cos(heading);
+   measured(1, 0) = distance * sin(heading);
+   CMatrix<2, 2> noise;
+   noise(0, 0) = position.HorizontalAcc * position.HorizontalAcc;
+   noise(1, 1) = position.HorizontalAcc * position.HorizontalAcc;
+   Update(observation, measured, noise);
+}
+
+
+void PE::CEkfFusion::InitValue(uint32_t index, const double& value, const double& accuracy)
+{
+   for ( uint32_t i = 0; i < STATE_SIZE; ++i )
+   {
+      m_Covariance(index, i) = 0.0;
+      m_Covariance(i, index) = 0.0;
+   }
+   m_Covariance(index, index) = accuracy * accuracy;
+   m_State(index, 0) = value;
+}
+
+
+void PE::CEkfFusion::ApplyCorrection(const TStateVector& correction)
+{
+   const double north = correction(STATE_NORTH, 0);
+   const double east  = correction(STATE_EAST, 0);
+   if ( m_PositionValid && ( 0 != north || 0 != east ) )
+   {
+      m_Position = TOOLS::ToPosition(m_Position, sqrt(north * north + east * east), TOOLS::ToDegrees(atan2(east, north)));
+   }
+   if ( m_HeadingValid )
+   {
+      m_State(STATE_HEADING, 0) = TOOLS::ToHeading(m_State(STATE_HEADING, 0), -correction(STATE_HEADING, 0));
+   }
+   if ( m_SpeedValid )
+   {
+      m_State(STATE_SPEED, 0) += correction(STATE_SPEED, 0);
+   }
+   if ( m_AngSpeedValid )
+   {
+      m_State(STATE_ANG_SPEED, 0) += correction(STATE_ANG_SPEED, 0);
+   }
+}
+
+
+void PE::CEkfFusion::UpdateOutputs()
+{
+   if ( m_PositionValid )
+   {
+      m_Position.HorizontalAcc = sqrt(( m_Covariance(STATE_NORTH, STATE_NORTH) + m_Covariance(STATE_EAST, STATE_EAST) ) / 2);
+   }
+   m_Heading  = m_HeadingValid  ? SBasicSensor(m_State(STATE_HEADING, 0), sqrt(m_Covariance(STATE_HEADING, STATE_HEADING))) : SBasicSensor();
+   m_Speed    = m_SpeedValid    ? SBasicSensor(m_State(STATE_SPEED, 0), sqrt(m_Covariance(STATE_SPEED, STATE_SPEED))) : SBasicSensor();
+   m_AngSpeed = m_AngSpeedValid ? SBasicSensor(m_State(STATE_ANG_SPEED, 0), sqrt(m_Covariance(STATE_ANG_SPEED, STATE_ANG_SPEED))) : SBasicSensor();
+}
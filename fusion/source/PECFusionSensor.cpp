@@ -12,6 +12,7 @@
  * See the License for more information.
  */
 
+#include <chrono>
 #include "PECFusionSensor.h"
 #include "PEFusionTools.h"
 #include "PETools.h"
@@ -22,101 +23,216 @@ using namespace PE;
 using namespace PE::FUSION;
 
 
-PE::CFusionSensor::CFusionSensor(const double& timestamp, const SPosition& position, const SBasicSensor& heading, const SBasicSensor& angSpeed, const SBasicSensor& speed)
+const uint32_t PE::CFusionSensor::DEFAULT_CAPACITY;
+
+
+PE::CFusionSensor::CFusionSensor(const double& timestamp, const SPosition& position, const SBasicSensor& heading, const SBasicSensor& angSpeed, const SBasicSensor& speed,
+                                 uint32_t capacity, TOverflowPolicy policy)
 : m_Timestamp(timestamp)
 , m_Position(position)
 , m_Heading(heading)
 , m_AngSpeed(angSpeed)
 , m_Speed(speed)
+, m_SensorsList(capacity)
+, m_OverflowPolicy(policy)
+, m_OverflowCount(0)
+, m_Incremental(false)
+, m_LatencyBudget(0.0)
+, m_Clock(GetMonotonicTime)
+, m_PendingSince(0.0)
+, m_LateCount(0)
+, m_HistoryDepth(0)
+, m_History(1)
+, m_Replay(1)
+, m_RewindCount(0)
+, m_ReplayCount(0)
+, m_TooOldCount(0)
 {
 }
 
 
 void PE::CFusionSensor::AddPosition(const double& timestamp, const SPosition& position)
 {
-   if ( !position.IsValid() )
+   if ( position.IsValid() )
    {
-      return;
+      Insert(SSensorItem(timestamp, position, SBasicSensor(), SBasicSensor(), SBasicSensor()));
    }
-   if ( m_SensorsList.empty() )
+}
+
+
+void PE::CFusionSensor::AddHeading(const double& timestamp, const SBasicSensor& heading)
+{
+   if ( heading.IsValid() )
    {
-      m_SensorsList.push_back(SSensorItem(timestamp, position, SBasicSensor(), SBasicSensor(), SBasicSensor()));
+      Insert(SSensorItem(timestamp, SPosition(), heading, SBasicSensor(), SBasicSensor()));
    }
-   else if ( timestamp > m_SensorsList.back().timestamp )
+}
+
+
+void PE::CFusionSensor::AddSpeed(const double& timestamp, const SBasicSensor& speed)
+{
+   if ( speed.IsValid() )
    {
-      m_SensorsList.push_back(SSensorItem(timestamp, position, SBasicSensor(), SBasicSensor(), SBasicSensor()));
+      Insert(SSensorItem(timestamp, SPosition(), SBasicSensor(), speed, SBasicSensor()));
    }
-   else if ( timestamp == m_SensorsList.back().timestamp )
+}
+
+
+void PE::CFusionSensor::AddAngSpeed(const double& timestamp, const SBasicSensor& angSpeed)
+{
+   if ( angSpeed.IsValid() )
    {
-      SPosition& oldPosition = m_SensorsList.back().position;
-      oldPosition = MergePosition(oldPosition, position);
+      Insert(SSensorItem(timestamp, SPosition(), SBasicSensor(), SBasicSensor(), angSpeed));
    }
 }
 
 
-void PE::CFusionSensor::AddHeading(const double& timestamp, const SBasicSensor& heading)
+void PE::CFusionSensor::Insert(const SSensorItem& item)
 {
-   if ( !heading.IsValid() )
+   if ( IsOutOfSequence(item) )
    {
-      return;
+      DoFusion();
+      Rewind(item);
    }
-   if ( m_SensorsList.empty() )
+   else if ( m_Incremental )
    {
-      m_SensorsList.push_back(SSensorItem(timestamp, SPosition(), heading, SBasicSensor(), SBasicSensor()));
+      InsertIncremental(item);
    }
-   else if ( timestamp > m_SensorsList.back().timestamp )
+   else if ( m_SensorsList.IsEmpty() || item.timestamp > m_SensorsList.Back().timestamp )
    {
-      m_SensorsList.push_back(SSensorItem(timestamp, SPosition(), heading, SBasicSensor(), SBasicSensor()));
+      if ( m_SensorsList.IsFull() )
+      {
+         if ( OVERFLOW_FUSE == m_OverflowPolicy )
+         {
+            const SSensorItem& oldest = m_SensorsList.Front();
+            DoOneItemFusion(oldest.timestamp, oldest.position, oldest.heading, oldest.speed, oldest.angSpeed);
+         }
+         m_SensorsList.PopFront();
+         ++m_OverflowCount;
+      }
+      m_SensorsList.PushBack(item);
    }
-   else if ( timestamp == m_SensorsList.back().timestamp )
+   else if ( item.timestamp == m_SensorsList.Back().timestamp )
    {
-      SBasicSensor& oldHeading = m_SensorsList.back().heading;
-      oldHeading = MergeHeading(oldHeading, heading);
+      MergeItem(m_SensorsList.Back(), item);
    }
 }
 
 
-void PE::CFusionSensor::AddSpeed(const double& timestamp, const SBasicSensor& speed)
+void PE::CFusionSensor::InsertIncremental(const SSensorItem& item)
 {
-   if ( !speed.IsValid() )
+   if ( item.timestamp <= m_Timestamp )
    {
+      ++m_LateCount;
       return;
    }
-   if ( m_SensorsList.empty() )
+   if ( false == m_SensorsList.IsEmpty() )
    {
-      m_SensorsList.push_back(SSensorItem(timestamp, SPosition(), SBasicSensor(), speed, SBasicSensor()));
+      const SSensorItem& pending = m_SensorsList.Back();
+      if ( item.timestamp == pending.timestamp )
+      {
+         MergeItem(m_SensorsList.Back(), item);
+         Poll();
+         return;
+      }
+      if ( item.timestamp < pending.timestamp )
+      {
+         ++m_LateCount;
+         return;
+      }
+      //newer timestamp makes pending item final
+      DoOneItemFusion(pending.timestamp, pending.position, pending.heading, pending.speed, pending.angSpeed);
+      m_SensorsList.Clean();
    }
-   else if ( timestamp > m_SensorsList.back().timestamp )
+   m_SensorsList.PushBack(item);
+   if ( 0.0 < m_LatencyBudget )
    {
-      m_SensorsList.push_back(SSensorItem(timestamp, SPosition(), SBasicSensor(), speed, SBasicSensor()));
+      m_PendingSince = m_Clock();
+      Poll();
    }
-   else if ( timestamp == m_SensorsList.back().timestamp )
+}
+
+
+void PE::CFusionSensor::MergeItem(SSensorItem& target, const SSensorItem& item)
+{
+   if ( item.position.IsValid() )
    {
-      SBasicSensor& oldSpeed = m_SensorsList.back().speed;
-      oldSpeed = MergeSensor(oldSpeed, speed);
+      target.position = MergePosition(target.position, item.position);
+   }
+   if ( item.heading.IsValid() )
+   {
+      target.heading = MergeHeading(target.heading, item.heading);
+   }
+   if ( item.speed.IsValid() )
+   {
+      target.speed = MergeSensor(target.speed, item.speed);
+   }
+   if ( item.angSpeed.IsValid() )
+   {
+      target.angSpeed = MergeSensor(target.angSpeed, item.angSpeed);
    }
 }
 
 
-void PE::CFusionSensor::AddAngSpeed(const double& timestamp, const SBasicSensor& angSpeed)
+bool PE::CFusionSensor::IsOutOfSequence(const SSensorItem& item) const
 {
-   if ( !angSpeed.IsValid() )
+   if ( 0 == m_HistoryDepth )
    {
+      return false;
+   }
+   return ( item.timestamp <= m_Timestamp )
+       || ( false == m_SensorsList.IsEmpty() && item.timestamp < m_SensorsList.Back().timestamp );
+}
+
+
+void PE::CFusionSensor::Rewind(const SSensorItem& item)
+{
+   //first checkpoint whose item is not older than the late item
+   uint32_t index = m_History.GetSize();
+   while ( 0 < index && m_History[index - 1].item.timestamp >= item.timestamp )
+   {
+      --index;
+   }
+   if ( m_History.GetSize() == index || m_History[index].timestamp >= item.timestamp )
+   {
+      ++m_TooOldCount;
       return;
    }
-   if ( m_SensorsList.empty() )
+
+   const SCheckpoint& checkpoint = m_History[index];
+   m_Timestamp = checkpoint.timestamp;
+   m_Position  = checkpoint.position;
+   m_Heading   = checkpoint.heading;
+   m_AngSpeed  = checkpoint.angSpeed;
+   m_Speed     = checkpoint.speed;
+
+   m_Replay.Clean();
+   if ( checkpoint.item.timestamp == item.timestamp )
+   {
+      m_Replay.PushBack(checkpoint.item);
+      MergeItem(m_Replay.Back(), item);
+   }
+   else
    {
-      m_SensorsList.push_back(SSensorItem(timestamp, SPosition(), SBasicSensor(), SBasicSensor(), angSpeed));
+      m_Replay.PushBack(item);
+      m_Replay.PushBack(checkpoint.item);
    }
-   else if ( timestamp > m_SensorsList.back().timestamp )
+   for ( uint32_t i = index + 1; i < m_History.GetSize(); ++i )
    {
-      m_SensorsList.push_back(SSensorItem(timestamp, SPosition(), SBasicSensor(), SBasicSensor(), angSpeed));
+      m_Replay.PushBack(m_History[i].item);
    }
-   else if ( timestamp == m_SensorsList.back().timestamp )
+   while ( m_History.GetSize() > index )
    {
-      SBasicSensor& oldAngSpeed = m_SensorsList.back().angSpeed;
-      oldAngSpeed = MergeSensor(oldAngSpeed, angSpeed);
+      m_History.PopBack();
    }
+
+   for ( uint32_t i = 0; i < m_Replay.GetSize(); ++i )
+   {
+      const SSensorItem& replayed = m_Replay[i];
+      DoOneItemFusion(replayed.timestamp, replayed.position, replayed.heading, replayed.speed, replayed.angSpeed);
+   }
+   ++m_RewindCount;
+   m_ReplayCount += m_Replay.GetSize();
 }
 
 
@@ -179,13 +295,83 @@ const SBasicSensor PE::CFusionSensor::GetAngSpeed(const double& timestamp) const
 
 void PE::CFusionSensor::DoFusion()
 {
-   TSensorsList::const_iterator item = m_SensorsList.begin();
-   while ( m_SensorsList.end() != item )
+   for ( uint32_t i = 0; i < m_SensorsList.GetSize(); ++i )
+   {
+      const SSensorItem& item = m_SensorsList[i];
+      DoOneItemFusion(item.timestamp, item.position, item.heading, item.speed, item.angSpeed);
+   }
+   m_SensorsList.Clean();
+}
+
+
+uint32_t PE::CFusionSensor::GetOverflowCount() const
+{
+   return m_OverflowCount;
+}
+
+
+void PE::CFusionSensor::SetIncremental(bool incremental, const double& latencyBudget, TClock clock)
+{
+   DoFusion();
+   m_Incremental   = incremental;
+   m_LatencyBudget = latencyBudget;
+   m_Clock         = ( 0 != clock ) ? clock : GetMonotonicTime;
+}
+
+
+bool PE::CFusionSensor::IsIncremental() const
+{
+   return m_Incremental;
+}
+
+
+void PE::CFusionSensor::Poll()
+{
+   if ( m_Incremental && false == m_SensorsList.IsEmpty() )
    {
-      DoOneItemFusion(item->timestamp, item->position, item->heading, item->speed, item->angSpeed);
-      ++item;
+      if ( 0.0 < m_LatencyBudget && m_Clock() - m_PendingSince >= m_LatencyBudget )
+      {
+         DoFusion();
+      }
    }
-   m_SensorsList.clear();
+}
+
+
+uint32_t PE::CFusionSensor::GetLateCount() const
+{
+   return m_LateCount;
+}
+
+
+void PE::CFusionSensor::SetHistory(uint32_t depth)
+{
+   m_HistoryDepth = depth;
+   m_History = TCheckpoints(( 0 < depth ) ? depth : 1);
+   m_Replay  = TSensorsList(depth + 1);
+}
+
+
+uint32_t PE::CFusionSensor::GetRewindCount() const
+{
+   return m_RewindCount;
+}
+
+
+uint32_t PE::CFusionSensor::GetReplayCount() const
+{
+   return m_ReplayCount;
+}
+
+
+uint32_t PE::CFusionSensor::GetTooOldCount() const
+{
+   return m_TooOldCount;
+}
+
+
+double PE::CFusionSensor::GetMonotonicTime()
+{
+   return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
 
@@ -193,6 +379,22 @@ void PE::CFusionSensor::DoOneItemFusion(const double& timestamp, const SPosition
 {
    if( m_Timestamp < timestamp )
    {
+      if ( 0 < m_HistoryDepth )
+      {
+         if ( m_History.IsFull() )
+         {
+            m_History.PopFront();
+         }
+         SCheckpoint checkpoint;
+         checkpoint.timestamp = m_Timestamp;
+         checkpoint.position  = m_Position;
+         checkpoint.heading   = m_Heading;
+         checkpoint.angSpeed  = m_AngSpeed;
+         checkpoint.speed     = m_Speed;
+         checkpoint.item      = SSensorItem(timestamp, position, heading, speed, angSpeed);
+         m_History.PushBack(checkpoint);
+      }
+
       double deltaTimestamp = timestamp - m_Timestamp;
 
       SBasicSensor posHeading;
@@ -201,13 +403,14 @@ void PE::CFusionSensor::DoOneItemFusion(const double& timestamp, const SPosition
 
       if ( position.IsValid() )
       {
-         double distPos = TOOLS::ToDistance(m_Position.Latitude,m_Position.Longitude,position.Latitude, position.Longitude);
+         //distance and heading between positions are shared by gating and predictions
+         TOOLS::SGeodesic geodesic = TOOLS::ToGeodesic(m_Position.Latitude,m_Position.Longitude,position.Latitude, position.Longitude);
          double accPos = m_Position.HorizontalAcc + position.HorizontalAcc;
-         if (distPos > accPos)
+         if (geodesic.Distance > accPos)
          {
-            posHeading  = PredictHeading(deltaTimestamp, m_Position, position, m_Heading);
+            posHeading  = PredictHeading(deltaTimestamp, m_Position, position, geodesic, m_Heading);
             posAngSpeed = PredictAngSpeed(deltaTimestamp, m_Heading, posHeading);
-            posSpeed    = PredictSpeed(deltaTimestamp, m_Position, position, posAngSpeed);
+            posSpeed    = PredictSpeed(deltaTimestamp, m_Position, position, geodesic, posAngSpeed);
          }
       }
 
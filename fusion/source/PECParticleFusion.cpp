@@ -0,0 +1,610 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <math.h>
+#include <algorithm>
+#include "PECParticleFusion.h"
+#include "PECThreadPool.h"
+#include "PEFusionTools.h"
+#include "PETools.h"
+
+
+using namespace PE;
+using namespace PE::FUSION;
+
+
+const uint32_t PE::CParticleFusion::BLOCK_SIZE;
+const uint32_t PE::CParticleFusion::DEFAULT_PARTICLE_COUNT;
+const uint32_t PE::CParticleFusion::CAPACITY;
+const double PE::CParticleFusion::POSITION_NOISE          = 0.1;
+const double PE::CParticleFusion::HEADING_NOISE           = 0.1;
+const double PE::CParticleFusion::UNKNOWN_ANG_SPEED_NOISE = 10.0;
+const double PE::CParticleFusion::RESAMPLE_THRESHOLD      = 0.5;
+const double PE::CParticleFusion::RECENTER_DISTANCE       = 100.0;
+
+
+PE::CParticleFusion::CParticleFusion(const double& timestamp, const SPosition& position, const SBasicSensor& heading, const SBasicSensor& angSpeed, const SBasicSensor& speed,
+                                     uint32_t particleCount, uint32_t threadCount)
+: m_Timestamp(timestamp)
+, m_Position(position)
+, m_Heading(heading)
+, m_AngSpeed(angSpeed)
+, m_Speed(speed)
+, m_Reference(position)
+, m_PositionValid(position.IsValid())
+, m_Count(( 0 < particleCount ) ? ( particleCount + BLOCK_SIZE - 1 ) / BLOCK_SIZE * BLOCK_SIZE : BLOCK_SIZE)
+, m_North(m_Count)
+, m_East(m_Count)
+, m_DirNorth(m_Count)
+, m_DirEast(m_Count)
+, m_Weight(m_Count, 1.0)
+, m_NextNorth(m_Count)
+, m_NextEast(m_Count)
+, m_NextDirNorth(m_Count)
+, m_NextDirEast(m_Count)
+, m_Noise(2 * m_Count)
+, m_Seed(777)
+, m_Pool(0)
+, m_SensorsList(CAPACITY)
+, m_ResampleCount(0)
+, m_OverflowCount(0)
+{
+   //Box-Muller transformation of deterministic generator
+   for ( uint32_t i = 0; i < m_Noise.size(); ++i )
+   {
+      const double u1 = 1.0 - GetRandom();
+      const double u2 = GetRandom();
+      m_Noise[i] = sqrt(-2.0 * log(u1)) * cos(2.0 * PI * u2);
+   }
+
+   if ( 1 != threadCount )
+   {
+      m_Pool = new CThreadPool(threadCount);
+   }
+   m_Sums.resize(( 0 != m_Pool ) ? m_Pool->GetSize() : 1);
+
+   if ( m_PositionValid )
+   {
+      SpreadPositions(position.HorizontalAcc);
+   }
+   for ( uint32_t i = 0; i < m_Count; ++i )
+   {
+      double value = 360.0 * i / m_Count;
+      if ( heading.IsValid() )
+      {
+         value = heading.Value + heading.Accuracy * m_Noise[m_Count + i];
+      }
+      m_DirNorth[i] = cos(TOOLS::ToRadians(value));
+      m_DirEast[i]  = sin(TOOLS::ToRadians(value));
+   }
+   UpdateOutputs();
+}
+
+
+PE::CParticleFusion::~CParticleFusion()
+{
+   delete m_Pool;
+}
+
+
+void PE::CParticleFusion::AddPosition(const double& timestamp, const SPosition& position)
+{
+   if ( position.IsValid() )
+   {
+      Insert(SSensorItem(timestamp, SENSOR_POSITION, position, SBasicSensor()));
+   }
+}
+
+
+void PE::CParticleFusion::AddHeading(const double& timestamp, const SBasicSensor& heading)
+{
+   if ( heading.IsValid() )
+   {
+      Insert(SSensorItem(timestamp, SENSOR_HEADING, SPosition(), heading));
+   }
+}
+
+
+void PE::CParticleFusion::AddSpeed(const double& timestamp, const SBasicSensor& speed)
+{
+   if ( speed.IsValid() )
+   {
+      Insert(SSensorItem(timestamp, SENSOR_SPEED, SPosition(), speed));
+   }
+}
+
+
+void PE::CParticleFusion::AddAngSpeed(const double& timestamp, const SBasicSensor& angSpeed)
+{
+   if ( angSpeed.IsValid() )
+   {
+      Insert(SSensorItem(timestamp, SENSOR_ANG_SPEED, SPosition(), angSpeed));
+   }
+}
+
+
+void PE::CParticleFusion::Insert(const SSensorItem& item)
+{
+   if ( m_SensorsList.IsEmpty() || item.timestamp >= m_SensorsList.Back().timestamp )
+   {
+      if ( m_SensorsList.IsFull() )
+      {
+         DoOneItemFusion(m_SensorsList.Front());
+         m_SensorsList.PopFront();
+         ++m_OverflowCount;
+      }
+      m_SensorsList.PushBack(item);
+   }
+}
+
+
+const double& PE::CParticleFusion::GetTimestamp() const
+{
+   return m_Timestamp;
+}
+
+
+const SBasicSensor& PE::CParticleFusion::GetHeading() const
+{
+   return m_Heading;
+}
+
+
+const SPosition& PE::CParticleFusion::GetPosition() const
+{
+   return m_Position;
+}
+
+
+const SBasicSensor& PE::CParticleFusion::GetSpeed() const
+{
+   return m_Speed;
+}
+
+
+const SBasicSensor PE::CParticleFusion::GetSpeed(const double& timestamp) const
+{
+   if ( m_Timestamp > timestamp )
+   {
+      return SBasicSensor();
+   }
+   return PredictSensorAccuracy(timestamp - m_Timestamp, m_Speed);
+}
+
+
+const SBasicSensor& PE::CParticleFusion::GetAngSpeed() const
+{
+   return m_AngSpeed;
+}
+
+
+const SBasicSensor PE::CParticleFusion::GetAngSpeed(const double& timestamp) const
+{
+   if ( m_Timestamp > timestamp )
+   {
+      return SBasicSensor();
+   }
+   return PredictSensorAccuracy(timestamp - m_Timestamp, m_AngSpeed);
+}
+
+
+void PE::CParticleFusion::DoFusion()
+{
+   for ( uint32_t i = 0; i < m_SensorsList.GetSize(); ++i )
+   {
+      DoOneItemFusion(m_SensorsList[i]);
+   }
+   m_SensorsList.Clean();
+   UpdateOutputs();
+}
+
+
+uint32_t PE::CParticleFusion::GetParticleCount() const
+{
+   return m_Count;
+}
+
+
+uint32_t PE::CParticleFusion::GetResampleCount() const
+{
+   return m_ResampleCount;
+}
+
+
+uint32_t PE::CParticleFusion::GetOverflowCount() const
+{
+   return m_OverflowCount;
+}
+
+
+void PE::CParticleFusion::DoOneItemFusion(const SSensorItem& item)
+{
+   if ( m_Timestamp <= item.timestamp )
+   {
+      const double deltaTimestamp = item.timestamp - m_Timestamp;
+      if ( 0 < deltaTimestamp )
+      {
+         Predict(deltaTimestamp);
+         m_Speed    = PredictSensorAccuracy(deltaTimestamp, m_Speed);
+         m_AngSpeed = PredictSensorAccuracy(deltaTimestamp, m_AngSpeed);
+         m_Timestamp = item.timestamp;
+      }
+      switch ( item.type )
+      {
+         case SENSOR_POSITION:
+            UpdatePosition(item.position);
+            break;
+         case SENSOR_HEADING:
+            UpdateHeading(item.sensor);
+            break;
+         case SENSOR_SPEED:
+            m_Speed = MergeSensor(m_Speed, item.sensor);
+            break;
+         case SENSOR_ANG_SPEED:
+            m_AngSpeed = MergeSensor(m_AngSpeed, item.sensor);
+            break;
+      }
+   }
+}
+
+
+void PE::CParticleFusion::Predict(const double& deltaTimestamp)
+{
+   SMotion motion;
+   double turn = 0.0;
+   double turnNoise = UNKNOWN_ANG_SPEED_NOISE * deltaTimestamp;
+   if ( m_AngSpeed.IsValid() )
+   {
+      turn = m_AngSpeed.Value * deltaTimestamp;
+      turnNoise = m_AngSpeed.Accuracy * deltaTimestamp;
+   }
+   turnNoise = sqrt(turnNoise * turnNoise + HEADING_NOISE * HEADING_NOISE * deltaTimestamp);
+   motion.CosHalfTurn   = cos(TOOLS::ToRadians(turn / 2));
+   motion.SinHalfTurn   = sin(TOOLS::ToRadians(turn / 2));
+   motion.HalfTurnNoise = TOOLS::ToRadians(turnNoise / 2);
+   //chord of the arc like FUSION::PredictPosition()
+   const double halfTurn = fabs(TOOLS::ToRadians(turn / 2));
+   const double chord = ( EPSILON < halfTurn ) ? sin(halfTurn) / halfTurn : 1.0;
+   motion.Distance      = m_Speed.IsValid() ? m_Speed.Value * deltaTimestamp * chord : 0.0;
+   motion.DistanceNoise = m_Speed.IsValid() ? m_Speed.Accuracy * deltaTimestamp * chord : 0.0;
+   motion.PositionNoise = POSITION_NOISE * sqrt(deltaTimestamp);
+   for ( uint32_t i = 0; i < 4; ++i )
+   {
+      motion.Noise[i] = GetNoise();
+   }
+
+   ForEachChunk([this, &motion](uint32_t, uint32_t first, uint32_t last)
+   {
+      for ( uint32_t i = first; i < last; i += BLOCK_SIZE )
+      {
+         PredictBlock(&m_North[i], &m_East[i], &m_DirNorth[i], &m_DirEast[i], motion, i);
+      }
+   });
+}
+
+
+void PE::CParticleFusion::UpdatePosition(const SPosition& position)
+{
+   if ( false == m_PositionValid )
+   {
+      m_Reference = position;
+      m_PositionValid = true;
+      SpreadPositions(position.HorizontalAcc);
+      return;
+   }
+
+   const double distance = TOOLS::ToDistance(m_Reference.Latitude, m_Reference.Longitude, position.Latitude, position.Longitude);
+   const double heading = TOOLS::ToRadians(TOOLS::ToHeading(m_Reference.Latitude, m_Reference.Longitude, position.Latitude, position.Longitude));
+   const double north = distance * cos(heading);
+   const double east = distance * sin(heading);
+   const double scale = 1.0 / ( 3.0 * position.HorizontalAcc * position.HorizontalAcc );
+
+   ForEachChunk([this, &north, &east, &scale](uint32_t chunk, uint32_t first, uint32_t last)
+   {
+      SSums& sums = m_Sums[chunk];
+      sums.Weight = 0.0;
+      sums.WeightSquare = 0.0;
+      for ( uint32_t i = first; i < last; i += BLOCK_SIZE )
+      {
+         WeightBlock(&m_Weight[i], &m_North[i], &m_East[i], north, east, scale, sums);
+      }
+   });
+   Normalize();
+}
+
+
+void PE::CParticleFusion::UpdateHeading(const SBasicSensor& heading)
+{
+   //chord between unit vectors is the angle in radian for small angles
+   const double dirNorth = cos(TOOLS::ToRadians(heading.Value));
+   const double dirEast = sin(TOOLS::ToRadians(heading.Value));
+   const double accuracy = TOOLS::ToRadians(heading.Accuracy);
+   const double scale = 1.0 / ( 3.0 * accuracy * accuracy );
+
+   ForEachChunk([this, &dirNorth, &dirEast, &scale](uint32_t chunk, uint32_t first, uint32_t last)
+   {
+      SSums& sums = m_Sums[chunk];
+      sums.Weight = 0.0;
+      sums.WeightSquare = 0.0;
+      for ( uint32_t i = first; i < last; i += BLOCK_SIZE )
+      {
+         WeightBlock(&m_Weight[i], &m_DirNorth[i], &m_DirEast[i], dirNorth, dirEast, scale, sums);
+      }
+   });
+   Normalize();
+}
+
+
+void PE::CParticleFusion::Normalize()
+{
+   double total = 0.0;
+   double square = 0.0;
+   for ( uint32_t i = 0; i < m_Sums.size(); ++i )
+   {
+      total += m_Sums[i].Weight;
+      square += m_Sums[i].WeightSquare;
+   }
+
+   if ( 0.0 >= total )
+   {
+      //weights of all particles are lost, keep them
+      std::fill(m_Weight.begin(), m_Weight.end(), 1.0);
+   }
+   else if ( total * total < RESAMPLE_THRESHOLD * m_Count * square )
+   {
+      Resample(total);
+   }
+   else
+   {
+      const double factor = 1.0 / total;
+      ForEachChunk([this, &factor](uint32_t, uint32_t first, uint32_t last)
+      {
+         double* weight = &m_Weight[0];
+         for ( uint32_t i = first; i < last; ++i )
+         {
+            weight[i] *= factor;
+         }
+      });
+   }
+}
+
+
+void PE::CParticleFusion::Resample(const double& totalWeight)
+{
+   ++m_ResampleCount;
+   const double step = totalWeight / m_Count;
+   const double start = GetRandom() * step;
+
+   //index of the first systematic point not lower than cumulative weight
+   const uint32_t count = m_Count;
+   auto GetIndex = [step, start, count](const double& cumulative) -> uint32_t
+   {
+      const double index = ceil(( cumulative - start ) / step);
+      return ( 0.0 >= index ) ? 0 : ( count <= index ) ? count : static_cast<uint32_t>(index);
+   };
+
+   std::vector<double> cumulatives(m_Sums.size() + 1, 0.0);
+   for ( uint32_t i = 0; i < m_Sums.size(); ++i )
+   {
+      cumulatives[i + 1] = cumulatives[i] + m_Sums[i].Weight;
+   }
+
+   const uint32_t chunks = static_cast<uint32_t>(m_Sums.size());
+   ForEachChunk([this, &cumulatives, &GetIndex, &step, &start, chunks](uint32_t chunk, uint32_t first, uint32_t last)
+   {
+      uint32_t target = GetIndex(cumulatives[chunk]);
+      const uint32_t end = ( chunk + 1 == chunks ) ? m_Count : GetIndex(cumulatives[chunk + 1]);
+      double cumulative = cumulatives[chunk];
+      for ( uint32_t i = first; i < last && target < end; ++i )
+      {
+         cumulative += m_Weight[i];
+         while ( target < end && ( start + target * step < cumulative || i + 1 == last ) )
+         {
+            m_NextNorth[target]    = m_North[i];
+            m_NextEast[target]     = m_East[i];
+            m_NextDirNorth[target] = m_DirNorth[i];
+            m_NextDirEast[target]  = m_DirEast[i];
+            ++target;
+         }
+      }
+   });
+
+   m_North.swap(m_NextNorth);
+   m_East.swap(m_NextEast);
+   m_DirNorth.swap(m_NextDirNorth);
+   m_DirEast.swap(m_NextDirEast);
+   std::fill(m_Weight.begin(), m_Weight.end(), 1.0);
+}
+
+
+void PE::CParticleFusion::UpdateOutputs()
+{
+   ForEachChunk([this](uint32_t chunk, uint32_t first, uint32_t last)
+   {
+      SSums& sums = m_Sums[chunk];
+      sums = SSums();
+      for ( uint32_t i = first; i < last; ++i )
+      {
+         const double weight = m_Weight[i];
+         sums.Weight      += weight;
+         sums.North       += weight * m_North[i];
+         sums.East        += weight * m_East[i];
+         sums.NorthSquare += weight * m_North[i] * m_North[i];
+         sums.EastSquare  += weight * m_East[i] * m_East[i];
+         sums.DirNorth    += weight * m_DirNorth[i];
+         sums.DirEast     += weight * m_DirEast[i];
+      }
+   });
+
+   SSums total = SSums();
+   for ( uint32_t i = 0; i < m_Sums.size(); ++i )
+   {
+      total.Weight      += m_Sums[i].Weight;
+      total.North       += m_Sums[i].North;
+      total.East        += m_Sums[i].East;
+      total.NorthSquare += m_Sums[i].NorthSquare;
+      total.EastSquare  += m_Sums[i].EastSquare;
+      total.DirNorth    += m_Sums[i].DirNorth;
+      total.DirEast     += m_Sums[i].DirEast;
+   }
+
+   const double north = total.North / total.Weight;
+   const double east = total.East / total.Weight;
+   if ( m_PositionValid )
+   {
+      const double variance = ( total.NorthSquare + total.EastSquare ) / total.Weight - north * north - east * east;
+      const double distance = sqrt(north * north + east * east);
+      m_Position = m_Reference;
+      if ( EPSILON < distance )
+      {
+         m_Position = TOOLS::ToPosition(m_Reference, distance, TOOLS::ToDegrees(atan2(east, north)));
+      }
+      m_Position.HorizontalAcc = ( 2 * MIN_ACCURACY * MIN_ACCURACY < variance ) ? sqrt(variance / 2) : MIN_ACCURACY;
+
+      if ( RECENTER_DISTANCE < distance )
+      {
+         m_Reference = m_Position;
+         ForEachChunk([this, &north, &east](uint32_t, uint32_t first, uint32_t last)
+         {
+            for ( uint32_t i = first; i < last; ++i )
+            {
+               m_North[i] -= north;
+               m_East[i]  -= east;
+            }
+         });
+      }
+   }
+
+   //circular standard deviation by length of mean direction, particles spread over the circle are invalid heading
+   const double length = sqrt(total.DirNorth * total.DirNorth + total.DirEast * total.DirEast) / total.Weight;
+   m_Heading = SBasicSensor();
+   if ( EPSILON < length && length <= 1.0 )
+   {
+      const double accuracy = TOOLS::ToDegrees(sqrt(-2.0 * log(length)));
+      if ( 90.0 > accuracy )
+      {
+         double heading = TOOLS::ToDegrees(atan2(total.DirEast, total.DirNorth));
+         m_Heading = SBasicSensor(( 0.0 > heading ) ? heading + 360.0 : heading, ( MIN_ACCURACY < accuracy ) ? accuracy : MIN_ACCURACY);
+      }
+   }
+}
+
+
+void PE::CParticleFusion::ForEachChunk(const TChunkTask& task)
+{
+   const uint32_t chunks = static_cast<uint32_t>(m_Sums.size());
+   const uint32_t blocks = m_Count / BLOCK_SIZE;
+   if ( 1 == chunks )
+   {
+      task(0, 0, m_Count);
+      return;
+   }
+   for ( uint32_t chunk = 0; chunk < chunks; ++chunk )
+   {
+      const uint32_t first = blocks * chunk / chunks * BLOCK_SIZE;
+      const uint32_t last = blocks * ( chunk + 1 ) / chunks * BLOCK_SIZE;
+      m_Pool->Add([&task, chunk, first, last]()
+      {
+         task(chunk, first, last);
+      });
+   }
+   m_Pool->Wait();
+}
+
+
+void PE::CParticleFusion::SpreadPositions(const double& accuracy)
+{
+   const double* north = GetNoise();
+   const double* east = GetNoise();
+   for ( uint32_t i = 0; i < m_Count; ++i )
+   {
+      m_North[i] = accuracy * north[i];
+      m_East[i]  = accuracy * east[i];
+      m_Weight[i] = 1.0;
+   }
+}
+
+
+const double* PE::CParticleFusion::GetNoise()
+{
+   m_Seed = m_Seed * 1103515245 + 12345;
+   return &m_Noise[( m_Seed >> 8 ) % ( m_Count + 1 )];
+}
+
+
+double PE::CParticleFusion::GetRandom()
+{
+   m_Seed = m_Seed * 1103515245 + 12345;
+   return ( m_Seed >> 8 ) / 16777216.0;
+}
+
+
+void PE::CParticleFusion::PredictBlock(double* __restrict north, double* __restrict east, double* __restrict dirNorth, double* __restrict dirEast,
+                                       const SMotion& motion, uint32_t offset)
+{
+   const double* __restrict turnNoise     = motion.Noise[0] + offset;
+   const double* __restrict distanceNoise = motion.Noise[1] + offset;
+   const double* __restrict northNoise    = motion.Noise[2] + offset;
+   const double* __restrict eastNoise     = motion.Noise[3] + offset;
+   const double cosTurn = motion.CosHalfTurn;
+   const double sinTurn = motion.SinHalfTurn;
+
+   for ( uint32_t i = 0; i < BLOCK_SIZE; ++i )
+   {
+      //half turn of the particle: common turn rotated by Taylor series of the small noise turn
+      const double x  = motion.HalfTurnNoise * turnNoise[i];
+      const double x2 = x * x;
+      const double c  = 1.0 - x2 / 2 + x2 * x2 / 24;
+      const double s  = x * ( 1.0 - x2 / 6 + x2 * x2 / 120 );
+      const double cosHalf = cosTurn * c - sinTurn * s;
+      const double sinHalf = sinTurn * c + cosTurn * s;
+
+      //chord heading is heading turned by half of the turn (left turn decreases heading)
+      const double chordNorth = dirNorth[i] * cosHalf + dirEast[i] * sinHalf;
+      const double chordEast  = dirEast[i] * cosHalf - dirNorth[i] * sinHalf;
+      const double distance   = motion.Distance + motion.DistanceNoise * distanceNoise[i];
+      north[i] += distance * chordNorth + motion.PositionNoise * northNoise[i];
+      east[i]  += distance * chordEast + motion.PositionNoise * eastNoise[i];
+
+      //last heading and one Newton step to keep unit length without square root
+      const double lastNorth = chordNorth * cosHalf + chordEast * sinHalf;
+      const double lastEast  = chordEast * cosHalf - chordNorth * sinHalf;
+      const double norm = 1.5 - 0.5 * ( lastNorth * lastNorth + lastEast * lastEast );
+      dirNorth[i] = lastNorth * norm;
+      dirEast[i]  = lastEast * norm;
+   }
+}
+
+
+void PE::CParticleFusion::WeightBlock(double* __restrict weight, const double* __restrict north, const double* __restrict east,
+                                      const double& north0, const double& east0, const double& scale, SSums& sums)
+{
+   //4 partial sums are vectorized without reordering of additions
+   double sum[4] = { 0.0, 0.0, 0.0, 0.0 };
+   double square[4] = { 0.0, 0.0, 0.0, 0.0 };
+   for ( uint32_t i = 0; i < BLOCK_SIZE; i += 4 )
+   {
+      for ( uint32_t k = 0; k < 4; ++k )
+      {
+         const double dn = north[i + k] - north0;
+         const double de = east[i + k] - east0;
+         const double t = 1.0 + ( dn * dn + de * de ) * scale;
+         weight[i + k] *= 1.0 / ( t * t );
+         sum[k] += weight[i + k];
+         square[k] += weight[i + k] * weight[i + k];
+      }
+   }
+   sums.Weight += ( sum[0] + sum[1] ) + ( sum[2] + sum[3] );
+   sums.WeightSquare += ( square[0] + square[1] ) + ( square[2] + square[3] );
+}
@@ -0,0 +1,304 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <math.h>
+#include "PECSmoother.h"
+#include "PECThreadPool.h"
+#include "PEFusionTools.h"
+#include "PETools.h"
+
+
+
+using namespace PE;
+using namespace PE::FUSION;
+
+
+const double PE::CSmoother::DEFAULT_ANCHOR_ACCURACY = 5.0;
+const uint32_t PE::CSmoother::DEFAULT_SEGMENT_LENGTH;
+
+
+PE::CSmoother::CSmoother(const double& timestamp, const SPosition& position, const SBasicSensor& heading, const SBasicSensor& angSpeed, const SBasicSensor& speed)
+{
+   m_Start.Timestamp = timestamp;
+   m_Start.Position  = position;
+   m_Start.Heading   = heading;
+   m_Start.AngSpeed  = angSpeed;
+   m_Start.Speed     = speed;
+}
+
+
+void PE::CSmoother::AddPosition(const double& timestamp, const SPosition& position)
+{
+   SSensorItem item;
+   item.Timestamp = timestamp;
+   item.Position  = position;
+   Insert(item);
+}
+
+
+void PE::CSmoother::AddHeading(const double& timestamp, const SBasicSensor& heading)
+{
+   SSensorItem item;
+   item.Timestamp = timestamp;
+   item.Heading   = heading;
+   Insert(item);
+}
+
+
+void PE::CSmoother::AddSpeed(const double& timestamp, const SBasicSensor& speed)
+{
+   SSensorItem item;
+   item.Timestamp = timestamp;
+   item.Speed     = speed;
+   Insert(item);
+}
+
+
+void PE::CSmoother::AddAngSpeed(const double& timestamp, const SBasicSensor& angSpeed)
+{
+   SSensorItem item;
+   item.Timestamp = timestamp;
+   item.AngSpeed  = angSpeed;
+   Insert(item);
+}
+
+
+uint32_t PE::CSmoother::GetSize() const
+{
+   return static_cast<uint32_t>(m_Items.size());
+}
+
+
+const PE::CSmoother::SState& PE::CSmoother::GetFused(uint32_t index) const
+{
+   return m_Fused[index];
+}
+
+
+const PE::CSmoother::SState& PE::CSmoother::GetSmoothed(uint32_t index) const
+{
+   return m_Smoothed[index];
+}
+
+
+uint32_t PE::CSmoother::Smooth(uint32_t threadCount, const double& anchorAccuracy, uint32_t segmentLength)
+{
+   const uint32_t size = GetSize();
+   m_Predicted.resize(size);
+   m_Fused.resize(size);
+
+   SState state = m_Start;
+   for ( uint32_t i = 0; i < size; ++i )
+   {
+      ForwardStep(state, m_Predicted[i], m_Items[i]);
+      m_Fused[i] = state;
+   }
+
+   m_Smoothed = m_Fused;
+   if ( 0 == size )
+   {
+      return 0;
+   }
+
+   //segment ends are not changed by backward passes, so segments never write the same step
+   std::vector<uint32_t> lasts = GetSegments(anchorAccuracy, segmentLength);
+   if ( 1 == threadCount || 1 == lasts.size() )
+   {
+      uint32_t first = 0;
+      for ( uint32_t i = 0; i < lasts.size(); ++i )
+      {
+         BackwardPass(first, lasts[i]);
+         first = lasts[i] + 1;
+      }
+   }
+   else
+   {
+      CThreadPool pool(threadCount);
+      uint32_t first = 0;
+      for ( uint32_t i = 0; i < lasts.size(); ++i )
+      {
+         const uint32_t last = lasts[i];
+         pool.Add([this, first, last]()
+         {
+            BackwardPass(first, last);
+         });
+         first = last + 1;
+      }
+      pool.Wait();
+   }
+   return static_cast<uint32_t>(lasts.size());
+}
+
+
+void PE::CSmoother::Insert(const SSensorItem& item)
+{
+   if ( m_Items.empty() || m_Items.back().Timestamp < item.Timestamp )
+   {
+      if ( m_Start.Timestamp < item.Timestamp )
+      {
+         m_Items.push_back(item);
+      }
+   }
+   else if ( m_Items.back().Timestamp == item.Timestamp )
+   {
+      SSensorItem& target = m_Items.back();
+      if ( item.Position.IsValid() )
+      {
+         target.Position = MergePosition(target.Position, item.Position);
+      }
+      if ( item.Heading.IsValid() )
+      {
+         target.Heading = MergeHeading(target.Heading, item.Heading);
+      }
+      if ( item.Speed.IsValid() )
+      {
+         target.Speed = MergeSensor(target.Speed, item.Speed);
+      }
+      if ( item.AngSpeed.IsValid() )
+      {
+         target.AngSpeed = MergeSensor(target.AngSpeed, item.AngSpeed);
+      }
+   }
+}
+
+
+void PE::CSmoother::ForwardStep(SState& state, SState& predicted, const SSensorItem& item)
+{
+   double deltaTimestamp = item.Timestamp - state.Timestamp;
+
+   SBasicSensor posHeading;
+   SBasicSensor posAngSpeed;
+   SBasicSensor posSpeed;
+
+   if ( item.Position.IsValid() )
+   {
+      TOOLS::SGeodesic geodesic = TOOLS::ToGeodesic(state.Position.Latitude, state.Position.Longitude, item.Position.Latitude, item.Position.Longitude);
+      double accPos = state.Position.HorizontalAcc + item.Position.HorizontalAcc;
+      if ( geodesic.Distance > accPos )
+      {
+         posHeading  = PredictHeading(deltaTimestamp, state.Position, item.Position, geodesic, state.Heading);
+         posAngSpeed = PredictAngSpeed(deltaTimestamp, state.Heading, posHeading);
+         posSpeed    = PredictSpeed(deltaTimestamp, state.Position, item.Position, geodesic, posAngSpeed);
+      }
+   }
+
+   predicted.Timestamp = item.Timestamp;
+   predicted.AngSpeed  = PredictSensorAccuracy(deltaTimestamp, state.AngSpeed);
+   predicted.Speed     = PredictSensorAccuracy(deltaTimestamp, state.Speed);
+
+   SBasicSensor newAngSpeed = MergeSensor(predicted.AngSpeed, item.AngSpeed);
+   SBasicSensor newSpeed    = MergeSensor(predicted.Speed, item.Speed);
+
+   predicted.Heading  = PredictHeading(deltaTimestamp, state.Heading, newAngSpeed);
+   predicted.Position = PredictPosition(deltaTimestamp, state.Heading, newAngSpeed, state.Position, newSpeed);
+
+   SBasicSensor newHeading  = MergeHeading(predicted.Heading, item.Heading);
+
+   state.Timestamp = item.Timestamp;
+   state.AngSpeed  = MergeSensor(newAngSpeed, posAngSpeed);
+   state.Speed     = MergeSensor(newSpeed, posSpeed);
+   state.Heading   = MergeHeading(newHeading, posHeading);
+   state.Position  = MergePosition(predicted.Position, item.Position);
+}
+
+
+void PE::CSmoother::BackwardPass(uint32_t first, uint32_t last)
+{
+   for ( uint32_t i = last; i > first; --i )
+   {
+      const SState& fused     = m_Fused[i - 1];
+      const SState& predicted = m_Predicted[i];
+      const SState& next      = m_Smoothed[i];
+      SState& smoothed        = m_Smoothed[i - 1];
+
+      smoothed.AngSpeed = SmoothSensor(fused.AngSpeed, predicted.AngSpeed, next.AngSpeed);
+      smoothed.Speed    = SmoothSensor(fused.Speed, predicted.Speed, next.Speed);
+
+      if ( fused.Heading.IsValid() && predicted.Heading.IsValid() && next.Heading.IsValid() )
+      {
+         double gain = GetGain(fused.Heading.Accuracy, predicted.Heading.Accuracy);
+         smoothed.Heading.Value    = TOOLS::ToHeading(fused.Heading.Value, -gain * TOOLS::ToAngle(next.Heading.Value, predicted.Heading.Value));
+         smoothed.Heading.Accuracy = GetAccuracy(gain, fused.Heading.Accuracy, predicted.Heading.Accuracy, next.Heading.Accuracy);
+      }
+
+      if ( fused.Position.IsValid() && predicted.Position.IsValid() && next.Position.IsValid() )
+      {
+         double gain = GetGain(fused.Position.HorizontalAcc, predicted.Position.HorizontalAcc);
+         double distance = TOOLS::ToDistance(predicted.Position.Latitude, predicted.Position.Longitude, next.Position.Latitude, next.Position.Longitude);
+         if ( EPSILON < distance )
+         {
+            double heading = TOOLS::ToHeading(predicted.Position.Latitude, predicted.Position.Longitude, next.Position.Latitude, next.Position.Longitude);
+            smoothed.Position = TOOLS::ToPosition(fused.Position, gain * distance, heading);
+         }
+         smoothed.Position.HorizontalAcc = GetAccuracy(gain, fused.Position.HorizontalAcc, predicted.Position.HorizontalAcc, next.Position.HorizontalAcc);
+      }
+   }
+}
+
+
+std::vector<uint32_t> PE::CSmoother::GetSegments(const double& anchorAccuracy, uint32_t segmentLength) const
+{
+   std::vector<uint32_t> lasts;
+   const uint32_t size = GetSize();
+   uint32_t first = 0;
+   for ( uint32_t i = 0; i + 1 < size; ++i )
+   {
+      const SPosition& position = m_Items[i].Position;
+      if ( first + segmentLength <= i && position.IsValid() && position.HorizontalAcc <= anchorAccuracy )
+      {
+         lasts.push_back(i);
+         first = i + 1;
+      }
+   }
+   lasts.push_back(size - 1);
+   return lasts;
+}
+
+
+SBasicSensor PE::CSmoother::SmoothSensor(const SBasicSensor& fused, const SBasicSensor& predicted, const SBasicSensor& next)
+{
+   SBasicSensor smoothed = fused;
+   if ( fused.IsValid() && predicted.IsValid() && next.IsValid() )
+   {
+      double gain = GetGain(fused.Accuracy, predicted.Accuracy);
+      smoothed.Value    = fused.Value + gain * (next.Value - predicted.Value);
+      smoothed.Accuracy = GetAccuracy(gain, fused.Accuracy, predicted.Accuracy, next.Accuracy);
+   }
+   return smoothed;
+}
+
+
+double PE::CSmoother::GetGain(const double& fusedAccuracy, const double& predictedAccuracy)
+{
+   double gain = 0.0;
+   if ( fusedAccuracy < predictedAccuracy )
+   {
+      gain = (fusedAccuracy * fusedAccuracy) / (predictedAccuracy * predictedAccuracy);
+   }
+   else if ( EPSILON < predictedAccuracy )
+   {
+      gain = 1.0;
+   }
+   return gain;
+}
+
+
+double PE::CSmoother::GetAccuracy(const double& gain, const double& fusedAccuracy, const double& predictedAccuracy, const double& nextAccuracy)
+{
+   double variance = fusedAccuracy * fusedAccuracy
+                   + gain * gain * (nextAccuracy * nextAccuracy - predictedAccuracy * predictedAccuracy);
+   double accuracy = variance > MIN_ACCURACY * MIN_ACCURACY ? sqrt(variance) : MIN_ACCURACY;
+   //accuracies of the fusion are not exact variances, smoothing uses more information and could not make it worse
+   return accuracy < fusedAccuracy ? accuracy : fusedAccuracy;
+}
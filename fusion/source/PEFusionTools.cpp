@@ -138,17 +138,27 @@ SBasicSensor PE::FUSION::PredictHeading(const double& deltaTimestamp, const SBas
    return resultHeading;
 }
 
-//TODO has to be reworked!!!!
 SBasicSensor PE::FUSION::PredictHeading(const double& deltaTimestamp, const SPosition& positionFirst, const SPosition& positionLast, const SBasicSensor& heading)
+{
+   TOOLS::SGeodesic geodesic = { 0.0, 0.0 };
+   if ( 0 < deltaTimestamp && positionFirst.IsValid() && positionLast.IsValid() )
+   {
+      geodesic = TOOLS::ToGeodesic(positionFirst.Latitude, positionFirst.Longitude, positionLast.Latitude, positionLast.Longitude);
+   }
+   return PredictHeading(deltaTimestamp, positionFirst, positionLast, geodesic, heading);
+}
+
+//TODO has to be reworked!!!!
+SBasicSensor PE::FUSION::PredictHeading(const double& deltaTimestamp, const SPosition& positionFirst, const SPosition& positionLast, const TOOLS::SGeodesic& geodesic, const SBasicSensor& heading)
 {
    SBasicSensor resultHeading = PredictSensorAccuracy(deltaTimestamp, heading);
    if ( 0 < deltaTimestamp && positionFirst.IsValid() && positionLast.IsValid() )
    {
-      double distance        = TOOLS::ToDistance(positionFirst.Latitude, positionFirst.Longitude, positionLast.Latitude, positionLast.Longitude);
+      double distance        = geodesic.Distance;
       if ( 0.0 < distance )
       {
          double deviation       = positionFirst.HorizontalAcc + positionLast.HorizontalAcc;
-         resultHeading.Value    = TOOLS::ToHeading(positionFirst.Latitude, positionFirst.Longitude, positionLast.Latitude, positionLast.Longitude);
+         resultHeading.Value    = geodesic.Heading;
          resultHeading.Accuracy = TOOLS::ToDegrees(atan(deviation / distance)) / 2 * deltaTimestamp;
          if (heading.IsValid())
          {
@@ -192,11 +202,22 @@ SPosition PE::FUSION::PredictPosition(const double& deltaTimestamp, const SBasic
 
 
 SBasicSensor PE::FUSION::PredictSpeed(const double& deltaTimestamp, const SPosition& positionFirst, const SPosition& positionLast, const SBasicSensor& angSpeed)
+{
+   TOOLS::SGeodesic geodesic = { 0.0, 0.0 };
+   if ( 0 < deltaTimestamp && positionFirst.IsValid() && positionLast.IsValid() )
+   {
+      geodesic.Distance = TOOLS::ToDistance(positionFirst.Latitude,positionFirst.Longitude,positionLast.Latitude,positionLast.Longitude);
+   }
+   return PredictSpeed(deltaTimestamp, positionFirst, positionLast, geodesic, angSpeed);
+}
+
+
+SBasicSensor PE::FUSION::PredictSpeed(const double& deltaTimestamp, const SPosition& positionFirst, const SPosition& positionLast, const TOOLS::SGeodesic& geodesic, const SBasicSensor& angSpeed)
 {
    SBasicSensor resutlSpeed;
    if ( 0 < deltaTimestamp && positionFirst.IsValid() && positionLast.IsValid() )
    {
-      double horda         = TOOLS::ToDistance(positionFirst.Latitude,positionFirst.Longitude,positionLast.Latitude,positionLast.Longitude);
+      double horda         = geodesic.Distance;
       resutlSpeed.Value    = horda / deltaTimestamp ;
       resutlSpeed.Accuracy = (positionFirst.HorizontalAcc + positionLast.HorizontalAcc) / cos(TOOLS::ToRadians(45));
       if (  0.0 < horda && angSpeed.IsValid() )
@@ -22,6 +22,8 @@ namespace PE
  */
 class CNormalisation
 {
+   friend class CNormalisationBank;
+
 public:
    /**
     * Constructor of normalisation
@@ -43,6 +45,18 @@ public:
     * @param  value     Raw sensor measurement
     */
    void AddSensor(const double& value);
+   /**
+    * Merges normalisation of other part of the same sensor data, e.g. other chunk of the track.
+    * Parts could be normalised in parallel, merging of two parts is symmetric:
+    *    mean     - exact mean of both parts
+    *    mld      - deviations of both parts plus joint term |meanA - meanB| * nA * nB / (nA + nB)
+    *    reliable - reliables of both parts plus reliable of the joint, which is calculated
+    *               by the mean shift of the smaller part (same like AddSensor() for one value part).
+    *               Start-up of each part is kept, so reliable of short parts is lower then sequential one.
+    *
+    * @param  other     normalisation of other part
+    */
+   void Merge(const CNormalisation& other);
    /**
     * Returns expected value of the sensor
     *
@@ -0,0 +1,159 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CNormalisationBank_H__
+#define __PE_CNormalisationBank_H__
+
+#include <vector>
+#include "PETypes.h"
+#include "PECNormalisation.h"
+
+class PECNormalisationBankTest; //to get possibility for test class
+
+namespace PE
+{
+
+/**
+ * State of many normalisers (e.g. one per vehicle of the fleet) stored as parallel arrays.
+ *
+ * Each normaliser behaves exactly like CNormalisation. Only accumulated values are stored,
+ * mean, mld and reliable are calculated on reading by the same formulas.
+ *
+ * Batch update gathers state of a block of normalisers into local arrays, updates the whole
+ * block by one loop without branches which is vectorized by compiler (GCC needs -fno-trapping-math
+ * to convert conditions of the loop into selects) and scatters state back. Block is closed
+ * before an index repeats, so batch with repeated indices gives same result like
+ * sequential AddSensor() calls.
+ */
+class CNormalisationBank
+{
+   friend class ::PECNormalisationBankTest;
+
+public:
+   /**
+    * Constructor
+    *
+    * @param  size   count of normalisers, all of them are unset
+    */
+   explicit CNormalisationBank(uint32_t size = 0);
+   /**
+    * Changes count of normalisers, new normalisers are unset
+    *
+    * @param  size   count of normalisers
+    */
+   void Resize(uint32_t size);
+   /**
+    * Returns count of normalisers
+    */
+   uint32_t GetSize() const;
+   /**
+    * Adds new raw value to one normaliser, same like CNormalisation::AddSensor()
+    *
+    * @param  index   index of the normaliser
+    * @param  value   raw sensor measurement
+    */
+   void AddSensor(uint32_t index, const double& value);
+   /**
+    * Adds values to normalisers in order of the batch
+    * @return   false if any index is out of range, nothing is added in this case
+    *
+    * @param  indices   indices of the normalisers, could repeat
+    * @param  values    raw sensor measurements
+    * @param  count     count of values
+    */
+   bool AddSensorBatch(const uint32_t* indices, const double* values, uint32_t count);
+   /**
+    * Adds values to normalisers in order of the batch
+    * @return   false if any index is out of range or sizes are different, nothing is added in this case
+    *
+    * @param  indices   indices of the normalisers, could repeat
+    * @param  values    raw sensor measurements
+    */
+   bool AddSensorBatch(const std::vector<uint32_t>& indices, const std::vector<double>& values);
+   /**
+    * Returns expected value of the normaliser
+    */
+   double GetMean(uint32_t index) const;
+   /**
+    * Returns mean linear deviation of the normaliser
+    */
+   double GetMld(uint32_t index) const;
+   /**
+    * Returns reliable status of the normaliser in range [0..100] percent
+    */
+   double GetReliable(uint32_t index) const;
+   /**
+    * Returns sample count of the normaliser
+    */
+   double GetSampleCount(uint32_t index) const;
+   /**
+    * Copies normaliser into the bank
+    *
+    * @param  index           index of the normaliser
+    * @param  normalisation   normalisation to copy
+    */
+   void Set(uint32_t index, const CNormalisation& normalisation);
+   /**
+    * Copies normaliser out of the bank
+    * @return   normalisation with the same state
+    *
+    * @param  index   index of the normaliser
+    */
+   CNormalisation Get(uint32_t index) const;
+
+   /**
+    * Maximal count of values updated by one pass of the branch free loop
+    */
+   static const uint32_t BLOCK_SIZE = 64;
+
+private:
+   /**
+    * State of one block, local arrays could be vectorized without aliasing checks
+    */
+   struct SBlock
+   {
+      double AccumulatedValue[BLOCK_SIZE];
+      double AccumulatedMld[BLOCK_SIZE];
+      double AccumulatedReliable[BLOCK_SIZE];
+      double SampleCount[BLOCK_SIZE];
+      double Value[BLOCK_SIZE];
+   };
+   /**
+    * Returns length of the batch head without repeated indices, up to BLOCK_SIZE
+    *
+    * @param  indices   indices of the normalisers
+    * @param  count     count of indices
+    */
+   static uint32_t GetBlockLength(const uint32_t* indices, uint32_t count);
+   /**
+    * Updates block of normalisers without repeated indices
+    *
+    * @param  indices   indices of the normalisers
+    * @param  values    raw sensor measurements
+    * @param  count     count of values, up to BLOCK_SIZE
+    */
+   void AddBlock(const uint32_t* indices, const double* values, uint32_t count);
+   /**
+    * Updates all values of the block like CNormalisation::AddSensor()
+    */
+   static void UpdateBlock(SBlock& block);
+
+   std::vector<double> m_AccumulatedValue;
+   std::vector<double> m_AccumulatedMld;
+   std::vector<double> m_AccumulatedReliable;
+   std::vector<double> m_SampleCount;
+};
+
+} //namespace PE
+
+#endif //__PE_CNormalisationBank_H__
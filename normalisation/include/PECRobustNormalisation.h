@@ -0,0 +1,198 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CRobustNormalisation_H__
+#define __PE_CRobustNormalisation_H__
+
+#include <vector>
+#include "PETypes.h"
+#include "PECNormalisation.h"
+
+class PECRobustNormalisationTest; //to get possibility for test class
+
+namespace PE
+{
+
+/**
+ * Robust normalisation over sliding window of last values
+ *
+ *   mean     - median of the window
+ *   mld      - median absolute deviation (MAD) of the window, scaled by MLD_FROM_MAD
+ *              to be comparable with mean linear deviation of CNormalisation for normal noise
+ *   reliable - mean of reliable contributions of the window values, each contribution
+ *              is calculated like in CNormalisation: 100 - |median shift| / mld * 100
+ *
+ * A burst of outliers shorter then half of the window does not move the median,
+ * values older then the window are forgotten completely.
+ *
+ * Values of the window are kept sorted in an indexable skip list with preallocated nodes,
+ * so memory is bounded by the window size. Insert and remove of a value are O(log N),
+ * median is O(log N) and MAD is O(log^2 N) by rank access to the sorted values.
+ *
+ * Interface is the same like of CNormalisation, so it could be used by CSensor<CRobustNormalisation>.
+ */
+class CRobustNormalisation
+{
+   friend class ::PECRobustNormalisationTest;
+
+public:
+   /**
+    * Constructor
+    *
+    * @param  windowSize   count of last values in the statistic, at least 1
+    */
+   explicit CRobustNormalisation(uint32_t windowSize = DEFAULT_WINDOW_SIZE);
+   /**
+    * Adds new raw value of the sensor, oldest value is removed if the window is full.
+    * NaN values are ignored.
+    *
+    * @param  value     Raw sensor measurement
+    */
+   void AddSensor(const double& value);
+   /**
+    * Returns median of the window
+    */
+   const double& GetMean() const;
+   /**
+    * Returns scaled median absolute deviation of the window
+    */
+   const double& GetMld() const;
+   /**
+    * Returns reliable status of the window in range [0..100] percent
+    */
+   const double& GetReliable() const;
+   /**
+    * Returns count of values in the window
+    */
+   const double& GetSampleCount() const;
+   /**
+    * Returns median absolute deviation of the window without scaling
+    */
+   const double& GetMad() const;
+   /**
+    * Returns window size
+    */
+   uint32_t GetWindowSize() const;
+
+   /**
+    * Default window size
+    */
+   static const uint32_t DEFAULT_WINDOW_SIZE = 256;
+   /**
+    * Ratio of mean linear deviation to median absolute deviation of normal distribution:
+    * sqrt(2/pi) / 0.6745
+    */
+   static const double MLD_FROM_MAD;
+
+private:
+   /**
+    * Returns value of the window by rank in ascending order
+    *
+    * @param  rank   rank of the value, has to be less then count of values
+    */
+   const double& GetByRank(uint32_t rank) const;
+   /**
+    * Inserts value into sorted list
+    */
+   void Insert(const double& value);
+   /**
+    * Removes one value equal to given one from sorted list
+    */
+   void Remove(const double& value);
+   /**
+    * Returns height of next node, geometric distribution with p = 0.5
+    */
+   uint32_t GetRandomHeight();
+   /**
+    * Calculates median of the window
+    */
+   double CalculateMedian() const;
+   /**
+    * Calculates median absolute deviation from the median of the window
+    *
+    * @param  median   median of the window
+    */
+   double CalculateMad(const double& median) const;
+   /**
+    * Returns absolute deviation from the median by rank in ascending order.
+    * Deviations of values below and above the median are two sorted sequences,
+    * the rank is found by binary search over both of them.
+    *
+    * @param  median   median of the window
+    * @param  rank     rank of the deviation, has to be less then count of values
+    */
+   double GetDeviationByRank(const double& median, uint32_t rank) const;
+
+   /**
+    * Window size
+    */
+   uint32_t m_WindowSize;
+   /**
+    * Count of skip list levels
+    */
+   uint32_t m_Levels;
+   /**
+    * Node values, node 0 is the head and last node is the tail with +infinity value
+    */
+   std::vector<double> m_NodeValue;
+   /**
+    * Node heights
+    */
+   std::vector<uint32_t> m_NodeHeight;
+   /**
+    * Next node per node and level: [node * m_Levels + level]
+    */
+   std::vector<uint32_t> m_Next;
+   /**
+    * Count of values skipped by the link per node and level: [node * m_Levels + level]
+    */
+   std::vector<uint32_t> m_Width;
+   /**
+    * Unused nodes
+    */
+   std::vector<uint32_t> m_Free;
+   /**
+    * Window values in order of adding, ring buffer
+    */
+   std::vector<double> m_Window;
+   /**
+    * Reliable contributions of window values, ring buffer
+    */
+   std::vector<double> m_Contribution;
+   /**
+    * Ring position of next value
+    */
+   uint32_t m_Position;
+   /**
+    * Count of values in the window
+    */
+   uint32_t m_Count;
+   /**
+    * Random state of node heights
+    */
+   uint32_t m_Random;
+   /**
+    * Sum of reliable contributions of the window
+    */
+   double m_AccumulatedReliable;
+
+   double m_Mean;
+   double m_Mad;
+   double m_Mld;
+   double m_Reliable;
+   double m_SampleCount;
+};
+
+} //namespace PE
+
+#endif //__PE_CRobustNormalisation_H__
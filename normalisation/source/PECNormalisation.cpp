@@ -14,6 +14,7 @@
 
 #include "PECNormalisation.h"
 #include <math.h>
+#include <algorithm>
 
 
 using namespace PE;
@@ -81,6 +82,50 @@ void PE::CNormalisation::AddSensor(const double& value)
    }
 }
 
+void PE::CNormalisation::Merge(const CNormalisation& other)
+{
+   if ( 0.0 >= other.mSampleCount ||
+        0.0 > other.mAccumulatedReliable )
+   {
+      return;
+   }
+   if ( 0.0 >= mSampleCount ||
+        0.0 > mAccumulatedReliable )
+   {
+      *this = other;
+      return;
+   }
+
+   double sampleCount = mSampleCount + other.mSampleCount;
+   double ownMean = mAccumulatedValue / mSampleCount;
+   double otherMean = other.mAccumulatedValue / other.mSampleCount;
+   mMean = (mAccumulatedValue + other.mAccumulatedValue) / sampleCount;
+
+   //Chan-style joint term, first value of each part is not considered in deviation and reliable,
+   //so joint of parts replaces first value of other part
+   mAccumulatedMld += other.mAccumulatedMld + fabs( ownMean - otherMean ) * mSampleCount * other.mSampleCount / sampleCount;
+   mMld = mAccumulatedMld / ( sampleCount - 1.0 );
+
+   mAccumulatedReliable += other.mAccumulatedReliable;
+   if ( 0.0 == mMld )
+   {
+      mAccumulatedReliable += 100;
+   }
+   else
+   {
+      //shift of the mean by the smaller part, same like AddSensor() if other part is one value
+      double deltaMean = std::min( fabs( ownMean - mMean ), fabs( otherMean - mMean ) );
+      if ( deltaMean < mMld )
+      {
+         mAccumulatedReliable += 100 - deltaMean / mMld * 100;
+      }
+   }
+
+   mAccumulatedValue += other.mAccumulatedValue;
+   mSampleCount = sampleCount;
+   mReliable = mAccumulatedReliable / mSampleCount;
+}
+
 const double& PE::CNormalisation::GetMean() const
 {
    return mMean;
@@ -0,0 +1,243 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <math.h>
+#include "PECNormalisationBank.h"
+
+
+using namespace PE;
+
+
+const uint32_t PE::CNormalisationBank::BLOCK_SIZE;
+
+
+PE::CNormalisationBank::CNormalisationBank(uint32_t size)
+{
+   Resize(size);
+}
+
+
+void PE::CNormalisationBank::Resize(uint32_t size)
+{
+   m_AccumulatedValue.resize(size, 0.0);
+   m_AccumulatedMld.resize(size, 0.0);
+   m_AccumulatedReliable.resize(size, 0.0);
+   m_SampleCount.resize(size, 0.0);
+}
+
+
+uint32_t PE::CNormalisationBank::GetSize() const
+{
+   return static_cast<uint32_t>( m_SampleCount.size() );
+}
+
+
+void PE::CNormalisationBank::AddSensor(uint32_t index, const double& value)
+{
+   AddBlock(&index, &value, 1);
+}
+
+
+bool PE::CNormalisationBank::AddSensorBatch(const uint32_t* indices, const double* values, uint32_t count)
+{
+   const uint32_t size = GetSize();
+   for ( uint32_t i = 0; i < count; ++i )
+   {
+      if ( indices[i] >= size )
+      {
+         return false;
+      }
+   }
+
+   uint32_t begin = 0;
+   while ( begin < count )
+   {
+      const uint32_t length = GetBlockLength(indices + begin, count - begin);
+      AddBlock(indices + begin, values + begin, length);
+      begin += length;
+   }
+   return true;
+}
+
+
+bool PE::CNormalisationBank::AddSensorBatch(const std::vector<uint32_t>& indices, const std::vector<double>& values)
+{
+   if ( indices.size() != values.size() )
+   {
+      return false;
+   }
+   if ( indices.empty() )
+   {
+      return true;
+   }
+   return AddSensorBatch(&indices[0], &values[0], static_cast<uint32_t>( indices.size() ));
+}
+
+
+double PE::CNormalisationBank::GetMean(uint32_t index) const
+{
+   if ( 1.0 < m_SampleCount[index] && 0.0 <= m_AccumulatedReliable[index] )
+   {
+      return m_AccumulatedValue[index] / m_SampleCount[index];
+   }
+   return 0.0;
+}
+
+
+double PE::CNormalisationBank::GetMld(uint32_t index) const
+{
+   if ( 1.0 < m_SampleCount[index] && 0.0 <= m_AccumulatedReliable[index] )
+   {
+      return m_AccumulatedMld[index] / ( m_SampleCount[index] - 1.0 );
+   }
+   return 0.0;
+}
+
+
+double PE::CNormalisationBank::GetReliable(uint32_t index) const
+{
+   if ( 1.0 < m_SampleCount[index] && 0.0 <= m_AccumulatedReliable[index] )
+   {
+      return m_AccumulatedReliable[index] / m_SampleCount[index];
+   }
+   return 0.0;
+}
+
+
+double PE::CNormalisationBank::GetSampleCount(uint32_t index) const
+{
+   return m_SampleCount[index];
+}
+
+
+void PE::CNormalisationBank::Set(uint32_t index, const CNormalisation& normalisation)
+{
+   m_AccumulatedValue[index]    = normalisation.mAccumulatedValue;
+   m_AccumulatedMld[index]      = normalisation.mAccumulatedMld;
+   m_AccumulatedReliable[index] = normalisation.mAccumulatedReliable;
+   m_SampleCount[index]         = normalisation.mSampleCount;
+}
+
+
+CNormalisation PE::CNormalisationBank::Get(uint32_t index) const
+{
+   CNormalisation normalisation(m_AccumulatedValue[index], m_AccumulatedMld[index], m_AccumulatedReliable[index], m_SampleCount[index]);
+   normalisation.mMean     = GetMean(index);
+   normalisation.mMld      = GetMld(index);
+   normalisation.mReliable = GetReliable(index);
+   return normalisation;
+}
+
+
+uint32_t PE::CNormalisationBank::GetBlockLength(const uint32_t* indices, uint32_t count)
+{
+   const uint32_t limit = ( count < BLOCK_SIZE ) ? count : BLOCK_SIZE;
+
+   //ascending indices could not repeat, e.g. batch sorted by vehicle
+   uint32_t ascending = 1;
+   while ( ascending < limit && indices[ascending - 1] < indices[ascending] )
+   {
+      ++ascending;
+   }
+   if ( limit == ascending )
+   {
+      return limit;
+   }
+
+   //open addressing set of indices in the block, twice as big as the block
+   static const uint32_t SLOT_BITS = 7;
+   static const uint32_t EMPTY = std::numeric_limits<uint32_t>::max();
+   uint32_t slots[1 << SLOT_BITS];
+   for ( uint32_t i = 0; i < ( 1 << SLOT_BITS ); ++i )
+   {
+      slots[i] = EMPTY;
+   }
+
+   for ( uint32_t length = 0; length < limit; ++length )
+   {
+      const uint32_t index = indices[length];
+      uint32_t slot = ( index * 2654435761U ) >> ( 32 - SLOT_BITS );
+      while ( EMPTY != slots[slot] )
+      {
+         if ( index == slots[slot] )
+         {
+            return length;
+         }
+         slot = ( slot + 1 ) & ( ( 1 << SLOT_BITS ) - 1 );
+      }
+      slots[slot] = index;
+   }
+   return limit;
+}
+
+
+void PE::CNormalisationBank::AddBlock(const uint32_t* indices, const double* values, uint32_t count)
+{
+   SBlock block;
+   for ( uint32_t i = 0; i < count; ++i )
+   {
+      const uint32_t index = indices[i];
+      block.AccumulatedValue[i]    = m_AccumulatedValue[index];
+      block.AccumulatedMld[i]      = m_AccumulatedMld[index];
+      block.AccumulatedReliable[i] = m_AccumulatedReliable[index];
+      block.SampleCount[i]         = m_SampleCount[index];
+      block.Value[i]               = values[i];
+   }
+   //rest of the block is updated as unset normalisers and dropped
+   for ( uint32_t i = count; i < BLOCK_SIZE; ++i )
+   {
+      block.AccumulatedValue[i]    = 0.0;
+      block.AccumulatedMld[i]      = 0.0;
+      block.AccumulatedReliable[i] = 0.0;
+      block.SampleCount[i]         = 0.0;
+      block.Value[i]               = 0.0;
+   }
+
+   UpdateBlock(block);
+
+   for ( uint32_t i = 0; i < count; ++i )
+   {
+      const uint32_t index = indices[i];
+      m_AccumulatedValue[index]    = block.AccumulatedValue[i];
+      m_AccumulatedMld[index]      = block.AccumulatedMld[i];
+      m_AccumulatedReliable[index] = block.AccumulatedReliable[i];
+      m_SampleCount[index]         = block.SampleCount[i];
+   }
+}
+
+
+void PE::CNormalisationBank::UpdateBlock(SBlock& block)
+{
+   //same calculation like CNormalisation::AddSensor(), both branches are calculated and selected
+   for ( uint32_t i = 0; i < BLOCK_SIZE; ++i )
+   {
+      const double value = block.Value[i];
+      const bool isSet = ( 0.0 < block.SampleCount[i] ) & ( 0.0 <= block.AccumulatedReliable[i] );
+      const double sampleCount = isSet ? block.SampleCount[i] : 1.0;
+
+      const double oldMean = block.AccumulatedValue[i] / sampleCount;
+      const double accumulatedValue = block.AccumulatedValue[i] + value;
+      const double newSampleCount = sampleCount + 1.0;
+      const double mean = accumulatedValue / newSampleCount;
+      const double accumulatedMld = block.AccumulatedMld[i] + fabs( mean - value );
+      const double mld = accumulatedMld / sampleCount;
+      const double deltaMean = fabs( oldMean - mean );
+      const double reliable = ( 0.0 == mld ) ? 100.0 : ( ( deltaMean < mld ) ? 100 - deltaMean / mld * 100 : 0.0 );
+
+      block.AccumulatedMld[i]      = isSet ? accumulatedMld : 0.0;
+      block.AccumulatedReliable[i] = isSet ? block.AccumulatedReliable[i] + reliable : 0.0;
+      block.AccumulatedValue[i]    = isSet ? accumulatedValue : value;
+      block.SampleCount[i]         = isSet ? newSampleCount : 1.0;
+   }
+}
@@ -0,0 +1,321 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <math.h>
+#include <algorithm>
+#include "PECRobustNormalisation.h"
+
+
+using namespace PE;
+
+
+const uint32_t PE::CRobustNormalisation::DEFAULT_WINDOW_SIZE;
+const double   PE::CRobustNormalisation::MLD_FROM_MAD = 1.1829;
+
+
+PE::CRobustNormalisation::CRobustNormalisation(uint32_t windowSize)
+: m_WindowSize( ( 0 < windowSize ) ? windowSize : 1 )
+, m_Levels(1)
+, m_Position(0)
+, m_Count(0)
+, m_Random(2463534242U)
+, m_AccumulatedReliable(0.0)
+, m_Mean(0.0)
+, m_Mad(0.0)
+, m_Mld(0.0)
+, m_Reliable(0.0)
+, m_SampleCount(0.0)
+{
+   while ( m_Levels < 32 && ( 1U << m_Levels ) < m_WindowSize )
+   {
+      ++m_Levels;
+   }
+
+   //node 0 is the head, node m_WindowSize + 1 is the tail
+   const uint32_t nodeCount = m_WindowSize + 2;
+   const uint32_t tail = nodeCount - 1;
+   m_NodeValue.assign(nodeCount, 0.0);
+   m_NodeValue[tail] = std::numeric_limits<double>::infinity();
+   m_NodeHeight.assign(nodeCount, 0);
+   m_NodeHeight[0] = m_Levels;
+   m_Next.assign(nodeCount * m_Levels, tail);
+   m_Width.assign(nodeCount * m_Levels, 1);
+
+   m_Free.reserve(m_WindowSize);
+   for ( uint32_t node = tail - 1; node > 0; --node )
+   {
+      m_Free.push_back(node);
+   }
+   m_Window.assign(m_WindowSize, 0.0);
+   m_Contribution.assign(m_WindowSize, 0.0);
+}
+
+
+void PE::CRobustNormalisation::AddSensor(const double& value)
+{
+   if ( PE::isnan(value) )
+   {
+      return;
+   }
+   const double oldMean = m_Mean;
+   const bool isFirst = ( 0 == m_Count );
+
+   if ( m_WindowSize == m_Count )
+   {
+      Remove(m_Window[m_Position]);
+      m_AccumulatedReliable -= m_Contribution[m_Position];
+      --m_Count;
+   }
+   Insert(value);
+   m_Window[m_Position] = value;
+   ++m_Count;
+
+   m_Mean = CalculateMedian();
+   m_Mad = CalculateMad(m_Mean);
+   m_Mld = m_Mad * MLD_FROM_MAD;
+
+   double contribution = 0.0;
+   if ( false == isFirst )
+   {
+      if ( 0.0 == m_Mld )
+      {
+         contribution = 100;
+      }
+      else
+      {
+         double deltaMean = fabs( oldMean - m_Mean );
+         //If differences between new median and previouse median values less then mld then value increase reliability
+         if ( deltaMean < m_Mld )
+         {
+            contribution = 100 - deltaMean / m_Mld * 100;
+         }
+      }
+   }
+   m_Contribution[m_Position] = contribution;
+   m_AccumulatedReliable += contribution;
+
+   m_Position = ( m_Position + 1 ) % m_WindowSize;
+   if ( 0 == m_Position )
+   {
+      //window is full and turned over, sum it again to drop rounding errors of the running sum
+      m_AccumulatedReliable = 0.0;
+      for ( uint32_t i = 0; i < m_Count; ++i )
+      {
+         m_AccumulatedReliable += m_Contribution[i];
+      }
+   }
+
+   m_SampleCount = m_Count;
+   m_Reliable = m_AccumulatedReliable / m_SampleCount;
+}
+
+
+const double& PE::CRobustNormalisation::GetMean() const
+{
+   return m_Mean;
+}
+
+
+const double& PE::CRobustNormalisation::GetMld() const
+{
+   return m_Mld;
+}
+
+
+const double& PE::CRobustNormalisation::GetReliable() const
+{
+   return m_Reliable;
+}
+
+
+const double& PE::CRobustNormalisation::GetSampleCount() const
+{
+   return m_SampleCount;
+}
+
+
+const double& PE::CRobustNormalisation::GetMad() const
+{
+   return m_Mad;
+}
+
+
+uint32_t PE::CRobustNormalisation::GetWindowSize() const
+{
+   return m_WindowSize;
+}
+
+
+const double& PE::CRobustNormalisation::GetByRank(uint32_t rank) const
+{
+   uint32_t node = 0;
+   uint32_t steps = rank + 1;
+   for ( uint32_t level = m_Levels; level > 0; --level )
+   {
+      const uint32_t l = level - 1;
+      while ( m_Width[node * m_Levels + l] <= steps )
+      {
+         steps -= m_Width[node * m_Levels + l];
+         node = m_Next[node * m_Levels + l];
+      }
+   }
+   return m_NodeValue[node];
+}
+
+
+void PE::CRobustNormalisation::Insert(const double& value)
+{
+   uint32_t chain[32];
+   uint32_t stepsAtLevel[32];
+   uint32_t node = 0;
+   for ( uint32_t level = m_Levels; level > 0; --level )
+   {
+      const uint32_t l = level - 1;
+      stepsAtLevel[l] = 0;
+      while ( m_NodeValue[m_Next[node * m_Levels + l]] <= value )
+      {
+         stepsAtLevel[l] += m_Width[node * m_Levels + l];
+         node = m_Next[node * m_Levels + l];
+      }
+      chain[l] = node;
+   }
+
+   const uint32_t newNode = m_Free.back();
+   m_Free.pop_back();
+   const uint32_t height = GetRandomHeight();
+   m_NodeValue[newNode] = value;
+   m_NodeHeight[newNode] = height;
+
+   uint32_t steps = 0;
+   for ( uint32_t l = 0; l < height; ++l )
+   {
+      const uint32_t prev = chain[l] * m_Levels + l;
+      m_Next[newNode * m_Levels + l] = m_Next[prev];
+      m_Next[prev] = newNode;
+      m_Width[newNode * m_Levels + l] = m_Width[prev] - steps;
+      m_Width[prev] = steps + 1;
+      steps += stepsAtLevel[l];
+   }
+   for ( uint32_t l = height; l < m_Levels; ++l )
+   {
+      ++m_Width[chain[l] * m_Levels + l];
+   }
+}
+
+
+void PE::CRobustNormalisation::Remove(const double& value)
+{
+   uint32_t chain[32];
+   uint32_t node = 0;
+   for ( uint32_t level = m_Levels; level > 0; --level )
+   {
+      const uint32_t l = level - 1;
+      while ( m_NodeValue[m_Next[node * m_Levels + l]] < value )
+      {
+         node = m_Next[node * m_Levels + l];
+      }
+      chain[l] = node;
+   }
+
+   const uint32_t oldNode = m_Next[chain[0] * m_Levels];
+   const uint32_t height = m_NodeHeight[oldNode];
+   for ( uint32_t l = 0; l < height; ++l )
+   {
+      const uint32_t prev = chain[l] * m_Levels + l;
+      m_Width[prev] += m_Width[oldNode * m_Levels + l] - 1;
+      m_Next[prev] = m_Next[oldNode * m_Levels + l];
+   }
+   for ( uint32_t l = height; l < m_Levels; ++l )
+   {
+      --m_Width[chain[l] * m_Levels + l];
+   }
+   m_Free.push_back(oldNode);
+}
+
+
+uint32_t PE::CRobustNormalisation::GetRandomHeight()
+{
+   //xorshift32, heights have to be random only to keep the list balanced
+   m_Random ^= m_Random << 13;
+   m_Random ^= m_Random >> 17;
+   m_Random ^= m_Random << 5;
+   uint32_t bits = m_Random;
+   uint32_t height = 1;
+   while ( height < m_Levels && 0 != ( bits & 1 ) )
+   {
+      ++height;
+      bits >>= 1;
+   }
+   return height;
+}
+
+
+double PE::CRobustNormalisation::CalculateMedian() const
+{
+   const uint32_t half = m_Count / 2;
+   if ( 0 != ( m_Count % 2 ) )
+   {
+      return GetByRank(half);
+   }
+   return ( GetByRank(half - 1) + GetByRank(half) ) / 2.0;
+}
+
+
+double PE::CRobustNormalisation::CalculateMad(const double& median) const
+{
+   const uint32_t half = m_Count / 2;
+   if ( 0 != ( m_Count % 2 ) )
+   {
+      return GetDeviationByRank(median, half);
+   }
+   return ( GetDeviationByRank(median, half - 1) + GetDeviationByRank(median, half) ) / 2.0;
+}
+
+
+double PE::CRobustNormalisation::GetDeviationByRank(const double& median, uint32_t rank) const
+{
+   //below: values [0..split) deviations grow to the begin, above: values [split..count) deviations grow to the end
+   const uint32_t split = m_Count / 2;
+   const uint32_t belowCount = split;
+   const uint32_t aboveCount = m_Count - split;
+   const uint32_t taken = rank + 1;
+
+   //count of deviations taken from below, the rest is taken from above
+   uint32_t low = ( taken > aboveCount ) ? taken - aboveCount : 0;
+   uint32_t high = std::min(taken, belowCount);
+   while ( low < high )
+   {
+      const uint32_t below = ( low + high ) / 2;
+      const uint32_t above = taken - below;
+      if ( median - GetByRank(split - 1 - below) < GetByRank(split + above - 1) - median )
+      {
+         low = below + 1;
+      }
+      else
+      {
+         high = below;
+      }
+   }
+
+   double deviation = 0.0;
+   if ( 0 < low )
+   {
+      deviation = median - GetByRank(split - low);
+   }
+   if ( low < taken )
+   {
+      deviation = std::max(deviation, GetByRank(split + taken - low - 1) - median);
+   }
+   return deviation;
+}
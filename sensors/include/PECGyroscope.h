@@ -16,6 +16,9 @@
 
 #include "PETypes.h"
 #include "PECSensor.h"
+#include "PECRateEstimator.h"
+#include "PECRlsCalibration.h"
+#include "PECTemperatureCalibration.h"
 
 class PECGyroscopeTest; //to get possibility for test class
 
@@ -25,7 +28,10 @@ namespace PE
 /**
  * class for processing gyroscope sensors data
  *
+ * @tparam  TCalibration   calibration of base and scale: CCalibration, CRlsCalibration to follow drift
+ *                         or CTemperatureCalibration to take base and scale of the gyroscope temperature
  */
+template <typename TCalibration = CCalibration>
 class CGyroscope : public ISensorAdjuster
 {
 
@@ -34,6 +40,8 @@ class CGyroscope : public ISensorAdjuster
 public:
    /**
     * Constructor
+    *
+    * @param  calibration   initial state of calibration, e.g. CRlsCalibration with its forgetting factor
     */
    CGyroscope( const double& headInterval,
                const double& headHysteresis,
@@ -43,7 +51,20 @@ public:
                const double& gyroInterval,
                const double& gyroHysteresis,
                const double& gyroMin,
-               const double& gyroMax);
+               const double& gyroMax,
+               const TCalibration& calibration = TCalibration());
+   /**
+    * Constructor with automatic detection of heading and gyroscope rates.
+    * Samples are rejected till the rate of the sensor is detected.
+    *
+    * @param  calibration   initial state of calibration, e.g. CTemperatureCalibration with restored bins
+    */
+   CGyroscope( const double& headMin,
+               const double& headMax,
+               const double& headAccuracyRatio,
+               const double& gyroMin,
+               const double& gyroMax,
+               const TCalibration& calibration = TCalibration());
    /**
     * Adds new reference heading
     * @return true if reference data was accepted
@@ -62,6 +83,17 @@ public:
     * @param  isValid   True if sensors data is valid
     */
    bool AddGyro(const double& ts, const double& gyro, bool isValid );
+   /**
+    * Adds new gyroscope sensor value with temperature of the sensor
+    * @return true if sensor data was accepted
+    *
+    * @param  ts            Timestamp of gyro sensor value [s]
+    * @param  gyro          Gyroscope angular velicity in [units/s]
+    * @param  isValid       True if sensors data is valid
+    * @param  temperature   Temperature of the gyroscope in [C], NaN if unknown,
+    *                       it is considered only with temperature calibration
+    */
+   bool AddGyro(const double& ts, const double& gyro, bool isValid, const double& temperature );
    /**
     * Returns timestamp of last successfully added gyroscope sensor value.
     *         It is undefined if last AddGyro() call was unsuccessful
@@ -95,6 +127,31 @@ public:
     * @return  base calibration status in %
     */
    const double& CalibratedTo() const;
+   /**
+    * Returns rate estimator of reference heading
+    * @return   heading rate estimator
+    */
+   const CRateEstimator& HeadingRate() const;
+   /**
+    * Returns rate estimator of gyroscope sensor
+    * @return   gyroscope rate estimator
+    */
+   const CRateEstimator& GyroRate() const;
+   /**
+    * Returns count of calibration resets which were avoided by detected rates
+    * @return   count of avoided resets
+    */
+   uint32_t AvoidedResets() const;
+   /**
+    * Returns counters of accepted and rejected values by reason, resets and calibration steps
+    * @return   counters since creation
+    */
+   const SSensorStats& Stats() const;
+   /**
+    * Returns calibration of the gyroscope, e.g. to store bins of CTemperatureCalibration
+    * @return   calibration service
+    */
+   const TCalibration& Calibration() const;
 
 public:
    /**************************************************************************************
@@ -142,7 +199,7 @@ private:
    /**
     * Service for processing sensors data
     */
-   CSensor m_sensor;
+   CSensor<TCalibration> m_sensor;
    /**
     * Last reference heading value in [deg]
     */
@@ -167,22 +224,35 @@ private:
     * Last gyroscope angular velocity adjusted to reference timestamp [unit/s]
     */
    double m_gyroAngularVelocity;
+   /**
+    * Interval checking of reference heading
+    */
+   CRateEstimator m_headRate;
+   /**
+    * Interval checking of gyroscope sensor
+    */
+   CRateEstimator m_gyroRate;
 private:
    /**************************************************************************************
     * Constant operation limits
     **************************************************************************************/
 
-   const double m_headInterval;
-   const double m_headHysteresis;
    const double m_headMin;
    const double m_headMax;
    const double m_headAccuracyRatio;
-   const double m_gyroInterval;
-   const double m_gyroHysteresis;
    const double m_gyroMin;
    const double m_gyroMax;
 };
 
+/**
+ * Temperature calibration takes base and scale of the bin of last gyroscope temperature
+ */
+template <> bool CGyroscope<CTemperatureCalibration>::AddGyro(const double& ts, const double& gyro, bool isValid, const double& temperature );
+template <> const double CGyroscope<CTemperatureCalibration>::Accuracy() const;
+template <> const double& CGyroscope<CTemperatureCalibration>::Base() const;
+template <> const double& CGyroscope<CTemperatureCalibration>::Scale() const;
+template <> const double& CGyroscope<CTemperatureCalibration>::CalibratedTo() const;
+
 } //namespace PE
 
 #endif //__PE_CGyroscope_H__
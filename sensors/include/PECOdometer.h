@@ -17,6 +17,7 @@
 #include "PETypes.h"
 #include "PECNormalisation.h"
 #include "PECCalibration.h"
+#include "PECRateEstimator.h"
 
 class PECOdometerTest; //to get possibility for test class
 
@@ -47,6 +48,16 @@ public:
     * @param  speedAccuracyRatio   consider the reference speed only when value is more then accuracy by this ratio. For instance ration 5 means that value is 5 times bigger then accuracy.
     */
    bool Init(const double& odoInterval, const double& speedInterval, const double& biasLimit, const double& scaleLimit, const uint32_t speedAccuracyRatio);
+   /**
+    * Initialized odomer object with automatic detection of odometer and reference speed intervals.
+    * Samples are rejected till the rate of the sensor is detected.
+    * @return   true if init process was done successfully
+    *
+    * @param  biasLimit       base calibartion limit in %
+    * @param  scaleLimit      scale calibartion limit in %
+    * @param  speedAccuracyRatio   consider the reference speed only when value is more then accuracy by this ratio. For instance ration 5 means that value is 5 times bigger then accuracy.
+    */
+   bool Init(const double& biasLimit, const double& scaleLimit, const uint32_t speedAccuracyRatio);
    /**
     * Adds new reference speed
     *
@@ -110,13 +121,13 @@ private:
     */
    bool m_isInitOk;
    /**
-    * Odometer sensors interval in seconds
+    * Odometer sensors interval checking
     */
-   double m_odoInterval;
+   CRateEstimator m_odoRate;
    /**
-    * Reference speed interval in seconds
+    * Reference speed interval checking
     */
-   double m_speedInterval;
+   CRateEstimator m_speedRate;
    /**
     * Base calibartion limit in %
     */
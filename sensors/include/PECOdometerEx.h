@@ -16,6 +16,8 @@
 
 #include "PETypes.h"
 #include "PECSensor.h"
+#include "PECRateEstimator.h"
+#include "PECRlsCalibration.h"
 
 class PECOdometerExTest; //to get possibility for test class
 
@@ -25,7 +27,9 @@ namespace PE
 /**
  * class for processing odometers data
  *
+ * @tparam  TCalibration   calibration of base and scale: CCalibration or CRlsCalibration to follow drift
  */
+template <typename TCalibration = CCalibration>
 class COdometerEx : public ISensorAdjuster
 {
 
@@ -34,6 +38,8 @@ friend class ::PECOdometerExTest;
 public:
    /**
     * Constructor
+    *
+    * @param  calibration   initial state of calibration, e.g. CRlsCalibration with its forgetting factor
     */
    COdometerEx( const double& speedInterval,
                 const double& speedHysteresis,
@@ -43,7 +49,20 @@ public:
                 const double& odoInterval,
                 const double& odoHysteresis,
                 const double& odoMin,
-                const double& odoMax);
+                const double& odoMax,
+                const TCalibration& calibration = TCalibration());
+   /**
+    * Constructor with automatic detection of speed and odometer rates.
+    * Samples are rejected till the rate of the sensor is detected.
+    *
+    * @param  calibration   initial state of calibration
+    */
+   COdometerEx( const double& speedMin,
+                const double& speedMax,
+                const double& speedAccuracyRatio,
+                const double& odoMin,
+                const double& odoMax,
+                const TCalibration& calibration = TCalibration());
    /**
     * Constructor
     */
@@ -99,6 +118,26 @@ public:
     * @return base calibration status in %
     */
    const double& CalibratedTo() const;
+   /**
+    * Returns rate estimator of reference speed
+    * @return   speed rate estimator
+    */
+   const CRateEstimator& SpeedRate() const;
+   /**
+    * Returns rate estimator of odometer ticks
+    * @return   odometer rate estimator
+    */
+   const CRateEstimator& TicksRate() const;
+   /**
+    * Returns count of calibration resets which were avoided by detected rates
+    * @return   count of avoided resets
+    */
+   uint32_t AvoidedResets() const;
+   /**
+    * Returns counters of accepted and rejected values by reason, resets and calibration steps
+    * @return   counters since creation
+    */
+   const SSensorStats& Stats() const;
 
 public:
    /**************************************************************************************
@@ -144,7 +183,7 @@ private:
    /**
     * Service for processing sensors data
     */
-   CSensor m_sensor;
+   CSensor<TCalibration> m_sensor;
    /**
     * Last reference speed [m/s]
     */
@@ -165,6 +204,14 @@ private:
     * Last odometer linear velocity adjusted to reference timestamp [ticks/s]
     */
    double m_odoLinearVelocity;
+   /**
+    * Interval checking of reference speed
+    */
+   CRateEstimator m_speedRate;
+   /**
+    * Interval checking of odometer ticks
+    */
+   CRateEstimator m_odoRate;
 
    
 private:
@@ -172,13 +219,9 @@ private:
     * Constant operation limits
     **************************************************************************************/
 
-   const double m_speedInterval;
-   const double m_speedHysteresis;
    const double m_speedMin;
    const double m_speedMax;
    const double m_speedAccuracyRatio;
-   const double m_odoInterval;
-   const double m_odoHysteresis;
    const double m_odoMin;
    const double m_odoMax;
 };
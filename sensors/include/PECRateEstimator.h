@@ -0,0 +1,205 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CRateEstimator_H__
+#define __PE_CRateEstimator_H__
+
+#include "PETypes.h"
+
+class PECRateEstimatorTest; //to get possibility for test class
+
+namespace PE
+{
+
+/**
+ * class for detecting sample rate of the sensor and checking intervals between samples
+ *
+ * Works in one of three modes:
+ *  - fixed:    interval and hysteresis are given and never changed
+ *  - seeded:   interval and hysteresis are given as start values and are replaced by detected ones
+ *  - auto:     nothing is known, all intervals are rejected until the rate is detected
+ *
+ * Rate detection is done by streaming histogram of the intervals with logarithmic bins.
+ * As soon as enough intervals are collected and most of them are concentrated around one bin
+ * the estimator locks onto this rate. After that interval and hysteresis follow the real
+ * intervals of the sensor (mean and mean linear deviation).
+ */
+class CRateEstimator
+{
+   friend class ::PECRateEstimatorTest;
+
+public:
+   /**
+    * Constructor of auto detection mode
+    */
+   CRateEstimator();
+   /**
+    * Constructor of fixed or seeded mode
+    *
+    * @param  interval     expected interval in [s]
+    * @param  hysteresis   expected hysteresis of the interval in [s]
+    * @param  isAdaptive   true if interval and hysteresis have to be adapted to detected rate
+    */
+   CRateEstimator(const double& interval, const double& hysteresis, bool isAdaptive = false);
+   /**
+    * Adds new interval between two samples into the rate detection
+    *
+    * @param  deltaTs   interval between two samples in [s]
+    */
+   void AddInterval(const double& deltaTs);
+   /**
+    * Checks if interval fits to the current acceptance band
+    * @return   true if interval passed the checking
+    *
+    * @param  deltaTs   interval between two samples in [s]
+    */
+   bool IsIntervalOk(const double& deltaTs) const;
+   /**
+    * Returns true if estimator is locked to the detected rate or it works in fixed mode
+    */
+   bool IsLocked() const;
+   /**
+    * Returns current interval of acceptance band in [s], zero if unknown
+    */
+   const double& GetInterval() const;
+   /**
+    * Returns current hysteresis of acceptance band in [s], zero if unknown
+    */
+   const double& GetHysteresis() const;
+   /**
+    * Returns count of intervals which are accepted by detected band but would be rejected by
+    * nominal band (given one or band at the first lock). Each of them would reset calibration.
+    */
+   const uint32_t& GetAvoidedResets() const;
+
+private:
+   /**
+    * Smallest detected interval in [s]
+    */
+   static const double   MIN_INTERVAL;
+   /**
+    * Ratio between borders of two neighbouring bins
+    */
+   static const double   BIN_RATIO;
+   /**
+    * Count of bins, covers intervals MIN_INTERVAL .. MIN_INTERVAL * BIN_RATIO ^ BIN_COUNT
+    */
+   static const uint32_t BIN_COUNT = 512;
+   /**
+    * Half width of the lock window in bins
+    */
+   static const uint32_t LOCK_WINDOW = 6;
+   /**
+    * Minimal count of intervals before first lock
+    */
+   static const uint32_t LOCK_SAMPLES = 16;
+   /**
+    * Minimal share of intervals inside of lock window
+    */
+   static const double   LOCK_SHARE;
+   /**
+    * Minimal hysteresis as ratio of the interval
+    */
+   static const double   MIN_HYSTERESIS_RATIO;
+   /**
+    * Hysteresis as multiple of mean linear deviation of intervals
+    */
+   static const double   MLD_HYSTERESIS_FACTOR;
+   /**
+    * Window of averaging of the interval and its deviation after lock
+    */
+   static const uint32_t TRACKING_WINDOW = 64;
+
+   /**
+    * True if interval and hysteresis are adapted to detected rate
+    */
+   bool m_IsAdaptive;
+   /**
+    * True if estimator is locked to the rate
+    */
+   bool m_IsLocked;
+   /**
+    * True if nominal band is known
+    */
+   bool m_HasNominal;
+   /**
+    * Nominal interval in [s]
+    */
+   double m_NominalInterval;
+   /**
+    * Nominal hysteresis in [s]
+    */
+   double m_NominalHysteresis;
+   /**
+    * Current interval in [s]
+    */
+   double m_Interval;
+   /**
+    * Current hysteresis in [s]
+    */
+   double m_Hysteresis;
+   /**
+    * Mean linear deviation of accepted intervals in [s]
+    */
+   double m_Mld;
+   /**
+    * Count of tracked intervals since lock (limited by TRACKING_WINDOW)
+    */
+   uint32_t m_Tracked;
+   /**
+    * Count of rejected intervals in a row since lock
+    */
+   uint32_t m_Rejected;
+   /**
+    * Count of avoided resets
+    */
+   uint32_t m_AvoidedResets;
+   /**
+    * Count of intervals in the histogram
+    */
+   uint32_t m_Samples;
+   /**
+    * Histogram of the intervals
+    */
+   uint16_t m_Histogram[BIN_COUNT];
+
+   /**
+    * Returns bin index of the interval or BIN_COUNT if it is out of histogram
+    */
+   uint32_t ToBin(const double& deltaTs) const;
+   /**
+    * Returns interval of the bin position in [s], integer position is lower border of the bin
+    */
+   double FromBin(const double& bin) const;
+   /**
+    * Tries to lock onto the rate
+    * @return   true if lock was done
+    */
+   bool TryLock();
+   /**
+    * Updates interval and hysteresis by the accepted interval
+    */
+   void Track(const double& deltaTs);
+   /**
+    * Counts interval if it is accepted by current band but rejected by nominal one
+    */
+   void CountAvoidedReset(const double& deltaTs);
+   /**
+    * Cleans histogram and starts detection from the beginning
+    */
+   void Unlock();
+};
+
+} //namespace PE
+
+#endif //__PE_CRateEstimator_H__
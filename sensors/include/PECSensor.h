@@ -17,6 +17,7 @@
 #include "PETypes.h"
 #include "PECNormalisation.h"
 #include "PECCalibration.h"
+#include "PESSensorStats.h"
 
 
 namespace PE
@@ -70,16 +71,23 @@ public:
 /**
  * class for processing sensors data
  *
+ * @tparam  TCalibration     calibration of bias and scale: CCalibration, CRlsCalibration or CTemperatureCalibration
+ * @tparam  TNormalisation   normalisation of bias and scale, by default the one which fits to the calibration
  */
+template <typename TCalibration = CCalibration, typename TNormalisation = typename TCalibration::TNormalisation>
 class CSensor
 {
 public:
    /**
     * Constructor
     *
-    * @param  adjuster   Reference to the adjuster instance
+    * @param  adjuster        Reference to the adjuster instance
+    * @param  calibration     Initial state of calibration, e.g. CRlsCalibration with its forgetting factor
+    * @param  normalisation   Initial state of normalisation of bias and of scale, e.g. CRobustNormalisation with its window size
     */
-   explicit CSensor(ISensorAdjuster& adjuster);
+   explicit CSensor( ISensorAdjuster& adjuster,
+                     const TCalibration& calibration = TCalibration(),
+                     const TNormalisation& normalisation = TNormalisation() );
    /**
     * Adds new reference data
     * @return true if reference data was accepted
@@ -107,15 +115,35 @@ public:
     */
    const double& GetSenTimeStamp() const;
    /**
-    * @return   Sensor normalisation service for bias
+    * @return   Sensor normalisation service for bias, it stays empty with CTemperatureCalibration
+    *           which normalises bias of each temperature bin itself
     */
-   const CNormalisation& GetBias() const;
+   const TNormalisation& GetBias() const;
    /**
-    * @return   Sensor normalisation service for scale
+    * @return   Sensor normalisation service for scale, it stays empty with CTemperatureCalibration
     */
-   const CNormalisation& GetScale() const;
+   const TNormalisation& GetScale() const;
+   /**
+    * @return   Sensor calibration service
+    */
+   const TCalibration& GetCalibration() const;
+   /**
+    * @return   Sensor calibration service, e.g. to set temperature of CTemperatureCalibration
+    */
+   TCalibration& GetCalibration();
+   /**
+    * Returns counters of accepted and rejected values
+    */
+   const SSensorStats& GetStats() const;
+   /**
+    * Returns counters of accepted and rejected values to be updated by sensor adjuster
+    */
+   SSensorStats& GetStats();
 
 private:
+   CSensor(const CSensor&);
+   CSensor& operator=(const CSensor&);
+
    /**
     * Rference to sensor adjuster instance
     */
@@ -131,19 +159,27 @@ private:
    /**
     * Sensor calibration service
     */
-   CCalibration m_Calibration;
+   TCalibration m_Calibration;
    /**
     * Sensor normalisation service for bias
     */
-   CNormalisation m_SenBias;
+   TNormalisation m_SenBias;
    /**
     * Sensor normalisation service for scale
     */
-   CNormalisation m_SenScale;
+   TNormalisation m_SenScale;
+   /**
+    * Counters of accepted and rejected values
+    */
+   SSensorStats m_Stats;
    /**
     * Resets uncomplited calibration in case some inconsistency during current sensors processing
     */
    void ResetUncomplitedProcessing();
+   /**
+    * Injects bias and scale of last calibration step into normalisation stuff
+    */
+   void Normalise();
    /**
     * Inject new bias into normalisation stuff
     *
@@ -0,0 +1,90 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_SSensorStats_H__
+#define __PE_SSensorStats_H__
+
+#include "PETypes.h"
+
+namespace PE
+{
+   /**
+    * Counters of accepted and rejected reference/sensor values of one sensor, by reason.
+    * Counters are plain increments of the thread which adds the values, all of them share one cache line.
+    * The struct is aligned to the cache line, so it does not straddle two lines inside of its owner.
+    */
+   struct alignas(64) SSensorStats
+   {
+      /**
+       * Constructor
+       */
+      SSensorStats()
+         : RefAccepted(0)
+         , RefOutOfRange(0)
+         , RefInterval(0)
+         , RefInaccurate(0)
+         , SenAccepted(0)
+         , SenInvalid(0)
+         , SenOutOfRange(0)
+         , SenInterval(0)
+         , Steps(0)
+         , Resets(0)
+      {
+      }
+      /**
+       * Reference values which passed all checkings
+       */
+      uint32_t RefAccepted;
+      /**
+       * Reference values rejected because value is out of range
+       */
+      uint32_t RefOutOfRange;
+      /**
+       * Reference values rejected because interval to previous one is not expected
+       */
+      uint32_t RefInterval;
+      /**
+       * Accepted reference values not used for calibration because change is less than its accuracy
+       */
+      uint32_t RefInaccurate;
+      /**
+       * Sensor values which passed all checkings
+       */
+      uint32_t SenAccepted;
+      /**
+       * Sensor values rejected because they are marked invalid
+       */
+      uint32_t SenInvalid;
+      /**
+       * Sensor values rejected because value is out of range
+       */
+      uint32_t SenOutOfRange;
+      /**
+       * Sensor values rejected because interval to previous one is not expected
+       */
+      uint32_t SenInterval;
+      /**
+       * Calibration steps built of reference and sensor values
+       */
+      uint32_t Steps;
+      /**
+       * Resets of uncompleted calibration step caused by rejected values
+       */
+      uint32_t Resets;
+   };
+
+   static_assert(64 == sizeof(SSensorStats) && 64 == alignof(SSensorStats), "sensor statistics have to fill one cache line");
+
+} //namespace PE
+
+#endif //__PE_SSensorStats_H__
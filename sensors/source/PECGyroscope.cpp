@@ -21,90 +21,169 @@
 using namespace PE;
 
 
-PE::CGyroscope::CGyroscope( const double& headInterval,
-                            const double& headHysteresis,
-                            const double& headMin,
-                            const double& headMax,
-                            const double& headAccuracyRatio,
-                            const double& gyroInterval,
-                            const double& gyroHysteresis,
-                            const double& gyroMin,
-                            const double& gyroMax)
-: m_sensor(*this)
+template <typename TCalibration>
+PE::CGyroscope<TCalibration>::CGyroscope( const double& headInterval,
+                                          const double& headHysteresis,
+                                          const double& headMin,
+                                          const double& headMax,
+                                          const double& headAccuracyRatio,
+                                          const double& gyroInterval,
+                                          const double& gyroHysteresis,
+                                          const double& gyroMin,
+                                          const double& gyroMax,
+                                          const TCalibration& calibration)
+: m_sensor(*this, calibration)
 , m_headValue(std::numeric_limits<double>::quiet_NaN())
 , m_headAccuracy(std::numeric_limits<double>::quiet_NaN())
 , m_headAngularVelocity(std::numeric_limits<double>::quiet_NaN())
 , m_gyroValue(std::numeric_limits<double>::quiet_NaN())
 , m_gyroValid(false)
 , m_gyroAngularVelocity(std::numeric_limits<double>::quiet_NaN())
-, m_headInterval(headInterval)
-, m_headHysteresis(headHysteresis)
+, m_headRate(headInterval, headHysteresis)
+, m_gyroRate(gyroInterval, gyroHysteresis)
 , m_headMin(headMin)
 , m_headMax(headMax)
 , m_headAccuracyRatio(headAccuracyRatio)
-, m_gyroInterval(gyroInterval)
-, m_gyroHysteresis(gyroHysteresis)
 , m_gyroMin(gyroMin)
 , m_gyroMax(gyroMax)
 {
 }
 
 
-bool PE::CGyroscope::AddHeading(const double& ts, const double& head, const double& acc)
+template <typename TCalibration>
+PE::CGyroscope<TCalibration>::CGyroscope( const double& headMin,
+                                          const double& headMax,
+                                          const double& headAccuracyRatio,
+                                          const double& gyroMin,
+                                          const double& gyroMax,
+                                          const TCalibration& calibration)
+: m_sensor(*this, calibration)
+, m_headValue(std::numeric_limits<double>::quiet_NaN())
+, m_headAccuracy(std::numeric_limits<double>::quiet_NaN())
+, m_headAngularVelocity(std::numeric_limits<double>::quiet_NaN())
+, m_gyroValue(std::numeric_limits<double>::quiet_NaN())
+, m_gyroValid(false)
+, m_gyroAngularVelocity(std::numeric_limits<double>::quiet_NaN())
+, m_headRate()
+, m_gyroRate()
+, m_headMin(headMin)
+, m_headMax(headMax)
+, m_headAccuracyRatio(headAccuracyRatio)
+, m_gyroMin(gyroMin)
+, m_gyroMax(gyroMax)
+{
+}
+
+
+template <typename TCalibration>
+bool PE::CGyroscope<TCalibration>::AddHeading(const double& ts, const double& head, const double& acc)
 {
    return m_sensor.AddRef(ts, head, acc);
 }
 
 
-bool PE::CGyroscope::AddGyro(const double& ts, const double& gyro, bool isValid )
+template <typename TCalibration>
+bool PE::CGyroscope<TCalibration>::AddGyro(const double& ts, const double& gyro, bool isValid )
+{
+   return m_sensor.AddSen(ts, gyro, isValid);
+}
+
+
+template <typename TCalibration>
+bool PE::CGyroscope<TCalibration>::AddGyro(const double& ts, const double& gyro, bool isValid, const double& )
 {
+   //temperature is considered only by temperature calibration
    return m_sensor.AddSen(ts, gyro, isValid);
 }
 
 
-const double& PE::CGyroscope::TimeStamp() const
+template <typename TCalibration>
+const double& PE::CGyroscope<TCalibration>::TimeStamp() const
 {
    return m_sensor.GetSenTimeStamp();
 }
 
 
-const double PE::CGyroscope::Value() const
+template <typename TCalibration>
+const double PE::CGyroscope<TCalibration>::Value() const
 {
-   return m_sensor.GetScale().GetMean() * ( m_gyroValue - m_sensor.GetBias().GetMean()); //value = scale * (gyro - bias)
+   return Scale() * ( m_gyroValue - Base()); //value = scale * (gyro - bias)
 }
 
 
-const double PE::CGyroscope::Accuracy() const
+template <typename TCalibration>
+const double PE::CGyroscope<TCalibration>::Accuracy() const
 {
    return m_sensor.GetBias().GetMld() * ( fabs(m_sensor.GetScale().GetMean()) + m_sensor.GetScale().GetMld() ); // accuracy = bias_mld * (|scale| + scale_mld)
 }
 
 
-const double& PE::CGyroscope::Base() const
+template <typename TCalibration>
+const double& PE::CGyroscope<TCalibration>::Base() const
 {
    return m_sensor.GetBias().GetMean();
 }
 
 
-const double& PE::CGyroscope::Scale() const
+template <typename TCalibration>
+const double& PE::CGyroscope<TCalibration>::Scale() const
 {
    return m_sensor.GetScale().GetMean();
 }
 
 
-const double& PE::CGyroscope::CalibratedTo() const
+template <typename TCalibration>
+const double& PE::CGyroscope<TCalibration>::CalibratedTo() const
 {
    return m_sensor.GetBias().GetReliable(); //consider only calibration status of the base of gyro
 }
 
 
-bool PE::CGyroscope::SetRefValue(const double& oldHeadTS, const double& newHeadTS, const double& head, const double& acc)
+template <typename TCalibration>
+const CRateEstimator& PE::CGyroscope<TCalibration>::HeadingRate() const
+{
+   return m_headRate;
+}
+
+
+template <typename TCalibration>
+const CRateEstimator& PE::CGyroscope<TCalibration>::GyroRate() const
+{
+   return m_gyroRate;
+}
+
+
+template <typename TCalibration>
+uint32_t PE::CGyroscope<TCalibration>::AvoidedResets() const
+{
+   return m_headRate.GetAvoidedResets() + m_gyroRate.GetAvoidedResets();
+}
+
+
+template <typename TCalibration>
+const SSensorStats& PE::CGyroscope<TCalibration>::Stats() const
+{
+   return m_sensor.GetStats();
+}
+
+
+template <typename TCalibration>
+const TCalibration& PE::CGyroscope<TCalibration>::Calibration() const
 {
+   return m_sensor.GetCalibration();
+}
+
+
+template <typename TCalibration>
+bool PE::CGyroscope<TCalibration>::SetRefValue(const double& oldHeadTS, const double& newHeadTS, const double& head, const double& acc)
+{
+   SSensorStats& stats = m_sensor.GetStats();
    m_headAngularVelocity = std::numeric_limits<double>::quiet_NaN();
    if ( PE::Sensor::IsInRange(head, m_headMin, m_headMax) )
    {
       double deltaTS = newHeadTS - oldHeadTS;
-      if ( PE::Sensor::IsIntervalOk(deltaTS, m_headInterval, m_headHysteresis) )
+      m_headRate.AddInterval(deltaTS);
+      if ( m_headRate.IsIntervalOk(deltaTS) )
       {
          if ( false == PE::isnan(m_headValue) )
          {
@@ -114,32 +193,46 @@ bool PE::CGyroscope::SetRefValue(const double& oldHeadTS, const double& newHeadT
             {
                m_headAngularVelocity = angle / deltaTS;
             }
+            else
+            {
+               ++stats.RefInaccurate;
+            }
          }
          m_headValue    = head;
          m_headAccuracy = acc;
+         ++stats.RefAccepted;
          return true;
       }
+      ++stats.RefInterval;
+   }
+   else
+   {
+      ++stats.RefOutOfRange;
    }
    m_headValue = std::numeric_limits<double>::quiet_NaN();
    return false;
 }
 
 
-const double& PE::CGyroscope::GetRefValue() const
+template <typename TCalibration>
+const double& PE::CGyroscope<TCalibration>::GetRefValue() const
 {
    return m_headAngularVelocity;
 }
 
 
-bool PE::CGyroscope::SetSenValue(const double& oldHeadTS, const double& oldGyroTS, const double& newGyroTS, const double& gyro, bool IsValid)
+template <typename TCalibration>
+bool PE::CGyroscope<TCalibration>::SetSenValue(const double& oldHeadTS, const double& oldGyroTS, const double& newGyroTS, const double& gyro, bool IsValid)
 {
+   SSensorStats& stats = m_sensor.GetStats();
    m_gyroAngularVelocity = std::numeric_limits<double>::quiet_NaN();
    if ( IsValid )
    {
       if ( PE::Sensor::IsInRange(gyro, m_gyroMin, m_gyroMax) )
       {
          double deltaTS = newGyroTS - oldGyroTS;
-         if ( PE::Sensor::IsIntervalOk(deltaTS, m_gyroInterval, m_gyroHysteresis) )
+         m_gyroRate.AddInterval(deltaTS);
+         if ( m_gyroRate.IsIntervalOk(deltaTS) )
          {
             if ( m_gyroValid )
             {
@@ -147,16 +240,70 @@ bool PE::CGyroscope::SetSenValue(const double& oldHeadTS, const double& oldGyroT
             }
             m_gyroValue = gyro;
             m_gyroValid = true;
+            ++stats.SenAccepted;
             return true;
          }
+         ++stats.SenInterval;
+      }
+      else
+      {
+         ++stats.SenOutOfRange;
       }
    }
+   else
+   {
+      ++stats.SenInvalid;
+   }
    m_gyroValid = false;
    return false;
 }
 
 
-const double& PE::CGyroscope::GetSenValue() const
+template <typename TCalibration>
+const double& PE::CGyroscope<TCalibration>::GetSenValue() const
 {
    return m_gyroAngularVelocity;
 }
+
+
+template <>
+bool PE::CGyroscope<CTemperatureCalibration>::AddGyro(const double& ts, const double& gyro, bool isValid, const double& temperature )
+{
+   m_sensor.GetCalibration().SetTemperature(temperature);
+   return m_sensor.AddSen(ts, gyro, isValid);
+}
+
+
+template <>
+const double PE::CGyroscope<CTemperatureCalibration>::Accuracy() const
+{
+   const CTemperatureCalibration& calibration = m_sensor.GetCalibration();
+   return calibration.GetBiasMld() * ( fabs(calibration.GetScale()) + calibration.GetScaleMld() );
+}
+
+
+template <>
+const double& PE::CGyroscope<CTemperatureCalibration>::Base() const
+{
+   return m_sensor.GetCalibration().GetBias();
+}
+
+
+template <>
+const double& PE::CGyroscope<CTemperatureCalibration>::Scale() const
+{
+   return m_sensor.GetCalibration().GetScale();
+}
+
+
+template <>
+const double& PE::CGyroscope<CTemperatureCalibration>::CalibratedTo() const
+{
+   return m_sensor.GetCalibration().GetReliable();
+}
+
+
+//calibrations which could be used by gyroscope
+template class PE::CGyroscope<PE::CCalibration>;
+template class PE::CGyroscope<PE::CRlsCalibration>;
+template class PE::CGyroscope<PE::CTemperatureCalibration>;
@@ -21,8 +21,8 @@ using namespace PE;
 
 PE::COdometer::COdometer()
 : m_isInitOk(false)
-, m_odoInterval(0)
-, m_speedInterval(0)
+, m_odoRate(0, 0)
+, m_speedRate(0, 0)
 , m_biasLimit(0)
 , m_scaleLimit(0)
 , m_speedAccuracyRatio(0)
@@ -47,8 +47,8 @@ bool PE::COdometer::Init(const double& odoInterval, const double& speedInterval,
                if ( 0 < speedAccuracyRatio ) //ration has to be bigger then 0
                {
                   m_isInitOk = true;
-                  m_odoInterval = odoInterval;
-                  m_speedInterval = speedInterval;
+                  m_odoRate = CRateEstimator(odoInterval, odoInterval / 20); //hysteresis 5% - has to be adjusted
+                  m_speedRate = CRateEstimator(speedInterval, speedInterval / 10); //hysteresis 10% - has to be adjusted
                   m_biasLimit = biasLimit;
                   m_scaleLimit = scaleLimit;
                   m_speedAccuracyRatio = speedAccuracyRatio;
@@ -62,6 +62,28 @@ bool PE::COdometer::Init(const double& odoInterval, const double& speedInterval,
 }
 
 
+bool PE::COdometer::Init(const double& biasLimit, const double& scaleLimit, const uint32_t speedAccuracyRatio)
+{
+   if ( PE::EPSILON < biasLimit ) //bias limit has to be bigger then zero
+   {
+      if ( PE::EPSILON < scaleLimit ) //scale limit has to be bigger then zero
+      {
+         if ( 0 < speedAccuracyRatio ) //ration has to be bigger then 0
+         {
+            m_isInitOk = true;
+            m_odoRate = CRateEstimator();
+            m_speedRate = CRateEstimator();
+            m_biasLimit = biasLimit;
+            m_scaleLimit = scaleLimit;
+            m_speedAccuracyRatio = speedAccuracyRatio;
+            return true;
+         }
+      }
+   }
+   return false;
+}
+
+
 void PE::COdometer::AddSpeed(const double& ts, const double& speed, const double& acc)
 {
    if ( false == m_isInitOk )
@@ -75,6 +97,7 @@ void PE::COdometer::AddSpeed(const double& ts, const double& speed, const double
    else
    {
       double deltatime = ts - m_SpeedTs;
+      m_speedRate.AddInterval(deltatime);
       if ( true == IsSpeedOk(deltatime, speed, acc) )
       {
          m_Speed = speed;
@@ -103,6 +126,7 @@ void PE::COdometer::AddOdo(const double& ts, const double& ticks, bool IsValid )
       else
       {
          double deltatime = ts - m_OdoTs;
+         m_odoRate.AddInterval(deltatime);
          if ( true == IsOdoOk(deltatime, ticks, IsValid) )
          {
             double currentOdoTickSpeed = ticks / deltatime;
@@ -213,7 +237,7 @@ bool PE::COdometer::IsSpeedOk( const double& deltaTs, const double& speed, const
 {
    if ( PE::EPSILON < speed ) //speed has to be always more then zero
    {
-      if ( true == PE::Sensor::IsIntervalOk(deltaTs, m_speedInterval, m_speedInterval / 10) ) //hysteresis 10% - has to be adjusted
+      if ( true == m_speedRate.IsIntervalOk(deltaTs) )
       {
          return PE::Sensor::IsAccuracyOk(speed, acc, m_speedAccuracyRatio);
       }
@@ -228,7 +252,7 @@ bool PE::COdometer::IsOdoOk(const double& deltaTs, const double& ticks, bool IsV
    {
       if ( PE::EPSILON < ticks )
       {
-         return PE::Sensor::IsIntervalOk(deltaTs, m_odoInterval, m_odoInterval / 20); //hysteresis 5% - has to be adjusted
+         return m_odoRate.IsIntervalOk(deltaTs);
       }
    }
    return false;
@@ -20,115 +20,193 @@
 using namespace PE;
 
 
-PE::COdometerEx::COdometerEx( const double& speedInterval,
-                              const double& speedHysteresis,
-                              const double& speedMin,
-                              const double& speedMax,
-                              const double& speedAccuracyRatio,
-                              const double& odoInterval,
-                              const double& odoHysteresis,
-                              const double& odoMin,
-                              const double& odoMax)
- : m_sensor(*this)
+template <typename TCalibration>
+PE::COdometerEx<TCalibration>::COdometerEx( const double& speedInterval,
+                                            const double& speedHysteresis,
+                                            const double& speedMin,
+                                            const double& speedMax,
+                                            const double& speedAccuracyRatio,
+                                            const double& odoInterval,
+                                            const double& odoHysteresis,
+                                            const double& odoMin,
+                                            const double& odoMax,
+                                            const TCalibration& calibration)
+ : m_sensor(*this, calibration)
  , m_speed(std::numeric_limits<double>::quiet_NaN())
  , m_ticks(std::numeric_limits<double>::quiet_NaN())
  , m_ticksValid(false)
  , m_ticksPerSecond(std::numeric_limits<double>::quiet_NaN())
  , m_odoLinearVelocity(std::numeric_limits<double>::quiet_NaN())
- , m_speedInterval(speedInterval)
- , m_speedHysteresis(speedHysteresis)
+ , m_speedRate(speedInterval, speedHysteresis)
+ , m_odoRate(odoInterval, odoHysteresis)
  , m_speedMin(speedMin)
  , m_speedMax(speedMax)
  , m_speedAccuracyRatio(speedAccuracyRatio)
- , m_odoInterval(odoInterval)
- , m_odoHysteresis(odoHysteresis)
  , m_odoMin(odoMin)
  , m_odoMax(odoMax)
 {
 }
 
 
-bool PE::COdometerEx::AddSpeed(const double& timestamp, const double& speed, const double& accuracy)
+template <typename TCalibration>
+PE::COdometerEx<TCalibration>::COdometerEx( const double& speedMin,
+                                            const double& speedMax,
+                                            const double& speedAccuracyRatio,
+                                            const double& odoMin,
+                                            const double& odoMax,
+                                            const TCalibration& calibration)
+ : m_sensor(*this, calibration)
+ , m_speed(std::numeric_limits<double>::quiet_NaN())
+ , m_ticks(std::numeric_limits<double>::quiet_NaN())
+ , m_ticksValid(false)
+ , m_ticksPerSecond(std::numeric_limits<double>::quiet_NaN())
+ , m_odoLinearVelocity(std::numeric_limits<double>::quiet_NaN())
+ , m_speedRate()
+ , m_odoRate()
+ , m_speedMin(speedMin)
+ , m_speedMax(speedMax)
+ , m_speedAccuracyRatio(speedAccuracyRatio)
+ , m_odoMin(odoMin)
+ , m_odoMax(odoMax)
+{
+}
+
+
+template <typename TCalibration>
+bool PE::COdometerEx<TCalibration>::AddSpeed(const double& timestamp, const double& speed, const double& accuracy)
 {
    return m_sensor.AddRef(timestamp, speed, accuracy);
 }
 
 
-bool PE::COdometerEx::AddTicks(const double& timestamp, const double& ticks, bool valid )
+template <typename TCalibration>
+bool PE::COdometerEx<TCalibration>::AddTicks(const double& timestamp, const double& ticks, bool valid )
 {
    return m_sensor.AddSen(timestamp, ticks, valid);
 }
 
 
-const double& PE::COdometerEx::TimeStamp() const
+template <typename TCalibration>
+const double& PE::COdometerEx<TCalibration>::TimeStamp() const
 {
    return m_sensor.GetSenTimeStamp();
 }
 
 
-const double PE::COdometerEx::Value() const
+template <typename TCalibration>
+const double PE::COdometerEx<TCalibration>::Value() const
 {
    return m_sensor.GetScale().GetMean() * ( m_ticksPerSecond - m_sensor.GetBias().GetMean()); //value = scale * (m_ticksPerSecond - bias)
 }
 
 
-const double PE::COdometerEx::Accuracy() const
+template <typename TCalibration>
+const double PE::COdometerEx<TCalibration>::Accuracy() const
 {
    return m_sensor.GetBias().GetMld() * ( fabs(m_sensor.GetScale().GetMean()) + m_sensor.GetScale().GetMld() ); // accuracy = bias_mld * (|scale| + scale_mld)
 }
 
-const double& PE::COdometerEx::Base() const
+template <typename TCalibration>
+const double& PE::COdometerEx<TCalibration>::Base() const
 {
    return m_sensor.GetBias().GetMean();
 }
 
 
-const double& PE::COdometerEx::Scale() const
+template <typename TCalibration>
+const double& PE::COdometerEx<TCalibration>::Scale() const
 {
    return m_sensor.GetScale().GetMean();
 }
 
 
-const double& PE::COdometerEx::CalibratedTo() const
+template <typename TCalibration>
+const double& PE::COdometerEx<TCalibration>::CalibratedTo() const
 {
    return m_sensor.GetBias().GetReliable(); //consider only calibration status of the base of odometer
 }
 
 
-bool PE::COdometerEx::SetRefValue(const double& oldSpeedTS, const double& newSpeedTS, const double& speed, const double& accuracy)
+template <typename TCalibration>
+const CRateEstimator& PE::COdometerEx<TCalibration>::SpeedRate() const
+{
+   return m_speedRate;
+}
+
+
+template <typename TCalibration>
+const CRateEstimator& PE::COdometerEx<TCalibration>::TicksRate() const
+{
+   return m_odoRate;
+}
+
+
+template <typename TCalibration>
+uint32_t PE::COdometerEx<TCalibration>::AvoidedResets() const
+{
+   return m_speedRate.GetAvoidedResets() + m_odoRate.GetAvoidedResets();
+}
+
+
+template <typename TCalibration>
+const SSensorStats& PE::COdometerEx<TCalibration>::Stats() const
+{
+   return m_sensor.GetStats();
+}
+
+
+template <typename TCalibration>
+bool PE::COdometerEx<TCalibration>::SetRefValue(const double& oldSpeedTS, const double& newSpeedTS, const double& speed, const double& accuracy)
 {
+   SSensorStats& stats = m_sensor.GetStats();
    m_speed = std::numeric_limits<double>::quiet_NaN();
    if ( PE::Sensor::IsInRange(speed, m_speedMin, m_speedMax) )
    {
-      if ( PE::Sensor::IsIntervalOk(newSpeedTS - oldSpeedTS, m_speedInterval, m_speedHysteresis) )
+      double deltaTS = newSpeedTS - oldSpeedTS;
+      m_speedRate.AddInterval(deltaTS);
+      if ( m_speedRate.IsIntervalOk(deltaTS) )
       {
          if ( PE::Sensor::IsAccuracyOk( speed, accuracy, m_speedAccuracyRatio) )
          {
             m_speed = speed;
             //printf("\nSpeed   =%.2f", m_speed);
          }
+         else
+         {
+            ++stats.RefInaccurate;
+         }
+         ++stats.RefAccepted;
          return true;
       }
+      ++stats.RefInterval;
+   }
+   else
+   {
+      ++stats.RefOutOfRange;
    }
    return false;
 }
 
 
-const double& PE::COdometerEx::GetRefValue() const
+template <typename TCalibration>
+const double& PE::COdometerEx<TCalibration>::GetRefValue() const
 {
    return m_speed;
 }
 
 
-bool PE::COdometerEx::SetSenValue(const double& oldSpeedTS, const double& oldTicksTS, const double& newTicksTS, const double& ticks, bool valid)
+template <typename TCalibration>
+bool PE::COdometerEx<TCalibration>::SetSenValue(const double& oldSpeedTS, const double& oldTicksTS, const double& newTicksTS, const double& ticks, bool valid)
 {
+   SSensorStats& stats = m_sensor.GetStats();
    m_odoLinearVelocity = std::numeric_limits<double>::quiet_NaN();
    if ( valid )
    {
       if ( PE::Sensor::IsInRange(ticks, m_odoMin, m_odoMax) )
       {
          double deltaTS = newTicksTS - oldTicksTS;
-         if ( PE::Sensor::IsIntervalOk(deltaTS, m_odoInterval, m_odoHysteresis) )
+         m_odoRate.AddInterval(deltaTS);
+         if ( m_odoRate.IsIntervalOk(deltaTS) )
          {
             double ticksPerSecond = 0;
             if ( m_ticksValid )
@@ -147,16 +225,32 @@ bool PE::COdometerEx::SetSenValue(const double& oldSpeedTS, const double& oldTic
             m_ticks = ticks;
             m_ticksValid = true;
             m_ticksPerSecond = ticksPerSecond;
+            ++stats.SenAccepted;
             return true;
          }
+         ++stats.SenInterval;
+      }
+      else
+      {
+         ++stats.SenOutOfRange;
       }
    }
+   else
+   {
+      ++stats.SenInvalid;
+   }
    m_ticksValid = false;
    return false;
 }
 
 
-const double& PE::COdometerEx::GetSenValue() const
+template <typename TCalibration>
+const double& PE::COdometerEx<TCalibration>::GetSenValue() const
 {
    return m_odoLinearVelocity;
 }
+
+
+//calibrations which could be used by odometer
+template class PE::COdometerEx<PE::CCalibration>;
+template class PE::COdometerEx<PE::CRlsCalibration>;
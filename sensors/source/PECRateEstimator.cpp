@@ -0,0 +1,277 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "PECRateEstimator.h"
+#include "PESensorTools.h"
+
+
+using namespace PE;
+
+
+const double PE::CRateEstimator::MIN_INTERVAL          = 0.001; // 1ms
+const double PE::CRateEstimator::BIN_RATIO             = 1.02;  // 2% per bin, 512 bins cover 1ms .. 25s
+const double PE::CRateEstimator::LOCK_SHARE            = 0.5;   // 50% of intervals inside of lock window
+const double PE::CRateEstimator::MIN_HYSTERESIS_RATIO  = 0.05;  // 5% of interval
+const double PE::CRateEstimator::MLD_HYSTERESIS_FACTOR = 4.0;
+const uint32_t PE::CRateEstimator::BIN_COUNT;
+const uint32_t PE::CRateEstimator::LOCK_WINDOW;
+const uint32_t PE::CRateEstimator::LOCK_SAMPLES;
+const uint32_t PE::CRateEstimator::TRACKING_WINDOW;
+
+
+PE::CRateEstimator::CRateEstimator()
+: m_IsAdaptive(true)
+, m_IsLocked(false)
+, m_HasNominal(false)
+, m_NominalInterval(0)
+, m_NominalHysteresis(0)
+, m_Interval(0)
+, m_Hysteresis(0)
+, m_Mld(0)
+, m_Tracked(0)
+, m_Rejected(0)
+, m_AvoidedResets(0)
+, m_Samples(0)
+{
+   memset(m_Histogram, 0, sizeof(m_Histogram));
+}
+
+
+PE::CRateEstimator::CRateEstimator(const double& interval, const double& hysteresis, bool isAdaptive)
+: m_IsAdaptive(isAdaptive)
+, m_IsLocked(false)
+, m_HasNominal(true)
+, m_NominalInterval(interval)
+, m_NominalHysteresis(hysteresis)
+, m_Interval(interval)
+, m_Hysteresis(hysteresis)
+, m_Mld(0)
+, m_Tracked(0)
+, m_Rejected(0)
+, m_AvoidedResets(0)
+, m_Samples(0)
+{
+   memset(m_Histogram, 0, sizeof(m_Histogram));
+}
+
+
+void PE::CRateEstimator::AddInterval(const double& deltaTs)
+{
+   if ( false == m_IsAdaptive )
+   {
+      return;
+   }
+   uint32_t bin = ToBin(deltaTs);
+   if ( BIN_COUNT > bin )
+   {
+      if ( std::numeric_limits<uint16_t>::max() == m_Histogram[bin] )
+      {
+         //keep histogram bounded, older intervals loose the weight
+         m_Samples = 0;
+         for ( uint32_t i = 0; i < BIN_COUNT; ++i )
+         {
+            m_Histogram[i] /= 2;
+            m_Samples += m_Histogram[i];
+         }
+      }
+      ++m_Histogram[bin];
+      ++m_Samples;
+   }
+   if ( false == m_IsLocked )
+   {
+      if ( TryLock() )
+      {
+         CountAvoidedReset(deltaTs);
+      }
+   }
+   else if ( PE::Sensor::IsIntervalOk(deltaTs, m_Interval, m_Hysteresis) )
+   {
+      CountAvoidedReset(deltaTs);
+      Track(deltaTs);
+      m_Rejected = 0;
+   }
+   else
+   {
+      ++m_Rejected;
+      if ( LOCK_SAMPLES < m_Rejected )
+      {
+         //rate of the sensor was changed
+         Unlock();
+      }
+   }
+}
+
+
+bool PE::CRateEstimator::IsIntervalOk(const double& deltaTs) const
+{
+   if ( m_IsLocked || m_HasNominal )
+   {
+      return PE::Sensor::IsIntervalOk(deltaTs, m_Interval, m_Hysteresis);
+   }
+   return false;
+}
+
+
+bool PE::CRateEstimator::IsLocked() const
+{
+   return ( m_IsLocked || false == m_IsAdaptive );
+}
+
+
+const double& PE::CRateEstimator::GetInterval() const
+{
+   return m_Interval;
+}
+
+
+const double& PE::CRateEstimator::GetHysteresis() const
+{
+   return m_Hysteresis;
+}
+
+
+const uint32_t& PE::CRateEstimator::GetAvoidedResets() const
+{
+   return m_AvoidedResets;
+}
+
+
+uint32_t PE::CRateEstimator::ToBin(const double& deltaTs) const
+{
+   if ( MIN_INTERVAL <= deltaTs )
+   {
+      double bin = log(deltaTs / MIN_INTERVAL) / log(BIN_RATIO);
+      if ( BIN_COUNT > bin )
+      {
+         return static_cast<uint32_t>(bin);
+      }
+   }
+   return BIN_COUNT;
+}
+
+
+double PE::CRateEstimator::FromBin(const double& bin) const
+{
+   return MIN_INTERVAL * pow(BIN_RATIO, bin);
+}
+
+
+bool PE::CRateEstimator::TryLock()
+{
+   if ( LOCK_SAMPLES > m_Samples )
+   {
+      return false;
+   }
+   //find window of neighbouring bins with the most intervals
+   uint32_t windowSize = 2 * LOCK_WINDOW + 1;
+   uint32_t sum = 0;
+   uint32_t bestSum = 0;
+   uint32_t bestBegin = 0;
+   for ( uint32_t i = 0; i < BIN_COUNT; ++i )
+   {
+      sum += m_Histogram[i];
+      if ( i >= windowSize )
+      {
+         sum -= m_Histogram[i - windowSize];
+      }
+      if ( sum > bestSum )
+      {
+         bestSum = sum;
+         bestBegin = ( i >= windowSize ) ? i - windowSize + 1 : 0;
+      }
+   }
+   if ( bestSum < LOCK_SHARE * m_Samples )
+   {
+      return false;
+   }
+   //weighted mean and mean linear deviation of the window
+   uint32_t windowEnd = ( BIN_COUNT < bestBegin + windowSize ) ? BIN_COUNT : bestBegin + windowSize;
+   double mean = 0;
+   for ( uint32_t i = bestBegin; i < windowEnd; ++i )
+   {
+      mean += FromBin(i + 0.5) * m_Histogram[i];
+   }
+   mean /= bestSum;
+   double mld = 0;
+   for ( uint32_t i = bestBegin; i < windowEnd; ++i )
+   {
+      mld += fabs(FromBin(i + 0.5) - mean) * m_Histogram[i];
+   }
+   mld /= bestSum;
+
+   m_Interval   = mean;
+   m_Mld        = mld;
+   m_Hysteresis = MLD_HYSTERESIS_FACTOR * m_Mld;
+   if ( m_Hysteresis < MIN_HYSTERESIS_RATIO * m_Interval )
+   {
+      m_Hysteresis = MIN_HYSTERESIS_RATIO * m_Interval;
+   }
+   m_Tracked    = ( TRACKING_WINDOW < bestSum ) ? TRACKING_WINDOW : bestSum;
+   m_Rejected   = 0;
+   m_IsLocked   = true;
+   if ( false == m_HasNominal )
+   {
+      //first detected band becomes nominal one
+      m_HasNominal        = true;
+      m_NominalInterval   = m_Interval;
+      m_NominalHysteresis = m_Hysteresis;
+   }
+   return true;
+}
+
+
+void PE::CRateEstimator::Track(const double& deltaTs)
+{
+   if ( TRACKING_WINDOW > m_Tracked )
+   {
+      ++m_Tracked;
+   }
+   m_Interval += ( deltaTs - m_Interval ) / m_Tracked;
+   m_Mld      += ( fabs(deltaTs - m_Interval) - m_Mld ) / m_Tracked;
+   m_Hysteresis = MLD_HYSTERESIS_FACTOR * m_Mld;
+   if ( m_Hysteresis < MIN_HYSTERESIS_RATIO * m_Interval )
+   {
+      m_Hysteresis = MIN_HYSTERESIS_RATIO * m_Interval;
+   }
+}
+
+
+void PE::CRateEstimator::CountAvoidedReset(const double& deltaTs)
+{
+   if ( PE::Sensor::IsIntervalOk(deltaTs, m_Interval, m_Hysteresis) )
+   {
+      if ( false == PE::Sensor::IsIntervalOk(deltaTs, m_NominalInterval, m_NominalHysteresis) )
+      {
+         ++m_AvoidedResets;
+      }
+   }
+}
+
+
+void PE::CRateEstimator::Unlock()
+{
+   memset(m_Histogram, 0, sizeof(m_Histogram));
+   m_Samples  = 0;
+   m_Tracked  = 0;
+   m_Rejected = 0;
+   m_IsLocked = false;
+   if ( m_NominalInterval > 0 )
+   {
+      //falls back to nominal band till next lock
+      m_Interval   = m_NominalInterval;
+      m_Hysteresis = m_NominalHysteresis;
+   }
+}
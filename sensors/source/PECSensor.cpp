@@ -13,21 +13,30 @@
  */
 
 #include "PECSensor.h"
+#include "PECRlsCalibration.h"
+#include "PECTemperatureCalibration.h"
 #include "PESensorTools.h"
 
 
 using namespace PE;
 
 
-PE::CSensor::CSensor(ISensorAdjuster& adjuster)
+template <typename TCalibration, typename TNormalisation>
+PE::CSensor<TCalibration, TNormalisation>::CSensor( ISensorAdjuster& adjuster,
+                                                    const TCalibration& calibration,
+                                                    const TNormalisation& normalisation )
 : m_adjuster(adjuster)
 , m_refTimestamp(0)
 , m_senTimestamp(0)
+, m_Calibration(calibration)
+, m_SenBias(normalisation)
+, m_SenScale(normalisation)
 {
 }
 
 
-bool PE::CSensor::AddRef(const double& refTimestamp, const double& refValue, const double& refAccuracy)
+template <typename TCalibration, typename TNormalisation>
+bool PE::CSensor<TCalibration, TNormalisation>::AddRef(const double& refTimestamp, const double& refValue, const double& refAccuracy)
 {
    if ( 0 == m_refTimestamp )
    {
@@ -49,7 +58,8 @@ bool PE::CSensor::AddRef(const double& refTimestamp, const double& refValue, con
 }
 
 
-bool PE::CSensor::AddSen(const double& senTimestamp, const double& senValue, bool senValid )
+template <typename TCalibration, typename TNormalisation>
+bool PE::CSensor<TCalibration, TNormalisation>::AddSen(const double& senTimestamp, const double& senValue, bool senValid )
 {
    if ( 0 < m_refTimestamp )
    {
@@ -69,9 +79,11 @@ bool PE::CSensor::AddSen(const double& senTimestamp, const double& senValue, boo
                {
                   m_Calibration.AddRef(m_adjuster.GetRefValue());
                   m_Calibration.AddRaw(m_adjuster.GetSenValue());
-                  m_Calibration.Recalculate();
-                  UpdateBias( m_Calibration.GetBias() );
-                  UpdateScale( m_Calibration.GetScale() );
+                  ++m_Stats.Steps;
+                  if ( m_Calibration.Recalculate() )
+                  {
+                     Normalise();
+                  }
                }
             }
             m_senTimestamp = senTimestamp;
@@ -91,39 +103,89 @@ bool PE::CSensor::AddSen(const double& senTimestamp, const double& senValue, boo
 }
 
 
-const double& PE::CSensor::GetRefTimeStamp() const
+template <typename TCalibration, typename TNormalisation>
+const double& PE::CSensor<TCalibration, TNormalisation>::GetRefTimeStamp() const
 {
    return m_refTimestamp;
 }
 
 
-const double& PE::CSensor::GetSenTimeStamp() const
+template <typename TCalibration, typename TNormalisation>
+const double& PE::CSensor<TCalibration, TNormalisation>::GetSenTimeStamp() const
 {
    return m_senTimestamp;
 }
 
 
-const CNormalisation& PE::CSensor::GetBias() const
+template <typename TCalibration, typename TNormalisation>
+const TNormalisation& PE::CSensor<TCalibration, TNormalisation>::GetBias() const
 {
    return m_SenBias;
 }
 
 
-const CNormalisation& PE::CSensor::GetScale() const
+template <typename TCalibration, typename TNormalisation>
+const TNormalisation& PE::CSensor<TCalibration, TNormalisation>::GetScale() const
 {
    return m_SenScale;
 }
 
 
-void PE::CSensor::ResetUncomplitedProcessing()
+template <typename TCalibration, typename TNormalisation>
+const TCalibration& PE::CSensor<TCalibration, TNormalisation>::GetCalibration() const
 {
+   return m_Calibration;
+}
+
+
+template <typename TCalibration, typename TNormalisation>
+TCalibration& PE::CSensor<TCalibration, TNormalisation>::GetCalibration()
+{
+   return m_Calibration;
+}
+
+
+template <typename TCalibration, typename TNormalisation>
+const SSensorStats& PE::CSensor<TCalibration, TNormalisation>::GetStats() const
+{
+   return m_Stats;
+}
+
+
+template <typename TCalibration, typename TNormalisation>
+SSensorStats& PE::CSensor<TCalibration, TNormalisation>::GetStats()
+{
+   return m_Stats;
+}
+
+
+template <typename TCalibration, typename TNormalisation>
+void PE::CSensor<TCalibration, TNormalisation>::ResetUncomplitedProcessing()
+{
+   ++m_Stats.Resets;
    m_refTimestamp = 0;
    m_senTimestamp = 0;
    m_Calibration.CleanLastStep();
 }
 
 
-void PE::CSensor::UpdateBias(const double& bias)
+template <typename TCalibration, typename TNormalisation>
+void PE::CSensor<TCalibration, TNormalisation>::Normalise()
+{
+   UpdateBias( m_Calibration.GetBias() );
+   UpdateScale( m_Calibration.GetScale() );
+}
+
+
+template <>
+void PE::CSensor<PE::CTemperatureCalibration>::Normalise()
+{
+   //bias and scale are already normalised in the bin of the temperature
+}
+
+
+template <typename TCalibration, typename TNormalisation>
+void PE::CSensor<TCalibration, TNormalisation>::UpdateBias(const double& bias)
 {
    if ( false == PE::isnan(bias) )
    {
@@ -132,10 +194,18 @@ void PE::CSensor::UpdateBias(const double& bias)
 }
 
 
-void PE::CSensor::UpdateScale(const double& scale)
+template <typename TCalibration, typename TNormalisation>
+void PE::CSensor<TCalibration, TNormalisation>::UpdateScale(const double& scale)
 {
    if ( false == PE::isnan(scale) )
    {
       m_SenScale.AddSensor(scale);
    }
 }
+
+
+//calibrations and normalisations which could be used by sensors
+template class PE::CSensor<PE::CCalibration>;
+template class PE::CSensor<PE::CCalibration, PE::CRobustNormalisation>;
+template class PE::CSensor<PE::CRlsCalibration>;
+template class PE::CSensor<PE::CTemperatureCalibration>;
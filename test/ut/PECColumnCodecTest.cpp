@@ -0,0 +1,238 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PE::CColumnCodec class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <stdlib.h>
+#include <gtest/gtest.h>
+
+#include "PECColumnCodec.h"
+#include "PECTrack.h"
+#include "PETypes.h"
+
+#define RECORDED_TRACK PE_TEST_TRACKS_DIR "ODO_40ms_60sec_GNSS_100ms_32sec.txt"
+
+class PECColumnCodecTest : public ::testing::Test
+{
+public:
+   virtual void SetUp() {
+      srand(7);
+   }
+   virtual void TearDown() {
+   }
+
+   /**
+    * Encodes and decodes values, decoded values are expected to be the same
+    * @return   size of encoded column in bytes
+    */
+   static size_t RoundTrip(const std::vector<int64_t>& values)
+   {
+      std::vector<uint8_t> data;
+      PE::CColumnCodec::Encode(values.data(), values.size(), data);
+      std::vector<int64_t> decoded(3, 1);
+      EXPECT_TRUE( PE::CColumnCodec::Decode(data.data(), data.size(), decoded) );
+      EXPECT_TRUE( values == decoded );
+      return data.size();
+   }
+
+   static bool Decode(const std::vector<uint8_t>& data)
+   {
+      std::vector<int64_t> decoded;
+      return PE::CColumnCodec::Decode(data.data(), data.size(), decoded);
+   }
+
+   static void Unpack(const uint8_t* words, uint32_t width, uint32_t slots, uint32_t* values, bool isScalar)
+   {
+      if ( isScalar )
+      {
+         PE::CColumnCodec::UnpackScalar(words, width, slots, values);
+      }
+      else
+      {
+         PE::CColumnCodec::Unpack(words, width, slots, values);
+      }
+   }
+
+   static uint32_t Random32()
+   {
+      return ( static_cast<uint32_t>(rand()) << 16 ) ^ static_cast<uint32_t>(rand());
+   }
+};
+
+
+/**
+ * columns of different shapes and sizes are decoded like encoded
+ */
+TEST_F(PECColumnCodecTest, test_round_trip)
+{
+   std::vector<int64_t> values;
+   EXPECT_EQ( 1, RoundTrip(values) );
+
+   //regular timestamps: width 0, count, width, first and reference per block
+   for ( int64_t i = 0; i < 1000; ++i )
+   {
+      values.push_back(269128 + 40 * i);
+   }
+   EXPECT_GE( 2 + 8 * ( 1 + 3 + 1 ), RoundTrip(values) );
+
+   //counters with jitter, decreasing and negative values, all sizes around blocks and lanes
+   const size_t sizes[] = { 1, 2, 3, 4, 5, 127, 128, 129, 255, 256, 257, 1001 };
+   for ( uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s )
+   {
+      values.clear();
+      int64_t value = -500;
+      for ( size_t i = 0; i < sizes[s]; ++i )
+      {
+         value += static_cast<int64_t>(rand() % 100) - 20;
+         values.push_back(value);
+      }
+      //at most one byte per value and one row of lanes for a short block
+      EXPECT_GE( values.size() + 4 * PE::CColumnCodec::LANES + 8, RoundTrip(values) ) << sizes[s];
+   }
+
+   //deltas of all widths up to raw blocks
+   for ( uint32_t width = 0; width <= 64; ++width )
+   {
+      values.clear();
+      const uint64_t mask = ( 64 == width ) ? ~static_cast<uint64_t>(0) : ( static_cast<uint64_t>(1) << width ) - 1;
+      uint64_t value = 0;
+      for ( size_t i = 0; i < 300; ++i )
+      {
+         value += ( ( static_cast<uint64_t>(Random32()) << 32 ) | Random32() ) & mask;
+         values.push_back(static_cast<int64_t>(value));
+      }
+      RoundTrip(values);
+   }
+
+   //extremes
+   values.clear();
+   values.push_back(std::numeric_limits<int64_t>::max());
+   values.push_back(std::numeric_limits<int64_t>::min());
+   values.push_back(0);
+   values.push_back(std::numeric_limits<int64_t>::min());
+   RoundTrip(values);
+}
+
+
+/**
+ * SIMD unpacking gives the same values like scalar one for all widths
+ */
+TEST_F(PECColumnCodecTest, test_unpack)
+{
+   const uint32_t slots = PE::CColumnCodec::BLOCK_SIZE / PE::CColumnCodec::LANES;
+   //words start not aligned
+   std::vector<uint8_t> words(PE::CColumnCodec::BLOCK_SIZE * sizeof(uint32_t) + 1);
+   for ( size_t i = 0; i < words.size(); ++i )
+   {
+      words[i] = static_cast<uint8_t>(rand());
+   }
+   for ( uint32_t width = 0; width <= 32; ++width )
+   {
+      for ( uint32_t count = 1; count <= slots; count += 7 )
+      {
+         uint32_t expected[PE::CColumnCodec::BLOCK_SIZE];
+         uint32_t values[PE::CColumnCodec::BLOCK_SIZE];
+         Unpack(&words[1], width, count, expected, true);
+         Unpack(&words[1], width, count, values, false);
+         for ( uint32_t i = 0; i < count * PE::CColumnCodec::LANES; ++i )
+         {
+            ASSERT_EQ( expected[i], values[i] ) << width << " " << i;
+            EXPECT_GT( static_cast<uint64_t>(1) << width, expected[i] );
+         }
+      }
+   }
+}
+
+
+/**
+ * truncated and damaged data is not decoded
+ */
+TEST_F(PECColumnCodecTest, test_damaged_data)
+{
+   std::vector<int64_t> values;
+   for ( int64_t i = 0; i < 300; ++i )
+   {
+      values.push_back(i * i);
+   }
+   std::vector<uint8_t> data;
+   PE::CColumnCodec::Encode(values.data(), values.size(), data);
+   ASSERT_TRUE ( Decode(data) );
+
+   for ( size_t size = 0; size < data.size(); ++size )
+   {
+      EXPECT_FALSE( Decode(std::vector<uint8_t>(data.begin(), data.begin() + size)) ) << size;
+   }
+   std::vector<uint8_t> damaged = data;
+   damaged.push_back(0);
+   EXPECT_FALSE( Decode(damaged) );
+   //width of the first block behind count
+   damaged = data;
+   damaged[2] = 33;
+   EXPECT_FALSE( Decode(damaged) );
+   //huge count
+   const uint8_t count[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x00 };
+   EXPECT_FALSE( Decode(std::vector<uint8_t>(count, count + sizeof(count))) );
+   EXPECT_FALSE( Decode(std::vector<uint8_t>(10, 0x80)) );
+}
+
+
+/**
+ * timestamps and odometer ticks of recorded track are kept without loss and compressed
+ */
+TEST_F(PECColumnCodecTest, test_recorded_track)
+{
+   PE::CTrack track;
+   ASSERT_TRUE( track.LoadText(RECORDED_TRACK) );
+   std::vector<double> timestamps;
+   std::vector<double> ticks;
+   for ( size_t i = 0; i < track.GetSize(); ++i )
+   {
+      if ( PE::EVENT_ODO == track[i].Type )
+      {
+         timestamps.push_back(track[i].Timestamp);
+         ticks.push_back(track[i].Values[0]);
+      }
+   }
+   ASSERT_EQ( 1503, timestamps.size() );
+
+   std::vector<int64_t> integers;
+   ASSERT_TRUE( PE::CColumnCodec::ToIntegers(timestamps.data(), timestamps.size(), 1000, integers) );
+   EXPECT_EQ  ( 269128, integers[0] );
+   EXPECT_GT  ( timestamps.size() * sizeof(double) / 8, RoundTrip(integers) );
+   std::vector<double> restored;
+   PE::CColumnCodec::FromIntegers(integers, 1000, restored);
+   EXPECT_TRUE( timestamps == restored );
+
+   ASSERT_TRUE( PE::CColumnCodec::ToIntegers(ticks.data(), ticks.size(), 1, integers) );
+   EXPECT_GT  ( ticks.size() * sizeof(double) / 4, RoundTrip(integers) );
+
+   //not integer values
+   const double wrong[] = { 1.0, 1.5 };
+   EXPECT_FALSE( PE::CColumnCodec::ToIntegers(wrong, 2, 1, integers) );
+   const double unknown[] = { std::numeric_limits<double>::quiet_NaN() };
+   EXPECT_FALSE( PE::CColumnCodec::ToIntegers(unknown, 1, 1, integers) );
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
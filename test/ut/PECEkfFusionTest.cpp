@@ -0,0 +1,273 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PE::CEkfFusion class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "PECEkfFusion.h"
+#include "PETools.h"
+
+
+class PECEkfFusionTest : public ::testing::Test
+{
+public:
+   virtual void SetUp()
+   {}
+   virtual void TearDown()
+   {}
+
+   /**
+    * Expects position within distance in meter
+    */
+   static void ExpectPosition(const PE::SPosition& expected, const PE::SPosition& position, const double& distance)
+   {
+      EXPECT_GT( distance, PE::TOOLS::ToDistance(expected.Latitude, expected.Longitude, position.Latitude, position.Longitude) )
+         << position.Latitude << " " << position.Longitude;
+   }
+
+   static uint32_t GetQueueSize(const PE::CEkfFusion& fusion)
+   {
+      return fusion.m_SensorsList.GetSize();
+   }
+};
+
+
+TEST_F(PECEkfFusionTest, test_create )
+{
+   PE::SPosition pos = PE::SPosition(50.0,10.0,0.1);
+   PE::SBasicSensor heading = PE::SBasicSensor(90.0,5.0);
+   PE::SBasicSensor speed = PE::SBasicSensor(5.0,0.1);
+   PE::SBasicSensor angSpeed = PE::SBasicSensor(10.0,0.2);
+
+   PE::CEkfFusion fusion(1000.0, pos, heading, angSpeed, speed);
+   EXPECT_EQ( 1000.0, fusion.GetTimestamp() );
+   EXPECT_EQ( 50.0, fusion.GetPosition().Latitude );
+   EXPECT_EQ( 10.0, fusion.GetPosition().Longitude );
+   EXPECT_NEAR( 0.1, fusion.GetPosition().HorizontalAcc, 0.00000001 );
+   EXPECT_EQ( 90.0, fusion.GetHeading().Value );
+   EXPECT_NEAR( 5.0, fusion.GetHeading().Accuracy, 0.00000001 );
+   EXPECT_EQ( 5.0, fusion.GetSpeed().Value );
+   EXPECT_NEAR( 0.1, fusion.GetSpeed().Accuracy, 0.00000001 );
+   EXPECT_EQ( 10.0, fusion.GetAngSpeed().Value );
+   EXPECT_NEAR( 0.2, fusion.GetAngSpeed().Accuracy, 0.00000001 );
+   EXPECT_NEAR( 0.04, fusion.GetCovariance()(PE::CEkfFusion::STATE_ANG_SPEED, PE::CEkfFusion::STATE_ANG_SPEED), 0.00000001 );
+
+   //prediction of speeds only increases accuracy value
+   EXPECT_FALSE( fusion.GetSpeed(999.0).IsValid() );
+   EXPECT_EQ( 5.0, fusion.GetSpeed(1001.0).Value );
+   EXPECT_LT( 0.1, fusion.GetSpeed(1001.0).Accuracy );
+   EXPECT_FALSE( fusion.GetAngSpeed(999.0).IsValid() );
+   EXPECT_EQ( 10.0, fusion.GetAngSpeed(1001.0).Value );
+   EXPECT_LT( 0.2, fusion.GetAngSpeed(1001.0).Accuracy );
+}
+
+
+TEST_F(PECEkfFusionTest, test_invalid_start_values )
+{
+   PE::CEkfFusion fusion(0.0, PE::SPosition(), PE::SBasicSensor(), PE::SBasicSensor(), PE::SBasicSensor());
+   EXPECT_FALSE( fusion.GetPosition().IsValid() );
+   EXPECT_FALSE( fusion.GetHeading().IsValid() );
+   EXPECT_FALSE( fusion.GetSpeed().IsValid() );
+   EXPECT_FALSE( fusion.GetAngSpeed().IsValid() );
+   EXPECT_FALSE( fusion.GetSpeed(1.0).IsValid() );
+
+   //invalid sensors are not queued
+   fusion.AddPosition(1.0, PE::SPosition());
+   fusion.AddHeading(1.0, PE::SBasicSensor());
+   fusion.AddSpeed(1.0, PE::SBasicSensor());
+   fusion.AddAngSpeed(1.0, PE::SBasicSensor());
+   EXPECT_EQ( 0, GetQueueSize(fusion) );
+
+   //first measurements initialise the states
+   fusion.AddPosition(1.0, PE::SPosition(50.0, 10.0, 2.0));
+   fusion.AddHeading(1.0, PE::SBasicSensor(45.0, 1.0));
+   fusion.AddSpeed(1.0, PE::SBasicSensor(10.0, 0.5));
+   fusion.AddAngSpeed(1.0, PE::SBasicSensor(-3.0, 0.2));
+   fusion.DoFusion();
+   EXPECT_EQ( 1.0, fusion.GetTimestamp() );
+   EXPECT_EQ( 50.0, fusion.GetPosition().Latitude );
+   EXPECT_EQ( 10.0, fusion.GetPosition().Longitude );
+   EXPECT_NEAR( 2.0, fusion.GetPosition().HorizontalAcc, 0.00000001 );
+   EXPECT_EQ( 45.0, fusion.GetHeading().Value );
+   EXPECT_NEAR( 1.0, fusion.GetHeading().Accuracy, 0.00000001 );
+   EXPECT_EQ( 10.0, fusion.GetSpeed().Value );
+   EXPECT_NEAR( 0.5, fusion.GetSpeed().Accuracy, 0.00000001 );
+   EXPECT_EQ( -3.0, fusion.GetAngSpeed().Value );
+   EXPECT_NEAR( 0.2, fusion.GetAngSpeed().Accuracy, 0.00000001 );
+}
+
+
+TEST_F(PECEkfFusionTest, test_same_sensor_with_same_time )
+{
+   //sequential update by two measurements of the same time is weighted mean like FUSION::MergeSensor()
+   PE::CEkfFusion fusion(0.0, PE::SPosition(), PE::SBasicSensor(), PE::SBasicSensor(), PE::SBasicSensor());
+   fusion.AddSpeed(1000.0, PE::SBasicSensor(10.0, 1.0));
+   fusion.AddSpeed(1000.0, PE::SBasicSensor(11.0, 2.0));
+   EXPECT_EQ( 2, GetQueueSize(fusion) );
+   fusion.DoFusion();
+   EXPECT_NEAR( 10.2, fusion.GetSpeed().Value, 0.00000001 );
+   EXPECT_NEAR( sqrt(0.8), fusion.GetSpeed().Accuracy, 0.00000001 );
+
+   //heading over north
+   fusion.AddHeading(1000.0, PE::SBasicSensor(350.0, 1.0));
+   fusion.AddHeading(1000.0, PE::SBasicSensor(10.0, 1.0));
+   fusion.DoFusion();
+   EXPECT_NEAR( 0.0, PE::TOOLS::ToAngle(fusion.GetHeading().Value, 0.0), 0.00000001 );
+   EXPECT_NEAR( sqrt(0.5), fusion.GetHeading().Accuracy, 0.00000001 );
+}
+
+
+TEST_F(PECEkfFusionTest, test_old_timestamp )
+{
+   PE::CEkfFusion fusion(10.0, PE::SPosition(50.0, 10.0, 1.0), PE::SBasicSensor(0.0, 1.0), PE::SBasicSensor(0.0, 1.0), PE::SBasicSensor(1.0, 1.0));
+   fusion.AddSpeed(12.0, PE::SBasicSensor(2.0, 0.1));
+   fusion.AddSpeed(11.0, PE::SBasicSensor(5.0, 0.1));
+   EXPECT_EQ( 1, GetQueueSize(fusion) );
+   fusion.DoFusion();
+   EXPECT_EQ( 12.0, fusion.GetTimestamp() );
+
+   fusion.AddSpeed(11.0, PE::SBasicSensor(5.0, 0.1));
+   fusion.DoFusion();
+   EXPECT_EQ( 12.0, fusion.GetTimestamp() );
+   EXPECT_NEAR( 2.0, fusion.GetSpeed().Value, 0.1 );
+}
+
+
+TEST_F(PECEkfFusionTest, test_one_circle_left_by_permanent_angular_and_linear_speed )
+{
+   PE::SBasicSensor  heading  ( 90.0,0.1);
+   PE::SBasicSensor angSpeed  ( 18.0,0.1); //turn left 18deg/s
+   PE::SBasicSensor    speed  ( 10.0,0.1); //10 m/s
+   PE::SPosition         pos  ( 50.0,10.0, 0.1);
+   PE::CEkfFusion fusion(0.0,pos,heading,angSpeed,speed);
+
+   const double timestamps[] = { 1.0, 2.0, 3.0, 4.0, 5.0, 10.0, 15.0, 20.0 };
+   const PE::SPosition positions[] = {
+      PE::SPosition(50.00001401, 10.00013761), PE::SPosition(50.00005467, 10.00026176),
+      PE::SPosition(50.00011800, 10.00036029), PE::SPosition(50.00019780, 10.00042354),
+      PE::SPosition(50.00028626, 10.00044534), PE::SPosition(50.00057252, 10.00000000),
+      PE::SPosition(50.00028626,  9.99955464), PE::SPosition(50.00000000, 10.00000000) };
+   const double headings[] = { 72.0, 54.0, 36.0, 18.0, 0.0, 270.0, 180.0, 90.0 };
+   double accuracy = pos.HorizontalAcc;
+   for ( uint32_t i = 0; i < 8; ++i )
+   {
+      fusion.AddSpeed(timestamps[i], speed);
+      fusion.AddAngSpeed(timestamps[i], angSpeed);
+      fusion.DoFusion();
+      ExpectPosition(positions[i], fusion.GetPosition(), 0.01);
+      EXPECT_NEAR( 0.0, PE::TOOLS::ToAngle(headings[i], fusion.GetHeading().Value), 0.00000001 );
+      EXPECT_NEAR( 18.0, fusion.GetAngSpeed().Value, 0.00000001 );
+      EXPECT_NEAR( 10.0, fusion.GetSpeed().Value, 0.00000001 );
+      //without position measurements uncertainty grows
+      EXPECT_LT( accuracy, fusion.GetPosition().HorizontalAcc );
+      accuracy = fusion.GetPosition().HorizontalAcc;
+   }
+}
+
+
+TEST_F(PECEkfFusionTest, test_one_circle_left_by_position )
+{
+   PE::SBasicSensor  heading  ( 90.0,0.1);
+   PE::SBasicSensor angSpeed  ( 18.0,0.1);
+   PE::SBasicSensor    speed  ( 10.0,0.1);
+   PE::SPosition         pos  ( 50.0,10.0, 0.1);
+   PE::CEkfFusion fusion(0.0,pos,heading,angSpeed,speed);
+
+   const double timestamps[] = { 1.0, 2.0, 3.0, 4.0, 5.0, 10.0, 15.0, 20.0 };
+   const PE::SPosition positions[] = {
+      PE::SPosition(50.00001401, 10.00013761, 0.1), PE::SPosition(50.00005467, 10.00026176, 0.1),
+      PE::SPosition(50.00011800, 10.00036029, 0.1), PE::SPosition(50.00019780, 10.00042354, 0.1),
+      PE::SPosition(50.00028626, 10.00044534, 0.1), PE::SPosition(50.00057252, 10.00000000, 0.1),
+      PE::SPosition(50.00028626,  9.99955464, 0.1), PE::SPosition(50.00000000, 10.00000000, 0.1) };
+   const double headings[] = { 72.0, 54.0, 36.0, 18.0, 0.0, 270.0, 180.0, 90.0 };
+   for ( uint32_t i = 0; i < 8; ++i )
+   {
+      fusion.AddPosition(timestamps[i], positions[i]);
+      fusion.DoFusion();
+      ExpectPosition(positions[i], fusion.GetPosition(), 0.05);
+      EXPECT_NEAR( 0.0, PE::TOOLS::ToAngle(headings[i], fusion.GetHeading().Value), 0.1 );
+      EXPECT_NEAR( 18.0, fusion.GetAngSpeed().Value, 0.1 );
+      EXPECT_NEAR( 10.0, fusion.GetSpeed().Value, 0.1 );
+      EXPECT_GT( 0.1, fusion.GetPosition().HorizontalAcc );
+   }
+}
+
+
+TEST_F(PECEkfFusionTest, test_position_corrects_wrong_speed )
+{
+   //start speed is wrong, positions on straight line to east with 10 m/s
+   PE::SPosition pos(50.0, 10.0, 1.0);
+   PE::CEkfFusion fusion(0.0, pos, PE::SBasicSensor(90.0, 1.0), PE::SBasicSensor(0.0, 0.1), PE::SBasicSensor(5.0, 5.0));
+   for ( uint32_t i = 1; i <= 20; ++i )
+   {
+      fusion.AddPosition(i, PE::TOOLS::ToPosition(pos, 10.0 * i, 90.0));
+      fusion.DoFusion();
+   }
+   EXPECT_NEAR( 10.0, fusion.GetSpeed().Value, 0.1 );
+   EXPECT_NEAR( 90.0, fusion.GetHeading().Value, 0.5 );
+   ExpectPosition(PE::TOOLS::ToPosition(pos, 200.0, 90.0), fusion.GetPosition(), 1.0);
+}
+
+
+TEST_F(PECEkfFusionTest, test_queue_overflow_fuse )
+{
+   PE::SBasicSensor  heading  ( 90.0,0.1);
+   PE::SBasicSensor angSpeed  ( 18.0,0.1);
+   PE::SBasicSensor    speed  ( 10.0,0.1);
+   PE::SPosition         pos  ( 50.0,10.0, 0.1);
+   PE::CEkfFusion unlimited(0.0, pos, heading, angSpeed, speed, 1000);
+   PE::CEkfFusion limited  (0.0, pos, heading, angSpeed, speed, 4, PE::CFusionSensor::OVERFLOW_FUSE);
+   PE::CEkfFusion dropping (0.0, pos, heading, angSpeed, speed, 4, PE::CFusionSensor::OVERFLOW_DROP_OLDEST);
+
+   for ( uint32_t i = 1; i <= 20; ++i )
+   {
+      double ts = i * 0.5;
+      unlimited.AddSpeed(ts, speed);
+      unlimited.AddAngSpeed(ts, angSpeed);
+      limited.AddSpeed(ts, speed);
+      limited.AddAngSpeed(ts, angSpeed);
+      dropping.AddSpeed(ts, speed);
+      dropping.AddAngSpeed(ts, angSpeed);
+   }
+   EXPECT_EQ( 36, limited.GetOverflowCount() );
+   EXPECT_EQ( 36, dropping.GetOverflowCount() );
+   EXPECT_EQ( 0, unlimited.GetOverflowCount() );
+   //each sensor is own item, so queue holds two last timestamps
+   EXPECT_EQ( 9.0, limited.GetTimestamp() );
+   EXPECT_EQ( 0.0, dropping.GetTimestamp() );
+
+   unlimited.DoFusion();
+   limited.DoFusion();
+   dropping.DoFusion();
+   EXPECT_EQ( unlimited.GetTimestamp(), limited.GetTimestamp() );
+   EXPECT_EQ( unlimited.GetPosition().Latitude, limited.GetPosition().Latitude );
+   EXPECT_EQ( unlimited.GetPosition().Longitude, limited.GetPosition().Longitude );
+   EXPECT_EQ( unlimited.GetHeading().Value, limited.GetHeading().Value );
+   EXPECT_EQ( unlimited.GetSpeed().Accuracy, limited.GetSpeed().Accuracy );
+   EXPECT_EQ( 10.0, dropping.GetTimestamp() );
+   EXPECT_LT( unlimited.GetSpeed().Accuracy, dropping.GetSpeed().Accuracy );
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
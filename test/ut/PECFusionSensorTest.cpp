@@ -32,8 +32,38 @@ public:
    {}
    virtual void TearDown()
    {}
+
+   static const PE::CFusionSensor::TSensorsList& GetQueue(const PE::CFusionSensor& fusion)
+   {
+      return fusion.m_SensorsList;
+   }
+
+   /**
+    * Clock of incremental mode controlled by test
+    */
+   static double s_Now;
+
+   /**
+    * Expects the same fusion result
+    */
+   static void ExpectSame(const PE::CFusionSensor& expected, const PE::CFusionSensor& fusion)
+   {
+      EXPECT_EQ( expected.GetTimestamp(), fusion.GetTimestamp() );
+      EXPECT_EQ( expected.GetPosition().Latitude, fusion.GetPosition().Latitude );
+      EXPECT_EQ( expected.GetPosition().Longitude, fusion.GetPosition().Longitude );
+      EXPECT_EQ( expected.GetPosition().HorizontalAcc, fusion.GetPosition().HorizontalAcc );
+      EXPECT_EQ( expected.GetHeading().Value, fusion.GetHeading().Value );
+      EXPECT_EQ( expected.GetSpeed().Value, fusion.GetSpeed().Value );
+      EXPECT_EQ( expected.GetAngSpeed().Accuracy, fusion.GetAngSpeed().Accuracy );
+   }
+   static double GetNow()
+   {
+      return s_Now;
+   }
 };
 
+double PECFusionSensorTest::s_Now = 0.0;
+
 //test cases:
 //check skipping sensors data with outdated timesatmp
 //check if all start value are invalid and add only one set of sensors. -> getters have to return same value
@@ -1221,6 +1251,355 @@ TEST_F(PECFusionSensorTest, test_same_angular_velocity_with_same_time)
 }
 
 
+TEST_F(PECFusionSensorTest, test_queue_overflow_fuse )
+{
+   PE::SBasicSensor  heading  ( 90.0,0.1);
+   PE::SBasicSensor angSpeed  ( 18.0,0.1);
+   PE::SBasicSensor    speed  ( 10.0,0.1);
+   PE::SPosition         pos  ( 50.0,10.0, 0.1);
+   PE::CFusionSensor unlimited(0.0, pos, heading, angSpeed, speed, 1000);
+   PE::CFusionSensor limited  (0.0, pos, heading, angSpeed, speed, 4, PE::CFusionSensor::OVERFLOW_FUSE);
+   EXPECT_EQ( 4, GetQueue(limited).GetCapacity() );
+
+   for ( uint32_t i = 1; i <= 20; ++i )
+   {
+      double ts = i * 0.5;
+      unlimited.AddSpeed(ts, speed);
+      unlimited.AddAngSpeed(ts, angSpeed);
+      limited.AddSpeed(ts, speed);
+      limited.AddAngSpeed(ts, angSpeed);
+      EXPECT_GE( 4, GetQueue(limited).GetSize() );
+   }
+   EXPECT_EQ( 16, limited.GetOverflowCount() );
+   EXPECT_EQ( 0, unlimited.GetOverflowCount() );
+   //oldest items are fused already
+   EXPECT_EQ( 8.0, limited.GetTimestamp() );
+
+   unlimited.DoFusion();
+   limited.DoFusion();
+   EXPECT_EQ( unlimited.GetTimestamp(), limited.GetTimestamp() );
+   EXPECT_EQ( unlimited.GetPosition().Latitude, limited.GetPosition().Latitude );
+   EXPECT_EQ( unlimited.GetPosition().Longitude, limited.GetPosition().Longitude );
+   EXPECT_EQ( unlimited.GetHeading().Value, limited.GetHeading().Value );
+   EXPECT_EQ( unlimited.GetSpeed().Accuracy, limited.GetSpeed().Accuracy );
+   EXPECT_EQ( 0, GetQueue(limited).GetSize() );
+}
+
+
+TEST_F(PECFusionSensorTest, test_queue_overflow_drop_oldest )
+{
+   PE::SBasicSensor  heading  ( 90.0,0.1);
+   PE::SBasicSensor angSpeed  ( 18.0,0.1);
+   PE::SBasicSensor    speed  ( 10.0,0.1);
+   PE::SPosition         pos  ( 50.0,10.0, 0.1);
+   PE::CFusionSensor fusion(0.0, pos, heading, angSpeed, speed, 2, PE::CFusionSensor::OVERFLOW_DROP_OLDEST);
+
+   fusion.AddSpeed(1.0, PE::SBasicSensor(20.0, 0.1));
+   fusion.AddSpeed(2.0, PE::SBasicSensor(20.0, 0.1));
+   //same timestamp is merged and does not need new item
+   fusion.AddSpeed(2.0, PE::SBasicSensor(20.0, 0.1));
+   EXPECT_EQ( 0, fusion.GetOverflowCount() );
+   fusion.AddSpeed(3.0, PE::SBasicSensor(20.0, 0.1));
+   fusion.AddSpeed(4.0, PE::SBasicSensor(20.0, 0.1));
+   EXPECT_EQ( 2, fusion.GetOverflowCount() );
+   //nothing was fused
+   EXPECT_EQ( 0.0, fusion.GetTimestamp() );
+   EXPECT_EQ( 3.0, GetQueue(fusion).Front().timestamp );
+
+   fusion.DoFusion();
+   EXPECT_EQ( 4.0, fusion.GetTimestamp() );
+}
+
+
+TEST_F(PECFusionSensorTest, test_merge_of_different_sensors_with_same_time )
+{
+   PE::CFusionSensor fusion = PE::CFusionSensor(0.0,PE::SPosition(), PE::SBasicSensor(), PE::SBasicSensor(), PE::SBasicSensor());
+   fusion.AddSpeed   (1.0, PE::SBasicSensor(10.0, 1.0));
+   fusion.AddAngSpeed(1.0, PE::SBasicSensor( 5.0, 1.0));
+   fusion.AddHeading (1.0, PE::SBasicSensor(45.0, 1.0));
+   fusion.AddPosition(1.0, PE::SPosition(50.0, 10.0, 1.0));
+   fusion.AddSpeed   (1.0, PE::SBasicSensor(12.0, 1.0));
+   EXPECT_EQ( 1, GetQueue(fusion).GetSize() );
+   EXPECT_EQ( 11.0, GetQueue(fusion).Back().speed.Value );
+   EXPECT_EQ(  5.0, GetQueue(fusion).Back().angSpeed.Value );
+   EXPECT_EQ( 45.0, GetQueue(fusion).Back().heading.Value );
+   EXPECT_EQ( 50.0, GetQueue(fusion).Back().position.Latitude );
+   //older timestamp is ignored
+   fusion.AddSpeed   (0.5, PE::SBasicSensor(12.0, 1.0));
+   EXPECT_EQ( 1, GetQueue(fusion).GetSize() );
+}
+
+
+TEST_F(PECFusionSensorTest, test_incremental_without_latency_budget )
+{
+   PE::SBasicSensor  heading  ( 90.0,0.1);
+   PE::SBasicSensor angSpeed  ( 18.0,0.1);
+   PE::SBasicSensor    speed  ( 10.0,0.1);
+   PE::SPosition         pos  ( 50.0,10.0, 0.1);
+   PE::CFusionSensor incremental(0.0, pos, heading, angSpeed, speed);
+   PE::CFusionSensor onDemand(0.0, pos, heading, angSpeed, speed);
+   incremental.SetIncremental(true);
+   EXPECT_TRUE( incremental.IsIncremental() );
+   EXPECT_FALSE( onDemand.IsIncremental() );
+
+   for ( uint32_t i = 1; i <= 20; ++i )
+   {
+      //each sensor makes previous one final and fuses it
+      incremental.AddSpeed(i * 0.5, speed);
+      EXPECT_EQ( ( i - 1 ) * 0.5, incremental.GetTimestamp() );
+      EXPECT_EQ( 1, GetQueue(incremental).GetSize() );
+      EXPECT_EQ( onDemand.GetPosition().Latitude, incremental.GetPosition().Latitude );
+      EXPECT_EQ( onDemand.GetPosition().Longitude, incremental.GetPosition().Longitude );
+      EXPECT_EQ( onDemand.GetHeading().Value, incremental.GetHeading().Value );
+      onDemand.AddSpeed(i * 0.5, speed);
+      onDemand.DoFusion();
+   }
+   EXPECT_EQ( 0, incremental.GetLateCount() );
+
+   //sensors with timestamp of pending item are merged without limit of waiting
+   incremental.Poll();
+   incremental.AddAngSpeed(10.0, angSpeed);
+   incremental.AddHeading(10.0, heading);
+   EXPECT_EQ( 9.5, incremental.GetTimestamp() );
+   EXPECT_EQ( 1, GetQueue(incremental).GetSize() );
+   EXPECT_TRUE( GetQueue(incremental).Back().angSpeed.IsValid() );
+   EXPECT_TRUE( GetQueue(incremental).Back().heading.IsValid() );
+   EXPECT_EQ( 0, incremental.GetLateCount() );
+
+   //sensor of fused timestamp is late
+   incremental.AddAngSpeed(9.5, angSpeed);
+   incremental.AddAngSpeed(9.0, angSpeed);
+   EXPECT_EQ( 2, incremental.GetLateCount() );
+   //DoFusion fuses pending item
+   incremental.DoFusion();
+   EXPECT_EQ( 10.0, incremental.GetTimestamp() );
+   EXPECT_EQ( 0, GetQueue(incremental).GetSize() );
+}
+
+
+/**
+ * GNSS fix sent as position, heading and speed of one timestamp is fused as one item
+ */
+TEST_F(PECFusionSensorTest, test_incremental_gnss_fix )
+{
+   PE::SBasicSensor  heading  ( 90.0,0.1);
+   PE::SBasicSensor angSpeed  ( 18.0,0.1);
+   PE::SBasicSensor    speed  ( 10.0,0.1);
+   PE::SPosition         pos  ( 50.0,10.0, 0.1);
+   PE::CFusionSensor incremental(0.0, pos, heading, angSpeed, speed);
+   PE::CFusionSensor onDemand(0.0, pos, heading, angSpeed, speed);
+   incremental.SetIncremental(true);
+
+   const PE::SPosition fix(50.0, 10.00014, 1.0);
+   const PE::SBasicSensor fixHeading(80.0, 1.0);
+   const PE::SBasicSensor fixSpeed(11.0, 0.5);
+   incremental.AddPosition(1.0, fix);
+   incremental.AddHeading (1.0, fixHeading);
+   incremental.AddSpeed   (1.0, fixSpeed);
+   incremental.AddSpeed   (2.0, speed);
+   onDemand.AddPosition(1.0, fix);
+   onDemand.AddHeading (1.0, fixHeading);
+   onDemand.AddSpeed   (1.0, fixSpeed);
+   onDemand.DoFusion();
+
+   EXPECT_EQ( 0, incremental.GetLateCount() );
+   EXPECT_EQ( 1.0, incremental.GetTimestamp() );
+   EXPECT_EQ( onDemand.GetPosition().Latitude, incremental.GetPosition().Latitude );
+   EXPECT_EQ( onDemand.GetPosition().Longitude, incremental.GetPosition().Longitude );
+   EXPECT_EQ( onDemand.GetHeading().Value, incremental.GetHeading().Value );
+   EXPECT_EQ( onDemand.GetSpeed().Value, incremental.GetSpeed().Value );
+}
+
+
+TEST_F(PECFusionSensorTest, test_incremental_with_latency_budget )
+{
+   PE::SBasicSensor  heading  ( 90.0,0.1);
+   PE::SBasicSensor angSpeed  ( 18.0,0.1);
+   PE::SBasicSensor    speed  ( 10.0,0.1);
+   PE::SPosition         pos  ( 50.0,10.0, 0.1);
+   PE::CFusionSensor incremental(0.0, pos, heading, angSpeed, speed);
+   PE::CFusionSensor onDemand(0.0, pos, heading, angSpeed, speed);
+   s_Now = 100.0;
+   incremental.SetIncremental(true, 0.001, GetNow);
+
+   incremental.AddSpeed(1.0, speed);
+   s_Now += 0.0005;
+   incremental.AddAngSpeed(1.0, angSpeed);
+   //still waiting for sensors with the same timestamp
+   EXPECT_EQ( 0.0, incremental.GetTimestamp() );
+   EXPECT_EQ( 1, GetQueue(incremental).GetSize() );
+
+   //newer timestamp makes the pending item final
+   incremental.AddSpeed(2.0, speed);
+   EXPECT_EQ( 1.0, incremental.GetTimestamp() );
+   onDemand.AddSpeed(1.0, speed);
+   onDemand.AddAngSpeed(1.0, angSpeed);
+   onDemand.DoFusion();
+   EXPECT_EQ( onDemand.GetPosition().Latitude, incremental.GetPosition().Latitude );
+   EXPECT_EQ( onDemand.GetPosition().Longitude, incremental.GetPosition().Longitude );
+   EXPECT_EQ( onDemand.GetAngSpeed().Accuracy, incremental.GetAngSpeed().Accuracy );
+
+   //budget is not spent yet
+   s_Now += 0.0009;
+   incremental.Poll();
+   EXPECT_EQ( 1.0, incremental.GetTimestamp() );
+   //budget is spent
+   s_Now += 0.0001;
+   incremental.Poll();
+   EXPECT_EQ( 2.0, incremental.GetTimestamp() );
+   EXPECT_EQ( 0, GetQueue(incremental).GetSize() );
+
+   //switching back fuses nothing new, DoFusion works as before
+   incremental.SetIncremental(false);
+   incremental.AddSpeed(3.0, speed);
+   EXPECT_EQ( 2.0, incremental.GetTimestamp() );
+   incremental.DoFusion();
+   EXPECT_EQ( 3.0, incremental.GetTimestamp() );
+   EXPECT_EQ( 0, incremental.GetLateCount() );
+}
+
+
+TEST_F(PECFusionSensorTest, test_switch_to_incremental_fuses_queue )
+{
+   PE::CFusionSensor fusion(0.0, PE::SPosition(50.0, 10.0, 0.1), PE::SBasicSensor(90.0, 0.1), PE::SBasicSensor(0.0, 0.1), PE::SBasicSensor(10.0, 0.1));
+   fusion.AddSpeed(1.0, PE::SBasicSensor(10.0, 0.1));
+   fusion.AddSpeed(2.0, PE::SBasicSensor(10.0, 0.1));
+   fusion.SetIncremental(true, 0.5);
+   EXPECT_EQ( 2.0, fusion.GetTimestamp() );
+   EXPECT_EQ( 0, GetQueue(fusion).GetSize() );
+   //DoFusion fuses pending item without waiting
+   fusion.AddSpeed(3.0, PE::SBasicSensor(10.0, 0.1));
+   fusion.DoFusion();
+   EXPECT_EQ( 3.0, fusion.GetTimestamp() );
+}
+
+
+TEST_F(PECFusionSensorTest, test_out_of_sequence_position )
+{
+   PE::SBasicSensor  heading  ( 90.0,0.1);
+   PE::SBasicSensor angSpeed  ( 18.0,0.1);
+   PE::SBasicSensor    speed  ( 10.0,0.1);
+   PE::SPosition         pos  ( 50.0,10.0, 0.1);
+   PE::SPosition        late  ( 50.00001401, 10.00013761, 0.1);
+   PE::CFusionSensor inOrder(0.0, pos, heading, angSpeed, speed);
+   PE::CFusionSensor delayed(0.0, pos, heading, angSpeed, speed);
+   PE::CFusionSensor ignoring(0.0, pos, heading, angSpeed, speed);
+   delayed.SetHistory(100);
+
+   for ( uint32_t i = 1; i <= 30; ++i )
+   {
+      const double ts = i * 0.1;
+      inOrder.AddSpeed(ts, speed);
+      inOrder.AddAngSpeed(ts, angSpeed);
+      delayed.AddSpeed(ts, speed);
+      delayed.AddAngSpeed(ts, angSpeed);
+      ignoring.AddSpeed(ts, speed);
+      ignoring.AddAngSpeed(ts, angSpeed);
+      if ( 10 == i )
+      {
+         inOrder.AddPosition(ts, late);
+      }
+      if ( 0 == i % 5 )
+      {
+         inOrder.DoFusion();
+         delayed.DoFusion();
+         ignoring.DoFusion();
+      }
+   }
+   //position of the same timestamp like fused item is merged into it and all newer items are fused again
+   delayed.AddPosition(1.0, late);
+   ignoring.AddPosition(1.0, late);
+   ignoring.DoFusion();
+   ExpectSame(inOrder, delayed);
+   EXPECT_EQ( 1, delayed.GetRewindCount() );
+   EXPECT_EQ( 21, delayed.GetReplayCount() );
+   EXPECT_EQ( 0, delayed.GetTooOldCount() );
+   EXPECT_NE( inOrder.GetPosition().HorizontalAcc, ignoring.GetPosition().HorizontalAcc );
+   EXPECT_EQ( 0, ignoring.GetRewindCount() );
+
+   //position between fused timestamps is inserted
+   PE::CFusionSensor inOrder2(0.0, pos, heading, angSpeed, speed);
+   PE::CFusionSensor delayed2(0.0, pos, heading, angSpeed, speed);
+   delayed2.SetHistory(100);
+   for ( uint32_t i = 1; i <= 30; ++i )
+   {
+      const double ts = i * 0.1;
+      inOrder2.AddSpeed(ts, speed);
+      delayed2.AddSpeed(ts, speed);
+      if ( 10 == i )
+      {
+         inOrder2.AddPosition(1.05, late);
+      }
+   }
+   inOrder2.DoFusion();
+   delayed2.DoFusion();
+   delayed2.AddPosition(1.05, late);
+   ExpectSame(inOrder2, delayed2);
+   EXPECT_EQ( 21, delayed2.GetReplayCount() );
+}
+
+
+TEST_F(PECFusionSensorTest, test_out_of_sequence_with_queued_items )
+{
+   PE::SBasicSensor  heading  ( 90.0,0.1);
+   PE::SBasicSensor angSpeed  ( 18.0,0.1);
+   PE::SBasicSensor    speed  ( 10.0,0.1);
+   PE::SPosition         pos  ( 50.0,10.0, 0.1);
+   PE::SPosition        late  ( 50.00001401, 10.00013761, 0.1);
+   PE::CFusionSensor inOrder(0.0, pos, heading, angSpeed, speed);
+   PE::CFusionSensor delayed(0.0, pos, heading, angSpeed, speed, 8);
+   delayed.SetHistory(8);
+
+   for ( uint32_t i = 1; i <= 6; ++i )
+   {
+      inOrder.AddSpeed(i * 0.2, speed);
+      delayed.AddSpeed(i * 0.2, speed);
+      if ( 2 == i )
+      {
+         inOrder.AddPosition(0.5, late);
+      }
+   }
+   //older than the last queued item, queue is fused first
+   delayed.AddPosition(0.5, late);
+   EXPECT_EQ( 0, GetQueue(delayed).GetSize() );
+   inOrder.DoFusion();
+   ExpectSame(inOrder, delayed);
+   EXPECT_EQ( 5, delayed.GetReplayCount() );
+}
+
+
+TEST_F(PECFusionSensorTest, test_out_of_sequence_older_than_history )
+{
+   PE::SBasicSensor  heading  ( 90.0,0.1);
+   PE::SBasicSensor angSpeed  ( 18.0,0.1);
+   PE::SBasicSensor    speed  ( 10.0,0.1);
+   PE::SPosition         pos  ( 50.0,10.0, 0.1);
+   PE::CFusionSensor fusion(0.0, pos, heading, angSpeed, speed);
+   PE::CFusionSensor reference(0.0, pos, heading, angSpeed, speed);
+   fusion.SetHistory(4);
+   for ( uint32_t i = 1; i <= 10; ++i )
+   {
+      fusion.AddSpeed(i, speed);
+      reference.AddSpeed(i, speed);
+   }
+   fusion.DoFusion();
+   reference.DoFusion();
+
+   //checkpoints before 7, 8, 9 and 10 are kept, state before 7 has timestamp 6
+   fusion.AddPosition(6.0, pos);
+   fusion.AddPosition(5.5, pos);
+   EXPECT_EQ( 2, fusion.GetTooOldCount() );
+   EXPECT_EQ( 0, fusion.GetRewindCount() );
+   ExpectSame(reference, fusion);
+
+   //rewind cost is bounded by history depth
+   fusion.AddSpeed(6.5, speed);
+   EXPECT_EQ( 1, fusion.GetRewindCount() );
+   EXPECT_EQ( 5, fusion.GetReplayCount() );
+   EXPECT_EQ( 10.0, fusion.GetTimestamp() );
+}
+
+
 int main(int argc, char *argv[])
 {
    ::testing::InitGoogleTest(&argc, argv);
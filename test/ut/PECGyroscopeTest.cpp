@@ -55,15 +55,15 @@ TEST_F(PECGyroscopeTest, test_set_get_ref_value)
    double GYRO_MIN                          = 0;
    double GYRO_MAX                          = 4096;
 
-   PE::CGyroscope gyro( HEADING_INTERVAL_100MS,
-                        HEADING_INTERVAL_HYSTERESIS_10MS,
-                        HEADING_MIN,
-                        HEADING_MAX,
-                        HEADING_ACCURACY_RATIO_2X,
-                        GYRO_INTERVAL_50MS,
-                        GYRO_INTERVAL_HYSTERESIS_5MS,
-                        GYRO_MIN,
-                        GYRO_MAX);
+   PE::CGyroscope<> gyro( HEADING_INTERVAL_100MS,
+                          HEADING_INTERVAL_HYSTERESIS_10MS,
+                          HEADING_MIN,
+                          HEADING_MAX,
+                          HEADING_ACCURACY_RATIO_2X,
+                          GYRO_INTERVAL_50MS,
+                          GYRO_INTERVAL_HYSTERESIS_5MS,
+                          GYRO_MIN,
+                          GYRO_MAX);
 
    //init values have to be NaN
    EXPECT_TRUE( PE::isnan(gyro.GetRefValue()) );
@@ -117,6 +117,13 @@ TEST_F(PECGyroscopeTest, test_set_get_ref_value)
    //set correct heading 90deg -> +500[deg/s] since last heading was correct
    EXPECT_TRUE ( gyro.SetRefValue(0.700, 0.800, HEADING_090DEG, HEADING_ACCURACY_10DEG));
    EXPECT_NEAR ( +500.0, gyro.GetRefValue(), 0.1 );
+
+   //each rejection is counted by its reason
+   EXPECT_EQ   ( 8, gyro.Stats().RefAccepted );
+   EXPECT_EQ   ( 1, gyro.Stats().RefOutOfRange );
+   EXPECT_EQ   ( 1, gyro.Stats().RefInterval );
+   EXPECT_EQ   ( 1, gyro.Stats().RefInaccurate );
+   EXPECT_EQ   ( 0, gyro.Stats().SenAccepted );
 }
 
 
@@ -135,15 +142,15 @@ TEST_F(PECGyroscopeTest, test_set_get_sen_value)
    double GYRO_MIN                          = 0;
    double GYRO_MAX                          = 4096;
 
-   PE::CGyroscope gyro( HEADING_INTERVAL_100MS,
-                        HEADING_INTERVAL_HYSTERESIS_10MS,
-                        HEADING_MIN,
-                        HEADING_MAX,
-                        HEADING_ACCURACY_RATIO_2X,
-                        GYRO_INTERVAL_50MS,
-                        GYRO_INTERVAL_HYSTERESIS_5MS,
-                        GYRO_MIN,
-                        GYRO_MAX);
+   PE::CGyroscope<> gyro( HEADING_INTERVAL_100MS,
+                          HEADING_INTERVAL_HYSTERESIS_10MS,
+                          HEADING_MIN,
+                          HEADING_MAX,
+                          HEADING_ACCURACY_RATIO_2X,
+                          GYRO_INTERVAL_50MS,
+                          GYRO_INTERVAL_HYSTERESIS_5MS,
+                          GYRO_MIN,
+                          GYRO_MAX);
 
    //init values have to be NaN
    EXPECT_TRUE( PE::isnan(gyro.GetSenValue()) );
@@ -199,6 +206,13 @@ TEST_F(PECGyroscopeTest, test_set_get_sen_value)
    //set correct gyro and interval is correct  -> sensor value still NaN
    EXPECT_TRUE ( gyro.SetSenValue(HEAD_TS_0125MS, GYRO_TS_0100MS, GYRO_TS_0150MS, GYRO_2000, GYRO_VALID));
    EXPECT_TRUE ( PE::isnan(gyro.GetSenValue()) );
+
+   //each rejection is counted by its reason
+   EXPECT_EQ   ( 7, gyro.Stats().SenAccepted );
+   EXPECT_EQ   ( 1, gyro.Stats().SenInvalid );
+   EXPECT_EQ   ( 1, gyro.Stats().SenOutOfRange );
+   EXPECT_EQ   ( 1, gyro.Stats().SenInterval );
+   EXPECT_EQ   ( 0, gyro.Stats().RefAccepted );
 }
 
 
@@ -220,15 +234,15 @@ TEST_F(PECGyroscopeTest, test_simple_circle_driving)
    double RAW_GYRO_BASE                     = 2048;
    double HEADING_DEVIATION_DEG             = 0.1;
 
-   PE::CGyroscope gyro( HEADING_INTERVAL_1S,
-                        HEADING_INTERVAL_HYSTERESIS_100MS,
-                        HEADING_MIN,
-                        HEADING_MAX,
-                        HEADING_ACCURACY_RATIO_2X,
-                        GYRO_INTERVAL_500MS,
-                        GYRO_INTERVAL_HYSTERESIS_25MS,
-                        GYRO_MIN,
-                        GYRO_MAX);
+   PE::CGyroscope<> gyro( HEADING_INTERVAL_1S,
+                          HEADING_INTERVAL_HYSTERESIS_100MS,
+                          HEADING_MIN,
+                          HEADING_MAX,
+                          HEADING_ACCURACY_RATIO_2X,
+                          GYRO_INTERVAL_500MS,
+                          GYRO_INTERVAL_HYSTERESIS_25MS,
+                          GYRO_MIN,
+                          GYRO_MAX);
    EXPECT_FALSE( gyro.AddHeading( 1.000,                   0, HEADING_DEVIATION_DEG)); //first adding is always false
    EXPECT_FALSE( gyro.AddGyro   ( 1.100,       RAW_GYRO_BASE, true)); //first adding is always false
    EXPECT_TRUE ( gyro.AddGyro   ( 1.600, RAW_GYRO_BASE +  50, true));
@@ -287,6 +301,57 @@ TEST_F(PECGyroscopeTest, test_simple_circle_driving)
    EXPECT_NEAR (    9.60, gyro.TimeStamp() ,0.01);
    EXPECT_NEAR (    0.1234567, gyro.Value() ,0.0000001);
    EXPECT_NEAR (    0.00, gyro.Accuracy() ,0.01);
+   //one calibration step per heading interval but the first one, nothing was rejected
+   EXPECT_EQ   ( 7, gyro.Stats().Steps );
+   EXPECT_EQ   ( 0, gyro.Stats().Resets );
+}
+
+
+/**
+ * Test temperature binned calibration: base of known temperature is available immediately
+ */
+TEST_F(PECGyroscopeTest, test_temperature_calibration)
+{
+   double RAW_GYRO_BASE_COLD = 2048;
+   double RAW_GYRO_BASE_WARM = 2100;
+   double RATES[]            = { 5, 10, 15, 20, 10 };
+
+   PE::CGyroscope<PE::CTemperatureCalibration> gyro( 0, 360, 2, 0, 4096 );
+
+   double ts = 1.0;
+   double head = 0;
+   double rawBase = RAW_GYRO_BASE_COLD;
+   double temperature = 0;
+   for ( uint32_t i = 0; i < 240; ++i )
+   {
+      if ( 120 == i )
+      {
+         rawBase = RAW_GYRO_BASE_WARM;
+         temperature = 60;
+      }
+      //gyroscope value belongs to heading change of the interval before its timestamp
+      double rate = RATES[i % 5];
+      gyro.AddHeading(ts, head, 0.1);
+      gyro.AddGyro(ts + 0.1, rawBase + RATES[(i + 4) % 5] * 10, true, temperature);
+      gyro.AddGyro(ts + 0.6, rawBase + rate * 10, true, temperature);
+      head = fmod(head + rate, 360);
+      ts += 1.0;
+      if ( 119 == i )
+      {
+         EXPECT_NEAR( RAW_GYRO_BASE_COLD, gyro.Base(), 0.01 );
+         EXPECT_NEAR( -0.1, gyro.Scale(), 0.001 );
+      }
+   }
+   //first steps after warm up are mixed with cold values
+   EXPECT_NEAR( RAW_GYRO_BASE_WARM, gyro.Base(), 0.5 );
+   EXPECT_NEAR( -0.1, gyro.Scale(), 0.001 );
+   EXPECT_LT  ( 90, gyro.CalibratedTo() );
+
+   //cold again, no new calibration is needed
+   gyro.AddGyro(ts + 0.1, RAW_GYRO_BASE_COLD + 50, true, 0);
+   EXPECT_NEAR( RAW_GYRO_BASE_COLD, gyro.Base(), 0.01 );
+   EXPECT_NEAR( -5, gyro.Value(), 0.01 );
+   EXPECT_LT  ( 90, gyro.CalibratedTo() );
 }
 
 
@@ -0,0 +1,135 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PE::CMatrix class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "PECMatrix.h"
+
+class PECMatrixTest : public ::testing::Test
+{
+public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+   }
+};
+
+
+/**
+ * check zero and identity matrices
+ */
+TEST_F(PECMatrixTest, test_init)
+{
+   PE::CMatrix<2, 3> zero;
+   EXPECT_EQ( 2, zero.GetRows() );
+   EXPECT_EQ( 3, zero.GetCols() );
+   for ( uint32_t row = 0; row < 2; ++row )
+   {
+      for ( uint32_t col = 0; col < 3; ++col )
+      {
+         EXPECT_EQ( 0.0, zero(row, col) );
+      }
+   }
+
+   PE::CMatrix<3, 3> identity = PE::CMatrix<3, 3>::Identity();
+   for ( uint32_t row = 0; row < 3; ++row )
+   {
+      for ( uint32_t col = 0; col < 3; ++col )
+      {
+         EXPECT_EQ( ( row == col ) ? 1.0 : 0.0, identity(row, col) );
+      }
+   }
+}
+
+
+/**
+ * check sum, difference, products and transpose
+ */
+TEST_F(PECMatrixTest, test_arithmetic)
+{
+   PE::CMatrix<2, 3> a;
+   PE::CMatrix<3, 2> b;
+   for ( uint32_t row = 0; row < 2; ++row )
+   {
+      for ( uint32_t col = 0; col < 3; ++col )
+      {
+         a(row, col) = row * 3 + col + 1;   // 1 2 3 / 4 5 6
+         b(col, row) = col * 2 + row + 1;   // 1 2 / 3 4 / 5 6
+      }
+   }
+
+   PE::CMatrix<2, 2> product = a * b;
+   EXPECT_EQ( 22.0, product(0, 0) );
+   EXPECT_EQ( 28.0, product(0, 1) );
+   EXPECT_EQ( 49.0, product(1, 0) );
+   EXPECT_EQ( 64.0, product(1, 1) );
+
+   PE::CMatrix<3, 2> transposed = a.Transpose();
+   EXPECT_EQ( 4.0, transposed(0, 1) );
+   EXPECT_EQ( 3.0, transposed(2, 0) );
+
+   PE::CMatrix<3, 2> sum = transposed + b;
+   EXPECT_EQ( 2.0, sum(0, 0) );
+   EXPECT_EQ( 12.0, sum(2, 1) );
+   PE::CMatrix<3, 2> difference = sum - b;
+   EXPECT_EQ( transposed(2, 1), difference(2, 1) );
+   PE::CMatrix<3, 2> scaled = b * 0.5;
+   EXPECT_EQ( 3.0, scaled(2, 1) );
+}
+
+
+/**
+ * check inverse of regular and singular matrices
+ */
+TEST_F(PECMatrixTest, test_invert)
+{
+   PE::CMatrix<3, 3> a;
+   a(0, 0) = 0.0; a(0, 1) = 2.0; a(0, 2) = 1.0;   //zero pivot needs row swap
+   a(1, 0) = 1.0; a(1, 1) = 1.0; a(1, 2) = 0.0;
+   a(2, 0) = 3.0; a(2, 1) = 0.0; a(2, 2) = 4.0;
+
+   PE::CMatrix<3, 3> inverse;
+   EXPECT_TRUE( a.Invert(inverse) );
+   PE::CMatrix<3, 3> identity = a * inverse;
+   for ( uint32_t row = 0; row < 3; ++row )
+   {
+      for ( uint32_t col = 0; col < 3; ++col )
+      {
+         EXPECT_NEAR( ( row == col ) ? 1.0 : 0.0, identity(row, col), 0.000000000001 );
+      }
+   }
+
+   PE::CMatrix<2, 2> singular;
+   singular(0, 0) = 1.0; singular(0, 1) = 2.0;
+   singular(1, 0) = 2.0; singular(1, 1) = 4.0;
+   PE::CMatrix<2, 2> unchanged = PE::CMatrix<2, 2>::Identity();
+   EXPECT_FALSE( singular.Invert(unchanged) );
+   EXPECT_EQ( 1.0, unchanged(0, 0) );
+   EXPECT_EQ( 0.0, unchanged(0, 1) );
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
@@ -0,0 +1,198 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PE::CNormalisationBank class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "PECNormalisationBank.h"
+
+class PECNormalisationBankTest : public ::testing::Test
+{
+public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+   }
+
+   /**
+    * Bank normaliser has to be bit exact like CNormalisation
+    */
+   static void CheckSame(const PE::CNormalisationBank& bank, uint32_t index, const PE::CNormalisation& norm)
+   {
+      EXPECT_EQ( norm.GetMean(), bank.GetMean(index) ) << "index " << index;
+      EXPECT_EQ( norm.GetMld(), bank.GetMld(index) ) << "index " << index;
+      EXPECT_EQ( norm.GetReliable(), bank.GetReliable(index) ) << "index " << index;
+      EXPECT_EQ( norm.GetSampleCount(), bank.GetSampleCount(index) ) << "index " << index;
+      EXPECT_EQ( norm.GetAccumulatedValue(), bank.m_AccumulatedValue[index] ) << "index " << index;
+      EXPECT_EQ( norm.GetAccumulatedMld(), bank.m_AccumulatedMld[index] ) << "index " << index;
+      EXPECT_EQ( norm.GetAccumulatedReliable(), bank.m_AccumulatedReliable[index] ) << "index " << index;
+   }
+
+   static uint32_t GetBlockLength(const std::vector<uint32_t>& indices)
+   {
+      return PE::CNormalisationBank::GetBlockLength(&indices[0], static_cast<uint32_t>( indices.size() ));
+   }
+};
+
+
+/**
+ * check initial state and resize
+ */
+TEST_F(PECNormalisationBankTest, test_init)
+{
+   PE::CNormalisationBank bank(3);
+   EXPECT_EQ( 3, bank.GetSize() );
+   PE::CNormalisation norm;
+   for ( uint32_t i = 0; i < 3; ++i )
+   {
+      CheckSame(bank, i, norm);
+   }
+   bank.AddSensor(1, 5.0);
+   bank.Resize(5);
+   EXPECT_EQ( 5, bank.GetSize() );
+   EXPECT_EQ( 1, bank.GetSampleCount(1) );
+   EXPECT_EQ( 0, bank.GetSampleCount(4) );
+}
+
+
+/**
+ * check single values against CNormalisation
+ */
+TEST_F(PECNormalisationBankTest, test_add_sensor)
+{
+   PE::CNormalisationBank bank(1);
+   PE::CNormalisation norm;
+   double values[] = { 10, 11, 9, 10, 10, 12, 8, 10 };
+   for ( uint32_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i )
+   {
+      bank.AddSensor(0, values[i]);
+      norm.AddSensor(values[i]);
+      CheckSame(bank, 0, norm);
+   }
+}
+
+
+/**
+ * check batches with repeated indices against sequential CNormalisation
+ */
+TEST_F(PECNormalisationBankTest, test_batch_with_repeated_indices)
+{
+   const uint32_t size = 37;
+   PE::CNormalisationBank bank(size);
+   std::vector<PE::CNormalisation> norms(size);
+
+   uint32_t seed = 4321;
+   for ( uint32_t batch = 0; batch < 50; ++batch )
+   {
+      std::vector<uint32_t> indices;
+      std::vector<double> values;
+      uint32_t count = 1 + batch * 7 % 300;
+      for ( uint32_t i = 0; i < count; ++i )
+      {
+         seed = seed * 1103515245 + 12345;
+         uint32_t index = ( seed >> 16 ) % size;
+         double value = 100.0 + index + static_cast<double>( ( seed >> 8 ) % 200 ) / 100.0;
+         indices.push_back(index);
+         values.push_back(value);
+         norms[index].AddSensor(value);
+      }
+      EXPECT_TRUE( bank.AddSensorBatch(indices, values) );
+   }
+   for ( uint32_t i = 0; i < size; ++i )
+   {
+      CheckSame(bank, i, norms[i]);
+      EXPECT_LT( 0, bank.GetSampleCount(i) );
+   }
+}
+
+
+/**
+ * check that wrong batch is rejected as whole
+ */
+TEST_F(PECNormalisationBankTest, test_wrong_batch)
+{
+   PE::CNormalisationBank bank(2);
+   uint32_t indices[] = { 0, 1, 2 };
+   double values[] = { 1.0, 2.0, 3.0 };
+   EXPECT_FALSE( bank.AddSensorBatch(indices, values, 3) );
+   EXPECT_EQ( 0, bank.GetSampleCount(0) );
+   EXPECT_EQ( 0, bank.GetSampleCount(1) );
+
+   EXPECT_FALSE( bank.AddSensorBatch(std::vector<uint32_t>(2, 0), std::vector<double>(1, 0.0)) );
+   EXPECT_TRUE( bank.AddSensorBatch(std::vector<uint32_t>(), std::vector<double>()) );
+   EXPECT_TRUE( bank.AddSensorBatch(indices, values, 2) );
+   EXPECT_EQ( 1, bank.GetSampleCount(0) );
+   EXPECT_EQ( 1, bank.GetSampleCount(1) );
+}
+
+
+/**
+ * check copy of state in and out of the bank
+ */
+TEST_F(PECNormalisationBankTest, test_set_get)
+{
+   PE::CNormalisation norm;
+   norm.AddSensor(1.0);
+   norm.AddSensor(2.0);
+   norm.AddSensor(4.0);
+
+   PE::CNormalisationBank bank(2);
+   bank.Set(1, norm);
+   CheckSame(bank, 1, norm);
+
+   PE::CNormalisation copy = bank.Get(1);
+   EXPECT_EQ( norm.GetMean(), copy.GetMean() );
+   EXPECT_EQ( norm.GetMld(), copy.GetMld() );
+   EXPECT_EQ( norm.GetReliable(), copy.GetReliable() );
+
+   //both continue the same way
+   bank.AddSensor(1, 3.0);
+   norm.AddSensor(3.0);
+   CheckSame(bank, 1, norm);
+}
+
+
+/**
+ * check splitting of the batch into blocks without repeated indices
+ */
+TEST_F(PECNormalisationBankTest, test_block_length)
+{
+   std::vector<uint32_t> indices;
+   for ( uint32_t i = 0; i < 3 * PE::CNormalisationBank::BLOCK_SIZE; ++i )
+   {
+      indices.push_back(i * 1024);
+   }
+   EXPECT_EQ( PE::CNormalisationBank::BLOCK_SIZE, GetBlockLength(indices) );
+
+   indices.resize(10);
+   EXPECT_EQ( 10, GetBlockLength(indices) );
+   indices[7] = indices[2];
+   EXPECT_EQ( 7, GetBlockLength(indices) );
+   indices[1] = indices[0];
+   EXPECT_EQ( 1, GetBlockLength(indices) );
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
@@ -596,6 +596,141 @@ TEST_F(PECNormalisationTest, test_reduced_reliable_value_by_big_difference)
 }
 
 
+/**
+ * check merging of one value part - same like adding of the value
+ */
+TEST_F(PECNormalisationTest, test_merge_one_value)
+{
+   double values[] = { 10.0016967, 10.017085, 10.01674144, 10.00577947, 10.0319618, 10.02513243,
+                       10.0049031, 10.04936262, 10.02806204, 10.03876338, 10.03785415, 10.02486409 };
+   PE::CNormalisation sequential;
+   for ( uint32_t i = 0; i < 12; ++i )
+   {
+      sequential.AddSensor(values[i]);
+   }
+   PE::CNormalisation merged = sequential;
+   PE::CNormalisation reversed;
+   reversed.AddSensor(10.02808851);
+   PE::CNormalisation one = reversed;
+
+   reversed.Merge(sequential);
+   sequential.AddSensor(10.02808851);
+   merged.Merge(one);
+   EXPECT_NEAR(sequential.GetMean(),               merged.GetMean(),               0.000000001);
+   EXPECT_NEAR(sequential.GetMld(),                merged.GetMld(),                0.000000001);
+   EXPECT_NEAR(sequential.GetReliable(),           merged.GetReliable(),           0.000000001);
+   EXPECT_NEAR(sequential.GetAccumulatedValue(),   merged.GetAccumulatedValue(),   0.000000001);
+   EXPECT_NEAR(sequential.GetAccumulatedMld(),     merged.GetAccumulatedMld(),     0.000000001);
+   EXPECT_NEAR(sequential.GetAccumulatedReliable(),merged.GetAccumulatedReliable(),0.000000001);
+   EXPECT_EQ  (sequential.GetSampleCount(),        merged.GetSampleCount());
+
+   //other way around
+   EXPECT_NEAR(merged.GetMean(),     reversed.GetMean(),     0.000000001);
+   EXPECT_NEAR(merged.GetMld(),      reversed.GetMld(),      0.000000001);
+   EXPECT_NEAR(merged.GetReliable(), reversed.GetReliable(), 0.000000001);
+}
+
+
+/**
+ * check merging of parts of values form set [10.0...10.05]
+ */
+TEST_F(PECNormalisationTest, test_merge_parts)
+{
+   double values[] = { 10.0016967, 10.017085, 10.01674144, 10.00577947, 10.0319618, 10.02513243,
+                       10.0049031, 10.04936262, 10.02806204, 10.03876338, 10.03785415, 10.02486409,
+                       10.02808851, 10.02160893, 10.0345712, 10.00268356, 10.01072438, 10.00000485,
+                       10.04422098, 10.01388693, 10.036653, 10.04984578, 10.014407, 10.00288788,
+                       10.04565213, 10.02560543, 10.04907064, 10.01231752, 10.03113507, 10.01523936,
+                       10.02933993, 10.03231828, 10.01362208, 10.00672482, 10.03193204, 10.00515203,
+                       10.02589951, 10.01857826, 10.03582339, 10.04985731 };
+   PE::CNormalisation sequential;
+   PE::CNormalisation parts[4];
+   for ( uint32_t i = 0; i < 40; ++i )
+   {
+      sequential.AddSensor(values[i]);
+      parts[i / 10].AddSensor(values[i]);
+   }
+
+   //tree merging like from parallel workers
+   PE::CNormalisation left = parts[0];
+   left.Merge(parts[1]);
+   PE::CNormalisation right = parts[2];
+   right.Merge(parts[3]);
+   left.Merge(right);
+
+   EXPECT_NEAR(sequential.GetMean(),             left.GetMean(),             0.000000001);
+   EXPECT_NEAR(sequential.GetAccumulatedValue(), left.GetAccumulatedValue(), 0.000000001);
+   EXPECT_EQ  (sequential.GetSampleCount(),      left.GetSampleCount());
+   EXPECT_NEAR(sequential.GetMld(),              left.GetMld(),              0.001);
+   //start-up of each part reduces reliable
+   EXPECT_GT  (sequential.GetReliable(),         left.GetReliable());
+   EXPECT_LT  (50.0,                             left.GetReliable());
+
+   //symmetric merging
+   PE::CNormalisation reverse = right;
+   reverse.Merge(parts[0]);
+   PE::CNormalisation forward = parts[0];
+   forward.Merge(right);
+   EXPECT_NEAR(forward.GetMean(),     reverse.GetMean(),     0.000000001);
+   EXPECT_NEAR(forward.GetMld(),      reverse.GetMld(),      0.000000001);
+   EXPECT_NEAR(forward.GetReliable(), reverse.GetReliable(), 0.000000001);
+}
+
+
+/**
+ * check merging of long parts - start-up of parts becomes negligible
+ */
+TEST_F(PECNormalisationTest, test_merge_long_parts)
+{
+   PE::CNormalisation sequential;
+   PE::CNormalisation parts[4];
+   uint32_t random = 12345;
+   for ( uint32_t i = 0; i < 4000; ++i )
+   {
+      random = random * 1103515245 + 12345;
+      double value = 10.0 + 0.05 * ( ( random >> 16 ) % 1000 ) / 1000.0;
+      sequential.AddSensor(value);
+      parts[i / 1000].AddSensor(value);
+   }
+   for ( uint32_t i = 1; i < 4; ++i )
+   {
+      parts[0].Merge(parts[i]);
+   }
+   EXPECT_NEAR(sequential.GetMean(),     parts[0].GetMean(),     0.000000001);
+   EXPECT_NEAR(sequential.GetMld(),      parts[0].GetMld(),      0.0001);
+   EXPECT_NEAR(sequential.GetReliable(), parts[0].GetReliable(), 1.0);
+}
+
+
+/**
+ * check merging with empty and invalid parts
+ */
+TEST_F(PECNormalisationTest, test_merge_empty_and_invalid)
+{
+   PE::CNormalisation norm;
+   norm.AddSensor(1.0);
+   norm.AddSensor(3.0);
+
+   PE::CNormalisation empty;
+   norm.Merge(empty);
+   EXPECT_NEAR(2.0, norm.GetMean(),        0.000001);
+   EXPECT_NEAR(2.0, norm.GetSampleCount(), 0.000001);
+
+   PE::CNormalisation invalid(10.0, 0.0, -1.0, 5.0);
+   norm.Merge(invalid);
+   EXPECT_NEAR(2.0, norm.GetMean(),        0.000001);
+
+   empty.Merge(norm);
+   EXPECT_NEAR(2.0, empty.GetMean(),        0.000001);
+   EXPECT_NEAR(1.0, empty.GetMld(),         0.000001);
+   EXPECT_NEAR(2.0, empty.GetSampleCount(), 0.000001);
+
+   invalid.Merge(norm);
+   EXPECT_NEAR(2.0, invalid.GetMean(),        0.000001);
+   EXPECT_NEAR(2.0, invalid.GetSampleCount(), 0.000001);
+}
+
+
 int main(int argc, char *argv[])
 {
    ::testing::InitGoogleTest(&argc, argv);
@@ -52,15 +52,15 @@ TEST_F(PECOdometerExTest, test_odo_all_is_valid)
    double ODO_INTERVAL_HYSTERESIS_5MS      = 0.005;
    double ODO_MIN                          = 0;
    double ODO_MAX                          = 1000000;
-   PE::COdometerEx odo( SPEED_INTERVAL_100MS,
-                        SPEED_INTERVAL_HYSTERESIS_10MS,
-                        SPEED_MIN,
-                        SPEED_MAX,
-                        SPEED_ACCURACY_RATIO_2X,
-                        ODO_INTERVAL_25MS,
-                        ODO_INTERVAL_HYSTERESIS_5MS,
-                        ODO_MIN,
-                        ODO_MAX);
+   PE::COdometerEx<> odo( SPEED_INTERVAL_100MS,
+                          SPEED_INTERVAL_HYSTERESIS_10MS,
+                          SPEED_MIN,
+                          SPEED_MAX,
+                          SPEED_ACCURACY_RATIO_2X,
+                          ODO_INTERVAL_25MS,
+                          ODO_INTERVAL_HYSTERESIS_5MS,
+                          ODO_MIN,
+                          ODO_MAX);
 
    //init values have to be NaN
    EXPECT_TRUE( PE::isnan(odo.GetRefValue()) );
@@ -133,15 +133,15 @@ TEST_F(PECOdometerExTest, test_set_get_reference_value)
    double ODO_INTERVAL_HYSTERESIS_5MS      = 0.005;
    double ODO_MIN                          = 0;
    double ODO_MAX                          = 2048;
-   PE::COdometerEx odo( SPEED_INTERVAL_100MS,
-                        SPEED_INTERVAL_HYSTERESIS_10MS,
-                        SPEED_MIN,
-                        SPEED_MAX,
-                        SPEED_ACCURACY_RATIO_2X,
-                        ODO_INTERVAL_50MS,
-                        ODO_INTERVAL_HYSTERESIS_5MS,
-                        ODO_MIN,
-                        ODO_MAX);
+   PE::COdometerEx<> odo( SPEED_INTERVAL_100MS,
+                          SPEED_INTERVAL_HYSTERESIS_10MS,
+                          SPEED_MIN,
+                          SPEED_MAX,
+                          SPEED_ACCURACY_RATIO_2X,
+                          ODO_INTERVAL_50MS,
+                          ODO_INTERVAL_HYSTERESIS_5MS,
+                          ODO_MIN,
+                          ODO_MAX);
 
    //init values have to be NaN
    EXPECT_TRUE( PE::isnan(odo.GetRefValue()) );
@@ -165,6 +165,13 @@ TEST_F(PECOdometerExTest, test_set_get_reference_value)
    
    EXPECT_TRUE ( odo.SetRefValue(1.000, 1.100,  9.9, 5.0) );
    EXPECT_TRUE( PE::isnan(odo.GetRefValue()) );
+
+   //each rejection is counted by its reason
+   EXPECT_EQ   ( 7, odo.Stats().RefAccepted );
+   EXPECT_EQ   ( 2, odo.Stats().RefOutOfRange );
+   EXPECT_EQ   ( 2, odo.Stats().RefInterval );
+   //zero speed and 9.9 are not bigger than twice of their accuracy
+   EXPECT_EQ   ( 2, odo.Stats().RefInaccurate );
 }
 
 
@@ -182,15 +189,15 @@ TEST_F(PECOdometerExTest, test_set_get_sensor_value)
    double ODO_INTERVAL_HYSTERESIS_50MS   = 0.050;
    double ODO_MIN                        = 0;
    double ODO_MAX                        = 4000;
-   PE::COdometerEx odo( SPEED_INTERVAL_100MS,
-                        SPEED_INTERVAL_HYSTERESIS_10MS,
-                        SPEED_MIN,
-                        SPEED_MAX,
-                        SPEED_ACCURACY_RATIO_2X,
-                        ODO_INTERVAL_1000MS,
-                        ODO_INTERVAL_HYSTERESIS_50MS,
-                        ODO_MIN,
-                        ODO_MAX);
+   PE::COdometerEx<> odo( SPEED_INTERVAL_100MS,
+                          SPEED_INTERVAL_HYSTERESIS_10MS,
+                          SPEED_MIN,
+                          SPEED_MAX,
+                          SPEED_ACCURACY_RATIO_2X,
+                          ODO_INTERVAL_1000MS,
+                          ODO_INTERVAL_HYSTERESIS_50MS,
+                          ODO_MIN,
+                          ODO_MAX);
 
    //init values have to be NaN
    EXPECT_TRUE( PE::isnan(odo.GetSenValue()) );
@@ -217,6 +224,12 @@ TEST_F(PECOdometerExTest, test_set_get_sensor_value)
    EXPECT_TRUE ( PE::isnan(odo.GetSenValue()) ); //NaN
    EXPECT_TRUE ( odo.SetSenValue(1.500, 1.000, 2.000, 2600, true) );
    EXPECT_NEAR ( 300, odo.GetSenValue(), 0.0001 );
+
+   //each rejection is counted by its reason
+   EXPECT_EQ   ( 6, odo.Stats().SenAccepted );
+   EXPECT_EQ   ( 1, odo.Stats().SenInvalid );
+   EXPECT_EQ   ( 2, odo.Stats().SenOutOfRange );
+   EXPECT_EQ   ( 2, odo.Stats().SenInterval );
 }
 
 
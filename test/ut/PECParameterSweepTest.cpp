@@ -0,0 +1,166 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PE::CParameterSweep class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "PECParameterSweep.h"
+#include "PETypes.h"
+
+class PECParameterSweepTest : public ::testing::Test
+{
+public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+   }
+
+   PE::CParameterSweep::SLimits GetOdoLimits(const double& speedHysteresis, const double& odoHysteresis) const
+   {
+      PE::CParameterSweep::SLimits limits;
+      limits.RefInterval      = 0.100;
+      limits.RefHysteresis    = speedHysteresis;
+      limits.RefMin           = 0;
+      limits.RefMax           = 343;
+      limits.RefAccuracyRatio = 2;
+      limits.SenInterval      = 0.040;
+      limits.SenHysteresis    = odoHysteresis;
+      limits.SenMin           = 0;
+      limits.SenMax           = 2047;
+      return limits;
+   }
+};
+
+
+/**
+ * empty track and empty sweep
+ */
+TEST_F(PECParameterSweepTest, test_empty)
+{
+   PE::CTrack track;
+   PE::CParameterSweep sweep(track, PE::CParameterSweep::SENSOR_ODOMETER, 50);
+   sweep.Run(2);
+   EXPECT_EQ( 0, sweep.GetResults().size() );
+
+   sweep.AddLimits(GetOdoLimits(0.040, 0.002));
+   sweep.Run(2);
+   EXPECT_EQ( 1, sweep.GetResults().size() );
+   EXPECT_EQ( PE::MAX_TIMESTAMP, sweep.GetResults()[0].ConvergenceTime );
+   EXPECT_EQ( 0, sweep.GetResults()[0].Accepted );
+}
+
+
+/**
+ * parallel run gives the same results like serial one and ranks them
+ */
+TEST_F(PECParameterSweepTest, test_odometer_sweep)
+{
+   PE::CTrack track;
+   EXPECT_TRUE( track.LoadText(PE_TEST_TRACKS_DIR "ODO_40ms_60sec_GNSS_100ms_32sec.txt") );
+
+   PE::CParameterSweep sweep(track, PE::CParameterSweep::SENSOR_ODOMETER, 10);
+   sweep.AddLimits(GetOdoLimits(0.001, 0.002)); //speed jitter is bigger then hysteresis
+   sweep.AddLimits(GetOdoLimits(0.010, 0.002));
+   sweep.AddLimits(GetOdoLimits(0.040, 0.002));
+   sweep.AddLimits(GetOdoLimits(0.040, 0.0001)); //odometer jitter is bigger then hysteresis
+   EXPECT_EQ( 4, sweep.GetSize() );
+   sweep.Run(4);
+
+   const std::vector<PE::CParameterSweep::SResult>& results = sweep.GetResults();
+   ASSERT_EQ( 4, results.size() );
+   //best one has the widest speed hysteresis
+   EXPECT_EQ( 2, results[0].Index );
+   EXPECT_LT( results[0].ConvergenceTime, PE::MAX_TIMESTAMP );
+   EXPECT_LT( 10, results[0].CalibratedTo );
+   EXPECT_LT( 1000, results[0].Accepted );
+   //ranking order
+   for ( uint32_t i = 1; i < results.size(); ++i )
+   {
+      EXPECT_LE( results[i - 1].ConvergenceTime, results[i].ConvergenceTime );
+      if ( results[i - 1].ConvergenceTime == results[i].ConvergenceTime )
+      {
+         EXPECT_GE( results[i - 1].CalibratedTo, results[i].CalibratedTo );
+      }
+   }
+   //each result is equal to serial evaluation
+   for ( uint32_t i = 0; i < results.size(); ++i )
+   {
+      PE::CParameterSweep::SResult serial = PE::CParameterSweep::Evaluate(track, PE::CParameterSweep::SENSOR_ODOMETER, 10, sweep.GetLimits(results[i].Index));
+      EXPECT_EQ( serial.ConvergenceTime, results[i].ConvergenceTime );
+      EXPECT_EQ( serial.CalibratedTo, results[i].CalibratedTo );
+      EXPECT_EQ( serial.Base, results[i].Base );
+      EXPECT_EQ( serial.Scale, results[i].Scale );
+      EXPECT_EQ( serial.Accepted, results[i].Accepted );
+   }
+}
+
+
+/**
+ * gyroscope uses heading and gyro events
+ */
+TEST_F(PECParameterSweepTest, test_gyroscope_sweep)
+{
+   PE::CTrack track;
+   double ts = 1.0;
+   double heading = 0;
+   for ( uint32_t i = 0; i < 400; ++i )
+   {
+      double angSpeed = 5.0 * ( 1 + (i / 20) % 3 ); //5, 10 or 15 deg/s
+      ts += 0.050;
+      heading += angSpeed * 0.050;
+      track.Add(PE::STrackEvent(ts, PE::EVENT_GYRO, 2048 - angSpeed * 10)); //scale -0.1
+      if ( 0 == i % 2 )
+      {
+         track.Add(PE::STrackEvent(ts, PE::EVENT_HEADING, heading, 0.01));
+      }
+   }
+   PE::CParameterSweep::SLimits limits;
+   limits.RefInterval      = 0.100;
+   limits.RefHysteresis    = 0.010;
+   limits.RefMin           = 0;
+   limits.RefMax           = 360;
+   limits.RefAccuracyRatio = 2;
+   limits.SenInterval      = 0.050;
+   limits.SenHysteresis    = 0.005;
+   limits.SenMin           = 0;
+   limits.SenMax           = 4096;
+
+   PE::CParameterSweep sweep(track, PE::CParameterSweep::SENSOR_GYROSCOPE, 1);
+   sweep.AddLimits(limits);
+   limits.RefInterval      = 0.200; //wrong heading interval
+   sweep.AddLimits(limits);
+   sweep.Run(2);
+
+   const std::vector<PE::CParameterSweep::SResult>& results = sweep.GetResults();
+   ASSERT_EQ( 2, results.size() );
+   EXPECT_EQ( 0, results[0].Index );
+   EXPECT_LT( results[0].ConvergenceTime, PE::MAX_TIMESTAMP );
+   EXPECT_EQ( 1, results[1].Index );
+   EXPECT_EQ( PE::MAX_TIMESTAMP, results[1].ConvergenceTime );
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
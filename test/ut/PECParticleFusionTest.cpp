@@ -0,0 +1,232 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PE::CParticleFusion class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "PECParticleFusion.h"
+#include "PECFusionSensor.h"
+#include "PETools.h"
+
+
+class PECParticleFusionTest : public ::testing::Test
+{
+public:
+   virtual void SetUp()
+   {}
+   virtual void TearDown()
+   {}
+
+   /**
+    * Expects position within distance in meter
+    */
+   static void ExpectPosition(const PE::SPosition& expected, const PE::SPosition& position, const double& distance)
+   {
+      EXPECT_GT( distance, GetDistance(expected, position) ) << position.Latitude << " " << position.Longitude;
+   }
+
+   static double GetDistance(const PE::SPosition& first, const PE::SPosition& second)
+   {
+      return PE::TOOLS::ToDistance(first.Latitude, first.Longitude, second.Latitude, second.Longitude);
+   }
+
+   static uint32_t GetQueueSize(const PE::CParticleFusion& fusion)
+   {
+      return fusion.m_SensorsList.GetSize();
+   }
+
+   static uint32_t GetChunkCount(const PE::CParticleFusion& fusion)
+   {
+      return static_cast<uint32_t>(fusion.m_Sums.size());
+   }
+
+   /**
+    * Straight track to north with 10 m/s, speeds at 10Hz and positions at 1Hz,
+    * the position of second 5 is reflected by a building 30 m to east
+    */
+   template <typename TFusion>
+   static double RunMultipath(TFusion& fusion, const PE::SPosition& start)
+   {
+      double maxError = 0.0;
+      for ( uint32_t i = 1; i <= 100; ++i )
+      {
+         const double timestamp = 0.1 * i;
+         fusion.AddSpeed(timestamp, PE::SBasicSensor(10.0, 0.1));
+         fusion.AddAngSpeed(timestamp, PE::SBasicSensor(0.0, 0.1));
+         PE::SPosition truth = PE::TOOLS::ToPosition(start, 10.0 * timestamp, 0.0);
+         if ( 0 == i % 10 )
+         {
+            PE::SPosition position = ( 50 == i ) ? PE::TOOLS::ToPosition(truth, 30.0, 90.0) : truth;
+            position.HorizontalAcc = 2.0;
+            fusion.AddPosition(timestamp, position);
+         }
+         fusion.DoFusion();
+         maxError = std::max(maxError, GetDistance(truth, fusion.GetPosition()));
+      }
+      return maxError;
+   }
+};
+
+
+TEST_F(PECParticleFusionTest, test_create )
+{
+   PE::SPosition pos = PE::SPosition(50.0,10.0,1.0);
+   PE::CParticleFusion fusion(1000.0, pos, PE::SBasicSensor(90.0,1.0), PE::SBasicSensor(10.0,0.2), PE::SBasicSensor(5.0,0.1), 1000);
+   //rounded up to blocks
+   EXPECT_EQ( 1024, fusion.GetParticleCount() );
+   EXPECT_EQ( 1, GetChunkCount(fusion) );
+   EXPECT_EQ( 1000.0, fusion.GetTimestamp() );
+   ExpectPosition(pos, fusion.GetPosition(), 0.2);
+   EXPECT_NEAR( 1.0, fusion.GetPosition().HorizontalAcc, 0.1 );
+   EXPECT_NEAR( 0.0, PE::TOOLS::ToAngle(90.0, fusion.GetHeading().Value), 0.2 );
+   EXPECT_NEAR( 1.0, fusion.GetHeading().Accuracy, 0.1 );
+   EXPECT_EQ( 5.0, fusion.GetSpeed().Value );
+   EXPECT_EQ( 10.0, fusion.GetAngSpeed().Value );
+
+   EXPECT_FALSE( fusion.GetSpeed(999.0).IsValid() );
+   EXPECT_EQ( 5.0, fusion.GetSpeed(1001.0).Value );
+   EXPECT_LT( 0.1, fusion.GetSpeed(1001.0).Accuracy );
+   EXPECT_FALSE( fusion.GetAngSpeed(999.0).IsValid() );
+   EXPECT_EQ( 10.0, fusion.GetAngSpeed(1001.0).Value );
+}
+
+
+TEST_F(PECParticleFusionTest, test_old_timestamp )
+{
+   PE::CParticleFusion fusion(10.0, PE::SPosition(50.0, 10.0, 1.0), PE::SBasicSensor(0.0, 1.0), PE::SBasicSensor(0.0, 1.0), PE::SBasicSensor(1.0, 1.0));
+   fusion.AddSpeed(12.0, PE::SBasicSensor(2.0, 0.1));
+   fusion.AddSpeed(11.0, PE::SBasicSensor(5.0, 0.1));
+   EXPECT_EQ( 1, GetQueueSize(fusion) );
+   fusion.DoFusion();
+   EXPECT_EQ( 12.0, fusion.GetTimestamp() );
+
+   fusion.AddSpeed(11.0, PE::SBasicSensor(5.0, 0.1));
+   fusion.DoFusion();
+   EXPECT_EQ( 12.0, fusion.GetTimestamp() );
+   EXPECT_NEAR( 2.0, fusion.GetSpeed().Value, 0.1 );
+}
+
+
+TEST_F(PECParticleFusionTest, test_one_circle_left_by_permanent_angular_and_linear_speed )
+{
+   PE::SBasicSensor  heading  ( 90.0,0.1);
+   PE::SBasicSensor angSpeed  ( 18.0,0.1); //turn left 18deg/s
+   PE::SBasicSensor    speed  ( 10.0,0.1); //10 m/s
+   PE::SPosition         pos  ( 50.0,10.0, 0.1);
+   PE::CParticleFusion fusion(0.0,pos,heading,angSpeed,speed);
+
+   const double timestamps[] = { 1.0, 2.0, 3.0, 4.0, 5.0, 10.0, 15.0, 20.0 };
+   const PE::SPosition positions[] = {
+      PE::SPosition(50.00001401, 10.00013761), PE::SPosition(50.00005467, 10.00026176),
+      PE::SPosition(50.00011800, 10.00036029), PE::SPosition(50.00019780, 10.00042354),
+      PE::SPosition(50.00028626, 10.00044534), PE::SPosition(50.00057252, 10.00000000),
+      PE::SPosition(50.00028626,  9.99955464), PE::SPosition(50.00000000, 10.00000000) };
+   const double headings[] = { 72.0, 54.0, 36.0, 18.0, 0.0, 270.0, 180.0, 90.0 };
+   double accuracy = fusion.GetPosition().HorizontalAcc;
+   for ( uint32_t i = 0; i < 8; ++i )
+   {
+      fusion.AddSpeed(timestamps[i], speed);
+      fusion.AddAngSpeed(timestamps[i], angSpeed);
+      fusion.DoFusion();
+      ExpectPosition(positions[i], fusion.GetPosition(), 1.0);
+      EXPECT_NEAR( 0.0, PE::TOOLS::ToAngle(headings[i], fusion.GetHeading().Value), 1.0 );
+      //without position measurements uncertainty grows
+      EXPECT_LT( accuracy, fusion.GetPosition().HorizontalAcc );
+      accuracy = fusion.GetPosition().HorizontalAcc;
+   }
+   EXPECT_EQ( 0, fusion.GetResampleCount() );
+}
+
+
+TEST_F(PECParticleFusionTest, test_unknown_heading_by_positions )
+{
+   //heading is unknown, particles drive in all directions, positions to east select them
+   PE::SPosition pos(50.0, 10.0, 1.0);
+   PE::CParticleFusion fusion(0.0, pos, PE::SBasicSensor(), PE::SBasicSensor(0.0, 0.1), PE::SBasicSensor(10.0, 0.1), 4096);
+   EXPECT_FALSE( fusion.GetHeading().IsValid() );
+   for ( uint32_t i = 1; i <= 10; ++i )
+   {
+      fusion.AddSpeed(i, PE::SBasicSensor(10.0, 0.1));
+      fusion.AddAngSpeed(i, PE::SBasicSensor(0.0, 0.1));
+      fusion.AddPosition(i, PE::TOOLS::ToPosition(pos, 10.0 * i, 90.0));
+      fusion.DoFusion();
+   }
+   EXPECT_LT( 0, fusion.GetResampleCount() );
+   ASSERT_TRUE( fusion.GetHeading().IsValid() );
+   EXPECT_NEAR( 90.0, fusion.GetHeading().Value, 5.0 );
+   ExpectPosition(PE::TOOLS::ToPosition(pos, 100.0, 90.0), fusion.GetPosition(), 2.0);
+}
+
+
+TEST_F(PECParticleFusionTest, test_heading_measurement )
+{
+   PE::SPosition pos(50.0, 10.0, 1.0);
+   PE::CParticleFusion fusion(0.0, pos, PE::SBasicSensor(), PE::SBasicSensor(0.0, 0.1), PE::SBasicSensor(10.0, 0.1));
+   fusion.AddHeading(1.0, PE::SBasicSensor(270.0, 2.0));
+   fusion.DoFusion();
+   ASSERT_TRUE( fusion.GetHeading().IsValid() );
+   EXPECT_NEAR( 0.0, PE::TOOLS::ToAngle(270.0, fusion.GetHeading().Value), 2.0 );
+   EXPECT_GT( 5.0, fusion.GetHeading().Accuracy );
+}
+
+
+TEST_F(PECParticleFusionTest, test_multipath_outlier )
+{
+   const PE::SPosition start(50.0, 10.0, 1.0);
+   PE::CFusionSensor single(0.0, start, PE::SBasicSensor(0.0, 1.0), PE::SBasicSensor(0.0, 0.1), PE::SBasicSensor(10.0, 0.1));
+   PE::CParticleFusion particles(0.0, start, PE::SBasicSensor(0.0, 1.0), PE::SBasicSensor(0.0, 0.1), PE::SBasicSensor(10.0, 0.1));
+
+   //scalar merge moves position to the middle of the reflection, particles keep the track
+   EXPECT_LT( 10.0, RunMultipath(single, start) );
+   EXPECT_GT( 5.0, RunMultipath(particles, start) );
+}
+
+
+TEST_F(PECParticleFusionTest, test_threads )
+{
+   const PE::SPosition start(50.0, 10.0, 1.0);
+   PE::CParticleFusion fusion(0.0, start, PE::SBasicSensor(0.0, 1.0), PE::SBasicSensor(0.0, 0.1), PE::SBasicSensor(10.0, 0.1), 10000, 3);
+   EXPECT_EQ( 10048, fusion.GetParticleCount() );
+   EXPECT_EQ( 3, GetChunkCount(fusion) );
+   EXPECT_GT( 5.0, RunMultipath(fusion, start) );
+   EXPECT_LT( 0, fusion.GetResampleCount() );
+   EXPECT_NEAR( 0.0, PE::TOOLS::ToAngle(0.0, fusion.GetHeading().Value), 2.0 );
+}
+
+
+TEST_F(PECParticleFusionTest, test_queue_overflow_fuse )
+{
+   PE::CParticleFusion fusion(0.0, PE::SPosition(50.0, 10.0, 1.0), PE::SBasicSensor(0.0, 1.0), PE::SBasicSensor(0.0, 0.1), PE::SBasicSensor(1.0, 0.1), 64);
+   for ( uint32_t i = 1; i <= PE::CParticleFusion::CAPACITY + 2; ++i )
+   {
+      fusion.AddSpeed(i, PE::SBasicSensor(1.0, 0.1));
+   }
+   EXPECT_EQ( 2, fusion.GetOverflowCount() );
+   EXPECT_EQ( PE::CParticleFusion::CAPACITY, GetQueueSize(fusion) );
+   fusion.DoFusion();
+   EXPECT_EQ( PE::CParticleFusion::CAPACITY + 2.0, fusion.GetTimestamp() );
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
@@ -0,0 +1,294 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PE::CRateEstimator class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "PECRateEstimator.h"
+#include "PECGyroscope.h"
+#include "PETypes.h"
+
+class PECRateEstimatorTest : public ::testing::Test
+{
+public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+   }
+
+   uint32_t GetLockSamples() const
+   {
+      return PE::CRateEstimator::LOCK_SAMPLES;
+   }
+
+   uint32_t GetHistogramMax(const PE::CRateEstimator& rate) const
+   {
+      uint32_t max = 0;
+      for ( uint32_t i = 0; i < PE::CRateEstimator::BIN_COUNT; ++i )
+      {
+         if ( max < rate.m_Histogram[i] )
+         {
+            max = rate.m_Histogram[i];
+         }
+      }
+      return max;
+   }
+
+   uint32_t GetHistogramSum(const PE::CRateEstimator& rate) const
+   {
+      uint32_t sum = 0;
+      for ( uint32_t i = 0; i < PE::CRateEstimator::BIN_COUNT; ++i )
+      {
+         sum += rate.m_Histogram[i];
+      }
+      return sum;
+   }
+
+   uint32_t GetSamples(const PE::CRateEstimator& rate) const
+   {
+      return rate.m_Samples;
+   }
+};
+
+
+/**
+ * fixed mode does not learn anything
+ */
+TEST_F(PECRateEstimatorTest, test_fixed_mode)
+{
+   PE::CRateEstimator rate(0.100, 0.010);
+   EXPECT_TRUE ( rate.IsLocked() );
+   EXPECT_FALSE( rate.IsIntervalOk(0.090) );
+   EXPECT_TRUE ( rate.IsIntervalOk(0.0901) );
+   EXPECT_TRUE ( rate.IsIntervalOk(0.1099) );
+   EXPECT_FALSE( rate.IsIntervalOk(0.110) );
+
+   for ( uint32_t i = 0; i < 100; ++i )
+   {
+      rate.AddInterval(0.040);
+   }
+   EXPECT_FALSE( rate.IsIntervalOk(0.040) );
+   EXPECT_NEAR ( 0.100, rate.GetInterval(), PE::EPSILON );
+   EXPECT_NEAR ( 0.010, rate.GetHysteresis(), PE::EPSILON );
+   EXPECT_EQ   ( 0, rate.GetAvoidedResets() );
+}
+
+
+/**
+ * auto mode rejects all intervals till rate is detected
+ */
+TEST_F(PECRateEstimatorTest, test_auto_mode_lock)
+{
+   PE::CRateEstimator rate;
+   EXPECT_FALSE( rate.IsLocked() );
+   EXPECT_FALSE( rate.IsIntervalOk(0.040) );
+
+   for ( uint32_t i = 1; i < GetLockSamples(); ++i )
+   {
+      rate.AddInterval(0.040);
+      EXPECT_FALSE( rate.IsLocked() );
+      EXPECT_FALSE( rate.IsIntervalOk(0.040) );
+   }
+   rate.AddInterval(0.040);
+   EXPECT_TRUE ( rate.IsLocked() );
+   EXPECT_NEAR ( 0.040, rate.GetInterval(), 0.0004 ); //bin resolution 2%
+   EXPECT_NEAR ( 0.002, rate.GetHysteresis(), 0.0001 ); //minimal hysteresis 5%
+   EXPECT_TRUE ( rate.IsIntervalOk(0.041) );
+   EXPECT_TRUE ( rate.IsIntervalOk(0.039) );
+   EXPECT_FALSE( rate.IsIntervalOk(0.045) );
+   EXPECT_FALSE( rate.IsIntervalOk(0.035) );
+   EXPECT_FALSE( rate.IsIntervalOk(0.080) );
+
+   //tracking moves interval to real mean
+   for ( uint32_t i = 0; i < 200; ++i )
+   {
+      rate.AddInterval(0.040);
+   }
+   EXPECT_NEAR ( 0.040, rate.GetInterval(), 0.00001 );
+   //band of the first lock is nominal one
+   EXPECT_EQ   ( 0, rate.GetAvoidedResets() );
+}
+
+
+/**
+ * auto mode ignores noise intervals during detection
+ */
+TEST_F(PECRateEstimatorTest, test_auto_mode_noise)
+{
+   PE::CRateEstimator rate;
+   //only outliers
+   rate.AddInterval(0.0);
+   rate.AddInterval(-1.0);
+   rate.AddInterval(1000.0);
+   for ( uint32_t i = 0; i < GetLockSamples(); ++i )
+   {
+      rate.AddInterval(0.010 * (i + 1));
+   }
+   EXPECT_FALSE( rate.IsLocked() );
+   //dominated rate
+   for ( uint32_t i = 0; i < GetLockSamples(); ++i )
+   {
+      rate.AddInterval(0.100);
+   }
+   EXPECT_TRUE ( rate.IsLocked() );
+   EXPECT_NEAR ( 0.100, rate.GetInterval(), 0.003 );
+}
+
+
+/**
+ * seeded mode uses given band till the rate is detected
+ */
+TEST_F(PECRateEstimatorTest, test_seeded_mode_jitter)
+{
+   PE::CRateEstimator rate(0.100, 0.010, true);
+   EXPECT_FALSE( rate.IsLocked() );
+   EXPECT_TRUE ( rate.IsIntervalOk(0.100) );
+
+   //jitter of +/-12ms around 100ms is out of nominal band
+   uint32_t accepted = 0;
+   for ( uint32_t i = 0; i < 200; ++i )
+   {
+      double delta = ( 0 == i % 2 ) ? 0.088 : 0.112;
+      rate.AddInterval(delta);
+      if ( rate.IsIntervalOk(delta) )
+      {
+         ++accepted;
+      }
+   }
+   EXPECT_TRUE ( rate.IsLocked() );
+   EXPECT_EQ   ( 200 - GetLockSamples() + 1, accepted );
+   EXPECT_EQ   ( accepted, rate.GetAvoidedResets() );
+   EXPECT_NEAR ( 0.100, rate.GetInterval(), 0.002 );
+   EXPECT_TRUE ( rate.GetHysteresis() > 0.012 );
+   EXPECT_FALSE( rate.IsIntervalOk(0.200) );
+   EXPECT_FALSE( rate.IsIntervalOk(0.050) );
+}
+
+
+/**
+ * estimator detects new rate of the sensor
+ */
+TEST_F(PECRateEstimatorTest, test_rate_change)
+{
+   PE::CRateEstimator rate;
+   for ( uint32_t i = 0; i < 100; ++i )
+   {
+      rate.AddInterval(0.040);
+   }
+   EXPECT_TRUE ( rate.IsLocked() );
+   EXPECT_NEAR ( 0.040, rate.GetInterval(), 0.0004 );
+
+   //single gaps do not unlock
+   rate.AddInterval(0.080);
+   rate.AddInterval(0.040);
+   EXPECT_TRUE ( rate.IsLocked() );
+   EXPECT_NEAR ( 0.040, rate.GetInterval(), 0.0004 );
+
+   //rate is changed
+   for ( uint32_t i = 0; i <= GetLockSamples(); ++i )
+   {
+      rate.AddInterval(0.100);
+   }
+   EXPECT_FALSE( rate.IsLocked() );
+   //old nominal band is used till next lock
+   EXPECT_TRUE ( rate.IsIntervalOk(0.040) );
+   for ( uint32_t i = 0; i < GetLockSamples(); ++i )
+   {
+      rate.AddInterval(0.100);
+   }
+   EXPECT_TRUE ( rate.IsLocked() );
+   EXPECT_NEAR ( 0.100, rate.GetInterval(), 0.002 );
+   EXPECT_FALSE( rate.IsIntervalOk(0.040) );
+   rate.AddInterval(0.100);
+   EXPECT_EQ   ( 2, rate.GetAvoidedResets() );
+}
+
+
+/**
+ * histogram is limited by 16 bits per bin
+ */
+TEST_F(PECRateEstimatorTest, test_histogram_overflow)
+{
+   PE::CRateEstimator rate;
+   for ( uint32_t i = 0; i < 200000; ++i )
+   {
+      rate.AddInterval(0.040);
+   }
+   EXPECT_TRUE ( rate.IsLocked() );
+   EXPECT_TRUE ( GetHistogramMax(rate) <= std::numeric_limits<uint16_t>::max() );
+   EXPECT_TRUE ( GetHistogramMax(rate) > std::numeric_limits<uint16_t>::max() / 2 );
+   EXPECT_NEAR ( 0.040, rate.GetInterval(), 0.00001 );
+   //samples are halved together with the bins
+   EXPECT_EQ   ( GetHistogramSum(rate), GetSamples(rate) );
+
+   //new rate is locked after it has the most of halved samples
+   for ( uint32_t i = 0; i < 70000; ++i )
+   {
+      rate.AddInterval(0.100);
+   }
+   EXPECT_TRUE ( rate.IsLocked() );
+   EXPECT_NEAR ( 0.100, rate.GetInterval(), 0.002 );
+   EXPECT_EQ   ( GetHistogramSum(rate), GetSamples(rate) );
+}
+
+
+/**
+ * gyroscope with automatic rate detection
+ */
+TEST_F(PECRateEstimatorTest, test_gyroscope_auto_rate)
+{
+   double HEADING_MIN               = 0.0;
+   double HEADING_MAX               = 360.0;
+   double HEADING_ACCURACY_RATIO_2X = 2;
+   double GYRO_MIN                  = 0;
+   double GYRO_MAX                  = 4096;
+
+   PE::CGyroscope<> gyro( HEADING_MIN, HEADING_MAX, HEADING_ACCURACY_RATIO_2X, GYRO_MIN, GYRO_MAX );
+   EXPECT_FALSE( gyro.HeadingRate().IsLocked() );
+   EXPECT_FALSE( gyro.GyroRate().IsLocked() );
+
+   //learning of the rates is slower because each rejected sample resets sensor processing
+   double ts = 1.0;
+   bool isAccepted = false;
+   for ( uint32_t i = 0; i < 10 * GetLockSamples(); ++i )
+   {
+      ts += 0.050;
+      isAccepted = gyro.AddGyro(ts, 2048, true);
+      if ( 0 == i % 2 )
+      {
+         gyro.AddHeading(ts, 0, 0.1);
+      }
+   }
+   EXPECT_TRUE ( isAccepted );
+   EXPECT_TRUE ( gyro.GyroRate().IsLocked() );
+   EXPECT_NEAR ( 0.050, gyro.GyroRate().GetInterval(), 0.001 );
+   EXPECT_TRUE ( gyro.HeadingRate().IsLocked() );
+   EXPECT_NEAR ( 0.100, gyro.HeadingRate().GetInterval(), 0.002 );
+   EXPECT_EQ   ( 0, gyro.AvoidedResets() );
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
@@ -0,0 +1,323 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PE::CRecorder class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "PECRecorder.h"
+#include "PECTrackFile.h"
+#include "PECTrack.h"
+#include "PETypes.h"
+
+class PECRecorderTest : public ::testing::Test
+{
+public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+      remove(FILE_NAME);
+      remove(JOURNAL_NAME);
+   }
+
+   static const char* FILE_NAME;
+   static const char* JOURNAL_NAME;
+
+   static bool IsFile(const char* fileName)
+   {
+      std::ifstream file(fileName, std::ios::in | std::ios::binary);
+      return file.good();
+   }
+
+   /**
+    * Writes journal like the background writer does, the last record is cut by size
+    */
+   static void WriteJournal(const std::vector<PE::STrackEvent>& events, size_t cut)
+   {
+      std::ofstream file(JOURNAL_NAME, std::ios::out | std::ios::binary | std::ios::trunc);
+      for ( size_t i = 0; i < events.size(); ++i )
+      {
+         PE::CRecorder::SRecord record;
+         record.Timestamp = events[i].Timestamp;
+         record.Type = events[i].Type;
+         memcpy(record.Values, events[i].Values, sizeof(record.Values));
+         const size_t size = ( i + 1 == events.size() ) ? sizeof(record) - cut : sizeof(record);
+         file.write(reinterpret_cast<const char*>(&record), size);
+      }
+   }
+
+   static size_t GetRecordSize()
+   {
+      return sizeof(PE::CRecorder::SRecord);
+   }
+
+   static off_t GetJournalSize()
+   {
+      struct stat info;
+      return ( 0 == stat(JOURNAL_NAME, &info) ) ? info.st_size : -1;
+   }
+
+   static size_t GetCapacity(const PE::CRecorder& recorder)
+   {
+      return recorder.m_Slots.size();
+   }
+
+   /**
+    * Loads native track file
+    */
+   static bool Load(PE::CTrack& track)
+   {
+      PE::CTrackFile file;
+      return file.Open(FILE_NAME) && file.ToTrack(track);
+   }
+};
+
+const char* PECRecorderTest::FILE_NAME = "test_recorder.petrk";
+const char* PECRecorderTest::JOURNAL_NAME = "test_recorder.petrk.part";
+
+
+/**
+ * recorded events of all types are written into native file in order of recording
+ */
+TEST_F(PECRecorderTest, test_record)
+{
+   PE::CRecorder recorder(1000, 1, 5);
+   EXPECT_EQ   ( 1024, GetCapacity(recorder) );
+   EXPECT_FALSE( recorder.IsStarted() );
+   EXPECT_FALSE( recorder.Record(PE::STrackEvent(1.0, PE::EVENT_ODO, 25)) );
+   EXPECT_FALSE( recorder.Stop() );
+   EXPECT_EQ   ( 0, recorder.GetDropCount() );
+
+   ASSERT_TRUE ( recorder.Start(FILE_NAME) );
+   EXPECT_TRUE ( recorder.IsStarted() );
+   EXPECT_TRUE ( IsFile(JOURNAL_NAME) );
+   std::vector<PE::STrackEvent> events;
+   events.push_back(PE::STrackEvent(1.0, PE::EVENT_ODO, 25));
+   events.push_back(PE::STrackEvent(1.1, PE::EVENT_SPEED, 20.52, 0.13));
+   events.push_back(PE::STrackEvent(1.2, PE::EVENT_ODO, 65));
+   events.push_back(PE::STrackEvent(1.3, PE::EVENT_HEADING, 270.5, 1.5));
+   events.push_back(PE::STrackEvent(1.4, PE::EVENT_POSITION, 52.1234567, -13.1234567, 2.5));
+   events.push_back(PE::STrackEvent(1.5, PE::EVENT_GYRO, 2048));
+   for ( size_t i = 0; i < events.size(); ++i )
+   {
+      EXPECT_TRUE( recorder.Record(events[i]) );
+   }
+   //unknown events are not stored
+   EXPECT_TRUE ( recorder.Record(PE::STrackEvent(1.6, PE::EVENT_UNKNOWN, 1)) );
+   EXPECT_EQ   ( 7, recorder.GetRecordCount() );
+
+   ASSERT_TRUE ( recorder.Stop() );
+   EXPECT_FALSE( recorder.IsStarted() );
+   EXPECT_FALSE( IsFile(JOURNAL_NAME) );
+   EXPECT_EQ   ( 7, recorder.GetWriteCount() );
+   EXPECT_EQ   ( 0, recorder.GetDropCount() );
+   EXPECT_LE   ( 1, recorder.GetSyncCount() );
+   EXPECT_FALSE( recorder.Record(PE::STrackEvent(1.7, PE::EVENT_ODO, 70)) );
+
+   PE::CTrack track;
+   ASSERT_TRUE ( Load(track) );
+   ASSERT_EQ   ( events.size(), track.GetSize() );
+   for ( size_t i = 0; i < events.size(); ++i )
+   {
+      EXPECT_EQ( events[i].Timestamp, track[i].Timestamp ) << i;
+      EXPECT_EQ( events[i].Type, track[i].Type ) << i;
+      EXPECT_EQ( events[i].Values[0], track[i].Values[0] ) << i;
+   }
+   EXPECT_EQ   ( 0.13, track[1].Values[1] );
+   EXPECT_EQ   ( 2.5, track[4].Values[2] );
+
+   //restart overwrites the file and resets the counters
+   ASSERT_TRUE ( recorder.Start(FILE_NAME) );
+   EXPECT_EQ   ( 0, recorder.GetRecordCount() );
+   EXPECT_TRUE ( recorder.Record(events[0]) );
+   ASSERT_TRUE ( recorder.Start(FILE_NAME) );
+   ASSERT_TRUE ( recorder.Stop() );
+   ASSERT_TRUE ( Load(track) );
+   EXPECT_EQ   ( 0, track.GetSize() );
+
+   EXPECT_FALSE( recorder.Start("not_existing_directory/test_recorder.petrk") );
+   EXPECT_FALSE( recorder.IsStarted() );
+}
+
+
+/**
+ * events are dropped and counted if the ring is full, the writer is not waited for
+ */
+TEST_F(PECRecorderTest, test_full_ring)
+{
+   //writer does not wake up before stop
+   PE::CRecorder recorder(4, 100000, 100000);
+   ASSERT_TRUE ( recorder.Start(FILE_NAME) );
+   for ( int i = 0; i < 9; ++i )
+   {
+      EXPECT_EQ( 4 > i, recorder.Record(PE::STrackEvent(i, PE::EVENT_ODO, i)) ) << i;
+   }
+   EXPECT_EQ   ( 4, recorder.GetRecordCount() );
+   EXPECT_EQ   ( 5, recorder.GetDropCount() );
+   EXPECT_EQ   ( 0, recorder.GetWriteCount() );
+
+   ASSERT_TRUE ( recorder.Stop() );
+   EXPECT_EQ   ( 4, recorder.GetWriteCount() );
+   EXPECT_EQ   ( 1, recorder.GetSyncCount() );
+   PE::CTrack track;
+   ASSERT_TRUE ( Load(track) );
+   ASSERT_EQ   ( 4, track.GetSize() );
+   EXPECT_EQ   ( 3, track[3].Values[0] );
+}
+
+
+/**
+ * events of parallel producers are written without loss in order of each producer
+ */
+TEST_F(PECRecorderTest, test_producers)
+{
+   const int producers = 4;
+   const int count = 20000;
+   PE::CRecorder recorder(1024, 1, 1000);
+   ASSERT_TRUE ( recorder.Start(FILE_NAME) );
+   std::vector<std::thread> threads;
+   for ( int p = 0; p < producers; ++p )
+   {
+      threads.push_back(std::thread([&recorder, p, count]()
+      {
+         for ( int i = 0; i < count; ++i )
+         {
+            //small ring is retried, so nothing is lost
+            while ( false == recorder.Record(PE::STrackEvent(i, PE::EVENT_POSITION, p, i)) )
+            {
+               std::this_thread::yield();
+            }
+         }
+      }));
+   }
+   for ( size_t t = 0; t < threads.size(); ++t )
+   {
+      threads[t].join();
+   }
+   const uint64_t dropped = recorder.GetDropCount();
+   ASSERT_TRUE ( recorder.Stop() );
+   EXPECT_EQ   ( producers * count, recorder.GetRecordCount() );
+   EXPECT_EQ   ( producers * count, recorder.GetWriteCount() );
+   EXPECT_EQ   ( dropped, recorder.GetDropCount() );
+
+   PE::CTrack track;
+   ASSERT_TRUE ( Load(track) );
+   ASSERT_EQ   ( producers * count, track.GetSize() );
+   std::vector<int> next(producers, 0);
+   for ( size_t i = 0; i < track.GetSize(); ++i )
+   {
+      const int p = static_cast<int>(track[i].Values[0]);
+      ASSERT_TRUE( 0 <= p && producers > p );
+      ASSERT_EQ  ( next[p], track[i].Values[1] ) << p;
+      ++next[p];
+   }
+}
+
+
+/**
+ * partly written event is cut from the journal, next events are written behind the last whole one
+ */
+TEST_F(PECRecorderTest, test_partial_write)
+{
+   PE::CRecorder recorder(16, 1, 1000);
+   ASSERT_TRUE ( recorder.Start(FILE_NAME) );
+
+   //file size limit stops writing in the middle of the third event
+   struct rlimit limit;
+   ASSERT_EQ   ( 0, getrlimit(RLIMIT_FSIZE, &limit) );
+   struct rlimit small = limit;
+   small.rlim_cur = 2 * GetRecordSize() + GetRecordSize() / 2;
+   void (*handler)(int) = signal(SIGXFSZ, SIG_IGN);
+   ASSERT_EQ   ( 0, setrlimit(RLIMIT_FSIZE, &small) );
+   for ( int i = 0; i < 5; ++i )
+   {
+      EXPECT_TRUE( recorder.Record(PE::STrackEvent(i, PE::EVENT_ODO, i)) );
+   }
+   while ( 5 > recorder.GetWriteCount() + recorder.GetDropCount() )
+   {
+      std::this_thread::yield();
+   }
+   setrlimit(RLIMIT_FSIZE, &limit);
+   signal(SIGXFSZ, handler);
+   EXPECT_EQ   ( 2, recorder.GetWriteCount() );
+   EXPECT_EQ   ( 3, recorder.GetDropCount() );
+   EXPECT_EQ   ( 2 * GetRecordSize(), GetJournalSize() );
+
+   EXPECT_TRUE ( recorder.Record(PE::STrackEvent(5, PE::EVENT_ODO, 5)) );
+   ASSERT_TRUE ( recorder.Stop() );
+   EXPECT_EQ   ( 3, recorder.GetWriteCount() );
+   PE::CTrack track;
+   ASSERT_TRUE ( Load(track) );
+   ASSERT_EQ   ( 3, track.GetSize() );
+   EXPECT_EQ   ( 0, track[0].Values[0] );
+   EXPECT_EQ   ( 1, track[1].Values[0] );
+   EXPECT_EQ   ( 5, track[2].Values[0] );
+}
+
+
+/**
+ * journal left by a crash is converted, incomplete record is ignored
+ */
+TEST_F(PECRecorderTest, test_finish)
+{
+   EXPECT_FALSE( PE::CRecorder::Finish(FILE_NAME) );
+
+   std::vector<PE::STrackEvent> events;
+   events.push_back(PE::STrackEvent(2.0, PE::EVENT_SPEED, 10.5, 0.1));
+   events.push_back(PE::STrackEvent(2.1, PE::EVENT_ODO, 100));
+   events.push_back(PE::STrackEvent(2.2, PE::EVENT_ODO, 101));
+   WriteJournal(events, 1);
+   ASSERT_TRUE ( PE::CRecorder::Finish(FILE_NAME) );
+   EXPECT_FALSE( IsFile(JOURNAL_NAME) );
+   PE::CTrack track;
+   ASSERT_TRUE ( Load(track) );
+   ASSERT_EQ   ( 2, track.GetSize() );
+   EXPECT_EQ   ( 10.5, track[0].Values[0] );
+   EXPECT_EQ   ( 100, track[1].Values[0] );
+
+   //damaged type is skipped
+   events[1].Type = static_cast<PE::TEventType>(77);
+   WriteJournal(events, 0);
+   ASSERT_TRUE ( PE::CRecorder::Finish(FILE_NAME) );
+   ASSERT_TRUE ( Load(track) );
+   ASSERT_EQ   ( 2, track.GetSize() );
+   EXPECT_EQ   ( 101, track[1].Values[0] );
+
+   //empty journal gives empty track
+   WriteJournal(std::vector<PE::STrackEvent>(), 0);
+   ASSERT_TRUE ( PE::CRecorder::Finish(FILE_NAME) );
+   ASSERT_TRUE ( Load(track) );
+   EXPECT_EQ   ( 0, track.GetSize() );
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
@@ -0,0 +1,147 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PE::CRingBuffer class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "PECRingBuffer.h"
+
+class PECRingBufferTest : public ::testing::Test
+{
+public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+   }
+};
+
+
+/**
+ * check initial state
+ */
+TEST_F(PECRingBufferTest, test_init)
+{
+   PE::CRingBuffer<int> ring(3);
+   EXPECT_EQ( 3, ring.GetCapacity() );
+   EXPECT_EQ( 0, ring.GetSize() );
+   EXPECT_TRUE( ring.IsEmpty() );
+   EXPECT_FALSE( ring.IsFull() );
+
+   PE::CRingBuffer<int> empty(0);
+   EXPECT_EQ( 1, empty.GetCapacity() );
+}
+
+
+/**
+ * check adding till full and removing in order of adding
+ */
+TEST_F(PECRingBufferTest, test_push_pop)
+{
+   PE::CRingBuffer<int> ring(3);
+   EXPECT_TRUE( ring.PushBack(1) );
+   EXPECT_TRUE( ring.PushBack(2) );
+   EXPECT_TRUE( ring.PushBack(3) );
+   EXPECT_TRUE( ring.IsFull() );
+   EXPECT_FALSE( ring.PushBack(4) );
+   EXPECT_EQ( 3, ring.GetSize() );
+   EXPECT_EQ( 1, ring.Front() );
+   EXPECT_EQ( 3, ring.Back() );
+
+   ring.PopFront();
+   EXPECT_EQ( 2, ring.Front() );
+   EXPECT_TRUE( ring.PushBack(4) );
+   EXPECT_EQ( 4, ring.Back() );
+   EXPECT_EQ( 2, ring[0] );
+   EXPECT_EQ( 3, ring[1] );
+   EXPECT_EQ( 4, ring[2] );
+
+   ring.Back() = 5;
+   EXPECT_EQ( 5, ring[2] );
+
+   ring.PopFront();
+   ring.PopFront();
+   ring.PopFront();
+   EXPECT_TRUE( ring.IsEmpty() );
+   ring.PopFront();
+   EXPECT_EQ( 0, ring.GetSize() );
+}
+
+
+/**
+ * check many turns over the storage
+ */
+TEST_F(PECRingBufferTest, test_turn_over)
+{
+   PE::CRingBuffer<uint32_t> ring(5);
+   uint32_t next = 0;
+   uint32_t expected = 0;
+   for ( uint32_t i = 0; i < 100; ++i )
+   {
+      while ( ring.PushBack(next) )
+      {
+         ++next;
+      }
+      for ( uint32_t k = 0; k < 1 + i % 5; ++k )
+      {
+         ASSERT_EQ( expected, ring.Front() );
+         ring.PopFront();
+         ++expected;
+      }
+      for ( uint32_t k = 0; k < ring.GetSize(); ++k )
+      {
+         ASSERT_EQ( expected + k, ring[k] );
+      }
+   }
+   ring.Clean();
+   EXPECT_TRUE( ring.IsEmpty() );
+   EXPECT_TRUE( ring.PushBack(7) );
+   EXPECT_EQ( 7, ring.Front() );
+}
+
+
+/**
+ * check removing of the newest items
+ */
+TEST_F(PECRingBufferTest, test_pop_back)
+{
+   PE::CRingBuffer<uint32_t> ring(3);
+   ring.PopBack();
+   EXPECT_TRUE( ring.IsEmpty() );
+   for ( uint32_t i = 0; i < 3; ++i )
+   {
+      ring.PushBack(i);
+   }
+   ring.PopFront();
+   ring.PushBack(3);   //storage is wrapped
+   ring.PopBack();
+   EXPECT_EQ( 2, ring.GetSize() );
+   EXPECT_EQ( 2, ring.Back() );
+   ring.PushBack(4);
+   EXPECT_EQ( 4, ring.Back() );
+   EXPECT_EQ( 1, ring.Front() );
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
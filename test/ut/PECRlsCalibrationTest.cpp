@@ -0,0 +1,179 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PECRlsCalibration class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "PECRlsCalibration.h"
+#include "PECCalibration.h"
+
+
+class PECRlsCalibrationTest : public ::testing::Test
+{
+public:
+   virtual void SetUp()
+   {}
+   virtual void TearDown()
+   {}
+
+   /**
+    * Adds one step: ref in [1..8], raw = ref / scale + bias with small noise
+    */
+   template <typename TCalibration>
+   static void AddStep(TCalibration& calib, uint32_t step, const double& bias, const double& scale)
+   {
+      double ref = 1 + ( step * 7 ) % 8;
+      calib.AddRef(ref);
+      calib.AddRaw(ref / scale + bias + 0.01 * ( ( step * 13 ) % 5 ) - 0.02);
+      calib.Recalculate();
+   }
+   static double GetCovarianceTrace(const PE::CRlsCalibration& calib)
+   {
+      return calib.m_P[0] + calib.m_P[2];
+   }
+};
+
+
+/**
+ * tests creation
+ */
+TEST_F(PECRlsCalibrationTest, create_destroy_test)
+{
+   PE::CRlsCalibration calib;
+   EXPECT_TRUE( PE::isnan( calib.GetBias() ) );
+   EXPECT_TRUE( PE::isnan( calib.GetScale() ) );
+   EXPECT_EQ  ( PE::CRlsCalibration::DEFAULT_FORGETTING, calib.GetForgetting() );
+
+   PE::CRlsCalibration wrong_low(0.0);
+   EXPECT_EQ  ( PE::CRlsCalibration::DEFAULT_FORGETTING, wrong_low.GetForgetting() );
+   PE::CRlsCalibration wrong_high(1.5);
+   EXPECT_EQ  ( PE::CRlsCalibration::DEFAULT_FORGETTING, wrong_high.GetForgetting() );
+   PE::CRlsCalibration no_forgetting(1.0);
+   EXPECT_EQ  ( 1.0, no_forgetting.GetForgetting() );
+}
+
+
+/**
+ * tests solving of exact data
+ */
+TEST_F(PECRlsCalibrationTest, exact_data_test)
+{
+   PE::CRlsCalibration calib;
+
+   //nothing was added
+   EXPECT_FALSE( calib.Recalculate() );
+
+   //RAW=10+11   REF=1.0, one step is not enough
+   calib.AddRaw(10.0 + 11);
+   calib.AddRef(1.0);
+   EXPECT_FALSE( calib.Recalculate() );
+   EXPECT_TRUE ( PE::isnan( calib.GetBias() ) );
+
+   //RAW=20+11   REF=2.0
+   calib.AddRaw(20.0 + 11);
+   calib.AddRef(2.0);
+   EXPECT_TRUE ( calib.Recalculate() );
+   EXPECT_NEAR ( 11, calib.GetBias(), 0.001 );
+   EXPECT_NEAR ( 0.1, calib.GetScale(), 0.00001 );
+
+   //step as mean of several values, RAW=35+11   REF=3.5
+   calib.AddRaw(30.0 + 11);
+   calib.AddRef(3.0);
+   calib.AddRaw(40.0 + 11);
+   calib.AddRef(4.0);
+   EXPECT_TRUE ( calib.Recalculate() );
+   EXPECT_NEAR ( 11, calib.GetBias(), 0.001 );
+   EXPECT_NEAR ( 0.1, calib.GetScale(), 0.00001 );
+
+   //rejected step is not considered
+   calib.AddRaw(1000);
+   calib.AddRef(1);
+   calib.CleanLastStep();
+   EXPECT_FALSE( calib.Recalculate() );
+   EXPECT_NEAR ( 11, calib.GetBias(), 0.001 );
+}
+
+
+/**
+ * tests tracking of bias drift, two-checkpoint calibration stays on old bias
+ */
+TEST_F(PECRlsCalibrationTest, drift_test)
+{
+   PE::CRlsCalibration rls(0.99);
+   PE::CCalibration calib;
+
+   for ( uint32_t i = 0; i < 2000; ++i )
+   {
+      AddStep(rls, i, 11, 0.1);
+      AddStep(calib, i, 11, 0.1);
+   }
+   EXPECT_NEAR( 11, rls.GetBias(), 0.05 );
+   EXPECT_NEAR( 0.1, rls.GetScale(), 0.001 );
+
+   //bias drifts to 15
+   for ( uint32_t i = 2000; i < 4000; ++i )
+   {
+      AddStep(rls, i, 15, 0.1);
+      AddStep(calib, i, 15, 0.1);
+   }
+   EXPECT_NEAR( 15, rls.GetBias(), 0.05 );
+   EXPECT_NEAR( 0.1, rls.GetScale(), 0.001 );
+   EXPECT_LT  ( 0.5, fabs( calib.GetBias() - 15 ) );
+}
+
+
+/**
+ * tests bounded covariance without excitation
+ */
+TEST_F(PECRlsCalibrationTest, no_excitation_test)
+{
+   PE::CRlsCalibration calib(0.9);
+
+   for ( uint32_t i = 0; i < 100; ++i )
+   {
+      AddStep(calib, i, 11, 0.1);
+   }
+   //vehicle keeps the same speed for long time
+   for ( uint32_t i = 0; i < 100000; ++i )
+   {
+      calib.AddRaw(31);
+      calib.AddRef(2);
+      calib.Recalculate();
+      EXPECT_GE( 2.000001 * PE::CRlsCalibration::MAX_COVARIANCE, GetCovarianceTrace(calib) );
+   }
+   EXPECT_FALSE( PE::isnan( calib.GetBias() ) );
+   EXPECT_FALSE( PE::isnan( calib.GetScale() ) );
+
+   //excitation is back
+   for ( uint32_t i = 0; i < 100; ++i )
+   {
+      AddStep(calib, i, 11, 0.1);
+   }
+   EXPECT_NEAR( 11, calib.GetBias(), 0.05 );
+   EXPECT_NEAR( 0.1, calib.GetScale(), 0.001 );
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
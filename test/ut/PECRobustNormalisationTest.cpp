@@ -0,0 +1,263 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PE::CRobustNormalisation class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <math.h>
+#include "PECRobustNormalisation.h"
+
+class PECRobustNormalisationTest : public ::testing::Test
+{
+public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+   }
+
+   /**
+    * Checks normalisation of constant values by its interface
+    */
+   template <typename TNormalisation>
+   static void CheckInterface(TNormalisation& norm)
+   {
+      for ( uint32_t i = 0; i < 5; ++i )
+      {
+         norm.AddSensor(2.0);
+      }
+      EXPECT_EQ( 2.0, norm.GetMean() );
+      EXPECT_EQ( 0.0, norm.GetMld() );
+      EXPECT_NEAR( 80.0, norm.GetReliable(), PE::EPSILON );
+      EXPECT_EQ( 5, norm.GetSampleCount() );
+   }
+
+   /**
+    * Median of the values by sorting
+    */
+   static double SortedMedian(std::vector<double> values)
+   {
+      std::sort(values.begin(), values.end());
+      size_t half = values.size() / 2;
+      if ( 0 != ( values.size() % 2 ) )
+      {
+         return values[half];
+      }
+      return ( values[half - 1] + values[half] ) / 2.0;
+   }
+
+   /**
+    * Median absolute deviation of the values by sorting
+    */
+   static double SortedMad(const std::vector<double>& values)
+   {
+      double median = SortedMedian(values);
+      std::vector<double> deviations;
+      for ( size_t i = 0; i < values.size(); ++i )
+      {
+         deviations.push_back( fabs( values[i] - median ) );
+      }
+      return SortedMedian(deviations);
+   }
+
+   /**
+    * Count of used and free nodes has to be always the window size
+    */
+   static void CheckNodes(const PE::CRobustNormalisation& norm, uint32_t count)
+   {
+      EXPECT_EQ( norm.m_WindowSize + 2, norm.m_NodeValue.size() );
+      EXPECT_EQ( norm.m_WindowSize - count, norm.m_Free.size() );
+      for ( uint32_t i = 1; i < count; ++i )
+      {
+         EXPECT_LE( norm.GetByRank(i - 1), norm.GetByRank(i) );
+      }
+   }
+};
+
+
+/**
+ * check initial state
+ */
+TEST_F(PECRobustNormalisationTest, test_init)
+{
+   PE::CRobustNormalisation norm;
+   EXPECT_EQ( PE::CRobustNormalisation::DEFAULT_WINDOW_SIZE, norm.GetWindowSize() );
+   EXPECT_EQ( 0, norm.GetMean() );
+   EXPECT_EQ( 0, norm.GetMld() );
+   EXPECT_EQ( 0, norm.GetReliable() );
+   EXPECT_EQ( 0, norm.GetSampleCount() );
+   CheckNodes(norm, 0);
+
+   PE::CRobustNormalisation empty(0);
+   EXPECT_EQ( 1, empty.GetWindowSize() );
+   empty.AddSensor(3.0);
+   empty.AddSensor(4.0);
+   EXPECT_EQ( 4.0, empty.GetMean() );
+   EXPECT_EQ( 1, empty.GetSampleCount() );
+   CheckNodes(empty, 1);
+}
+
+
+/**
+ * check median and MAD of odd and even count of values
+ */
+TEST_F(PECRobustNormalisationTest, test_median_and_mad)
+{
+   PE::CRobustNormalisation norm(10);
+   norm.AddSensor(100.0);
+   norm.AddSensor(4.0);
+   norm.AddSensor(1.0);
+   norm.AddSensor(3.0);
+   norm.AddSensor(2.0);
+   //deviations 97, 1, 2, 0, 1
+   EXPECT_EQ( 3.0, norm.GetMean() );
+   EXPECT_EQ( 1.0, norm.GetMad() );
+   EXPECT_NEAR( PE::CRobustNormalisation::MLD_FROM_MAD, norm.GetMld(), PE::EPSILON );
+   EXPECT_EQ( 5, norm.GetSampleCount() );
+
+   norm.AddSensor(-100.0);
+   //values -100, 1, 2, 3, 4, 100; deviations 102.5, 1.5, 0.5, 0.5, 1.5, 97.5
+   EXPECT_EQ( 2.5, norm.GetMean() );
+   EXPECT_EQ( 1.5, norm.GetMad() );
+   CheckNodes(norm, 6);
+}
+
+
+/**
+ * check streaming median and MAD against sorting of the window, with duplicated values
+ */
+TEST_F(PECRobustNormalisationTest, test_compare_with_sorting)
+{
+   uint32_t windowSizes[] = { 1, 2, 3, 16, 50 };
+   for ( uint32_t w = 0; w < sizeof(windowSizes) / sizeof(windowSizes[0]); ++w )
+   {
+      PE::CRobustNormalisation norm(windowSizes[w]);
+      std::vector<double> all;
+      uint32_t seed = 12345;
+      for ( uint32_t i = 0; i < 500; ++i )
+      {
+         seed = seed * 1103515245 + 12345;
+         double value = static_cast<double>( ( seed >> 16 ) % 20 ) - 10.0;
+         all.push_back(value);
+         norm.AddSensor(value);
+
+         size_t begin = ( all.size() > windowSizes[w] ) ? all.size() - windowSizes[w] : 0;
+         std::vector<double> window(all.begin() + begin, all.end());
+         ASSERT_EQ( SortedMedian(window), norm.GetMean() ) << "window " << windowSizes[w] << " value " << i;
+         ASSERT_EQ( SortedMad(window), norm.GetMad() ) << "window " << windowSizes[w] << " value " << i;
+         ASSERT_EQ( window.size(), norm.GetSampleCount() );
+      }
+      CheckNodes(norm, windowSizes[w]);
+   }
+}
+
+
+/**
+ * check that short burst of outliers does not move median, but moves mean of CNormalisation
+ */
+TEST_F(PECRobustNormalisationTest, test_outlier_burst)
+{
+   PE::CRobustNormalisation robust(100);
+   PE::CNormalisation plain;
+   for ( uint32_t i = 0; i < 200; ++i )
+   {
+      double value = 5.0 + ( ( 0 == i % 2 ) ? 0.1 : -0.1 );
+      robust.AddSensor(value);
+      plain.AddSensor(value);
+   }
+   EXPECT_NEAR( 5.0, robust.GetMean(), PE::EPSILON );
+   EXPECT_NEAR( 100.0, robust.GetReliable(), 0.001 );
+
+   for ( uint32_t i = 0; i < 20; ++i )
+   {
+      robust.AddSensor(1000.0);
+      plain.AddSensor(1000.0);
+   }
+   //window: 40 x 4.9, 40 x 5.1, 20 x 1000
+   EXPECT_NEAR( 5.1, robust.GetMean(), PE::EPSILON );
+   EXPECT_NEAR( 0.2 * PE::CRobustNormalisation::MLD_FROM_MAD, robust.GetMld(), PE::EPSILON );
+   EXPECT_LT( 90.0, robust.GetReliable() );
+   EXPECT_LT( 90.0, plain.GetMean() );
+
+   //burst leaves the window
+   for ( uint32_t i = 0; i < 100; ++i )
+   {
+      robust.AddSensor(5.0 + ( ( 0 == i % 2 ) ? 0.1 : -0.1 ));
+   }
+   EXPECT_NEAR( 5.0, robust.GetMean(), PE::EPSILON );
+   EXPECT_LT( 99.0, robust.GetReliable() );
+   CheckNodes(robust, 100);
+}
+
+
+/**
+ * check reliable of the same values: first value is forgotten with the window turn over
+ */
+TEST_F(PECRobustNormalisationTest, test_same_values_reliable)
+{
+   PE::CRobustNormalisation norm(10);
+   norm.AddSensor(7.0);
+   EXPECT_EQ( 0, norm.GetReliable() );
+   for ( uint32_t i = 1; i < 10; ++i )
+   {
+      norm.AddSensor(7.0);
+   }
+   EXPECT_NEAR( 90.0, norm.GetReliable(), PE::EPSILON );
+   norm.AddSensor(7.0);
+   EXPECT_NEAR( 100.0, norm.GetReliable(), PE::EPSILON );
+   EXPECT_EQ( 7.0, norm.GetMean() );
+   EXPECT_EQ( 0.0, norm.GetMld() );
+   EXPECT_EQ( 10, norm.GetSampleCount() );
+}
+
+
+/**
+ * check that NaN values are ignored
+ */
+TEST_F(PECRobustNormalisationTest, test_nan_values)
+{
+   PE::CRobustNormalisation norm(10);
+   norm.AddSensor(1.0);
+   norm.AddSensor(std::numeric_limits<double>::quiet_NaN());
+   norm.AddSensor(3.0);
+   EXPECT_EQ( 2.0, norm.GetMean() );
+   EXPECT_EQ( 2, norm.GetSampleCount() );
+   CheckNodes(norm, 2);
+}
+
+
+/**
+ * check usage by same interface like CNormalisation
+ */
+TEST_F(PECRobustNormalisationTest, test_interface)
+{
+   PE::CRobustNormalisation robust(10);
+   PE::CNormalisation plain;
+   CheckInterface(robust);
+   CheckInterface(plain);
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
@@ -24,6 +24,9 @@
 #include <gmock/gmock.h>
 
 #include "PECSensor.h"
+#include "PECRlsCalibration.h"
+#include "PECTemperatureCalibration.h"
+#include "PECRobustNormalisation.h"
 #include "PETools.h"
 
 class PECSensorTest : public ::testing::Test
@@ -96,7 +99,7 @@ public:
 TEST_F(PECSensorTest, test_init)
 {
    PECSensorStub adjuster_stub;
-   PE::CSensor sensor(adjuster_stub);
+   PE::CSensor<> sensor(adjuster_stub);
 
    EXPECT_EQ( 0.0, sensor.GetRefTimeStamp() );
    EXPECT_EQ( 0.0, sensor.GetSenTimeStamp() );
@@ -111,7 +114,7 @@ TEST_F(PECSensorTest, test_init)
 TEST_F(PECSensorTest, test_all_values_are_valid_check)
 {
    PECSensorStub adjuster_stub;
-   PE::CSensor sensor(adjuster_stub);
+   PE::CSensor<> sensor(adjuster_stub);
 
    sensor.AddRef(1.000, 100,  0.0);
    sensor.AddSen(1.001,   5+2, true);
@@ -139,7 +142,7 @@ TEST_F(PECSensorTest, test_all_values_are_valid_check)
 TEST_F(PECSensorTest, test_adding_first_ref_and_sen_values)
 {
    PECSensorStub adjuster_stub;
-   PE::CSensor sensor(adjuster_stub);
+   PE::CSensor<> sensor(adjuster_stub);
 
    EXPECT_FALSE(sensor.AddSen(1.001, 0, true));
    EXPECT_FALSE(sensor.AddSen(1.002, 0, true));
@@ -164,7 +167,7 @@ TEST_F(PECSensorTest, test_adding_first_ref_and_sen_values)
 TEST_F(PECSensorTest, test_handling_wrong_ref_and_sen_values)
 {
    PECSensorStub adjuster_stub;
-   PE::CSensor sensor(adjuster_stub);
+   PE::CSensor<> sensor(adjuster_stub);
 
    sensor.AddRef(1.000, 100, 0.0);
    sensor.AddSen(1.001,  10, true);
@@ -198,7 +201,7 @@ TEST_F(PECSensorTest, test_handling_wrong_ref_and_sen_values)
 TEST_F(PECSensorTest, test_adding_NaN_ref_and_sen_values)
 {
    PECSensorStub adjuster_stub;
-   PE::CSensor sensor(adjuster_stub);
+   PE::CSensor<> sensor(adjuster_stub);
 
    sensor.AddRef(1.000, 100,  0.0);
    sensor.AddSen(1.001,   5-100, true);
@@ -251,6 +254,120 @@ TEST_F(PECSensorTest, test_adding_NaN_ref_and_sen_values)
 }
 
 
+/**
+ * checks sensor with recursive least squares calibration
+ */
+TEST_F(PECSensorTest, test_rls_calibration)
+{
+   PECSensorStub adjuster_stub;
+   PE::CSensor<PE::CRlsCalibration> sensor(adjuster_stub);
+
+   sensor.AddRef(1.000, 100,  0.0);
+   sensor.AddSen(1.001,   5+2, true);
+   sensor.AddRef(1.002, 200,  0.0);
+   sensor.AddSen(1.003,  10+2, true);
+   sensor.AddRef(1.004, 300,  0.0);
+   sensor.AddSen(1.005,  15+2, true);
+   sensor.AddRef(1.006, 100,  0.0);
+   sensor.AddSen(1.007,   5+2, true);
+   sensor.AddRef(1.008, 200,  0.0);
+   sensor.AddSen(1.009,  10+2, true);
+
+   EXPECT_NEAR  ( 2.00, sensor.GetCalibration().GetBias(), 0.01 );
+   EXPECT_NEAR  ( 20.00, sensor.GetCalibration().GetScale(), 0.01 );
+   //results of forgetting calibration are normalised over a window
+   EXPECT_EQ    ( PE::CRobustNormalisation::DEFAULT_WINDOW_SIZE, sensor.GetBias().GetWindowSize() );
+   EXPECT_NEAR  ( 2.00, sensor.GetBias().GetMean(), 0.01 );
+   EXPECT_NEAR  ( 20.00, sensor.GetScale().GetMean(), 0.01 );
+   EXPECT_EQ    ( 3, sensor.GetBias().GetSampleCount() );
+}
+
+
+/**
+ * checks that sensor with forgetting calibration follows drift of the bias
+ */
+TEST_F(PECSensorTest, test_bias_drift)
+{
+   PECSensorStub fixed_stub;
+   PE::CSensor<> fixed(fixed_stub);
+   PECSensorStub drift_stub;
+   PE::CSensor<PE::CRlsCalibration> drift(drift_stub, PE::CRlsCalibration(0.98));
+
+   double refs[] = { 100, 200, 300 };
+   const uint32_t STEPS = 3000;
+   double bias = 0;
+   for ( uint32_t i = 0; i < STEPS; ++i )
+   {
+      //bias drifts from 2 to 4
+      bias = 2.0 + 2.0 * i / STEPS;
+      double ts = 1.0 + i * 0.002;
+      double sen = refs[i % 3] / 20 + bias;
+      fixed.AddRef(ts, refs[i % 3], 0.0);
+      fixed.AddSen(ts + 0.001, sen, true);
+      drift.AddRef(ts, refs[i % 3], 0.0);
+      drift.AddSen(ts + 0.001, sen, true);
+   }
+   //calibration over all data keeps the bias of the start
+   EXPECT_NEAR  ( 2.00, fixed.GetBias().GetMean(), 0.01 );
+   //forgetting calibration with windowed normalisation follows the drift with small delay
+   EXPECT_NEAR  ( bias, drift.GetCalibration().GetBias(), 0.05 );
+   EXPECT_NEAR  ( bias, drift.GetBias().GetMean(), 0.15 );
+   EXPECT_NEAR  ( 20.00, drift.GetScale().GetMean(), 0.01 );
+}
+
+
+/**
+ * checks sensor with temperature calibration: bias and scale are normalised only in the bin
+ */
+TEST_F(PECSensorTest, test_temperature_calibration)
+{
+   PECSensorStub adjuster_stub;
+   PE::CSensor<PE::CTemperatureCalibration> sensor(adjuster_stub);
+
+   double refs[] = { 100, 200, 300, 100, 200, 300, 100, 200 };
+   double sens[] = { 7, 12, 17, 7, 12, 17, 7, 12 };
+   for ( uint32_t i = 0; i < 8; ++i )
+   {
+      double ts = 1.0 + i * 0.002;
+      sensor.AddRef(ts, refs[i], 0.0);
+      sensor.AddSen(ts + 0.001, sens[i], true);
+   }
+
+   EXPECT_NEAR  ( 2.00, sensor.GetCalibration().GetBias(), 0.01 );
+   EXPECT_NEAR  ( 20.00, sensor.GetCalibration().GetScale(), 0.01 );
+   EXPECT_EQ    ( 7, sensor.GetStats().Steps );
+   //normalisation of the sensor is not fed
+   EXPECT_EQ    ( 0, sensor.GetBias().GetSampleCount() );
+   EXPECT_EQ    ( 0, sensor.GetScale().GetSampleCount() );
+}
+
+
+/**
+ * checks sensor with windowed robust normalisation
+ */
+TEST_F(PECSensorTest, test_robust_normalisation)
+{
+   PECSensorStub adjuster_stub;
+   PE::CSensor<PE::CCalibration, PE::CRobustNormalisation> sensor(adjuster_stub, PE::CCalibration(), PE::CRobustNormalisation(2));
+
+   double refs[] = { 100, 200, 300, 100, 200, 300, 100, 200 };
+   double sens[] = { 7, 12, 17, 7, 12, 17, 7, 12 };
+   for ( uint32_t i = 0; i < 8; ++i )
+   {
+      double ts = 1.0 + i * 0.002;
+      sensor.AddRef(ts, refs[i], 0.0);
+      sensor.AddSen(ts + 0.001, sens[i], true);
+   }
+
+   EXPECT_EQ    ( 2, sensor.GetBias().GetWindowSize() );
+   EXPECT_EQ    ( 2, sensor.GetScale().GetWindowSize() );
+   //only last two results are in the window
+   EXPECT_EQ    ( 2, sensor.GetBias().GetSampleCount() );
+   EXPECT_NEAR  ( 2.00, sensor.GetBias().GetMean(), 0.01 );
+   EXPECT_NEAR  ( 20.00, sensor.GetScale().GetMean(), 0.01 );
+}
+
+
 int main(int argc, char *argv[])
 {
    ::testing::InitGoogleTest(&argc, argv);
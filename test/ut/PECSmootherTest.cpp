@@ -0,0 +1,226 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PE::CSmoother class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <math.h>
+#include <gtest/gtest.h>
+#include "PECSmoother.h"
+#include "PECFusionSensor.h"
+#include "PETools.h"
+
+
+class PECSmootherTest : public ::testing::Test
+{
+public:
+   virtual void SetUp()
+   {}
+   virtual void TearDown()
+   {}
+
+   /**
+    * Straight track to north with 10 m/s, speed and heading sensors at 10Hz,
+    * positions at 1Hz with +-noise meter alternating error, every anchorStep-th position is exact
+    */
+   template <typename TFusion>
+   static void AddTrack(TFusion& fusion, uint32_t seconds, const double& noise, uint32_t anchorStep)
+   {
+      for ( uint32_t i = 1; i <= seconds * 10; ++i )
+      {
+         double timestamp = 0.1 * i;
+         fusion.AddSpeed(timestamp, PE::SBasicSensor(10.0, 0.1));
+         fusion.AddAngSpeed(timestamp, PE::SBasicSensor(0.0, 0.1));
+         fusion.AddHeading(timestamp, PE::SBasicSensor(0.0, 1.0));
+         if ( 0 == i % 10 )
+         {
+            uint32_t second = i / 10;
+            PE::SPosition position = GetTruth(timestamp);
+            if ( 0 != anchorStep && 0 == second % anchorStep )
+            {
+               position.HorizontalAcc = 1.0;
+            }
+            else
+            {
+               position = PE::TOOLS::ToPosition(position, noise, 0 == second % 2 ? 90.0 : 270.0);
+               position.HorizontalAcc = noise;
+            }
+            fusion.AddPosition(timestamp, position);
+         }
+      }
+   }
+
+   static PE::SPosition GetTruth(const double& timestamp)
+   {
+      return PE::TOOLS::ToPosition(GetStart(), 10.0 * timestamp, 0.0);
+   }
+
+   static PE::SPosition GetStart()
+   {
+      return PE::SPosition(50.0, 10.0, 1.0);
+   }
+
+   static double GetDistance(const PE::SPosition& first, const PE::SPosition& second)
+   {
+      return PE::TOOLS::ToDistance(first.Latitude, first.Longitude, second.Latitude, second.Longitude);
+   }
+
+   static uint32_t GetSegmentCount(const PE::CSmoother& smoother, const double& anchorAccuracy, uint32_t segmentLength)
+   {
+      return static_cast<uint32_t>(smoother.GetSegments(anchorAccuracy, segmentLength).size());
+   }
+};
+
+
+TEST_F(PECSmootherTest, test_empty )
+{
+   PE::CSmoother smoother(0.0, GetStart(), PE::SBasicSensor(0.0, 1.0), PE::SBasicSensor(0.0, 0.1), PE::SBasicSensor(10.0, 0.1));
+   EXPECT_EQ( 0, smoother.Smooth() );
+   EXPECT_EQ( 0, smoother.GetSize() );
+}
+
+
+TEST_F(PECSmootherTest, test_same_time_and_old_timestamp )
+{
+   PE::CSmoother smoother(1.0, GetStart(), PE::SBasicSensor(0.0, 1.0), PE::SBasicSensor(0.0, 0.1), PE::SBasicSensor(10.0, 0.1));
+   //older than start state
+   smoother.AddSpeed(0.5, PE::SBasicSensor(10.0, 0.1));
+   EXPECT_EQ( 0, smoother.GetSize() );
+
+   smoother.AddSpeed(2.0, PE::SBasicSensor(10.0, 0.1));
+   smoother.AddHeading(2.0, PE::SBasicSensor(0.0, 1.0));
+   smoother.AddSpeed(2.0, PE::SBasicSensor(11.0, 0.1));
+   EXPECT_EQ( 1, smoother.GetSize() );
+
+   //older than last item
+   smoother.AddSpeed(1.5, PE::SBasicSensor(10.0, 0.1));
+   EXPECT_EQ( 1, smoother.GetSize() );
+
+   EXPECT_EQ( 1, smoother.Smooth(1) );
+   EXPECT_EQ( 2.0, smoother.GetFused(0).Timestamp );
+   //both speeds of the same time are merged
+   EXPECT_LT( 10.0, smoother.GetFused(0).Speed.Value );
+   EXPECT_GT( 11.0, smoother.GetFused(0).Speed.Value );
+   //the last step has no future
+   EXPECT_EQ( smoother.GetFused(0).Speed.Value, smoother.GetSmoothed(0).Speed.Value );
+}
+
+
+TEST_F(PECSmootherTest, test_forward_pass_is_fusion_sensor )
+{
+   PE::CSmoother smoother(0.0, GetStart(), PE::SBasicSensor(0.0, 1.0), PE::SBasicSensor(0.0, 0.1), PE::SBasicSensor(10.0, 0.1));
+   PE::CFusionSensor fusion(0.0, GetStart(), PE::SBasicSensor(0.0, 1.0), PE::SBasicSensor(0.0, 0.1), PE::SBasicSensor(10.0, 0.1));
+   AddTrack(smoother, 20, 3.0, 0);
+   smoother.Smooth(1);
+
+   uint32_t step = 0;
+   for ( uint32_t i = 1; i <= 200; ++i )
+   {
+      double timestamp = 0.1 * i;
+      fusion.AddSpeed(timestamp, PE::SBasicSensor(10.0, 0.1));
+      fusion.AddAngSpeed(timestamp, PE::SBasicSensor(0.0, 0.1));
+      fusion.AddHeading(timestamp, PE::SBasicSensor(0.0, 1.0));
+      if ( 0 == i % 10 )
+      {
+         PE::SPosition position = PE::TOOLS::ToPosition(GetTruth(timestamp), 3.0, 0 == (i / 10) % 2 ? 90.0 : 270.0);
+         position.HorizontalAcc = 3.0;
+         fusion.AddPosition(timestamp, position);
+      }
+      fusion.DoFusion();
+
+      const PE::CSmoother::SState& fused = smoother.GetFused(step++);
+      EXPECT_EQ( fusion.GetTimestamp(), fused.Timestamp );
+      EXPECT_EQ( fusion.GetPosition().Latitude, fused.Position.Latitude );
+      EXPECT_EQ( fusion.GetPosition().Longitude, fused.Position.Longitude );
+      EXPECT_EQ( fusion.GetPosition().HorizontalAcc, fused.Position.HorizontalAcc );
+      EXPECT_EQ( fusion.GetHeading().Value, fused.Heading.Value );
+      EXPECT_EQ( fusion.GetSpeed().Value, fused.Speed.Value );
+      EXPECT_EQ( fusion.GetAngSpeed().Value, fused.AngSpeed.Value );
+   }
+   EXPECT_EQ( step, smoother.GetSize() );
+}
+
+
+TEST_F(PECSmootherTest, test_smoothing_reduces_position_error )
+{
+   PE::CSmoother smoother(0.0, GetStart(), PE::SBasicSensor(0.0, 1.0), PE::SBasicSensor(0.0, 0.1), PE::SBasicSensor(10.0, 0.1));
+   AddTrack(smoother, 60, 3.0, 0);
+   EXPECT_EQ( 1, smoother.Smooth(1) );
+   ASSERT_EQ( 600, smoother.GetSize() );
+
+   double fusedError = 0.0;
+   double smoothedError = 0.0;
+   for ( uint32_t i = 0; i < smoother.GetSize(); ++i )
+   {
+      PE::SPosition truth = GetTruth(smoother.GetFused(i).Timestamp);
+      fusedError    += pow(GetDistance(truth, smoother.GetFused(i).Position), 2);
+      smoothedError += pow(GetDistance(truth, smoother.GetSmoothed(i).Position), 2);
+      //smoothed accuracy is never worse than causal one
+      EXPECT_GE( smoother.GetFused(i).Position.HorizontalAcc + 0.000001, smoother.GetSmoothed(i).Position.HorizontalAcc );
+   }
+   fusedError    = sqrt(fusedError / smoother.GetSize());
+   smoothedError = sqrt(smoothedError / smoother.GetSize());
+   EXPECT_GT( fusedError * 0.75, smoothedError ) << fusedError << " " << smoothedError;
+}
+
+
+TEST_F(PECSmootherTest, test_segments_are_split_at_anchors )
+{
+   PE::CSmoother smoother(0.0, GetStart(), PE::SBasicSensor(0.0, 1.0), PE::SBasicSensor(0.0, 0.1), PE::SBasicSensor(10.0, 0.1));
+   AddTrack(smoother, 60, 3.0, 10);
+   smoother.Smooth(1, 0.0);
+
+   //exact positions every 10 seconds (100 steps), the last one is the end of the track
+   EXPECT_EQ( 6, GetSegmentCount(smoother, 1.0, 50) );
+   EXPECT_EQ( 3, GetSegmentCount(smoother, 1.0, 150) );
+   EXPECT_EQ( 1, GetSegmentCount(smoother, 0.5, 50) );
+   EXPECT_EQ( 1, GetSegmentCount(smoother, 1.0, 1000) );
+}
+
+
+TEST_F(PECSmootherTest, test_parallel_segments_are_deterministic )
+{
+   PE::CSmoother single(0.0, GetStart(), PE::SBasicSensor(0.0, 1.0), PE::SBasicSensor(0.0, 0.1), PE::SBasicSensor(10.0, 0.1));
+   PE::CSmoother parallel(0.0, GetStart(), PE::SBasicSensor(0.0, 1.0), PE::SBasicSensor(0.0, 0.1), PE::SBasicSensor(10.0, 0.1));
+   PE::CSmoother whole(0.0, GetStart(), PE::SBasicSensor(0.0, 1.0), PE::SBasicSensor(0.0, 0.1), PE::SBasicSensor(10.0, 0.1));
+   AddTrack(single, 60, 3.0, 10);
+   AddTrack(parallel, 60, 3.0, 10);
+   AddTrack(whole, 60, 3.0, 10);
+
+   EXPECT_EQ( 6, single.Smooth(1, 1.0, 50) );
+   EXPECT_EQ( 6, parallel.Smooth(4, 1.0, 50) );
+   EXPECT_EQ( 1, whole.Smooth(1, 0.0) );
+
+   for ( uint32_t i = 0; i < single.GetSize(); ++i )
+   {
+      EXPECT_EQ( single.GetSmoothed(i).Position.Latitude, parallel.GetSmoothed(i).Position.Latitude );
+      EXPECT_EQ( single.GetSmoothed(i).Position.Longitude, parallel.GetSmoothed(i).Position.Longitude );
+      EXPECT_EQ( single.GetSmoothed(i).Heading.Value, parallel.GetSmoothed(i).Heading.Value );
+      EXPECT_EQ( single.GetSmoothed(i).Speed.Value, parallel.GetSmoothed(i).Speed.Value );
+      //future information behind an exact anchor is nearly irrelevant
+      EXPECT_GT( 0.5, GetDistance(single.GetSmoothed(i).Position, whole.GetSmoothed(i).Position) ) << i;
+   }
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
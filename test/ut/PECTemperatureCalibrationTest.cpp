@@ -0,0 +1,179 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PECTemperatureCalibration class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "PECTemperatureCalibration.h"
+
+
+class PECTemperatureCalibrationTest : public ::testing::Test
+{
+public:
+   virtual void SetUp()
+   {}
+   virtual void TearDown()
+   {}
+
+   /**
+    * Adds count of steps: ref in [1..8], raw = ref / scale + bias
+    */
+   static void Learn(PE::CTemperatureCalibration& calib, const double& temperature, const double& bias, const double& scale, uint32_t count)
+   {
+      calib.SetTemperature(temperature);
+      for ( uint32_t i = 0; i < count; ++i )
+      {
+         double ref = 1 + ( i * 7 ) % 8;
+         calib.AddRef(ref);
+         calib.AddRaw(ref / scale + bias);
+         calib.Recalculate();
+      }
+   }
+   static uint32_t GetCurrent(const PE::CTemperatureCalibration& calib)
+   {
+      return calib.m_Current;
+   }
+};
+
+
+/**
+ * tests creation and bins selection
+ */
+TEST_F(PECTemperatureCalibrationTest, bins_test)
+{
+   PE::CTemperatureCalibration calib;
+   EXPECT_EQ  ( 25, calib.GetBinCount() );
+   EXPECT_TRUE( PE::isnan( calib.GetBias() ) );
+   EXPECT_TRUE( PE::isnan( calib.GetScale() ) );
+   EXPECT_EQ  ( 0.0, calib.GetReliable() );
+   EXPECT_EQ  ( calib.GetBinIndex(PE::CTemperatureCalibration::DEFAULT_TEMPERATURE), GetCurrent(calib) );
+
+   EXPECT_EQ  ( 0, calib.GetBinIndex(-100) );
+   EXPECT_EQ  ( 0, calib.GetBinIndex(-40) );
+   EXPECT_EQ  ( 0, calib.GetBinIndex(-35.1) );
+   EXPECT_EQ  ( 1, calib.GetBinIndex(-35) );
+   EXPECT_EQ  ( 12, calib.GetBinIndex(20) );
+   EXPECT_EQ  ( 24, calib.GetBinIndex(84.9) );
+   EXPECT_EQ  ( 24, calib.GetBinIndex(200) );
+
+   calib.SetTemperature(-20);
+   EXPECT_EQ  ( 4, GetCurrent(calib) );
+   //unknown temperature keeps the bin
+   calib.SetTemperature(std::numeric_limits<double>::quiet_NaN());
+   EXPECT_EQ  ( 4, GetCurrent(calib) );
+
+   PE::CTemperatureCalibration wrong(10, 0, 0);
+   EXPECT_EQ  ( 1, wrong.GetBinCount() );
+   EXPECT_EQ  ( 0, wrong.GetBinIndex(-100) );
+   EXPECT_EQ  ( 0, wrong.GetBinIndex(100) );
+}
+
+
+/**
+ * tests separate calibration of bins, learned bin is used immediately after temperature change
+ */
+TEST_F(PECTemperatureCalibrationTest, warm_up_test)
+{
+   PE::CTemperatureCalibration calib;
+
+   Learn(calib, 0, 11, 0.1, 20);
+   EXPECT_NEAR( 11, calib.GetBias(), 0.000001 );
+   EXPECT_NEAR( 0.1, calib.GetScale(), 0.000001 );
+   EXPECT_EQ  ( 19, calib.GetBin(calib.GetBinIndex(0)).Bias.GetSampleCount() );
+
+   Learn(calib, 60, 15, 0.2, 20);
+   EXPECT_NEAR( 15, calib.GetBias(), 0.000001 );
+   EXPECT_NEAR( 0.2, calib.GetScale(), 0.000001 );
+
+   //cold start again: no convergence time
+   calib.SetTemperature(1);
+   EXPECT_NEAR( 11, calib.GetBias(), 0.000001 );
+   EXPECT_NEAR( 0.1, calib.GetScale(), 0.000001 );
+   EXPECT_LT  ( 90, calib.GetReliable() );
+
+   //unknown bin without known neighbours
+   calib.SetTemperature(30);
+   EXPECT_TRUE( PE::isnan( calib.GetBias() ) );
+
+   //rejected step stays in its bin
+   calib.SetTemperature(60);
+   calib.AddRef(100);
+   calib.AddRaw(100);
+   calib.CleanLastStep();
+   Learn(calib, 60, 15, 0.2, 1);
+   EXPECT_NEAR( 15, calib.GetBias(), 0.000001 );
+}
+
+
+/**
+ * tests interpolation of sparse bins
+ */
+TEST_F(PECTemperatureCalibrationTest, interpolation_test)
+{
+   PE::CTemperatureCalibration calib;
+
+   Learn(calib, 2.5, 10, 0.1, 20);   //centre of bin 8
+   Learn(calib, 12.5, 20, 0.3, 20);  //centre of bin 10
+
+   //sparse bin between two dense ones
+   calib.SetTemperature(7.5);
+   EXPECT_NEAR( 15, calib.GetBias(), 0.000001 );
+   EXPECT_NEAR( 0.2, calib.GetScale(), 0.000001 );
+   calib.SetTemperature(5);
+   EXPECT_NEAR( 12.5, calib.GetBias(), 0.000001 );
+
+   //sparse bin with one dense neighbour
+   calib.SetTemperature(-2.5);
+   EXPECT_NEAR( 10, calib.GetBias(), 0.000001 );
+   EXPECT_NEAR( 0.1, calib.GetScale(), 0.000001 );
+
+   //few values in sparse bin are still interpolated
+   Learn(calib, 7.5, 30, 0.5, 4);
+   EXPECT_NEAR( 15, calib.GetBias(), 0.000001 );
+   //bin became dense
+   Learn(calib, 7.5, 30, 0.5, 20);
+   EXPECT_NEAR( 30, calib.GetBias(), 0.000001 );
+}
+
+
+/**
+ * tests restoring of bins from previous driving cycle
+ */
+TEST_F(PECTemperatureCalibrationTest, restore_test)
+{
+   PE::CTemperatureCalibration learned;
+   Learn(learned, 40, 11, 0.1, 30);
+   uint32_t index = learned.GetBinIndex(40);
+
+   PE::CTemperatureCalibration calib;
+   calib.SetBin(index, learned.GetBin(index).Bias, learned.GetBin(index).Scale);
+   calib.SetTemperature(40);
+   EXPECT_NEAR( 11, calib.GetBias(), 0.000001 );
+   EXPECT_NEAR( 0.1, calib.GetScale(), 0.000001 );
+   EXPECT_EQ  ( learned.GetReliable(), calib.GetReliable() );
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
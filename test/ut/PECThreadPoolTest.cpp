@@ -0,0 +1,106 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PE::CThreadPool class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "PECThreadPool.h"
+#include "PETypes.h"
+
+class PECThreadPoolTest : public ::testing::Test
+{
+public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+   }
+};
+
+
+/**
+ * all added tasks are executed before Wait() returns
+ */
+TEST_F(PECThreadPoolTest, test_wait)
+{
+   PE::CThreadPool pool(4);
+   EXPECT_EQ( 4, pool.GetSize() );
+
+   //nothing to wait
+   pool.Wait();
+
+   std::atomic<uint32_t> counter(0);
+   std::vector<uint32_t> results(1000, 0);
+   for ( uint32_t i = 0; i < results.size(); ++i )
+   {
+      pool.Add([&counter, &results, i]()
+      {
+         results[i] = i * 2;
+         ++counter;
+      });
+   }
+   pool.Wait();
+   EXPECT_EQ( 1000, counter.load() );
+   for ( uint32_t i = 0; i < results.size(); ++i )
+   {
+      EXPECT_EQ( i * 2, results[i] );
+   }
+
+   //pool can be reused
+   pool.Add([&counter]() { ++counter; });
+   pool.Wait();
+   EXPECT_EQ( 1001, counter.load() );
+}
+
+
+/**
+ * destructor finishes all added tasks
+ */
+TEST_F(PECThreadPoolTest, test_destructor)
+{
+   std::atomic<uint32_t> counter(0);
+   {
+      PE::CThreadPool pool(2);
+      for ( uint32_t i = 0; i < 100; ++i )
+      {
+         pool.Add([&counter]() { ++counter; });
+      }
+   }
+   EXPECT_EQ( 100, counter.load() );
+}
+
+
+/**
+ * default count of threads
+ */
+TEST_F(PECThreadPoolTest, test_default_size)
+{
+   PE::CThreadPool pool;
+   EXPECT_LT( 0, pool.GetSize() );
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
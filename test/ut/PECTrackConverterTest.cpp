@@ -0,0 +1,198 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PE::CTrackConverter class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <gtest/gtest.h>
+
+#include "PECTrackConverter.h"
+#include "PECTrackFile.h"
+#include "PECTrack.h"
+#include "PETypes.h"
+
+#define RECORDED_TRACK PE_TEST_TRACKS_DIR "ODO_40ms_60sec_GNSS_100ms_32sec.txt"
+
+class PECTrackConverterTest : public ::testing::Test
+{
+public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+      remove(TEXT_NAME);
+      remove(NATIVE_NAME);
+      remove(EXPECTED_NAME);
+   }
+
+   static const char* TEXT_NAME;
+   static const char* NATIVE_NAME;
+   static const char* EXPECTED_NAME;
+
+   static std::string ReadFile(const char* fileName)
+   {
+      std::ifstream file(fileName, std::ios::in | std::ios::binary);
+      return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+   }
+
+   static void WriteFile(const char* fileName, const std::string& content)
+   {
+      std::ofstream file(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+      file.write(content.data(), content.size());
+   }
+
+   /**
+    * Expected native file: the text track loaded and stored
+    */
+   static std::string GetExpected(const char* textFileName)
+   {
+      PE::CTrack track;
+      EXPECT_TRUE( track.LoadText(textFileName) );
+      EXPECT_TRUE( PE::CTrackFile::Store(EXPECTED_NAME, track) );
+      return ReadFile(EXPECTED_NAME);
+   }
+
+   /**
+    * Returns first lines of chunks
+    */
+   static std::vector<std::string> GetChunkStarts(const std::string& text, uint32_t chunkSize)
+   {
+      std::vector<PE::CTrackConverter::SChunk> chunks = PE::CTrackConverter::Split(text.data(), text.data() + text.size(), chunkSize);
+      std::vector<std::string> starts;
+      for ( size_t c = 0; c < chunks.size(); ++c )
+      {
+         EXPECT_EQ( ( 0 == c ) ? text.data() : chunks[c - 1].End, chunks[c].Begin );
+         starts.push_back(std::string(chunks[c].Begin, std::find(chunks[c].Begin, chunks[c].End, '\n')));
+      }
+      EXPECT_EQ( text.data() + text.size(), chunks.empty() ? text.data() : chunks.back().End );
+      return starts;
+   }
+};
+
+const char* PECTrackConverterTest::TEXT_NAME = "test_track_converter.txt";
+const char* PECTrackConverterTest::NATIVE_NAME = "test_track_converter.petrk";
+const char* PECTrackConverterTest::EXPECTED_NAME = "test_track_converter_expected.petrk";
+
+
+/**
+ * chunks start at SPEED records with value
+ */
+TEST_F(PECTrackConverterTest, test_split)
+{
+   const std::string text = "1,ODO,1,10\n2,SPEED,1,100\n3,ACC,1,5\n4,ODO,2,20\n5,SPEED,2\n6,ODO,3,30\n7,SPEED,3,300\n8,ACC,3,5";
+   std::vector<std::string> starts = GetChunkStarts(text, 1);
+   ASSERT_EQ( 3, starts.size() );
+   EXPECT_EQ( "1,ODO,1,10", starts[0] );
+   EXPECT_EQ( "2,SPEED,1,100", starts[1] );
+   EXPECT_EQ( "7,SPEED,3,300", starts[2] );
+
+   //chunk is at least chunk size long, position in the middle of SPEED record goes to the next one
+   starts = GetChunkStarts(text, 12);
+   ASSERT_EQ( 2, starts.size() );
+   EXPECT_EQ( "7,SPEED,3,300", starts[1] );
+
+   EXPECT_EQ( 1, GetChunkStarts(text, 1000).size() );
+   EXPECT_EQ( 0, GetChunkStarts("", 1).size() );
+}
+
+
+/**
+ * converted recorded track is the same like stored one for all chunk sizes and threads
+ */
+TEST_F(PECTrackConverterTest, test_recorded_track)
+{
+   const std::string expected = GetExpected(RECORDED_TRACK);
+   ASSERT_LT( 0, expected.size() );
+
+   const uint32_t chunkSizes[] = { 1, 1000, 10000, PE::CTrackConverter::DEFAULT_CHUNK_SIZE };
+   const uint32_t threadCounts[] = { 1, 3 };
+   for ( uint32_t c = 0; c < sizeof(chunkSizes) / sizeof(chunkSizes[0]); ++c )
+   {
+      for ( uint32_t t = 0; t < sizeof(threadCounts) / sizeof(threadCounts[0]); ++t )
+      {
+         PE::CTrackConverter converter(threadCounts[t], chunkSizes[c]);
+         ASSERT_TRUE( converter.Convert(RECORDED_TRACK, NATIVE_NAME) );
+         EXPECT_EQ( 1503 + 324, converter.GetEventCount() );
+         EXPECT_LT( 40000, converter.GetInputSize() );
+         EXPECT_LE( 1, converter.GetChunkCount() );
+         EXPECT_TRUE( expected == ReadFile(NATIVE_NAME) ) << chunkSizes[c] << " " << threadCounts[t];
+      }
+   }
+
+   //one chunk per SPEED record
+   PE::CTrackConverter converter(1, 1);
+   ASSERT_TRUE( converter.Convert(RECORDED_TRACK, NATIVE_NAME) );
+   EXPECT_EQ( 1 + 324, converter.GetChunkCount() );
+}
+
+
+/**
+ * SPEED and its ACC are kept together also with other records in between
+ */
+TEST_F(PECTrackConverterTest, test_speed_between_chunks)
+{
+   //SPEED without value does not start chunk, it is ignored by parser
+   WriteFile(TEXT_NAME, "1000,SPEED,1,100\r\n1100,ODO,1,10\r\n1200,SPEED,2\r\n1300,ACC,1,5\r\n1400,SPEED,3,300\r\n1500,ODO,2,20\r\n"
+                        "1600,ACC,3,7\r\n1700,POSITION,1,521234567,131234567,250\r\n1800,GYRO,1,2048");
+   const std::string expected = GetExpected(TEXT_NAME);
+
+   PE::CTrackConverter converter(2, 1);
+   ASSERT_TRUE( converter.Convert(TEXT_NAME, NATIVE_NAME) );
+   EXPECT_EQ( 2, converter.GetChunkCount() );
+   EXPECT_EQ( 6, converter.GetEventCount() );
+   EXPECT_TRUE( expected == ReadFile(NATIVE_NAME) );
+
+   PE::CTrackFile file;
+   ASSERT_TRUE( file.Open(NATIVE_NAME) );
+   ASSERT_EQ( 2, file.GetCount(PE::EVENT_SPEED) );
+   EXPECT_EQ( 1.0, file.GetValues(PE::EVENT_SPEED, 0)[0] );
+   EXPECT_EQ( 0.05, file.GetValues(PE::EVENT_SPEED, 1)[0] );
+   EXPECT_EQ( 0.07, file.GetValues(PE::EVENT_SPEED, 1)[1] );
+}
+
+
+/**
+ * empty and not existing files
+ */
+TEST_F(PECTrackConverterTest, test_wrong_files)
+{
+   PE::CTrackConverter converter(1);
+   EXPECT_FALSE( converter.Convert("not_existing_track.txt", NATIVE_NAME) );
+   EXPECT_FALSE( converter.Convert(RECORDED_TRACK, "not_existing_dir/track.petrk") );
+   EXPECT_EQ   ( 0, converter.GetEventCount() );
+
+   WriteFile(TEXT_NAME, "");
+   ASSERT_TRUE ( converter.Convert(TEXT_NAME, NATIVE_NAME) );
+   EXPECT_EQ   ( 0, converter.GetInputSize() );
+   EXPECT_EQ   ( 0, converter.GetChunkCount() );
+   PE::CTrackFile file;
+   ASSERT_TRUE ( file.Open(NATIVE_NAME) );
+   EXPECT_EQ   ( 0, file.GetSize() );
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
@@ -0,0 +1,414 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PE::CTrackFile class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <fstream>
+#include <iterator>
+#include <gtest/gtest.h>
+
+#include "PECTrackFile.h"
+#include "PECTrack.h"
+#include "PETypes.h"
+
+class PECTrackFileTest : public ::testing::Test
+{
+public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+      remove(FILE_NAME);
+   }
+
+   static const char* FILE_NAME;
+
+   static std::string ReadFile(const char* fileName)
+   {
+      std::ifstream file(fileName, std::ios::in | std::ios::binary);
+      return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+   }
+
+   static void WriteFile(const char* fileName, const std::string& content)
+   {
+      std::ofstream file(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+      file.write(content.data(), content.size());
+   }
+
+   static size_t GetHeaderSize()
+   {
+      return sizeof(PE::CTrackFile::SHeader);
+   }
+
+   static size_t GetBlockSize()
+   {
+      return sizeof(PE::CTrackFile::SBlock);
+   }
+
+   static size_t GetSeekEntrySize()
+   {
+      return sizeof(PE::CTrackFile::SSeekEntry);
+   }
+
+   static size_t GetSeekOffsetPosition()
+   {
+      return offsetof(PE::CTrackFile::SHeader, SeekOffset);
+   }
+
+   static size_t GetIndexOffsetPosition()
+   {
+      return offsetof(PE::CTrackFile::SHeader, IndexOffset);
+   }
+};
+
+const char* PECTrackFileTest::FILE_NAME = "test_track_file.petrk";
+
+
+/**
+ * columns of all event types
+ */
+TEST_F(PECTrackFileTest, test_store_and_open)
+{
+   PE::CTrack track;
+   track.Add(PE::STrackEvent(1.0, PE::EVENT_ODO, 25));
+   track.Add(PE::STrackEvent(1.1, PE::EVENT_SPEED, 20.52, 0.13));
+   track.Add(PE::STrackEvent(1.2, PE::EVENT_ODO, 65));
+   track.Add(PE::STrackEvent(1.3, PE::EVENT_HEADING, 270.5, 1.5));
+   track.Add(PE::STrackEvent(1.4, PE::EVENT_POSITION, 52.1234567, -13.1234567, 2.5));
+   track.Add(PE::STrackEvent(1.5, PE::EVENT_GYRO, 2048));
+   ASSERT_TRUE ( PE::CTrackFile::Store(FILE_NAME, track) );
+
+   PE::CTrackFile file;
+   EXPECT_FALSE( file.IsOpen() );
+   EXPECT_EQ   ( 0, file.GetCount(PE::EVENT_ODO) );
+   ASSERT_TRUE ( file.Open(FILE_NAME) );
+   EXPECT_TRUE ( file.IsOpen() );
+
+   //order of 6 events and 5 blocks of timestamps, values and validity words, 8 bytes each for up to 64 events
+   size_t words = 1 + 5 + 5 + 5 + 7 + 3;
+   EXPECT_EQ   ( GetHeaderSize() + words * 8 + GetSeekEntrySize() + 5 * GetBlockSize(), ReadFile(FILE_NAME).size() );
+
+   ASSERT_EQ   ( 6, file.GetSize() );
+   EXPECT_EQ   ( PE::EVENT_ODO, file.GetOrder()[0] );
+   EXPECT_EQ   ( PE::EVENT_SPEED, file.GetOrder()[1] );
+   EXPECT_EQ   ( PE::EVENT_GYRO, file.GetOrder()[5] );
+   ASSERT_EQ   ( 2, file.GetCount(PE::EVENT_ODO) );
+   EXPECT_EQ   ( 1.0, file.GetTimestamps(PE::EVENT_ODO)[0] );
+   EXPECT_EQ   ( 1.2, file.GetTimestamps(PE::EVENT_ODO)[1] );
+   EXPECT_EQ   ( 25, file.GetValues(PE::EVENT_ODO, 0)[0] );
+   EXPECT_EQ   ( 65, file.GetValues(PE::EVENT_ODO, 0)[1] );
+   EXPECT_EQ   ( 3u, file.GetValidity(PE::EVENT_ODO, 0)[0] );
+   //odometer has one value only
+   EXPECT_EQ   ( NULL, file.GetValues(PE::EVENT_ODO, 1) );
+   EXPECT_EQ   ( NULL, file.GetValidity(PE::EVENT_ODO, 1) );
+
+   ASSERT_EQ   ( 1, file.GetCount(PE::EVENT_SPEED) );
+   EXPECT_EQ   ( 20.52, file.GetValues(PE::EVENT_SPEED, 0)[0] );
+   EXPECT_EQ   ( 0.13, file.GetValues(PE::EVENT_SPEED, 1)[0] );
+   ASSERT_EQ   ( 1, file.GetCount(PE::EVENT_HEADING) );
+   EXPECT_EQ   ( 1.5, file.GetValues(PE::EVENT_HEADING, 1)[0] );
+   ASSERT_EQ   ( 1, file.GetCount(PE::EVENT_POSITION) );
+   EXPECT_EQ   ( 52.1234567, file.GetValues(PE::EVENT_POSITION, 0)[0] );
+   EXPECT_EQ   ( -13.1234567, file.GetValues(PE::EVENT_POSITION, 1)[0] );
+   EXPECT_EQ   ( 2.5, file.GetValues(PE::EVENT_POSITION, 2)[0] );
+   EXPECT_TRUE ( file.IsValid(PE::EVENT_POSITION, 2, 0) );
+   EXPECT_FALSE( file.IsValid(PE::EVENT_POSITION, 2, 1) );
+   ASSERT_EQ   ( 1, file.GetCount(PE::EVENT_GYRO) );
+   EXPECT_EQ   ( 1.5, file.GetTimestamps(PE::EVENT_GYRO)[0] );
+
+   EXPECT_EQ   ( 0, file.GetCount(PE::EVENT_UNKNOWN) );
+   EXPECT_EQ   ( NULL, file.GetTimestamps(PE::EVENT_UNKNOWN) );
+
+   file.Close();
+   EXPECT_FALSE( file.IsOpen() );
+   EXPECT_EQ   ( 0, file.GetSize() );
+   EXPECT_EQ   ( 0, file.GetCount(PE::EVENT_ODO) );
+   EXPECT_EQ   ( NULL, file.GetTimestamps(PE::EVENT_ODO) );
+}
+
+
+/**
+ * unknown values are kept in validity bitmap over several words
+ */
+TEST_F(PECTrackFileTest, test_validity)
+{
+   PE::CTrack track;
+   for ( uint32_t i = 0; i < 100; ++i )
+   {
+      double accuracy = ( 0 == i % 3 ) ? std::numeric_limits<double>::quiet_NaN() : 0.1 * i;
+      track.Add(PE::STrackEvent(i, PE::EVENT_SPEED, i, accuracy));
+   }
+   track.Add(PE::STrackEvent(100, PE::EVENT_UNKNOWN, 1));
+   ASSERT_TRUE ( PE::CTrackFile::Store(FILE_NAME, track) );
+
+   PE::CTrackFile file;
+   ASSERT_TRUE ( file.Open(FILE_NAME) );
+   //unknown events are not stored
+   EXPECT_EQ   ( 100, file.GetSize() );
+   EXPECT_EQ   ( 0, file.GetCount(PE::EVENT_UNKNOWN) );
+   ASSERT_EQ   ( 100, file.GetCount(PE::EVENT_SPEED) );
+   for ( uint32_t i = 0; i < 100; ++i )
+   {
+      EXPECT_TRUE ( file.IsValid(PE::EVENT_SPEED, 0, i) );
+      EXPECT_EQ   ( 0 != i % 3, file.IsValid(PE::EVENT_SPEED, 1, i) ) << i;
+      EXPECT_EQ   ( ( 0 == i % 3 ) ? 0.0 : 0.1 * i, file.GetValues(PE::EVENT_SPEED, 1)[i] );
+   }
+   EXPECT_FALSE( file.IsValid(PE::EVENT_SPEED, 1, 100) );
+
+   PE::CTrack loaded;
+   ASSERT_TRUE ( file.ToTrack(loaded) );
+   ASSERT_EQ   ( 100, loaded.GetSize() );
+   EXPECT_TRUE ( PE::isnan(loaded[0].Values[1]) );
+   EXPECT_EQ   ( 0.1, loaded[1].Values[1] );
+}
+
+
+/**
+ * recorded track is the same after conversion, also order of events which are not sorted by time
+ */
+TEST_F(PECTrackFileTest, test_recorded_track)
+{
+   PE::CTrack text;
+   ASSERT_TRUE ( text.LoadText(PE_TEST_TRACKS_DIR "ODO_40ms_60sec_GNSS_100ms_32sec.txt") );
+   ASSERT_TRUE ( PE::CTrackFile::Store(FILE_NAME, text) );
+
+   PE::CTrackFile file;
+   ASSERT_TRUE ( file.Open(FILE_NAME) );
+   EXPECT_EQ   ( 1503, file.GetCount(PE::EVENT_ODO) );
+   EXPECT_EQ   ( 324, file.GetCount(PE::EVENT_SPEED) );
+
+   PE::CTrack native;
+   ASSERT_TRUE ( file.ToTrack(native) );
+   ASSERT_EQ   ( text.GetSize(), native.GetSize() );
+   for ( size_t i = 0; i < text.GetSize(); ++i )
+   {
+      EXPECT_EQ( text[i].Timestamp, native[i].Timestamp ) << i;
+      EXPECT_EQ( text[i].Type, native[i].Type ) << i;
+      for ( uint32_t v = 0; v < PE::CTrackFile::GetValueCount(text[i].Type); ++v )
+      {
+         EXPECT_EQ( text[i].Values[v], native[i].Values[v] ) << i;
+      }
+   }
+
+   PE::CTrackFile closed;
+   EXPECT_FALSE( closed.ToTrack(native) );
+   EXPECT_EQ   ( 0, native.GetSize() );
+}
+
+
+/**
+ * empty track has header and no blocks
+ */
+TEST_F(PECTrackFileTest, test_empty_track)
+{
+   PE::CTrack track;
+   ASSERT_TRUE ( PE::CTrackFile::Store(FILE_NAME, track) );
+   EXPECT_EQ   ( GetHeaderSize(), ReadFile(FILE_NAME).size() );
+
+   PE::CTrackFile file;
+   ASSERT_TRUE ( file.Open(FILE_NAME) );
+   EXPECT_EQ   ( 0, file.GetSize() );
+   EXPECT_EQ   ( NULL, file.GetOrder() );
+   EXPECT_EQ   ( 0, file.GetCount(PE::EVENT_ODO) );
+   PE::CTrack loaded;
+   EXPECT_TRUE ( file.ToTrack(loaded) );
+   EXPECT_EQ   ( 0, loaded.GetSize() );
+}
+
+
+/**
+ * created file is filled in place, opened file is read only
+ */
+TEST_F(PECTrackFileTest, test_create)
+{
+   size_t counts[PE::EVENT_COUNT] = { 0 };
+   counts[PE::EVENT_UNKNOWN] = 1;
+   PE::CTrackFile file;
+   EXPECT_FALSE( file.Create(FILE_NAME, counts) );
+   EXPECT_EQ   ( NULL, file.EditOrder() );
+
+   counts[PE::EVENT_UNKNOWN] = 0;
+   counts[PE::EVENT_GYRO] = 2;
+   ASSERT_TRUE ( file.Create(FILE_NAME, counts) );
+   ASSERT_EQ   ( 2, file.GetSize() );
+   EXPECT_EQ   ( 0, file.GetOrder()[0] );
+   EXPECT_FALSE( file.IsValid(PE::EVENT_GYRO, 0, 0) );
+   //rows are set in any order
+   file.SetEvent(1, 1, PE::STrackEvent(2.0, PE::EVENT_GYRO, 20));
+   file.SetEvent(0, 0, PE::STrackEvent(1.0, PE::EVENT_GYRO, std::numeric_limits<double>::quiet_NaN()));
+   EXPECT_EQ   ( NULL, file.EditValues(PE::EVENT_GYRO, 1) );
+   EXPECT_EQ   ( NULL, file.EditTimestamps(PE::EVENT_ODO) );
+   file.Close();
+
+   ASSERT_TRUE ( file.Open(FILE_NAME) );
+   EXPECT_EQ   ( NULL, file.EditOrder() );
+   EXPECT_EQ   ( NULL, file.EditTimestamps(PE::EVENT_GYRO) );
+   EXPECT_EQ   ( NULL, file.EditValues(PE::EVENT_GYRO, 0) );
+   EXPECT_EQ   ( NULL, file.EditValidity(PE::EVENT_GYRO, 0) );
+   EXPECT_EQ   ( PE::EVENT_GYRO, file.GetOrder()[1] );
+   EXPECT_EQ   ( 1.0, file.GetTimestamps(PE::EVENT_GYRO)[0] );
+   EXPECT_EQ   ( 20, file.GetValues(PE::EVENT_GYRO, 0)[1] );
+   EXPECT_FALSE( file.IsValid(PE::EVENT_GYRO, 0, 0) );
+   EXPECT_TRUE ( file.IsValid(PE::EVENT_GYRO, 0, 1) );
+}
+
+
+/**
+ * damaged files are not opened
+ */
+TEST_F(PECTrackFileTest, test_wrong_files)
+{
+   PE::CTrackFile file;
+   EXPECT_FALSE( file.Open("not_existing_track.petrk") );
+   EXPECT_FALSE( PE::CTrackFile::Store("not_existing_dir/track.petrk", PE::CTrack()) );
+
+   PE::CTrack track;
+   track.Add(PE::STrackEvent(1.0, PE::EVENT_ODO, 25));
+   track.Add(PE::STrackEvent(1.1, PE::EVENT_SPEED, 20.52, 0.13));
+   ASSERT_TRUE ( PE::CTrackFile::Store(FILE_NAME, track) );
+   const std::string content = ReadFile(FILE_NAME);
+   ASSERT_TRUE ( file.Open(FILE_NAME) );
+
+   //text track
+   WriteFile(FILE_NAME, "269128,ODO,6720,25,0,0\n269168,ODO,6721,65,0,0\n");
+   EXPECT_FALSE( file.Open(FILE_NAME) );
+   EXPECT_FALSE( file.IsOpen() );
+
+   //truncated
+   WriteFile(FILE_NAME, content.substr(0, content.size() - 8));
+   EXPECT_FALSE( file.Open(FILE_NAME) );
+   WriteFile(FILE_NAME, content.substr(0, 4));
+   EXPECT_FALSE( file.Open(FILE_NAME) );
+
+   //other version
+   std::string damaged = content;
+   damaged[8] = PE::CTrackFile::VERSION + 1;
+   WriteFile(FILE_NAME, damaged);
+   EXPECT_FALSE( file.Open(FILE_NAME) );
+
+   //timestamps of the first block outside of the blocks
+   damaged = content;
+   uint64_t indexOffset = 0;
+   memcpy(&indexOffset, &damaged[GetIndexOffsetPosition()], sizeof(indexOffset));
+   uint64_t offset = content.size();
+   memcpy(&damaged[indexOffset + 16], &offset, sizeof(offset));
+   WriteFile(FILE_NAME, damaged);
+   EXPECT_FALSE( file.Open(FILE_NAME) );
+
+   //seek index outside of the blocks
+   damaged = content;
+   memcpy(&damaged[GetSeekOffsetPosition()], &offset, sizeof(offset));
+   WriteFile(FILE_NAME, damaged);
+   EXPECT_FALSE( file.Open(FILE_NAME) );
+
+   //order with type which has no more events
+   damaged = content;
+   damaged[GetHeaderSize() + 1] = PE::EVENT_ODO;
+   WriteFile(FILE_NAME, damaged);
+   EXPECT_TRUE ( file.Open(FILE_NAME) );
+   PE::CTrack loaded;
+   EXPECT_FALSE( file.ToTrack(loaded) );
+   EXPECT_EQ   ( 0, loaded.GetSize() );
+   PE::CTrackFile::SCursor cursor;
+   EXPECT_FALSE( file.Seek(1.05, cursor) );
+   EXPECT_EQ   ( 0, cursor.Index );
+
+   //order with unknown type
+   damaged = content;
+   damaged[GetHeaderSize() + 1] = static_cast<char>(PE::EVENT_COUNT);
+   WriteFile(FILE_NAME, damaged);
+   EXPECT_TRUE ( file.Open(FILE_NAME) );
+   EXPECT_FALSE( file.ToTrack(loaded) );
+   EXPECT_EQ   ( 0, loaded.GetSize() );
+   damaged[GetHeaderSize() + 1] = static_cast<char>(0xFF);
+   WriteFile(FILE_NAME, damaged);
+   EXPECT_TRUE ( file.Open(FILE_NAME) );
+   EXPECT_FALSE( file.ToTrack(loaded) );
+   cursor.Index = 1;
+   EXPECT_FALSE( file.Seek(1.05, cursor) );
+   EXPECT_EQ   ( 0, cursor.Index );
+
+   WriteFile(FILE_NAME, content);
+   EXPECT_TRUE ( file.Open(FILE_NAME) );
+   EXPECT_TRUE ( file.ToTrack(loaded) );
+   EXPECT_EQ   ( 2, loaded.GetSize() );
+}
+
+
+/**
+ * seek finds the first event from which no newer event is lost, also for events not sorted by time
+ */
+TEST_F(PECTrackFileTest, test_seek)
+{
+   //every 10th event arrives late, timestamps are in [ms] to be exact
+   PE::CTrack track;
+   const size_t count = 3 * PE::CTrackFile::SEEK_INTERVAL + 17;
+   for ( size_t i = 0; i < count; ++i )
+   {
+      const double ts = ( 0 == i % 10 && 0 < i ) ? i - 25.0 : static_cast<double>(i);
+      track.Add(PE::STrackEvent(ts, ( 0 == i % 3 ) ? PE::EVENT_SPEED : PE::EVENT_ODO, i, 0.5));
+   }
+   ASSERT_TRUE ( PE::CTrackFile::Store(FILE_NAME, track) );
+   PE::CTrackFile file;
+   PE::CTrackFile::SCursor cursor;
+   EXPECT_FALSE( file.Seek(0, cursor) );
+   ASSERT_TRUE ( file.Open(FILE_NAME) );
+
+   //reference: first event with maximal timestamp till it at or after the searched one
+   for ( double ts = -10; ts < count + 10; ts += 0.5 )
+   {
+      size_t expected = 0;
+      double newest = -std::numeric_limits<double>::infinity();
+      while ( expected < count && std::max(newest, track[expected].Timestamp) < ts )
+      {
+         newest = std::max(newest, track[expected++].Timestamp);
+      }
+      ASSERT_TRUE ( file.Seek(ts, cursor) ) << ts;
+      ASSERT_EQ   ( expected, cursor.Index ) << ts;
+      PE::STrackEvent event;
+      if ( expected < count )
+      {
+         ASSERT_TRUE ( file.Next(cursor, event) );
+         EXPECT_EQ   ( track[expected].Timestamp, event.Timestamp ) << ts;
+         EXPECT_EQ   ( track[expected].Values[0], event.Values[0] ) << ts;
+         EXPECT_EQ   ( expected + 1, cursor.Index );
+      }
+      else
+      {
+         EXPECT_FALSE( file.Next(cursor, event) );
+      }
+   }
+
+   //empty track
+   ASSERT_TRUE ( PE::CTrackFile::Store(FILE_NAME, PE::CTrack()) );
+   ASSERT_TRUE ( file.Open(FILE_NAME) );
+   cursor.Index = 5;
+   EXPECT_TRUE ( file.Seek(100, cursor) );
+   EXPECT_EQ   ( 0, cursor.Index );
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
@@ -0,0 +1,263 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PE::CTrackReader class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fstream>
+#include <gtest/gtest.h>
+
+#include "PECTrackReader.h"
+#include "PECTrack.h"
+#include "PETypes.h"
+
+#define RECORDED_TRACK PE_TEST_TRACKS_DIR "ODO_40ms_60sec_GNSS_100ms_32sec.txt"
+
+class PECTrackReaderTest : public ::testing::Test
+{
+public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+      remove(FILE_NAME);
+   }
+
+   static const char* FILE_NAME;
+
+   static bool Parse(PE::CTrackReader& reader, const char* line, PE::STrackEvent& event)
+   {
+      return reader.Parse(line, line + strlen(line), event);
+   }
+
+   static std::thread::id GetThreadId(const PE::CTrackReader& reader)
+   {
+      return reader.m_Thread.get_id();
+   }
+
+   static void WriteFile(const std::string& content)
+   {
+      std::ofstream file(FILE_NAME, std::ios::out | std::ios::binary | std::ios::trunc);
+      file.write(content.data(), content.size());
+   }
+
+   /**
+    * Reference: events of line by line parsing of CTrack
+    */
+   static std::vector<PE::STrackEvent> ReadByLines(const char* fileName)
+   {
+      PE::CTrack track;
+      std::ifstream file(fileName);
+      std::string line;
+      while ( std::getline(file, line) )
+      {
+         track.AddLine(line);
+      }
+      return track.GetEvents();
+   }
+
+   static void ExpectEvent(const PE::STrackEvent& expected, const PE::STrackEvent& event)
+   {
+      EXPECT_EQ( expected.Timestamp, event.Timestamp );
+      EXPECT_EQ( expected.Type, event.Type );
+      EXPECT_EQ( expected.Values[0], event.Values[0] );
+      EXPECT_EQ( expected.Values[1], event.Values[1] );
+      EXPECT_EQ( expected.Values[2], event.Values[2] );
+   }
+};
+
+const char* PECTrackReaderTest::FILE_NAME = "test_track_reader.txt";
+
+
+/**
+ * parsing of all known records like CTrack::AddLine()
+ */
+TEST_F(PECTrackReaderTest, test_parse)
+{
+   PE::CTrackReader reader(64);
+   PE::CTrack track;
+   const char* lines[] = { "269128,ODO,6720,25,0,0", "269213,SPEED,7,2052", "269213,ACC,7,13",
+                           "269355,SPEED,8,2052", "269355,ACC,9,13", "269400,GYRO,1,2048\r",
+                           "269500,HEADING,1,27050,150", "269600,POSITION,1,521234567,-131234567,250",
+                           "269700,POSITION,1,52.1234567e7,+13.1234567e7,2.5e2,0,0", "269800.5,GYRO,1,-0.25",
+                           "", "269600,ODO,1", "269600,HEADING,1,100", "269600,POSITION,1,100,100",
+                           "269600,UNKNOWN,1,100,100", "269600,ODOX,1,100", ",,,", "269128,ODO,6720,9999999999999999" };
+   for ( uint32_t i = 0; i < sizeof(lines) / sizeof(lines[0]); ++i )
+   {
+      PE::STrackEvent event;
+      const bool added = track.AddLine(lines[i]);
+      EXPECT_EQ( added, Parse(reader, lines[i], event) ) << lines[i];
+      if ( added )
+      {
+         ExpectEvent(track[track.GetSize() - 1], event);
+      }
+   }
+   EXPECT_EQ( 8, track.GetSize() );
+}
+
+
+/**
+ * recorded track with chunks of different sizes, records are split between chunks
+ */
+TEST_F(PECTrackReaderTest, test_recorded_track)
+{
+   const std::vector<PE::STrackEvent> expected = ReadByLines(RECORDED_TRACK);
+   ASSERT_EQ( 1503 + 324, expected.size() );
+
+   const uint32_t chunkSizes[] = { 1, 7, 100, 4096, PE::CTrackReader::DEFAULT_CHUNK_SIZE };
+   for ( uint32_t c = 0; c < sizeof(chunkSizes) / sizeof(chunkSizes[0]); ++c )
+   {
+      PE::CTrackReader reader(chunkSizes[c]);
+      ASSERT_TRUE( reader.Open(RECORDED_TRACK) );
+      EXPECT_TRUE( reader.IsOpen() );
+      PE::STrackEvent event;
+      size_t count = 0;
+      while ( reader.Next(event) )
+      {
+         ASSERT_GT( expected.size(), count );
+         ExpectEvent(expected[count++], event);
+      }
+      EXPECT_EQ( expected.size(), count ) << chunkSizes[c];
+      EXPECT_EQ( expected.size(), reader.GetEventCount() );
+      EXPECT_EQ( 1503 + 2 * 324, reader.GetRecordCount() );
+      EXPECT_LT( 40000, reader.GetByteCount() );
+      //end of the file stays
+      EXPECT_FALSE( reader.Next(event) );
+   }
+
+   //CTrack uses the reader
+   PE::CTrack track;
+   ASSERT_TRUE( track.LoadText(RECORDED_TRACK) );
+   ASSERT_EQ( expected.size(), track.GetSize() );
+   ExpectEvent(expected.back(), track[track.GetSize() - 1]);
+}
+
+
+/**
+ * the last line without line end, too long lines and windows line ends
+ */
+TEST_F(PECTrackReaderTest, test_line_ends)
+{
+   std::string content = "1000,ODO,1,10\r\n";
+   content += "2000,GYRO,1," + std::string(2 * PE::CTrackReader::MAX_LINE_LENGTH, '1') + "\n";
+   content += "\n3000,ODO,2,30";
+   WriteFile(content);
+
+   const uint32_t chunkSizes[] = { 3, 1024 };
+   for ( uint32_t c = 0; c < sizeof(chunkSizes) / sizeof(chunkSizes[0]); ++c )
+   {
+      PE::CTrackReader reader(chunkSizes[c]);
+      ASSERT_TRUE( reader.Open(FILE_NAME) );
+      PE::STrackEvent event;
+      ASSERT_TRUE( reader.Next(event) );
+      EXPECT_EQ( 10, event.Values[0] );
+      //long record is cut in its value if it is split between chunks
+      ASSERT_TRUE( reader.Next(event) );
+      EXPECT_EQ( PE::EVENT_GYRO, event.Type );
+      ASSERT_TRUE( reader.Next(event) );
+      EXPECT_EQ( 3.0, event.Timestamp );
+      EXPECT_EQ( 30, event.Values[0] );
+      EXPECT_FALSE( reader.Next(event) );
+      EXPECT_EQ( 4, reader.GetRecordCount() );
+      EXPECT_EQ( content.size(), reader.GetByteCount() );
+   }
+}
+
+
+/**
+ * reading from the beginning again and stopping in the middle
+ */
+TEST_F(PECTrackReaderTest, test_rewind_and_close)
+{
+   PE::CTrackReader reader(100);
+   PE::STrackEvent event;
+   EXPECT_FALSE( reader.Open("not_existing_track.txt") );
+   EXPECT_FALSE( reader.IsOpen() );
+   EXPECT_FALSE( reader.Next(event) );
+   EXPECT_FALSE( reader.Rewind() );
+
+   ASSERT_TRUE ( reader.Open(RECORDED_TRACK) );
+   for ( uint32_t i = 0; i < 10; ++i )
+   {
+      ASSERT_TRUE( reader.Next(event) );
+   }
+   EXPECT_NEAR ( 269.408, event.Timestamp, PE::EPSILON );
+
+   //reading thread waits for free buffer, it is kept by rewind
+   const std::thread::id thread = GetThreadId(reader);
+   ASSERT_TRUE ( reader.Rewind() );
+   EXPECT_EQ   ( thread, GetThreadId(reader) );
+   EXPECT_EQ   ( 0, reader.GetEventCount() );
+   uint32_t count = 0;
+   while ( reader.Next(event) )
+   {
+      ++count;
+   }
+   EXPECT_EQ   ( 1503 + 324, count );
+   EXPECT_EQ   ( 0, reader.GetError() );
+
+   //reading thread waits at the end of the file
+   ASSERT_TRUE ( reader.Rewind() );
+   EXPECT_EQ   ( thread, GetThreadId(reader) );
+   ASSERT_TRUE ( reader.Next(event) );
+   EXPECT_NEAR ( 269.128, event.Timestamp, PE::EPSILON );
+   reader.Close();
+   EXPECT_FALSE( reader.IsOpen() );
+   EXPECT_FALSE( reader.Next(event) );
+}
+
+
+/**
+ * failed reading is reported and not taken as the end of the file
+ */
+TEST_F(PECTrackReaderTest, test_read_error)
+{
+   PE::CTrackReader reader(100);
+   PE::STrackEvent event;
+
+   //directory could be opened but not read
+   ASSERT_TRUE ( reader.Open(".") );
+   EXPECT_FALSE( reader.Next(event) );
+   EXPECT_EQ   ( EISDIR, reader.GetError() );
+   EXPECT_EQ   ( 0, reader.GetRecordCount() );
+
+   //error stays till rewind
+   EXPECT_FALSE( reader.Next(event) );
+   EXPECT_EQ   ( EISDIR, reader.GetError() );
+   ASSERT_TRUE ( reader.Rewind() );
+   EXPECT_EQ   ( 0, reader.GetError() );
+   EXPECT_FALSE( reader.Next(event) );
+   EXPECT_EQ   ( EISDIR, reader.GetError() );
+
+   //error is cleaned by opening of next file
+   WriteFile("269128,ODO,1,5\n");
+   ASSERT_TRUE ( reader.Open(FILE_NAME) );
+   EXPECT_TRUE ( reader.Next(event) );
+   EXPECT_FALSE( reader.Next(event) );
+   EXPECT_EQ   ( 0, reader.GetError() );
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
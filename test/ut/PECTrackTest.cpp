@@ -0,0 +1,135 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Unit test of the PE::CTrack class.
+ *
+ * Code under test:
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "PECTrack.h"
+#include "PETypes.h"
+
+class PECTrackTest : public ::testing::Test
+{
+public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+   }
+
+   uint32_t CountOf(const PE::CTrack& track, PE::TEventType type) const
+   {
+      uint32_t count = 0;
+      for ( size_t i = 0; i < track.GetSize(); ++i )
+      {
+         if ( type == track[i].Type )
+         {
+            ++count;
+         }
+      }
+      return count;
+   }
+};
+
+
+/**
+ * parsing of all known records
+ */
+TEST_F(PECTrackTest, test_add_line)
+{
+   PE::CTrack track;
+   EXPECT_EQ   ( 0, track.GetSize() );
+
+   EXPECT_TRUE ( track.AddLine("269128,ODO,6720,25,0,0") );
+   EXPECT_EQ   ( 1, track.GetSize() );
+   EXPECT_EQ   ( PE::EVENT_ODO, track[0].Type );
+   EXPECT_NEAR ( 269.128, track[0].Timestamp, PE::EPSILON );
+   EXPECT_NEAR ( 25, track[0].Values[0], PE::EPSILON );
+
+   //speed is added together with its accuracy
+   EXPECT_FALSE( track.AddLine("269213,SPEED,7,2052") );
+   EXPECT_EQ   ( 1, track.GetSize() );
+   EXPECT_TRUE ( track.AddLine("269213,ACC,7,13") );
+   EXPECT_EQ   ( 2, track.GetSize() );
+   EXPECT_EQ   ( PE::EVENT_SPEED, track[1].Type );
+   EXPECT_NEAR ( 269.213, track[1].Timestamp, PE::EPSILON );
+   EXPECT_NEAR ( 20.52, track[1].Values[0], PE::EPSILON );
+   EXPECT_NEAR ( 0.13, track[1].Values[1], PE::EPSILON );
+   //accuracy of other speed is ignored
+   EXPECT_FALSE( track.AddLine("269355,SPEED,8,2052") );
+   EXPECT_FALSE( track.AddLine("269355,ACC,9,13") );
+   EXPECT_FALSE( track.AddLine("269455,SPEED,10,2052") );
+   EXPECT_FALSE( track.AddLine("269455,ACC,8,13") );
+   EXPECT_EQ   ( 2, track.GetSize() );
+
+   EXPECT_TRUE ( track.AddLine("269400,GYRO,1,2048") );
+   EXPECT_EQ   ( PE::EVENT_GYRO, track[2].Type );
+   EXPECT_NEAR ( 2048, track[2].Values[0], PE::EPSILON );
+
+   EXPECT_TRUE ( track.AddLine("269500,HEADING,1,27050,150") );
+   EXPECT_EQ   ( PE::EVENT_HEADING, track[3].Type );
+   EXPECT_NEAR ( 270.5, track[3].Values[0], PE::EPSILON );
+   EXPECT_NEAR ( 1.5, track[3].Values[1], PE::EPSILON );
+
+   EXPECT_TRUE ( track.AddLine("269600,POSITION,1,521234567,-131234567,250") );
+   EXPECT_EQ   ( PE::EVENT_POSITION, track[4].Type );
+   EXPECT_NEAR ( 52.1234567, track[4].Values[0], PE::EPSILON );
+   EXPECT_NEAR ( -13.1234567, track[4].Values[1], PE::EPSILON );
+   EXPECT_NEAR ( 2.5, track[4].Values[2], PE::EPSILON );
+
+   //wrong records
+   EXPECT_FALSE( track.AddLine("") );
+   EXPECT_FALSE( track.AddLine("269600,ODO,1") );
+   EXPECT_FALSE( track.AddLine("269600,HEADING,1,100") );
+   EXPECT_FALSE( track.AddLine("269600,POSITION,1,100,100") );
+   EXPECT_FALSE( track.AddLine("269600,UNKNOWN,1,100,100") );
+   EXPECT_EQ   ( 5, track.GetSize() );
+
+   track.Clean();
+   EXPECT_EQ   ( 0, track.GetSize() );
+}
+
+
+/**
+ * loading of recorded track
+ */
+TEST_F(PECTrackTest, test_load_text)
+{
+   PE::CTrack track;
+   EXPECT_FALSE( track.LoadText(PE_TEST_TRACKS_DIR "not_existing_track.txt") );
+   EXPECT_TRUE ( track.LoadText(PE_TEST_TRACKS_DIR "ODO_40ms_60sec_GNSS_100ms_32sec.txt") );
+   EXPECT_EQ   ( 1503 + 324, track.GetSize() );
+   EXPECT_EQ   ( 1503, CountOf(track, PE::EVENT_ODO) );
+   EXPECT_EQ   ( 324, CountOf(track, PE::EVENT_SPEED) );
+   EXPECT_NEAR ( 269.128, track[0].Timestamp, PE::EPSILON );
+   EXPECT_NEAR ( 329.208, track[track.GetSize() - 1].Timestamp, PE::EPSILON );
+   EXPECT_NEAR ( 1042, track[track.GetSize() - 1].Values[0], PE::EPSILON );
+
+   //second loading replaces content
+   EXPECT_TRUE ( track.LoadText(PE_TEST_TRACKS_DIR "ODO_40ms_60sec_GNSS_100ms_32sec.txt") );
+   EXPECT_EQ   ( 1503 + 324, track.GetSize() );
+}
+
+
+int main(int argc, char *argv[])
+{
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
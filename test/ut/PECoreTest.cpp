@@ -18,9 +18,11 @@
   * Code under test:
   *
   */
+#include <stdio.h>
 #include <string>
 #include <gtest/gtest.h>
 #include "PECore.h"
+#include "PECTrackFile.h"
 
 
 class PECoreTest : public ::testing::Test
@@ -91,6 +93,19 @@ TEST_F(PECoreTest, invalid_instance_test )
    double odorel;
    //PEReceiveOdoStatus
    EXPECT_FALSE( PEReceiveOdoStatus(invalidInstance, odobase, odoscale, odorel) );
+
+   uint64_t recorded;
+   uint64_t dropped;
+   uint64_t written;
+   //PEStartRecording, PEStopRecording, PEReceiveRecorderStatus
+   EXPECT_FALSE( PEStartRecording(invalidInstance, "test_core.petrk") );
+   EXPECT_FALSE( PEStopRecording(invalidInstance) );
+   EXPECT_FALSE( PEReceiveRecorderStatus(invalidInstance, recorded, dropped, written) );
+
+   PE::SSensorStats odoStats;
+   PE::SSensorStats gyroStats;
+   //PEReceiveStats
+   EXPECT_FALSE( PEReceiveStats(invalidInstance, odoStats, gyroStats) );
 }
 
 
@@ -218,6 +233,101 @@ TEST_F(PECoreTest, after_stop_test )
    //PEReceiveOdoStatus
    EXPECT_FALSE( PEReceiveOdoStatus(pe, odobase, odoscale, odorel) );
 
+   PE::SSensorStats odoStats;
+   PE::SSensorStats gyroStats;
+   //PEReceiveStats
+   EXPECT_FALSE( PEReceiveStats(pe, odoStats, gyroStats) );
+}
+
+
+/**
+ * test recording of sent sensors data into native track file
+ */
+TEST_F(PECoreTest, recording_test )
+{
+   const char* fileName = "test_core.petrk";
+   PECCore* pe = PEStart("test3");
+   uint64_t recorded = 1;
+   uint64_t dropped = 1;
+   uint64_t written = 1;
+   EXPECT_FALSE( PEStopRecording(pe) );
+   EXPECT_FALSE( PEReceiveRecorderStatus(pe, recorded, dropped, written) );
+   EXPECT_FALSE( PEStartRecording(pe, 0) );
+
+   ASSERT_TRUE ( PEStartRecording(pe, fileName) );
+   EXPECT_TRUE ( PESendCoordinates(pe, 1.0, 52.5, 13.4, 3.0) );
+   EXPECT_TRUE ( PESendHeading(pe, 1.1, 90.0, 1.0) );
+   EXPECT_TRUE ( PESendSpeed(pe, 1.2, 12.5, 0.5) );
+   EXPECT_TRUE ( PESendGyro(pe, 1.3, 2048) );
+   EXPECT_TRUE ( PESendOdo(pe, 1.4, 120) );
+   EXPECT_TRUE ( PEReceiveRecorderStatus(pe, recorded, dropped, written) );
+   EXPECT_EQ   ( 5, recorded );
+   EXPECT_EQ   ( 0, dropped );
+   ASSERT_TRUE ( PEStopRecording(pe) );
+   EXPECT_FALSE( PEReceiveRecorderStatus(pe, recorded, dropped, written) );
+
+   PE::CTrackFile file;
+   ASSERT_TRUE ( file.Open(fileName) );
+   ASSERT_EQ   ( 5, file.GetSize() );
+   EXPECT_EQ   ( 52.5, file.GetValues(PE::EVENT_POSITION, 0)[0] );
+   EXPECT_EQ   ( 90.0, file.GetValues(PE::EVENT_HEADING, 0)[0] );
+   EXPECT_EQ   ( 0.5, file.GetValues(PE::EVENT_SPEED, 1)[0] );
+   EXPECT_EQ   ( 2048, file.GetValues(PE::EVENT_GYRO, 0)[0] );
+   EXPECT_EQ   ( 1.4, file.GetTimestamps(PE::EVENT_ODO)[0] );
+   file.Close();
+
+   //recording is stopped with the instance
+   ASSERT_TRUE ( PEStartRecording(pe, fileName) );
+   EXPECT_TRUE ( PESendOdo(pe, 1.5, 121) );
+   EXPECT_EQ   ( std::string("test3"), std::string(PEStop(pe)) );
+   ASSERT_TRUE ( file.Open(fileName) );
+   EXPECT_EQ   ( 1, file.GetSize() );
+   file.Close();
+   remove(fileName);
+}
+
+
+/**
+ * test counters of accepted and rejected sensors data of odometer and gyroscope of the engine
+ */
+TEST_F(PECoreTest, stats_test )
+{
+   PECCore* pe = PEStart("test4");
+   PE::SSensorStats odoStats;
+   PE::SSensorStats gyroStats;
+   ASSERT_TRUE ( PEReceiveStats(pe, odoStats, gyroStats) );
+   EXPECT_EQ   ( 0, odoStats.RefAccepted + odoStats.SenAccepted + odoStats.Steps );
+   EXPECT_EQ   ( 0, gyroStats.RefAccepted + gyroStats.SenAccepted + gyroStats.Steps );
+
+   //10 m/s with 100 ticks per 100 ms, turning with 10 deg/s
+   for ( int i = 0; i < 100; ++i )
+   {
+      const double timestamp = 1.0 + 0.1 * i;
+      EXPECT_TRUE ( PESendSpeed(pe, timestamp, 10.0, 0.1) );
+      EXPECT_TRUE ( PESendOdo(pe, timestamp, 100 * i) );
+      EXPECT_TRUE ( PESendHeading(pe, timestamp, 90.0 + i, 0.1) );
+      EXPECT_TRUE ( PESendGyro(pe, timestamp, 2048 + 100) );
+   }
+   //out of range values are counted
+   EXPECT_TRUE ( PESendSpeed(pe, 11.0, 400.0, 0.1) );
+   EXPECT_TRUE ( PESendHeading(pe, 11.0, 400.0, 0.1) );
+   ASSERT_TRUE ( PEReceiveStats(pe, odoStats, gyroStats) );
+   //samples are rejected till the rate of the sensors is detected by 16 intervals
+   EXPECT_EQ   ( 15, odoStats.RefInterval );
+   EXPECT_EQ   ( 15, odoStats.SenInterval );
+   EXPECT_EQ   ( 1, odoStats.RefOutOfRange );
+   EXPECT_LT   ( 0, odoStats.RefAccepted );
+   EXPECT_LT   ( 0, odoStats.SenAccepted );
+   EXPECT_LT   ( 0, odoStats.Steps );
+   EXPECT_EQ   ( 15, gyroStats.RefInterval );
+   EXPECT_EQ   ( 15, gyroStats.SenInterval );
+   EXPECT_EQ   ( 1, gyroStats.RefOutOfRange );
+   EXPECT_LT   ( 0, gyroStats.RefAccepted );
+   EXPECT_LT   ( 0, gyroStats.SenAccepted );
+   EXPECT_LT   ( 0, gyroStats.Steps );
+
+   EXPECT_EQ   ( std::string("test4"), std::string(PEStop(pe)) );
+   EXPECT_FALSE( PEReceiveStats(pe, odoStats, gyroStats) );
 }
 
 
@@ -682,6 +682,28 @@ TEST_F(PEFusionToolsTest, test_Predict_Speed_turning_right_40_deg )
 }
 
 
+/**
+ * PredictSpeed and PredictHeading by precalculated geodesic are the same like by positions
+ */
+TEST_F(PEFusionToolsTest, test_Predict_by_geodesic )
+{
+   double deltaTime ( 4 );
+   PE::SPosition  pos     ( 50.000000, 10.000000, 1.0);
+   PE::SPosition  pos4sec ( 50.00006027, 10.00025763, 1.0);
+   PE::SBasicSensor angSpeed (  10.0, 0.5);
+   PE::SBasicSensor heading  (  90.0, 1.0);
+   PE::TOOLS::SGeodesic geodesic = PE::TOOLS::ToGeodesic(pos.Latitude, pos.Longitude, pos4sec.Latitude, pos4sec.Longitude);
+
+   EXPECT_EQ( PE::FUSION::PredictSpeed(deltaTime,pos,pos4sec,angSpeed), PE::FUSION::PredictSpeed(deltaTime,pos,pos4sec,geodesic,angSpeed) );
+   EXPECT_EQ( PE::FUSION::PredictHeading(deltaTime,pos,pos4sec,heading), PE::FUSION::PredictHeading(deltaTime,pos,pos4sec,geodesic,heading) );
+   EXPECT_EQ( PE::FUSION::PredictHeading(deltaTime,pos,pos4sec,PE::SBasicSensor()), PE::FUSION::PredictHeading(deltaTime,pos,pos4sec,geodesic,PE::SBasicSensor()) );
+   //invalid inputs are checked the same way
+   EXPECT_FALSE( PE::FUSION::PredictSpeed(0.0,pos,pos4sec,geodesic,angSpeed).IsValid() );
+   EXPECT_FALSE( PE::FUSION::PredictSpeed(deltaTime,PE::SPosition(),pos4sec,geodesic,angSpeed).IsValid() );
+   EXPECT_EQ( heading.Value, PE::FUSION::PredictHeading(deltaTime,pos,PE::SPosition(),geodesic,heading).Value );
+}
+
+
 /**
  * PredictSpeed straight driving
  */
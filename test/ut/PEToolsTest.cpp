@@ -185,6 +185,25 @@ TEST_F(PEToolsTest, heading_from_coordinates_test)
 }
 
 
+//Test distance and heading calc at once, same results like separate calls
+TEST_F(PEToolsTest, geodesic_from_coordinates_test)
+{
+   const double coordinates[][4] = {
+      { 52.0524,   10.0548 ,  52.0596  ,    10.0548  },
+      { 52.0524,   10.0620 ,  52.0524  ,    10.0548  },
+      { 52.045690, 10.002842 , 52.045596 , 10.002975 },
+      {-16.499917,-68.150214,-16.500336,-68.149849   },
+      { 50.0,      10.0,       50.0,       10.0      } };
+   for ( uint32_t i = 0; i < 5; ++i )
+   {
+      const double* c = coordinates[i];
+      PE::TOOLS::SGeodesic geodesic = PE::TOOLS::ToGeodesic(c[0], c[1], c[2], c[3]);
+      EXPECT_EQ(PE::TOOLS::ToDistance(c[0], c[1], c[2], c[3]), geodesic.Distance);
+      EXPECT_EQ(PE::TOOLS::ToHeading(c[0], c[1], c[2], c[3]), geodesic.Heading);
+   }
+}
+
+
 //Test heading calc based on original heading plus provided angle.
 TEST_F(PEToolsTest, heading_from_angle_test)
 {
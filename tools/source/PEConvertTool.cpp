@@ -0,0 +1,75 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Track conversion tool: converts text tracks into native track files by CTrackConverter.
+ *
+ * Usage:
+ *    pe_convert <threads> <chunkMB> <text track> <native track> [<text track> <native track> ...]
+ *
+ * Threads 0 means count of hardware threads. Size, time and throughput of each file are printed,
+ * throughput per thread is the conversion throughput divided by count of threads.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <thread>
+#include "PECTrackConverter.h"
+
+
+int main(int argc, char *argv[])
+{
+   if ( 5 > argc || 0 != ( argc - 3 ) % 2 )
+   {
+      printf("Usage: %s <threads> <chunkMB> <text track> <native track> [<text track> <native track> ...]\n", argv[0]);
+      return 1;
+   }
+   uint32_t threads = static_cast<uint32_t>(atoi(argv[1]));
+   const uint32_t chunkSize = static_cast<uint32_t>(atoi(argv[2])) << 20;
+   PE::CTrackConverter converter(threads, chunkSize);
+   if ( 0 == threads )
+   {
+      threads = std::thread::hardware_concurrency();
+      threads = ( 0 < threads ) ? threads : 1;
+   }
+
+   uint64_t totalSize = 0;
+   double totalSeconds = 0;
+   int result = 0;
+   for ( int i = 3; i + 1 < argc; i += 2 )
+   {
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      if ( false == converter.Convert(argv[i], argv[i + 1]) )
+      {
+         printf("%s: can not convert into %s\n", argv[i], argv[i + 1]);
+         result = 1;
+         continue;
+      }
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      double mb = converter.GetInputSize() / 1e6;
+      printf("%s: %.1f MB, %llu events, %u chunks, %.3f s, %.1f MB/s, %.1f MB/s per thread\n", argv[i], mb,
+             static_cast<unsigned long long>(converter.GetEventCount()), converter.GetChunkCount(), seconds,
+             mb / seconds, mb / seconds / threads);
+      totalSize += converter.GetInputSize();
+      totalSeconds += seconds;
+   }
+   if ( 0 < totalSeconds )
+   {
+      printf("total: %.1f MB, %.3f s, %.1f MB/s with %u threads, %.1f MB/s per thread\n", totalSize / 1e6, totalSeconds,
+             totalSize / 1e6 / totalSeconds, threads, totalSize / 1e6 / totalSeconds / threads);
+   }
+   return result;
+}
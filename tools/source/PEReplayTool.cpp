@@ -0,0 +1,267 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Replay tool: feeds recorded track through the C API of the position engine (see PECore.h).
+ *
+ * Usage:
+ *    pe_replay <track> [speed] [period] [laps]
+ *
+ * Track is a native track file or a text track. Speed 0 replays as fast as possible, otherwise the events are
+ * sent at speed times real time. Every period [s] of track time one fusion step is done: PECalculate()
+ * and PEReceivePosition(). Laps repeat the track behind itself like one long drive.
+ *
+ * Sending and fusion steps depend on track time only, so the checksum of all received positions is the same
+ * for each run and speed, it changes only if the engine gives other results. Samples and fusion steps per second
+ * and latency percentiles of each API call (including cost of reading the clock) are printed.
+ *
+ * Note: fusion of the engine is not implemented yet. PECalculate() does nothing and PEReceivePosition() returns
+ * true without writing its outputs, so the checksum is the same for every track and the fusion steps per second
+ * and latencies of both calls measure the cost of the API call only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "PECore.h"
+#include "PECTrack.h"
+#include "PECTrackFile.h"
+
+
+/**
+ * Measured API calls
+ */
+enum TCall
+{
+   CALL_COORDINATES = 0,
+   CALL_HEADING,
+   CALL_SPEED,
+   CALL_GYRO,
+   CALL_ODO,
+   CALL_CALCULATE,
+   CALL_RECEIVE,
+   CALL_COUNT
+};
+
+static const char* CALL_NAMES[CALL_COUNT] = { "PESendCoordinates", "PESendHeading", "PESendSpeed", "PESendGyro",
+                                              "PESendOdo", "PECalculate", "PEReceivePosition" };
+
+typedef std::chrono::steady_clock TClock;
+
+
+/**
+ * Adds bytes of the value to FNV-1a hash
+ */
+static void Hash(const double& value, uint64_t& hash)
+{
+   uint8_t bytes[sizeof(double)];
+   memcpy(bytes, &value, sizeof(bytes));
+   for ( size_t i = 0; i < sizeof(bytes); ++i )
+   {
+      hash = ( hash ^ bytes[i] ) * 1099511628211ull;
+   }
+}
+
+
+/**
+ * Loads native track file or text track
+ */
+static bool Load(const char* fileName, PE::CTrack& track)
+{
+   PE::CTrackFile file;
+   if ( file.Open(fileName) )
+   {
+      return file.ToTrack(track);
+   }
+   return track.LoadText(fileName);
+}
+
+
+/**
+ * Returns API call which sends event of the type, CALL_COUNT if the type is not sent
+ */
+static TCall GetCall(PE::TEventType type)
+{
+   switch ( type )
+   {
+      case PE::EVENT_POSITION:
+         return CALL_COORDINATES;
+      case PE::EVENT_HEADING:
+         return CALL_HEADING;
+      case PE::EVENT_SPEED:
+         return CALL_SPEED;
+      case PE::EVENT_GYRO:
+         return CALL_GYRO;
+      case PE::EVENT_ODO:
+         return CALL_ODO;
+      default:
+         return CALL_COUNT;
+   }
+}
+
+
+/**
+ * Returns percentile of sorted latencies in [ns]
+ */
+static uint32_t GetPercentile(const std::vector<uint32_t>& sorted, const double& percentile)
+{
+   const size_t index = static_cast<size_t>(percentile / 100.0 * ( sorted.size() - 1 ) + 0.5);
+   return sorted[index];
+}
+
+
+int main(int argc, char *argv[])
+{
+   if ( 2 > argc )
+   {
+      printf("Usage: %s <track> [speed] [period] [laps]\n", argv[0]);
+      return 1;
+   }
+   const double   speed  = ( 2 < argc ) ? atof(argv[2]) : 0.0;
+   const double   period = ( 3 < argc ) ? atof(argv[3]) : 0.1;
+   const uint32_t laps   = ( 4 < argc ) ? static_cast<uint32_t>(atoi(argv[4])) : 1;
+   PE::CTrack track;
+   if ( false == Load(argv[1], track) || 0 == track.GetSize() )
+   {
+      printf("Can not open track %s\n", argv[1]);
+      return 1;
+   }
+   if ( 0 > speed || 0 >= period || 0 == laps )
+   {
+      printf("Speed has to be not negative, period and laps positive\n");
+      return 1;
+   }
+
+   const double begin = track[0].Timestamp;
+   const double lapDuration = track[track.GetSize() - 1].Timestamp - begin + period;
+   //latencies are not reallocated during the replay
+   size_t counts[CALL_COUNT + 1] = { 0 };
+   for ( size_t i = 0; i < track.GetSize(); ++i )
+   {
+      counts[GetCall(track[i].Type)] += laps;
+   }
+   //fusion steps are done till the last event of the last lap
+   counts[CALL_CALCULATE] = static_cast<size_t>(laps * lapDuration / period) + 1;
+   counts[CALL_RECEIVE] = counts[CALL_CALCULATE];
+   std::vector<uint32_t> latencies[CALL_COUNT];
+   for ( uint32_t c = 0; c < CALL_COUNT; ++c )
+   {
+      latencies[c].reserve(counts[c]);
+   }
+
+   PECCore* core = PEStart("replay");
+   if ( NULL == core )
+   {
+      printf("Can not start position engine\n");
+      return 1;
+   }
+   uint64_t hash = 14695981039346656037ull;
+   uint64_t samples = 0;
+   uint64_t steps = 0;
+   double nextStep = begin + period;
+   const TClock::time_point start = TClock::now();
+   for ( uint32_t lap = 0; lap < laps; ++lap )
+   {
+      for ( size_t i = 0; i < track.GetSize(); ++i )
+      {
+         const PE::STrackEvent& event = track[i];
+         const double timestamp = event.Timestamp + lap * lapDuration;
+         while ( nextStep <= timestamp )
+         {
+            double values[9] = { 0 };
+            TClock::time_point before = TClock::now();
+            PECalculate(core);
+            TClock::time_point after = TClock::now();
+            latencies[CALL_CALCULATE].push_back(static_cast<uint32_t>(std::chrono::nanoseconds(after - before).count()));
+            before = after;
+            values[8] = PEReceivePosition(core, values[0], values[1], values[2], values[3], values[4], values[5],
+                                          values[6], values[7]) ? 1 : 0;
+            after = TClock::now();
+            latencies[CALL_RECEIVE].push_back(static_cast<uint32_t>(std::chrono::nanoseconds(after - before).count()));
+            for ( uint32_t v = 0; v < 9; ++v )
+            {
+               Hash(values[v], hash);
+            }
+            nextStep += period;
+            ++steps;
+         }
+         if ( 0 < speed )
+         {
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<TClock::duration>(
+                                             std::chrono::duration<double>(( timestamp - begin ) / speed)));
+         }
+
+         TCall call = CALL_COUNT;
+         const TClock::time_point before = TClock::now();
+         switch ( event.Type )
+         {
+            case PE::EVENT_POSITION:
+               PESendCoordinates(core, timestamp, event.Values[0], event.Values[1], event.Values[2]);
+               call = CALL_COORDINATES;
+               break;
+            case PE::EVENT_HEADING:
+               PESendHeading(core, timestamp, event.Values[0], event.Values[1]);
+               call = CALL_HEADING;
+               break;
+            case PE::EVENT_SPEED:
+               PESendSpeed(core, timestamp, event.Values[0], event.Values[1]);
+               call = CALL_SPEED;
+               break;
+            case PE::EVENT_GYRO:
+               PESendGyro(core, timestamp, event.Values[0]);
+               call = CALL_GYRO;
+               break;
+            case PE::EVENT_ODO:
+               PESendOdo(core, timestamp, event.Values[0]);
+               call = CALL_ODO;
+               break;
+            default:
+               break;
+         }
+         if ( CALL_COUNT != call )
+         {
+            latencies[call].push_back(static_cast<uint32_t>(std::chrono::nanoseconds(TClock::now() - before).count()));
+            ++samples;
+         }
+      }
+   }
+   const double seconds = std::chrono::duration<double>(TClock::now() - start).count();
+   PEStop(core);
+
+   const double driven = laps * lapDuration;
+   printf("track: %s, %zu events, %.1f s, %u laps, speed %s\n", argv[1], track.GetSize(), driven, laps,
+          ( 0 < speed ) ? argv[2] : "max");
+   printf("replay: %.3f s, %.1f x real time, %.0f samples/s, %.0f fusion steps/s (period %.3f s)\n", seconds,
+          driven / seconds, samples / seconds, steps / seconds, period);
+   printf("%-20s %10s %10s %10s %10s %10s %10s\n", "call [ns]", "count", "p50", "p90", "p99", "p99.9", "max");
+   for ( uint32_t c = 0; c < CALL_COUNT; ++c )
+   {
+      std::vector<uint32_t>& sorted = latencies[c];
+      if ( sorted.empty() )
+      {
+         continue;
+      }
+      std::sort(sorted.begin(), sorted.end());
+      printf("%-20s %10zu %10u %10u %10u %10u %10u\n", CALL_NAMES[c], sorted.size(), GetPercentile(sorted, 50),
+             GetPercentile(sorted, 90), GetPercentile(sorted, 99), GetPercentile(sorted, 99.9), sorted.back());
+   }
+   printf("checksum: %016llx (%llu samples, %llu fusion steps)\n", static_cast<unsigned long long>(hash),
+          static_cast<unsigned long long>(samples), static_cast<unsigned long long>(steps));
+   return 0;
+}
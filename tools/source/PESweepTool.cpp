@@ -0,0 +1,111 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+
+/**
+ * Parameter sweep tool: tunes CGyroscope/COdometerEx limits on recorded track.
+ *
+ * Usage:
+ *    pe_sweep <track> <odo|gyro> <refInterval> <senInterval> <senMax> [threads] [top] [convergence]
+ *
+ * Grid of configurations is built around given intervals:
+ *    interval scale, reference and sensor hysteresis ratios, reference accuracy ratio.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "PECTrack.h"
+#include "PECParameterSweep.h"
+
+
+static const double INTERVAL_SCALES[]     = { 0.9, 1.0, 1.1 };
+static const double REF_HYSTERESIS[]      = { 0.05, 0.1, 0.2, 0.4, 0.8 };
+static const double SEN_HYSTERESIS[]      = { 0.025, 0.05, 0.1, 0.2 };
+static const double REF_ACCURACY_RATIOS[] = { 1, 2, 3, 5, 10 };
+
+#define COUNT_OF(array) (sizeof(array) / sizeof(array[0]))
+
+
+int main(int argc, char *argv[])
+{
+   if ( 6 > argc )
+   {
+      printf("Usage: %s <track> <odo|gyro> <refInterval> <senInterval> <senMax> [threads] [top] [convergence]\n", argv[0]);
+      return 1;
+   }
+   PE::CParameterSweep::TSensorType type = ( 0 == strcmp(argv[2], "gyro") ) ? PE::CParameterSweep::SENSOR_GYROSCOPE
+                                                                             : PE::CParameterSweep::SENSOR_ODOMETER;
+   double   refInterval = atof(argv[3]);
+   double   senInterval = atof(argv[4]);
+   double   senMax      = atof(argv[5]);
+   uint32_t threads     = ( 6 < argc ) ? atoi(argv[6]) : 0;
+   uint32_t top         = ( 7 < argc ) ? atoi(argv[7]) : 10;
+   double   convergence = ( 8 < argc ) ? atof(argv[8]) : 50.0;
+
+   PE::CTrack track;
+   if ( false == track.LoadText(argv[1]) )
+   {
+      printf("Can not open track %s\n", argv[1]);
+      return 1;
+   }
+
+   PE::CParameterSweep sweep(track, type, convergence);
+   for ( uint32_t s = 0; s < COUNT_OF(INTERVAL_SCALES); ++s )
+   for ( uint32_t rh = 0; rh < COUNT_OF(REF_HYSTERESIS); ++rh )
+   for ( uint32_t sh = 0; sh < COUNT_OF(SEN_HYSTERESIS); ++sh )
+   for ( uint32_t ar = 0; ar < COUNT_OF(REF_ACCURACY_RATIOS); ++ar )
+   {
+      PE::CParameterSweep::SLimits limits;
+      limits.RefInterval      = refInterval * INTERVAL_SCALES[s];
+      limits.RefHysteresis    = limits.RefInterval * REF_HYSTERESIS[rh];
+      limits.RefMin           = 0.0;
+      limits.RefMax           = ( PE::CParameterSweep::SENSOR_GYROSCOPE == type ) ? 360.0 : 343.0;
+      limits.RefAccuracyRatio = REF_ACCURACY_RATIOS[ar];
+      limits.SenInterval      = senInterval * INTERVAL_SCALES[s];
+      limits.SenHysteresis    = limits.SenInterval * SEN_HYSTERESIS[sh];
+      limits.SenMin           = 0;
+      limits.SenMax           = senMax;
+      sweep.AddLimits(limits);
+   }
+
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   sweep.Run(threads);
+   double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+   printf("track: %s events: %u configurations: %u time: %.3f[s]\n",
+          argv[1], static_cast<uint32_t>(track.GetSize()), static_cast<uint32_t>(sweep.GetSize()), seconds);
+   printf("rank  index  convergence[s]  calibrated[%%]        base       scale  accepted  refInt  refHyst  refAccR  senInt  senHyst\n");
+   const std::vector<PE::CParameterSweep::SResult>& results = sweep.GetResults();
+   for ( uint32_t i = 0; i < results.size() && i < top; ++i )
+   {
+      const PE::CParameterSweep::SResult& result = results[i];
+      const PE::CParameterSweep::SLimits& limits = sweep.GetLimits(result.Index);
+      printf("%4u  %5u  %14.3f  %13.2f  %10.4f  %10.6f  %8u  %6.3f  %7.4f  %7.1f  %6.3f  %7.4f\n",
+             i + 1,
+             result.Index,
+             ( PE::MAX_TIMESTAMP == result.ConvergenceTime ) ? -1.0 : result.ConvergenceTime,
+             result.CalibratedTo,
+             result.Base,
+             result.Scale,
+             result.Accepted,
+             limits.RefInterval,
+             limits.RefHysteresis,
+             limits.RefAccuracyRatio,
+             limits.SenInterval,
+             limits.SenHysteresis);
+   }
+   return 0;
+}
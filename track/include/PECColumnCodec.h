@@ -0,0 +1,127 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CColumnCodec_H__
+#define __PE_CColumnCodec_H__
+
+#include "PETypes.h"
+
+class PECColumnCodecTest; //to get possibility for test class
+
+namespace PE
+{
+
+/**
+ * Compressed codec of integer track columns with small deltas, like timestamps in [ms] and odometer ticks.
+ *
+ * Format is little-endian:
+ *    count         varint count of values
+ *    blocks        one block per BLOCK_SIZE values, the last one can be shorter:
+ *                     width         uint8_t bits per packed delta, RAW_WIDTH if all deltas are stored as int64_t
+ *                     first         zig-zag varint delta of the first value to the last value of the previous block (to 0)
+ *                     reference     zig-zag varint minimal delta of the other values (frame of reference)
+ *                     packed        other deltas minus reference, bit-packed in LANES interleaved uint32_t lanes
+ * Packed delta i is in lane i % LANES at slot i / LANES, so one SIMD word unpacks LANES deltas at once.
+ * Regular columns (e.g. timestamps of a sensor with constant rate) have width 0 and take 3-5 bytes per block.
+ */
+class CColumnCodec
+{
+   friend class ::PECColumnCodecTest;
+
+public:
+   /**
+    * Count of values per block
+    */
+   static const uint32_t BLOCK_SIZE = 128;
+   /**
+    * Count of interleaved lanes of packed deltas
+    */
+   static const uint32_t LANES = 4;
+   /**
+    * Width of block with deltas stored unpacked
+    */
+   static const uint8_t RAW_WIDTH = 64;
+   /**
+    * Encodes column of integers
+    *
+    * @param  values   values of the column
+    * @param  count    count of values
+    * @param  data     encoded column, previous content is replaced
+    */
+   static void Encode(const int64_t* values, size_t count, std::vector<uint8_t>& data);
+   /**
+    * Decodes column of integers
+    * @return   false if data is damaged
+    *
+    * @param  data     encoded column
+    * @param  size     size of encoded column in bytes
+    * @param  values   decoded values, previous content is replaced
+    */
+   static bool Decode(const uint8_t* data, size_t size, std::vector<int64_t>& values);
+   /**
+    * Converts column of doubles into integers without loss, e.g. timestamps in [s] with scale 1000 into [ms]
+    * @return   false if a value is not integer after scaling
+    *
+    * @param  values     values of the column
+    * @param  count      count of values
+    * @param  scale      scale of values
+    * @param  integers   scaled values, previous content is replaced
+    */
+   static bool ToIntegers(const double* values, size_t count, const double& scale, std::vector<int64_t>& integers);
+   /**
+    * Converts column of integers back into doubles
+    *
+    * @param  integers   scaled values
+    * @param  scale      scale of values
+    * @param  values     values of the column, previous content is replaced
+    */
+   static void FromIntegers(const std::vector<int64_t>& integers, const double& scale, std::vector<double>& values);
+
+private:
+   /**
+    * Returns zig-zag code of value: small negative and positive values get small codes
+    */
+   static uint64_t ZigZag(int64_t value);
+   static int64_t UnZigZag(uint64_t code);
+   static void PutVarint(uint64_t value, std::vector<uint8_t>& data);
+   /**
+    * Reads varint
+    * @return   false if varint is not complete or too long
+    */
+   static bool GetVarint(const uint8_t*& pos, const uint8_t* end, uint64_t& value);
+   /**
+    * Returns count of packed uint32_t words of block with count values of width bits
+    */
+   static size_t GetWordCount(uint32_t count, uint32_t width);
+   /**
+    * Encodes one block of deltas
+    */
+   static void EncodeBlock(const uint64_t* deltas, uint32_t count, std::vector<uint8_t>& data);
+   /**
+    * Unpacks slots of lanes by the best available SIMD instructions
+    *
+    * @param  words    packed words, LANES per slot row
+    * @param  width    bits per value, at most 32
+    * @param  slots    count of slots per lane
+    * @param  values   unpacked values, LANES per slot
+    */
+   static void Unpack(const uint8_t* words, uint32_t width, uint32_t slots, uint32_t* values);
+   /**
+    * Unpacks slots of lanes value by value, reference of Unpack()
+    */
+   static void UnpackScalar(const uint8_t* words, uint32_t width, uint32_t slots, uint32_t* values);
+};
+
+} //namespace PE
+
+#endif //__PE_CColumnCodec_H__
@@ -0,0 +1,192 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CRecorder_H__
+#define __PE_CRecorder_H__
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "PETypes.h"
+#include "PESTrackEvent.h"
+
+class PECRecorderTest; //to get possibility for test class
+
+namespace PE
+{
+
+/**
+ * Asynchronous recorder of events into native track file (see CTrackFile).
+ *
+ * Record() copies event into lock-free ring of fixed capacity and returns, it never blocks, allocates or
+ * calls the system, so it could be called on the sample path by any count of threads. If the ring is full,
+ * the event is dropped and counted, like events which could not be written. Background writer wakes up
+ * every flush period, appends all events of the ring to journal file "<fileName>.part" and syncs
+ * the journal to disk every sync period.
+ * Count of events of native file is known at the end only, so Stop() converts the journal into native
+ * file and removes it. Journal left by a crash is converted by Finish().
+ */
+class CRecorder
+{
+   friend class ::PECRecorderTest;
+
+public:
+   /**
+    * Default count of events in the ring
+    */
+   static const uint32_t DEFAULT_CAPACITY = 1 << 16;
+   /**
+    * Default period of writing of the ring in [ms]
+    */
+   static const uint32_t DEFAULT_FLUSH_PERIOD = 10;
+   /**
+    * Default period of syncing of the journal in [ms]
+    */
+   static const uint32_t DEFAULT_SYNC_PERIOD = 1000;
+   /**
+    * Constructor
+    *
+    * @param  capacity      count of events in the ring, rounded up to power of two
+    * @param  flushPeriod   period of writing of the ring in [ms]
+    * @param  syncPeriod    period of syncing of the journal in [ms]
+    */
+   explicit CRecorder(uint32_t capacity = DEFAULT_CAPACITY, uint32_t flushPeriod = DEFAULT_FLUSH_PERIOD,
+                      uint32_t syncPeriod = DEFAULT_SYNC_PERIOD);
+   /**
+    * Destructor stops recording
+    */
+   ~CRecorder();
+   /**
+    * Creates journal and starts background writer, previous recording is stopped
+    * @return   true if journal is created
+    *
+    * @param  fileName   name of the native track file
+    */
+   bool Start(const std::string& fileName);
+   /**
+    * Writes all recorded events, stops background writer and converts journal into native track file
+    * @return   true if recording was started and native file is written
+    */
+   bool Stop();
+   /**
+    * Returns true if recording is started
+    */
+   bool IsStarted() const;
+   /**
+    * Adds event to the ring, lock-free
+    * @return   false if recording is not started or ring is full (event is dropped)
+    *
+    * @param  event   recorded event
+    */
+   bool Record(const STrackEvent& event);
+   /**
+    * Returns count of events added to the ring since start
+    */
+   uint64_t GetRecordCount() const;
+   /**
+    * Returns count of events dropped because of full ring or failed writing of journal since start
+    */
+   uint64_t GetDropCount() const;
+   /**
+    * Returns count of events written into journal since start
+    */
+   uint64_t GetWriteCount() const;
+   /**
+    * Returns count of syncs of the journal since start
+    */
+   uint64_t GetSyncCount() const;
+   /**
+    * Converts journal "<fileName>.part" into native track file and removes the journal,
+    * incomplete event at the end of the journal is ignored
+    * @return   true if native file is written
+    *
+    * @param  fileName   name of the native track file
+    */
+   static bool Finish(const std::string& fileName);
+
+private:
+   CRecorder(const CRecorder&);
+   CRecorder& operator=(const CRecorder&);
+
+   /**
+    * Event in the journal, little-endian
+    */
+   struct SRecord
+   {
+      double   Timestamp;
+      uint64_t Type;
+      double   Values[3];
+   };
+   /**
+    * Slot of the ring: sequence tells writer and reader whose turn it is
+    */
+   struct SSlot
+   {
+      std::atomic<uint64_t> Sequence;
+      SRecord Record;
+   };
+   /**
+    * Size of padding between members used by different threads
+    */
+   static const uint32_t CACHE_LINE = 64;
+
+   /**
+    * Returns name of the journal
+    */
+   static std::string GetJournalName(const std::string& fileName);
+   /**
+    * Background writer
+    */
+   void Writer();
+   /**
+    * Writes events of the ring into journal, at most capacity of the ring.
+    * Partly written event is cut from the journal, so the next events are written behind the last whole one.
+    * @return   count of events taken from the ring
+    */
+   size_t Flush(std::vector<SRecord>& batch);
+
+   std::vector<SSlot> m_Slots;
+   uint64_t m_Mask;
+   uint32_t m_FlushPeriod;
+   uint32_t m_SyncPeriod;
+   std::string m_FileName;
+   int m_Journal;
+
+   /**
+    * Written by producers only
+    */
+   char m_ProducerPad[CACHE_LINE];
+   std::atomic<uint64_t> m_Enqueue;
+   std::atomic<uint64_t> m_RecordCount;
+   std::atomic<uint64_t> m_DropCount;
+   std::atomic<bool> m_IsStarted;
+   /**
+    * Written by background writer only
+    */
+   char m_WriterPad[CACHE_LINE];
+   uint64_t m_Dequeue;
+   uint64_t m_JournalSize;
+   std::atomic<uint64_t> m_WriteCount;
+   std::atomic<uint64_t> m_SyncCount;
+   char m_EndPad[CACHE_LINE];
+
+   std::thread m_Thread;
+   std::mutex m_Mutex;
+   std::condition_variable m_Stopped;
+   bool m_IsStopping;
+};
+
+} //namespace PE
+
+#endif //__PE_CRecorder_H__
@@ -0,0 +1,102 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CTrack_H__
+#define __PE_CTrack_H__
+
+#include "PETypes.h"
+#include "PESTrackEvent.h"
+
+class PECTrackTest; //to get possibility for test class
+
+namespace PE
+{
+
+/**
+ * In memory track - time ordered list of recorded sensors inputs.
+ *
+ * Text track format is comma separated, one record per line, timestamp in milliseconds:
+ *    ts,ODO,seq,ticks[,...]              raw odometer ticks counter
+ *    ts,SPEED,seq,speed                  speed in [cm/s], followed by ACC with the same seq
+ *    ts,ACC,seq,accuracy                 speed accuracy in +/-[cm/s]
+ *    ts,GYRO,seq,raw                     raw gyroscope value
+ *    ts,HEADING,seq,heading,accuracy     heading and accuracy in [0.01 deg]
+ *    ts,POSITION,seq,lat,lon,accuracy    latitude and longitude in [1e-7 deg], accuracy in [cm]
+ * Unknown records are ignored.
+ */
+class CTrack
+{
+   friend class ::PECTrackTest;
+
+public:
+   /**
+    * Constructor
+    */
+   CTrack();
+   /**
+    * Loads text track file by CTrackReader, previous content is cleaned
+    * @return   true if file was read
+    *
+    * @param  fileName   name of the text track file
+    */
+   bool LoadText(const std::string& fileName);
+   /**
+    * Parses one line of text track
+    * @return   true if event was added
+    *
+    * @param  line   one line of the text track
+    */
+   bool AddLine(const std::string& line);
+   /**
+    * Adds new event at the end of the track
+    *
+    * @param  event   new event
+    */
+   void Add(const STrackEvent& event);
+   /**
+    * Removes all events
+    */
+   void Clean();
+   /**
+    * Returns count of events
+    */
+   size_t GetSize() const;
+   /**
+    * Returns event by index
+    *
+    * @param  index   index of the event, has to be less then GetSize()
+    */
+   const STrackEvent& operator[](size_t index) const;
+   /**
+    * Returns all events
+    */
+   const std::vector<STrackEvent>& GetEvents() const;
+
+private:
+   /**
+    * Events of the track
+    */
+   std::vector<STrackEvent> m_Events;
+   /**
+    * Speed record waiting for its accuracy
+    */
+   STrackEvent m_PendingSpeed;
+   /**
+    * Sequence number of the pending speed, -1 if nothing is pending
+    */
+   int32_t m_PendingSpeedSeq;
+};
+
+} //namespace PE
+
+#endif //__PE_CTrack_H__
@@ -0,0 +1,132 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CTrackConverter_H__
+#define __PE_CTrackConverter_H__
+
+#include <functional>
+#include "PETypes.h"
+#include "PESTrackEvent.h"
+
+class PECTrackConverterTest; //to get possibility for test class
+
+namespace PE
+{
+
+class CTrackFile;
+
+/**
+ * Parallel conversion of text track (format see CTrack) into native track file (see CTrackFile).
+ *
+ * Text file is memory mapped and split into chunks which are parsed independently: chunk starts
+ * at SPEED record, so SPEED and its ACC are never in different chunks. Chunks are parsed twice
+ * on CThreadPool: first pass counts events per type of each chunk, from counts follow rows of each
+ * chunk in columns and the size of native file. Second pass writes events of chunks directly into
+ * created native file in order of the text file, so neither text nor native track is kept in memory.
+ * Result is the same like CTrackFile::Store() of CTrack::LoadText().
+ */
+class CTrackConverter
+{
+   friend class ::PECTrackConverterTest;
+
+public:
+   /**
+    * Default size of one chunk in bytes
+    */
+   static const uint32_t DEFAULT_CHUNK_SIZE = 16 << 20;
+   /**
+    * Constructor
+    *
+    * @param  threadCount   count of threads, 0 - count of hardware threads, 1 - without thread pool
+    * @param  chunkSize     minimal size of one chunk in bytes
+    */
+   explicit CTrackConverter(uint32_t threadCount = 0, uint32_t chunkSize = DEFAULT_CHUNK_SIZE);
+   /**
+    * Converts text track file into native track file
+    * @return   true if text file was read and native file was written
+    *
+    * @param  textFileName     name of the text track file
+    * @param  nativeFileName   name of the native track file
+    */
+   bool Convert(const std::string& textFileName, const std::string& nativeFileName);
+   /**
+    * Returns size of the last converted text file in bytes
+    */
+   uint64_t GetInputSize() const;
+   /**
+    * Returns count of events of the last converted file
+    */
+   uint64_t GetEventCount() const;
+   /**
+    * Returns count of chunks of the last converted file
+    */
+   uint32_t GetChunkCount() const;
+
+private:
+   /**
+    * Part of text file parsed by one task
+    */
+   struct SChunk
+   {
+      const char* Begin;
+      const char* End;
+      /**
+       * Count of events per type in the chunk
+       */
+      size_t Counts[EVENT_COUNT];
+      /**
+       * Row of the first event of the chunk per type
+       */
+      size_t FirstRows[EVENT_COUNT];
+      /**
+       * Index of the first event of the chunk
+       */
+      size_t FirstIndex;
+   };
+
+   /**
+    * Splits text into chunks of at least chunkSize bytes which start at SPEED record
+    */
+   static std::vector<SChunk> Split(const char* begin, const char* end, uint32_t chunkSize);
+   /**
+    * Returns start of the first SPEED record at or after position, end if there is no one
+    */
+   static const char* FindChunkStart(const char* pos, const char* end);
+   /**
+    * Returns next line of text without line end
+    * @return   false at the end of the text
+    */
+   static bool NextLine(const char*& pos, const char* end, const char*& lineBegin, const char*& lineEnd);
+   /**
+    * Counts events of the chunk per type
+    */
+   static void Count(SChunk& chunk);
+   /**
+    * Writes events of the chunk into native file
+    */
+   static void Write(const SChunk& chunk, CTrackFile& file);
+   /**
+    * Runs task for all chunks, in parallel if more than one thread is requested
+    */
+   void ForEachChunk(std::vector<SChunk>& chunks, const std::function<void(SChunk&)>& task) const;
+
+   uint32_t m_ThreadCount;
+   uint32_t m_ChunkSize;
+   uint64_t m_InputSize;
+   uint64_t m_EventCount;
+   uint32_t m_ChunkCount;
+};
+
+} //namespace PE
+
+#endif //__PE_CTrackConverter_H__
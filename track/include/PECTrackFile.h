@@ -0,0 +1,305 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CTrackFile_H__
+#define __PE_CTrackFile_H__
+
+#include "PETypes.h"
+#include "PESTrackEvent.h"
+
+class PECTrackFileTest; //to get possibility for test class
+
+namespace PE
+{
+
+class CTrack;
+
+/**
+ * Native binary track file, read zero-copy from memory mapped file.
+ *
+ * Format is little-endian, all offsets are in bytes from begin of the file and aligned to 8 bytes:
+ *    header        magic "PETRACK", version, count of blocks, count of events, offsets of order and index, size of the file,
+ *                  offset of seek index and count of events per seek entry
+ *    order         uint8_t[count of events] type of each event in order of the track, padded to 8 bytes
+ *    blocks        one column block per event type, the events of the type in order of the track:
+ *                     timestamps    double[count] in seconds
+ *                     values        double[count] per value of the type (see TEventType)
+ *                     validity      uint64_t[(count + 63) / 64] bitmap per value, bit set if value is known
+ *    seek index    one entry per SEEK_INTERVAL events: index of the event, row of the next event of each type
+ *                  and maximal timestamp of events till the entry, see Seek()
+ *    index         footer with one entry per block: type, count of values, count of events and offsets of columns
+ * Unknown values (NaN) are stored as 0 with cleared validity bit.
+ *
+ * Opening maps the file and checks header and index only, columns are used directly from the mapping,
+ * so pages of the file are read first time they are touched. Created file is mapped writable,
+ * its columns are filled directly in the mapping and the seek index is built on Close().
+ */
+class CTrackFile
+{
+   friend class ::PECTrackFileTest;
+
+public:
+   /**
+    * Version of the format, files of other versions are not opened
+    */
+   static const uint32_t VERSION = 2;
+   /**
+    * Maximal count of values of one event
+    */
+   static const uint32_t MAX_VALUES = 3;
+   /**
+    * Count of events per entry of the seek index of created files
+    */
+   static const uint32_t SEEK_INTERVAL = 256;
+   /**
+    * Position in the track: index of the next event and row of the next event of each type
+    */
+   struct SCursor
+   {
+      /**
+       * Constructor, cursor is at the first event
+       */
+      SCursor();
+
+      size_t Index;
+      size_t Rows[EVENT_COUNT];
+   };
+   /**
+    * Stores track into native file
+    * @return   true if file was written
+    *
+    * @param  fileName   name of the native track file
+    * @param  track      track to store
+    */
+   static bool Store(const std::string& fileName, const CTrack& track);
+   /**
+    * Returns count of values of event type
+    *
+    * @param  type   type of the event
+    */
+   static uint32_t GetValueCount(TEventType type);
+   /**
+    * Constructor
+    */
+   CTrackFile();
+   /**
+    * Destructor unmaps the file
+    */
+   ~CTrackFile();
+   /**
+    * Maps native track file, previous file is closed
+    * @return   true if file is mapped and its header and index are correct
+    *
+    * @param  fileName   name of the native track file
+    */
+   bool Open(const std::string& fileName);
+   /**
+    * Creates native track file and maps it writable, previous file is closed.
+    * Header and index are written, order and columns are zero till events are set.
+    * @return   true if file is created and mapped
+    *
+    * @param  fileName   name of the native track file
+    * @param  counts     count of events per type, types without values have to be 0
+    */
+   bool Create(const std::string& fileName, const size_t counts[EVENT_COUNT]);
+   /**
+    * Sets event of created file, events of different rows could be set in parallel
+    *
+    * @param  index   index of the event in order of the track, less then GetSize()
+    * @param  row     index of the event in columns of its type, less then GetCount(event.Type)
+    * @param  event   event, unknown values (NaN) are not set
+    */
+   void SetEvent(size_t index, size_t row, const STrackEvent& event);
+   /**
+    * Returns writable columns of created file, NULL if file is not created or there is no such column
+    */
+   uint8_t* EditOrder();
+   double* EditTimestamps(TEventType type);
+   double* EditValues(TEventType type, uint32_t index);
+   uint64_t* EditValidity(TEventType type, uint32_t index);
+   /**
+    * Unmaps the file, seek index of created file is built from its events and written content stays in the file
+    */
+   void Close();
+   /**
+    * Returns true if file is mapped
+    */
+   bool IsOpen() const;
+   /**
+    * Returns count of all events, 0 if file is not open
+    */
+   size_t GetSize() const;
+   /**
+    * Returns type of each event in order of the track, NULL if there is no event
+    */
+   const uint8_t* GetOrder() const;
+   /**
+    * Returns count of events of type, 0 if file is not open
+    *
+    * @param  type   type of the event
+    */
+   size_t GetCount(TEventType type) const;
+   /**
+    * Returns timestamps column of type in seconds, NULL if there is no event of the type
+    *
+    * @param  type   type of the event
+    */
+   const double* GetTimestamps(TEventType type) const;
+   /**
+    * Returns values column of type, NULL if there is no event of the type or no such value
+    *
+    * @param  type    type of the event
+    * @param  index   index of the value, less then GetValueCount(type)
+    */
+   const double* GetValues(TEventType type, uint32_t index) const;
+   /**
+    * Returns validity bitmap of values column, NULL if there is no event of the type or no such value
+    *
+    * @param  type    type of the event
+    * @param  index   index of the value, less then GetValueCount(type)
+    */
+   const uint64_t* GetValidity(TEventType type, uint32_t index) const;
+   /**
+    * Returns true if value of event is known
+    *
+    * @param  type    type of the event
+    * @param  index   index of the value, less then GetValueCount(type)
+    * @param  event   index of the event, less then GetCount(type)
+    */
+   bool IsValid(TEventType type, uint32_t index, size_t event) const;
+   /**
+    * Copies all events into track in order of the stored track, previous content is cleaned
+    * @return   true if file is open and order matches columns
+    *
+    * @param  track   target track
+    */
+   bool ToTrack(CTrack& track) const;
+   /**
+    * Moves cursor by the seek index to the first event from which the track is replayed without losing
+    * any event at or after timestamp: all events before the cursor are older than timestamp.
+    * Events are not sorted by time, so some events after the cursor could be older too.
+    * Only events of one seek interval are read, independent of the length of the track.
+    * @return   true if file is open and seek index matches columns, cursor is at GetSize() if all events are older
+    *
+    * @param  timestamp   timestamp in seconds
+    * @param  cursor      found position
+    */
+   bool Seek(const double& timestamp, SCursor& cursor) const;
+   /**
+    * Returns event at cursor and moves cursor to the next event
+    * @return   false at the end of the track or if order does not match columns
+    *
+    * @param  cursor   position in the track
+    * @param  event    event at the position
+    */
+   bool Next(SCursor& cursor, STrackEvent& event) const;
+
+private:
+   CTrackFile(const CTrackFile&);
+   CTrackFile& operator=(const CTrackFile&);
+
+   /**
+    * Magic at begin of the file
+    */
+   static const char MAGIC[8];
+   /**
+    * Header at begin of the file
+    */
+   struct SHeader
+   {
+      char     Magic[8];
+      uint32_t Version;
+      uint32_t BlockCount;
+      uint64_t EventCount;
+      uint64_t OrderOffset;
+      uint64_t IndexOffset;
+      uint64_t FileSize;
+      uint64_t SeekOffset;
+      uint64_t SeekInterval;
+   };
+   /**
+    * Index entry of one column block
+    */
+   struct SBlock
+   {
+      uint32_t Type;
+      uint32_t ValueCount;
+      uint64_t Count;
+      uint64_t TimestampsOffset;
+      uint64_t ValuesOffset[MAX_VALUES];
+      uint64_t ValidityOffset[MAX_VALUES];
+   };
+   /**
+    * Entry of the seek index
+    */
+   struct SSeekEntry
+   {
+      /**
+       * Maximal timestamp of events from the first one till the event at cursor including it
+       */
+      double   Timestamp;
+      uint64_t Index;
+      uint64_t Rows[EVENT_COUNT];
+   };
+
+   /**
+    * Returns true if host stores numbers little-endian like the file
+    */
+   static bool IsLittleEndian();
+   /**
+    * Returns size of validity bitmap in bytes for count of events
+    */
+   static uint64_t GetValiditySize(uint64_t count);
+   /**
+    * Returns size of order column in bytes for count of events
+    */
+   static uint64_t GetOrderSize(uint64_t count);
+   /**
+    * Returns count of seek entries for count of events
+    */
+   static uint64_t GetSeekCount(uint64_t count, uint64_t interval);
+   /**
+    * Writes seek index of created file from its order and timestamps
+    */
+   void WriteSeekIndex();
+   /**
+    * Returns seek index, NULL if there is no event
+    */
+   const SSeekEntry* GetSeekIndex() const;
+   /**
+    * Checks header and index of the mapped file and sets columns
+    */
+   bool ReadIndex();
+   /**
+    * Returns true if column of size bytes at offset is aligned and between header and index
+    */
+   bool IsColumn(uint64_t offset, uint64_t size) const;
+
+   /**
+    * Mapped file, NULL if file is not open
+    */
+   uint8_t* m_Data;
+   size_t m_Size;
+   /**
+    * True if file is created and mapped writable
+    */
+   bool m_IsWritable;
+   /**
+    * Index entries by event type, NULL if there is no event of the type
+    */
+   const SBlock* m_Blocks[EVENT_COUNT];
+};
+
+} //namespace PE
+
+#endif //__PE_CTrackFile_H__
@@ -0,0 +1,238 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CTrackReader_H__
+#define __PE_CTrackReader_H__
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "PETypes.h"
+#include "PESTrackEvent.h"
+
+class PECTrackReaderTest; //to get possibility for test class
+
+namespace PE
+{
+
+/**
+ * Streaming reader of text track (format see CTrack), events are returned one by one.
+ *
+ * File is read by background thread in chunks into two buffers: one is filled while records
+ * of the other are parsed. Records are parsed in place without allocation, numbers without
+ * fraction and exponent by own parser, others by strtod() like CTrack::AddLine().
+ * Lines longer than MAX_LINE_LENGTH are cut. Buffers are allocated by Open(), so reader
+ * without file is a cheap parser of records.
+ */
+class CTrackReader
+{
+   friend class ::PECTrackReaderTest;
+
+public:
+   /**
+    * Default size of one chunk in bytes
+    */
+   static const uint32_t DEFAULT_CHUNK_SIZE = 1 << 20;
+   /**
+    * Maximal length of one record which is not in one chunk
+    */
+   static const uint32_t MAX_LINE_LENGTH = 256;
+   /**
+    * Constructor
+    *
+    * @param  chunkSize   size of one read in bytes
+    */
+   explicit CTrackReader(uint32_t chunkSize = DEFAULT_CHUNK_SIZE);
+   /**
+    * Destructor stops reading thread
+    */
+   ~CTrackReader();
+   /**
+    * Opens text track file and starts reading, previous file is closed
+    * @return   true if file is open
+    *
+    * @param  fileName   name of the text track file
+    */
+   bool Open(const std::string& fileName);
+   /**
+    * Starts reading of the open file from the beginning again, reading thread and buffers are kept
+    * @return   true if file is open
+    */
+   bool Rewind();
+   /**
+    * Stops reading and closes the file
+    */
+   void Close();
+   /**
+    * Returns true if file is open
+    */
+   bool IsOpen() const;
+   /**
+    * Reads next event
+    * @return   false at the end of the file or if reading failed, see GetError()
+    *
+    * @param  event   next event
+    */
+   bool Next(STrackEvent& event);
+   /**
+    * Parses one record, SPEED is kept till ACC with the same sequence number
+    * @return   true if event is complete
+    *
+    * @param  begin   first character of the record
+    * @param  end     character after the record
+    * @param  event   parsed event
+    */
+   bool Parse(const char* begin, const char* end, STrackEvent& event);
+   /**
+    * Returns count of records (lines) read since opening
+    */
+   uint64_t GetRecordCount() const;
+   /**
+    * Returns count of events returned since opening
+    */
+   uint64_t GetEventCount() const;
+   /**
+    * Returns count of bytes read since opening
+    */
+   uint64_t GetByteCount() const;
+   /**
+    * Returns error of reading of the file
+    * @return   errno of failed read, 0 if all read chunks are complete
+    */
+   int GetError() const;
+
+private:
+   CTrackReader(const CTrackReader&);
+   CTrackReader& operator=(const CTrackReader&);
+
+   /**
+    * Maximal count of fields of known records
+    */
+   static const uint32_t MAX_FIELDS = 6;
+   /**
+    * One chunk of the file
+    */
+   struct SBuffer
+   {
+      std::vector<char> Data;
+      /**
+       * Count of read bytes
+       */
+      size_t Size;
+      /**
+       * True if buffer is filled and not parsed yet
+       */
+      bool IsFull;
+      /**
+       * True if it is the last chunk of the file
+       */
+      bool IsLast;
+      /**
+       * errno of failed read, the chunk is the last one. 0 if there was no error
+       */
+      int Error;
+   };
+
+   /**
+    * Main loop of reading thread
+    */
+   void Reader();
+   /**
+    * Reads one chunk into the buffer, reading is repeated if it was interrupted
+    * @return   errno of failed read, 0 if there was no error
+    */
+   int ReadChunk(SBuffer& buffer);
+   /**
+    * Releases parsed buffer and waits for the next one
+    */
+   void FetchChunk();
+   /**
+    * Returns next line without line end
+    * @return   false at the end of the file
+    */
+   bool ReadLine(const char*& begin, const char*& end);
+   /**
+    * Appends part of line to the line buffer, rest of the long line is lost
+    */
+   void AppendLine(const char* begin, const char* end);
+   /**
+    * Parses decimal number like atof()
+    */
+   static double ToNumber(const char* begin, const char* end);
+   /**
+    * Returns true if field is equal to name
+    */
+   static bool IsField(const char* begin, const char* end, const char* name);
+
+   uint32_t m_ChunkSize;
+   /**
+    * File descriptor, -1 if file is not open
+    */
+   int m_File;
+   std::thread m_Thread;
+   /**
+    * Protects state of buffers and stop flag
+    */
+   std::mutex m_Mutex;
+   /**
+    * Signals filled or released buffer and stop
+    */
+   std::condition_variable m_Changed;
+   SBuffer m_Buffers[2];
+   bool m_IsStopped;
+   /**
+    * True till reading thread moves to the beginning of the file and releases both buffers
+    */
+   bool m_IsRewinding;
+   /**
+    * Index of the buffer in parsing
+    */
+   uint32_t m_Current;
+   /**
+    * True if current buffer is taken from reading thread
+    */
+   bool m_IsHeld;
+   /**
+    * True if current buffer is the last one
+    */
+   bool m_IsEnd;
+   /**
+    * Not parsed part of current buffer
+    */
+   const char* m_Pos;
+   const char* m_End;
+   /**
+    * Record which is split between two chunks
+    */
+   char m_Line[MAX_LINE_LENGTH];
+   uint32_t m_LineLength;
+   /**
+    * Speed record waiting for its accuracy
+    */
+   STrackEvent m_PendingSpeed;
+   /**
+    * Sequence number of the pending speed, -1 if nothing is pending
+    */
+   int32_t m_PendingSpeedSeq;
+   uint64_t m_RecordCount;
+   uint64_t m_EventCount;
+   uint64_t m_ByteCount;
+   /**
+    * errno of failed read of the parsed chunks
+    */
+   int m_Error;
+};
+
+} //namespace PE
+
+#endif //__PE_CTrackReader_H__
@@ -0,0 +1,76 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_STrackEvent_H__
+#define __PE_STrackEvent_H__
+
+#include "PETypes.h"
+
+namespace PE
+{
+   /**
+    * Types of the track events, one per sensors input of the position engine
+    */
+   enum TEventType
+   {
+      EVENT_UNKNOWN  = 0,
+      EVENT_POSITION = 1,   ///< Values: latitude [deg], longitude [deg], accuracy [m]
+      EVENT_HEADING  = 2,   ///< Values: heading [deg], accuracy [deg]
+      EVENT_SPEED    = 3,   ///< Values: speed [m/s], accuracy [m/s]
+      EVENT_GYRO     = 4,   ///< Values: raw gyroscope value
+      EVENT_ODO      = 5,   ///< Values: raw odometer ticks counter
+      EVENT_COUNT    = 6
+   };
+
+   /**
+    * One recorded sensors input of the track
+    *
+    */
+   struct STrackEvent
+   {
+      /**
+       * Constructor
+       */
+      STrackEvent()
+         : Timestamp(0)
+         , Type(EVENT_UNKNOWN)
+      {
+         Values[0] = Values[1] = Values[2] = 0;
+      }
+      /**
+       * Constructor
+       */
+      STrackEvent(const double& timestamp, TEventType type, const double& value0, const double& value1 = 0, const double& value2 = 0)
+         : Timestamp(timestamp)
+         , Type(type)
+      {
+         Values[0] = value0;
+         Values[1] = value1;
+         Values[2] = value2;
+      }
+      /**
+       * Timestamp of the event in seconds
+       */
+      double Timestamp;
+      /**
+       * Type of the event
+       */
+      TEventType Type;
+      /**
+       * Values of the event, meaning depends on the type
+       */
+      double Values[3];
+   };
+
+} //namespace PE
+#endif //__PE_STrackEvent_H__
@@ -0,0 +1,310 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <math.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "PECColumnCodec.h"
+
+
+using namespace PE;
+
+
+const uint32_t PE::CColumnCodec::BLOCK_SIZE;
+const uint32_t PE::CColumnCodec::LANES;
+const uint8_t PE::CColumnCodec::RAW_WIDTH;
+
+
+void PE::CColumnCodec::Encode(const int64_t* values, size_t count, std::vector<uint8_t>& data)
+{
+   data.clear();
+   PutVarint(count, data);
+   uint64_t deltas[BLOCK_SIZE];
+   uint64_t previous = 0;
+   for ( size_t first = 0; first < count; first += BLOCK_SIZE )
+   {
+      const uint32_t blockCount = static_cast<uint32_t>(( count - first < BLOCK_SIZE ) ? count - first : BLOCK_SIZE);
+      for ( uint32_t i = 0; i < blockCount; ++i )
+      {
+         //unsigned arithmetic wraps, so any pair of values has a delta
+         const uint64_t value = static_cast<uint64_t>(values[first + i]);
+         deltas[i] = value - previous;
+         previous = value;
+      }
+      EncodeBlock(deltas, blockCount, data);
+   }
+}
+
+
+bool PE::CColumnCodec::Decode(const uint8_t* data, size_t size, std::vector<int64_t>& values)
+{
+   values.clear();
+   const uint8_t* pos = data;
+   const uint8_t* end = data + size;
+   uint64_t count = 0;
+   //each block has at least its width, so damaged count can not allocate more than the data allows
+   if ( false == GetVarint(pos, end, count) || count / BLOCK_SIZE > static_cast<uint64_t>(end - pos) )
+   {
+      return false;
+   }
+   values.resize(count);
+
+   uint32_t packed[BLOCK_SIZE];
+   uint64_t previous = 0;
+   for ( size_t first = 0; first < count; first += BLOCK_SIZE )
+   {
+      const uint32_t blockCount = static_cast<uint32_t>(( count - first < BLOCK_SIZE ) ? count - first : BLOCK_SIZE);
+      int64_t* block = &values[first];
+      if ( pos == end )
+      {
+         values.clear();
+         return false;
+      }
+      const uint8_t width = *pos++;
+      if ( RAW_WIDTH == width )
+      {
+         if ( static_cast<size_t>(end - pos) < blockCount * sizeof(uint64_t) )
+         {
+            values.clear();
+            return false;
+         }
+         for ( uint32_t i = 0; i < blockCount; ++i )
+         {
+            uint64_t delta;
+            memcpy(&delta, pos + i * sizeof(uint64_t), sizeof(delta));
+            previous += delta;
+            block[i] = static_cast<int64_t>(previous);
+         }
+         pos += blockCount * sizeof(uint64_t);
+         continue;
+      }
+
+      uint64_t firstDelta = 0;
+      uint64_t reference = 0;
+      const size_t words = GetWordCount(blockCount - 1, width);
+      if ( 32 < width || false == GetVarint(pos, end, firstDelta) || false == GetVarint(pos, end, reference) ||
+           static_cast<size_t>(end - pos) / sizeof(uint32_t) < words )
+      {
+         values.clear();
+         return false;
+      }
+      Unpack(pos, width, ( blockCount - 1 + LANES - 1 ) / LANES, packed);
+      pos += words * sizeof(uint32_t);
+      previous += static_cast<uint64_t>(UnZigZag(firstDelta));
+      block[0] = static_cast<int64_t>(previous);
+      const uint64_t minDelta = static_cast<uint64_t>(UnZigZag(reference));
+      for ( uint32_t i = 1; i < blockCount; ++i )
+      {
+         previous += minDelta + packed[i - 1];
+         block[i] = static_cast<int64_t>(previous);
+      }
+   }
+   if ( pos != end )
+   {
+      values.clear();
+      return false;
+   }
+   return true;
+}
+
+
+bool PE::CColumnCodec::ToIntegers(const double* values, size_t count, const double& scale, std::vector<int64_t>& integers)
+{
+   integers.resize(count);
+   for ( size_t i = 0; i < count; ++i )
+   {
+      const double scaled = values[i] * scale;
+      //also false for NaN
+      if ( false == ( fabs(scaled) < 9.0e18 ) )
+      {
+         return false;
+      }
+      integers[i] = llround(scaled);
+      if ( static_cast<double>(integers[i]) / scale != values[i] )
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+
+void PE::CColumnCodec::FromIntegers(const std::vector<int64_t>& integers, const double& scale, std::vector<double>& values)
+{
+   values.resize(integers.size());
+   for ( size_t i = 0; i < integers.size(); ++i )
+   {
+      values[i] = static_cast<double>(integers[i]) / scale;
+   }
+}
+
+
+uint64_t PE::CColumnCodec::ZigZag(int64_t value)
+{
+   return ( static_cast<uint64_t>(value) << 1 ) ^ static_cast<uint64_t>(value >> 63);
+}
+
+
+int64_t PE::CColumnCodec::UnZigZag(uint64_t code)
+{
+   return static_cast<int64_t>(( code >> 1 ) ^ ( 0 - ( code & 1 ) ));
+}
+
+
+void PE::CColumnCodec::PutVarint(uint64_t value, std::vector<uint8_t>& data)
+{
+   while ( 0x80 <= value )
+   {
+      data.push_back(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+   }
+   data.push_back(static_cast<uint8_t>(value));
+}
+
+
+bool PE::CColumnCodec::GetVarint(const uint8_t*& pos, const uint8_t* end, uint64_t& value)
+{
+   value = 0;
+   for ( uint32_t shift = 0; shift < 64 && pos < end; shift += 7 )
+   {
+      const uint8_t byte = *pos++;
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ( 0 == ( byte & 0x80 ) )
+      {
+         return true;
+      }
+   }
+   return false;
+}
+
+
+size_t PE::CColumnCodec::GetWordCount(uint32_t count, uint32_t width)
+{
+   const size_t slots = ( count + LANES - 1 ) / LANES;
+   return LANES * ( ( slots * width + 31 ) / 32 );
+}
+
+
+void PE::CColumnCodec::EncodeBlock(const uint64_t* deltas, uint32_t count, std::vector<uint8_t>& data)
+{
+   //the first delta is a jump to the previous block (or the start value), it is kept out of the frame
+   int64_t minDelta = ( 1 < count ) ? static_cast<int64_t>(deltas[1]) : 0;
+   for ( uint32_t i = 2; i < count; ++i )
+   {
+      minDelta = ( static_cast<int64_t>(deltas[i]) < minDelta ) ? static_cast<int64_t>(deltas[i]) : minDelta;
+   }
+   uint64_t maxOffset = 0;
+   for ( uint32_t i = 1; i < count; ++i )
+   {
+      const uint64_t offset = deltas[i] - static_cast<uint64_t>(minDelta);
+      maxOffset = ( offset > maxOffset ) ? offset : maxOffset;
+   }
+   uint32_t width = 0;
+   while ( 64 > width && 0 != ( maxOffset >> width ) )
+   {
+      ++width;
+   }
+
+   if ( 32 < width )
+   {
+      data.push_back(RAW_WIDTH);
+      const size_t size = data.size();
+      data.resize(size + count * sizeof(uint64_t));
+      memcpy(&data[size], deltas, count * sizeof(uint64_t));
+      return;
+   }
+
+   data.push_back(static_cast<uint8_t>(width));
+   PutVarint(ZigZag(static_cast<int64_t>(deltas[0])), data);
+   PutVarint(ZigZag(minDelta), data);
+   std::vector<uint32_t> words(GetWordCount(count - 1, width), 0);
+   for ( uint32_t i = 0; 0 < width && i < count - 1; ++i )
+   {
+      const uint64_t offset = deltas[i + 1] - static_cast<uint64_t>(minDelta);
+      const uint32_t bit = ( i / LANES ) * width;
+      const uint32_t word = ( bit / 32 ) * LANES + i % LANES;
+      const uint32_t shift = bit % 32;
+      words[word] |= static_cast<uint32_t>(offset << shift);
+      if ( 32 < shift + width )
+      {
+         words[word + LANES] |= static_cast<uint32_t>(offset >> ( 32 - shift ));
+      }
+   }
+   const size_t size = data.size();
+   data.resize(size + words.size() * sizeof(uint32_t));
+   if ( false == words.empty() )
+   {
+      memcpy(&data[size], words.data(), words.size() * sizeof(uint32_t));
+   }
+}
+
+
+void PE::CColumnCodec::Unpack(const uint8_t* words, uint32_t width, uint32_t slots, uint32_t* values)
+{
+#ifdef __SSE2__
+   if ( 0 == width )
+   {
+      memset(values, 0, slots * LANES * sizeof(uint32_t));
+      return;
+   }
+   //all lanes of one slot have the same bit position, so one shift and mask serves LANES values
+   const __m128i mask = _mm_set1_epi32(static_cast<int32_t>(0xFFFFFFFFu >> ( 32 - width )));
+   for ( uint32_t slot = 0; slot < slots; ++slot )
+   {
+      const uint32_t bit = slot * width;
+      const uint32_t shift = bit % 32;
+      const uint8_t* word = words + ( bit / 32 ) * LANES * sizeof(uint32_t);
+      __m128i value = _mm_srl_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(word)), _mm_cvtsi32_si128(shift));
+      if ( 32 < shift + width )
+      {
+         const __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(word + LANES * sizeof(uint32_t)));
+         value = _mm_or_si128(value, _mm_sll_epi32(next, _mm_cvtsi32_si128(32 - shift)));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(values + slot * LANES), _mm_and_si128(value, mask));
+   }
+#else
+   UnpackScalar(words, width, slots, values);
+#endif
+}
+
+
+void PE::CColumnCodec::UnpackScalar(const uint8_t* words, uint32_t width, uint32_t slots, uint32_t* values)
+{
+   const uint32_t mask = ( 0 == width ) ? 0 : 0xFFFFFFFFu >> ( 32 - width );
+   for ( uint32_t slot = 0; slot < slots; ++slot )
+   {
+      const uint32_t bit = slot * width;
+      const uint32_t shift = bit % 32;
+      for ( uint32_t lane = 0; lane < LANES; ++lane )
+      {
+         uint32_t value = 0;
+         if ( 0 != width )
+         {
+            const uint8_t* word = words + ( ( bit / 32 ) * LANES + lane ) * sizeof(uint32_t);
+            uint32_t low;
+            memcpy(&low, word, sizeof(low));
+            value = low >> shift;
+            if ( 32 < shift + width )
+            {
+               uint32_t high;
+               memcpy(&high, word + LANES * sizeof(uint32_t), sizeof(high));
+               value |= high << ( 32 - shift );
+            }
+         }
+         values[slot * LANES + lane] = value & mask;
+      }
+   }
+}
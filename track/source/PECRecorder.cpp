@@ -0,0 +1,327 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <chrono>
+#include "PECRecorder.h"
+#include "PECTrackFile.h"
+
+
+using namespace PE;
+
+
+const uint32_t PE::CRecorder::DEFAULT_CAPACITY;
+const uint32_t PE::CRecorder::DEFAULT_FLUSH_PERIOD;
+const uint32_t PE::CRecorder::DEFAULT_SYNC_PERIOD;
+const uint32_t PE::CRecorder::CACHE_LINE;
+
+
+PE::CRecorder::CRecorder(uint32_t capacity, uint32_t flushPeriod, uint32_t syncPeriod)
+: m_Mask(0)
+, m_FlushPeriod(flushPeriod)
+, m_SyncPeriod(syncPeriod)
+, m_Journal(-1)
+, m_Enqueue(0)
+, m_RecordCount(0)
+, m_DropCount(0)
+, m_IsStarted(false)
+, m_Dequeue(0)
+, m_JournalSize(0)
+, m_WriteCount(0)
+, m_SyncCount(0)
+, m_IsStopping(false)
+{
+   uint64_t size = 1;
+   while ( size < capacity )
+   {
+      size <<= 1;
+   }
+   //slots are not movable, so they are created in place
+   std::vector<SSlot>(size).swap(m_Slots);
+   m_Mask = size - 1;
+}
+
+
+PE::CRecorder::~CRecorder()
+{
+   Stop();
+}
+
+
+bool PE::CRecorder::Start(const std::string& fileName)
+{
+   Stop();
+   m_Journal = open(GetJournalName(fileName).c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+   if ( 0 > m_Journal )
+   {
+      return false;
+   }
+   m_FileName = fileName;
+   for ( uint64_t i = 0; i < m_Slots.size(); ++i )
+   {
+      m_Slots[i].Sequence.store(i, std::memory_order_relaxed);
+   }
+   m_Enqueue.store(0, std::memory_order_relaxed);
+   m_Dequeue = 0;
+   m_JournalSize = 0;
+   m_RecordCount.store(0, std::memory_order_relaxed);
+   m_DropCount.store(0, std::memory_order_relaxed);
+   m_WriteCount.store(0, std::memory_order_relaxed);
+   m_SyncCount.store(0, std::memory_order_relaxed);
+   m_IsStopping = false;
+   m_Thread = std::thread(&CRecorder::Writer, this);
+   m_IsStarted.store(true, std::memory_order_release);
+   return true;
+}
+
+
+bool PE::CRecorder::Stop()
+{
+   if ( false == m_IsStarted.load(std::memory_order_acquire) )
+   {
+      return false;
+   }
+   //events recorded in parallel to stopping could be not written
+   m_IsStarted.store(false, std::memory_order_release);
+   {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_IsStopping = true;
+   }
+   m_Stopped.notify_all();
+   m_Thread.join();
+   close(m_Journal);
+   m_Journal = -1;
+   return Finish(m_FileName);
+}
+
+
+bool PE::CRecorder::IsStarted() const
+{
+   return m_IsStarted.load(std::memory_order_acquire);
+}
+
+
+bool PE::CRecorder::Record(const STrackEvent& event)
+{
+   if ( false == m_IsStarted.load(std::memory_order_acquire) )
+   {
+      return false;
+   }
+   uint64_t position = m_Enqueue.load(std::memory_order_relaxed);
+   for ( ;; )
+   {
+      SSlot& slot = m_Slots[position & m_Mask];
+      const uint64_t sequence = slot.Sequence.load(std::memory_order_acquire);
+      const int64_t difference = static_cast<int64_t>(sequence - position);
+      if ( 0 == difference )
+      {
+         //slot is free, the producer which moves enqueue position owns it
+         if ( m_Enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed) )
+         {
+            slot.Record.Timestamp = event.Timestamp;
+            slot.Record.Type = static_cast<uint64_t>(event.Type);
+            memcpy(slot.Record.Values, event.Values, sizeof(slot.Record.Values));
+            slot.Sequence.store(position + 1, std::memory_order_release);
+            m_RecordCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+         }
+      }
+      else if ( 0 > difference )
+      {
+         //slot is not written by writer yet: ring is full
+         m_DropCount.fetch_add(1, std::memory_order_relaxed);
+         return false;
+      }
+      else
+      {
+         position = m_Enqueue.load(std::memory_order_relaxed);
+      }
+   }
+}
+
+
+uint64_t PE::CRecorder::GetRecordCount() const
+{
+   return m_RecordCount.load(std::memory_order_relaxed);
+}
+
+
+uint64_t PE::CRecorder::GetDropCount() const
+{
+   return m_DropCount.load(std::memory_order_relaxed);
+}
+
+
+uint64_t PE::CRecorder::GetWriteCount() const
+{
+   return m_WriteCount.load(std::memory_order_relaxed);
+}
+
+
+uint64_t PE::CRecorder::GetSyncCount() const
+{
+   return m_SyncCount.load(std::memory_order_relaxed);
+}
+
+
+bool PE::CRecorder::Finish(const std::string& fileName)
+{
+   const std::string journalName = GetJournalName(fileName);
+   int fd = open(journalName.c_str(), O_RDONLY);
+   if ( 0 > fd )
+   {
+      return false;
+   }
+   struct stat info;
+   const SRecord* records = NULL;
+   size_t count = 0;
+   bool isRead = ( 0 == fstat(fd, &info) );
+   if ( isRead && sizeof(SRecord) <= static_cast<uint64_t>(info.st_size) )
+   {
+      void* data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      isRead = ( MAP_FAILED != data );
+      records = isRead ? static_cast<const SRecord*>(data) : NULL;
+      count = isRead ? info.st_size / sizeof(SRecord) : 0;
+   }
+   close(fd);
+   if ( false == isRead )
+   {
+      return false;
+   }
+
+   //events without values are not stored in native file
+   size_t counts[EVENT_COUNT] = { 0 };
+   for ( size_t i = 0; i < count; ++i )
+   {
+      if ( EVENT_COUNT > records[i].Type && 0 < CTrackFile::GetValueCount(static_cast<TEventType>(records[i].Type)) )
+      {
+         ++counts[records[i].Type];
+      }
+   }
+   CTrackFile file;
+   bool isWritten = file.Create(fileName, counts);
+   if ( isWritten )
+   {
+      size_t rows[EVENT_COUNT] = { 0 };
+      size_t index = 0;
+      for ( size_t i = 0; i < count; ++i )
+      {
+         const TEventType type = static_cast<TEventType>(records[i].Type);
+         if ( EVENT_COUNT > records[i].Type && 0 < counts[type] )
+         {
+            file.SetEvent(index++, rows[type]++, STrackEvent(records[i].Timestamp, type, records[i].Values[0],
+                                                             records[i].Values[1], records[i].Values[2]));
+         }
+      }
+      file.Close();
+   }
+   if ( NULL != records )
+   {
+      munmap(const_cast<SRecord*>(records), info.st_size);
+   }
+   if ( isWritten )
+   {
+      remove(journalName.c_str());
+   }
+   return isWritten;
+}
+
+
+std::string PE::CRecorder::GetJournalName(const std::string& fileName)
+{
+   return fileName + ".part";
+}
+
+
+void PE::CRecorder::Writer()
+{
+   std::vector<SRecord> batch;
+   batch.reserve(m_Slots.size());
+   std::chrono::steady_clock::time_point lastSync = std::chrono::steady_clock::now();
+   bool isStopping = false;
+   while ( false == isStopping )
+   {
+      {
+         std::unique_lock<std::mutex> lock(m_Mutex);
+         m_Stopped.wait_for(lock, std::chrono::milliseconds(m_FlushPeriod), [this]() { return m_IsStopping; });
+         isStopping = m_IsStopping;
+      }
+      //ring is written in parts of its capacity, so the batch never grows
+      while ( m_Slots.size() == Flush(batch) )
+      {
+      }
+      const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+      if ( isStopping || now - lastSync >= std::chrono::milliseconds(m_SyncPeriod) )
+      {
+         fdatasync(m_Journal);
+         m_SyncCount.fetch_add(1, std::memory_order_relaxed);
+         lastSync = now;
+      }
+   }
+}
+
+
+size_t PE::CRecorder::Flush(std::vector<SRecord>& batch)
+{
+   batch.clear();
+   while ( batch.size() < m_Slots.size() )
+   {
+      SSlot& slot = m_Slots[m_Dequeue & m_Mask];
+      if ( slot.Sequence.load(std::memory_order_acquire) != m_Dequeue + 1 )
+      {
+         break;
+      }
+      batch.push_back(slot.Record);
+      //slot is free for the producer of the next round
+      slot.Sequence.store(m_Dequeue + m_Slots.size(), std::memory_order_release);
+      ++m_Dequeue;
+   }
+
+   size_t written = 0;
+   const char* data = reinterpret_cast<const char*>(batch.data());
+   const size_t size = batch.size() * sizeof(SRecord);
+   while ( written < size )
+   {
+      const ssize_t result = write(m_Journal, data + written, size - written);
+      if ( 0 > result && EINTR == errno )
+      {
+         continue;
+      }
+      if ( 0 >= result )
+      {
+         break;
+      }
+      written += result;
+   }
+   const size_t count = written / sizeof(SRecord);
+   const uint64_t journalSize = m_JournalSize + count * sizeof(SRecord);
+   if ( written != count * sizeof(SRecord) )
+   {
+      //rest of partly written event would shift all next events, it is counted as dropped
+      if ( 0 == ftruncate(m_Journal, journalSize) )
+      {
+         lseek(m_Journal, journalSize, SEEK_SET);
+      }
+   }
+   m_JournalSize = journalSize;
+   m_WriteCount.fetch_add(count, std::memory_order_relaxed);
+   m_DropCount.fetch_add(batch.size() - count, std::memory_order_relaxed);
+   return batch.size();
+}
@@ -0,0 +1,127 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <stdlib.h>
+#include "PECTrack.h"
+#include "PECTrackReader.h"
+#include "PETools.h"
+
+
+using namespace PE;
+
+
+PE::CTrack::CTrack()
+: m_PendingSpeedSeq(-1)
+{
+}
+
+
+bool PE::CTrack::LoadText(const std::string& fileName)
+{
+   Clean();
+   CTrackReader reader;
+   if ( false == reader.Open(fileName) )
+   {
+      return false;
+   }
+   STrackEvent event;
+   while ( reader.Next(event) )
+   {
+      Add(event);
+   }
+   return true;
+}
+
+
+bool PE::CTrack::AddLine(const std::string& line)
+{
+   std::vector<std::string> group = PE::TOOLS::Split(line, ',');
+   if ( 4 > group.size() )
+   {
+      return false;
+   }
+   double ts = atof(group[0].c_str()) / 1000.0;
+   const std::string& type = group[1];
+   int32_t seq = atoi(group[2].c_str());
+
+   if ( 0 == type.compare("ODO") )
+   {
+      Add(STrackEvent(ts, EVENT_ODO, atof(group[3].c_str())));
+      return true;
+   }
+   if ( 0 == type.compare("SPEED") )
+   {
+      m_PendingSpeed = STrackEvent(ts, EVENT_SPEED, atof(group[3].c_str()) / 100.0);
+      m_PendingSpeedSeq = seq;
+      return false;
+   }
+   if ( 0 == type.compare("ACC") )
+   {
+      if ( seq == m_PendingSpeedSeq )
+      {
+         m_PendingSpeed.Values[1] = atof(group[3].c_str()) / 100.0;
+         m_PendingSpeedSeq = -1;
+         Add(m_PendingSpeed);
+         return true;
+      }
+      return false;
+   }
+   if ( 0 == type.compare("GYRO") )
+   {
+      Add(STrackEvent(ts, EVENT_GYRO, atof(group[3].c_str())));
+      return true;
+   }
+   if ( 0 == type.compare("HEADING") && 5 <= group.size() )
+   {
+      Add(STrackEvent(ts, EVENT_HEADING, atof(group[3].c_str()) / 100.0, atof(group[4].c_str()) / 100.0));
+      return true;
+   }
+   if ( 0 == type.compare("POSITION") && 6 <= group.size() )
+   {
+      Add(STrackEvent(ts, EVENT_POSITION, atof(group[3].c_str()) / 10000000.0, atof(group[4].c_str()) / 10000000.0, atof(group[5].c_str()) / 100.0));
+      return true;
+   }
+   return false;
+}
+
+
+void PE::CTrack::Add(const STrackEvent& event)
+{
+   m_Events.push_back(event);
+}
+
+
+void PE::CTrack::Clean()
+{
+   m_Events.clear();
+   m_PendingSpeedSeq = -1;
+}
+
+
+size_t PE::CTrack::GetSize() const
+{
+   return m_Events.size();
+}
+
+
+const STrackEvent& PE::CTrack::operator[](size_t index) const
+{
+   return m_Events[index];
+}
+
+
+const std::vector<STrackEvent>& PE::CTrack::GetEvents() const
+{
+   return m_Events;
+}
@@ -0,0 +1,231 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "PECTrackConverter.h"
+#include "PECTrackFile.h"
+#include "PECTrackReader.h"
+#include "PECThreadPool.h"
+
+
+using namespace PE;
+
+
+const uint32_t PE::CTrackConverter::DEFAULT_CHUNK_SIZE;
+
+
+PE::CTrackConverter::CTrackConverter(uint32_t threadCount, uint32_t chunkSize)
+: m_ThreadCount(threadCount)
+, m_ChunkSize(0 < chunkSize ? chunkSize : DEFAULT_CHUNK_SIZE)
+, m_InputSize(0)
+, m_EventCount(0)
+, m_ChunkCount(0)
+{
+}
+
+
+bool PE::CTrackConverter::Convert(const std::string& textFileName, const std::string& nativeFileName)
+{
+   m_InputSize = 0;
+   m_EventCount = 0;
+   m_ChunkCount = 0;
+
+   int fd = open(textFileName.c_str(), O_RDONLY);
+   if ( 0 > fd )
+   {
+      return false;
+   }
+   struct stat info;
+   const char* text = NULL;
+   bool isRead = ( 0 == fstat(fd, &info) );
+   if ( isRead && 0 < info.st_size )
+   {
+      void* data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      isRead = ( MAP_FAILED != data );
+      text = isRead ? static_cast<const char*>(data) : NULL;
+   }
+   close(fd);
+   if ( false == isRead )
+   {
+      return false;
+   }
+   m_InputSize = ( NULL != text ) ? info.st_size : 0;
+
+   std::vector<SChunk> chunks = Split(text, text + m_InputSize, m_ChunkSize);
+   ForEachChunk(chunks, [](SChunk& chunk) { Count(chunk); });
+
+   //chunks follow each other in columns of each type
+   size_t counts[EVENT_COUNT] = { 0 };
+   size_t index = 0;
+   for ( size_t c = 0; c < chunks.size(); ++c )
+   {
+      chunks[c].FirstIndex = index;
+      for ( uint32_t type = 0; type < EVENT_COUNT; ++type )
+      {
+         chunks[c].FirstRows[type] = counts[type];
+         counts[type] += chunks[c].Counts[type];
+         index += chunks[c].Counts[type];
+      }
+   }
+
+   CTrackFile file;
+   const bool isWritten = file.Create(nativeFileName, counts);
+   if ( isWritten )
+   {
+      ForEachChunk(chunks, [&file](SChunk& chunk) { Write(chunk, file); });
+      file.Close();
+      m_EventCount = index;
+      m_ChunkCount = static_cast<uint32_t>(chunks.size());
+   }
+
+   if ( NULL != text )
+   {
+      munmap(const_cast<char*>(text), m_InputSize);
+   }
+   return isWritten;
+}
+
+
+uint64_t PE::CTrackConverter::GetInputSize() const
+{
+   return m_InputSize;
+}
+
+
+uint64_t PE::CTrackConverter::GetEventCount() const
+{
+   return m_EventCount;
+}
+
+
+uint32_t PE::CTrackConverter::GetChunkCount() const
+{
+   return m_ChunkCount;
+}
+
+
+std::vector<PE::CTrackConverter::SChunk> PE::CTrackConverter::Split(const char* begin, const char* end, uint32_t chunkSize)
+{
+   std::vector<SChunk> chunks;
+   const char* start = begin;
+   while ( start < end )
+   {
+      SChunk chunk;
+      memset(&chunk, 0, sizeof(chunk));
+      chunk.Begin = start;
+      chunk.End = ( static_cast<size_t>(end - start) > chunkSize ) ? FindChunkStart(start + chunkSize, end) : end;
+      chunks.push_back(chunk);
+      start = chunk.End;
+   }
+   return chunks;
+}
+
+
+const char* PE::CTrackConverter::FindChunkStart(const char* pos, const char* end)
+{
+   //position is inside of the text, so the character before exists
+   if ( '\n' != *(pos - 1) )
+   {
+      const char* lineEnd = static_cast<const char*>(memchr(pos, '\n', end - pos));
+      pos = ( NULL != lineEnd ) ? lineEnd + 1 : end;
+   }
+   while ( pos < end )
+   {
+      const char* lineEnd = static_cast<const char*>(memchr(pos, '\n', end - pos));
+      lineEnd = ( NULL != lineEnd ) ? lineEnd : end;
+      //SPEED with less than 4 fields is ignored by parser and does not replace pending one
+      const char* type = static_cast<const char*>(memchr(pos, ',', lineEnd - pos));
+      if ( NULL != type && 7 < lineEnd - type && 0 == memcmp(type, ",SPEED,", 7) && NULL != memchr(type + 7, ',', lineEnd - type - 7) )
+      {
+         return pos;
+      }
+      pos = ( lineEnd < end ) ? lineEnd + 1 : end;
+   }
+   return end;
+}
+
+
+bool PE::CTrackConverter::NextLine(const char*& pos, const char* end, const char*& lineBegin, const char*& lineEnd)
+{
+   if ( pos >= end )
+   {
+      return false;
+   }
+   lineBegin = pos;
+   lineEnd = static_cast<const char*>(memchr(pos, '\n', end - pos));
+   lineEnd = ( NULL != lineEnd ) ? lineEnd : end;
+   pos = ( lineEnd < end ) ? lineEnd + 1 : end;
+   return true;
+}
+
+
+void PE::CTrackConverter::Count(SChunk& chunk)
+{
+   CTrackReader parser;
+   STrackEvent event;
+   const char* pos = chunk.Begin;
+   const char* lineBegin = NULL;
+   const char* lineEnd = NULL;
+   while ( NextLine(pos, chunk.End, lineBegin, lineEnd) )
+   {
+      if ( parser.Parse(lineBegin, lineEnd, event) )
+      {
+         ++chunk.Counts[event.Type];
+      }
+   }
+}
+
+
+void PE::CTrackConverter::Write(const SChunk& chunk, CTrackFile& file)
+{
+   CTrackReader parser;
+   STrackEvent event;
+   size_t rows[EVENT_COUNT];
+   memcpy(rows, chunk.FirstRows, sizeof(rows));
+   size_t index = chunk.FirstIndex;
+   const char* pos = chunk.Begin;
+   const char* lineBegin = NULL;
+   const char* lineEnd = NULL;
+   while ( NextLine(pos, chunk.End, lineBegin, lineEnd) )
+   {
+      if ( parser.Parse(lineBegin, lineEnd, event) )
+      {
+         file.SetEvent(index++, rows[event.Type]++, event);
+      }
+   }
+}
+
+
+void PE::CTrackConverter::ForEachChunk(std::vector<SChunk>& chunks, const std::function<void(SChunk&)>& task) const
+{
+   if ( 1 == m_ThreadCount || 1 >= chunks.size() )
+   {
+      for ( size_t c = 0; c < chunks.size(); ++c )
+      {
+         task(chunks[c]);
+      }
+      return;
+   }
+   CThreadPool pool(m_ThreadCount);
+   for ( size_t c = 0; c < chunks.size(); ++c )
+   {
+      SChunk* chunk = &chunks[c];
+      pool.Add([&task, chunk]() { task(*chunk); });
+   }
+   pool.Wait();
+}
@@ -0,0 +1,605 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "PECTrackFile.h"
+#include "PECTrack.h"
+
+
+using namespace PE;
+
+
+const uint32_t PE::CTrackFile::VERSION;
+const uint32_t PE::CTrackFile::MAX_VALUES;
+const uint32_t PE::CTrackFile::SEEK_INTERVAL;
+const char PE::CTrackFile::MAGIC[8] = { 'P', 'E', 'T', 'R', 'A', 'C', 'K', '\0' };
+
+
+bool PE::CTrackFile::Store(const std::string& fileName, const CTrack& track)
+{
+   size_t counts[EVENT_COUNT] = { 0 };
+   for ( size_t i = 0; i < track.GetSize(); ++i )
+   {
+      if ( 0 < GetValueCount(track[i].Type) )
+      {
+         ++counts[track[i].Type];
+      }
+   }
+
+   CTrackFile file;
+   if ( false == file.Create(fileName, counts) )
+   {
+      return false;
+   }
+   size_t rows[EVENT_COUNT] = { 0 };
+   size_t index = 0;
+   for ( size_t i = 0; i < track.GetSize(); ++i )
+   {
+      const STrackEvent& event = track[i];
+      if ( 0 < GetValueCount(event.Type) )
+      {
+         file.SetEvent(index++, rows[event.Type]++, event);
+      }
+   }
+   return true;
+}
+
+
+PE::CTrackFile::SCursor::SCursor()
+: Index(0)
+{
+   memset(Rows, 0, sizeof(Rows));
+}
+
+
+uint32_t PE::CTrackFile::GetValueCount(TEventType type)
+{
+   switch ( type )
+   {
+      case EVENT_POSITION: return 3;
+      case EVENT_HEADING:  return 2;
+      case EVENT_SPEED:    return 2;
+      case EVENT_GYRO:     return 1;
+      case EVENT_ODO:      return 1;
+      default:             return 0;
+   }
+}
+
+
+PE::CTrackFile::CTrackFile()
+: m_Data(NULL)
+, m_Size(0)
+, m_IsWritable(false)
+{
+   memset(m_Blocks, 0, sizeof(m_Blocks));
+}
+
+
+PE::CTrackFile::~CTrackFile()
+{
+   Close();
+}
+
+
+bool PE::CTrackFile::Create(const std::string& fileName, const size_t counts[EVENT_COUNT])
+{
+   Close();
+   if ( false == IsLittleEndian() || 0 != counts[EVENT_UNKNOWN] )
+   {
+      return false;
+   }
+
+   //offsets follow from counts
+   SHeader header;
+   memset(&header, 0, sizeof(header));
+   memcpy(header.Magic, MAGIC, sizeof(header.Magic));
+   header.Version = VERSION;
+   header.OrderOffset = sizeof(SHeader);
+   for ( uint32_t type = 0; type < EVENT_COUNT; ++type )
+   {
+      header.EventCount += counts[type];
+   }
+
+   std::vector<SBlock> blocks;
+   uint64_t offset = header.OrderOffset + GetOrderSize(header.EventCount);
+   for ( uint32_t type = 0; type < EVENT_COUNT; ++type )
+   {
+      const uint64_t count = counts[type];
+      if ( 0 == count )
+      {
+         continue;
+      }
+      SBlock block;
+      memset(&block, 0, sizeof(block));
+      block.Type = type;
+      block.ValueCount = GetValueCount(static_cast<TEventType>(type));
+      block.Count = count;
+      block.TimestampsOffset = offset;
+      offset += count * sizeof(double);
+      for ( uint32_t v = 0; v < block.ValueCount; ++v )
+      {
+         block.ValuesOffset[v] = offset;
+         offset += count * sizeof(double);
+      }
+      for ( uint32_t v = 0; v < block.ValueCount; ++v )
+      {
+         block.ValidityOffset[v] = offset;
+         offset += GetValiditySize(count);
+      }
+      blocks.push_back(block);
+   }
+   header.BlockCount = static_cast<uint32_t>(blocks.size());
+   header.SeekOffset = offset;
+   header.SeekInterval = SEEK_INTERVAL;
+   offset += GetSeekCount(header.EventCount, header.SeekInterval) * sizeof(SSeekEntry);
+   header.IndexOffset = offset;
+   header.FileSize = offset + blocks.size() * sizeof(SBlock);
+
+   int fd = open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+   if ( 0 > fd )
+   {
+      return false;
+   }
+   //space is reserved, so writing into mapping could not fail on full disk, new space is zero
+   if ( 0 == posix_fallocate(fd, 0, header.FileSize) )
+   {
+      void* data = mmap(NULL, header.FileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if ( MAP_FAILED != data )
+      {
+         m_Data = static_cast<uint8_t*>(data);
+         m_Size = header.FileSize;
+         m_IsWritable = true;
+         memcpy(m_Data, &header, sizeof(header));
+         if ( false == blocks.empty() )
+         {
+            memcpy(m_Data + header.IndexOffset, blocks.data(), blocks.size() * sizeof(SBlock));
+         }
+      }
+   }
+   close(fd);
+
+   if ( NULL != m_Data && false == ReadIndex() )
+   {
+      Close();
+   }
+   return IsOpen();
+}
+
+
+void PE::CTrackFile::SetEvent(size_t index, size_t row, const STrackEvent& event)
+{
+   const TEventType type = event.Type;
+   EditOrder()[index] = static_cast<uint8_t>(type);
+   EditTimestamps(type)[row] = event.Timestamp;
+   for ( uint32_t v = 0; v < m_Blocks[type]->ValueCount; ++v )
+   {
+      if ( false == isnan(event.Values[v]) )
+      {
+         EditValues(type, v)[row] = event.Values[v];
+         //rows of other writers could share the word
+         __atomic_fetch_or(&EditValidity(type, v)[row / 64], static_cast<uint64_t>(1) << (row % 64), __ATOMIC_RELAXED);
+      }
+   }
+}
+
+
+uint8_t* PE::CTrackFile::EditOrder()
+{
+   return m_IsWritable ? const_cast<uint8_t*>(GetOrder()) : NULL;
+}
+
+
+double* PE::CTrackFile::EditTimestamps(TEventType type)
+{
+   return m_IsWritable ? const_cast<double*>(GetTimestamps(type)) : NULL;
+}
+
+
+double* PE::CTrackFile::EditValues(TEventType type, uint32_t index)
+{
+   return m_IsWritable ? const_cast<double*>(GetValues(type, index)) : NULL;
+}
+
+
+uint64_t* PE::CTrackFile::EditValidity(TEventType type, uint32_t index)
+{
+   return m_IsWritable ? const_cast<uint64_t*>(GetValidity(type, index)) : NULL;
+}
+
+
+bool PE::CTrackFile::Open(const std::string& fileName)
+{
+   Close();
+   int fd = open(fileName.c_str(), O_RDONLY);
+   if ( 0 > fd )
+   {
+      return false;
+   }
+   struct stat info;
+   if ( 0 == fstat(fd, &info) && sizeof(SHeader) <= static_cast<uint64_t>(info.st_size) )
+   {
+      void* data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if ( MAP_FAILED != data )
+      {
+         m_Data = static_cast<uint8_t*>(data);
+         m_Size = info.st_size;
+      }
+   }
+   //mapping stays valid without descriptor
+   close(fd);
+
+   if ( NULL != m_Data && false == ReadIndex() )
+   {
+      Close();
+   }
+   return IsOpen();
+}
+
+
+void PE::CTrackFile::Close()
+{
+   if ( m_IsWritable )
+   {
+      WriteSeekIndex();
+   }
+   if ( NULL != m_Data )
+   {
+      munmap(m_Data, m_Size);
+   }
+   m_Data = NULL;
+   m_Size = 0;
+   m_IsWritable = false;
+   memset(m_Blocks, 0, sizeof(m_Blocks));
+}
+
+
+bool PE::CTrackFile::IsOpen() const
+{
+   return NULL != m_Data;
+}
+
+
+size_t PE::CTrackFile::GetSize() const
+{
+   if ( false == IsOpen() )
+   {
+      return 0;
+   }
+   return static_cast<size_t>(reinterpret_cast<const SHeader*>(m_Data)->EventCount);
+}
+
+
+const uint8_t* PE::CTrackFile::GetOrder() const
+{
+   if ( 0 == GetSize() )
+   {
+      return NULL;
+   }
+   return m_Data + reinterpret_cast<const SHeader*>(m_Data)->OrderOffset;
+}
+
+
+size_t PE::CTrackFile::GetCount(TEventType type) const
+{
+   if ( EVENT_COUNT <= static_cast<uint32_t>(type) || NULL == m_Blocks[type] )
+   {
+      return 0;
+   }
+   return static_cast<size_t>(m_Blocks[type]->Count);
+}
+
+
+const double* PE::CTrackFile::GetTimestamps(TEventType type) const
+{
+   if ( 0 == GetCount(type) )
+   {
+      return NULL;
+   }
+   return reinterpret_cast<const double*>(m_Data + m_Blocks[type]->TimestampsOffset);
+}
+
+
+const double* PE::CTrackFile::GetValues(TEventType type, uint32_t index) const
+{
+   if ( 0 == GetCount(type) || m_Blocks[type]->ValueCount <= index )
+   {
+      return NULL;
+   }
+   return reinterpret_cast<const double*>(m_Data + m_Blocks[type]->ValuesOffset[index]);
+}
+
+
+const uint64_t* PE::CTrackFile::GetValidity(TEventType type, uint32_t index) const
+{
+   if ( 0 == GetCount(type) || m_Blocks[type]->ValueCount <= index )
+   {
+      return NULL;
+   }
+   return reinterpret_cast<const uint64_t*>(m_Data + m_Blocks[type]->ValidityOffset[index]);
+}
+
+
+bool PE::CTrackFile::IsValid(TEventType type, uint32_t index, size_t event) const
+{
+   const uint64_t* validity = GetValidity(type, index);
+   if ( NULL == validity || GetCount(type) <= event )
+   {
+      return false;
+   }
+   return 0 != ( ( validity[event / 64] >> (event % 64) ) & 1 );
+}
+
+
+bool PE::CTrackFile::ToTrack(CTrack& track) const
+{
+   track.Clean();
+   if ( false == IsOpen() )
+   {
+      return false;
+   }
+
+   SCursor cursor;
+   STrackEvent event;
+   while ( cursor.Index < GetSize() )
+   {
+      if ( false == Next(cursor, event) )
+      {
+         track.Clean();
+         return false;
+      }
+      track.Add(event);
+   }
+   return true;
+}
+
+
+bool PE::CTrackFile::Seek(const double& timestamp, SCursor& cursor) const
+{
+   cursor = SCursor();
+   const SSeekEntry* entries = GetSeekIndex();
+   if ( NULL == entries )
+   {
+      return IsOpen();
+   }
+
+   //maximal timestamps of entries grow, the last entry older than timestamp is the start of the search
+   const uint64_t interval = reinterpret_cast<const SHeader*>(m_Data)->SeekInterval;
+   size_t low = 0;
+   size_t high = static_cast<size_t>(GetSeekCount(GetSize(), interval));
+   if ( false == ( entries[0].Timestamp < timestamp ) )
+   {
+      return true;
+   }
+   while ( 1 < high - low )
+   {
+      const size_t middle = low + ( high - low ) / 2;
+      if ( entries[middle].Timestamp < timestamp )
+      {
+         low = middle;
+      }
+      else
+      {
+         high = middle;
+      }
+   }
+
+   const SSeekEntry& entry = entries[low];
+   uint64_t rows = 0;
+   for ( uint32_t type = 0; type < EVENT_COUNT; ++type )
+   {
+      if ( GetCount(static_cast<TEventType>(type)) < entry.Rows[type] )
+      {
+         cursor = SCursor();
+         return false;
+      }
+      cursor.Rows[type] = static_cast<size_t>(entry.Rows[type]);
+      rows += entry.Rows[type];
+   }
+   if ( entry.Index != rows || GetSize() <= entry.Index )
+   {
+      cursor = SCursor();
+      return false;
+   }
+   cursor.Index = static_cast<size_t>(entry.Index);
+
+   //event at entry is included in its timestamp
+   STrackEvent event;
+   if ( false == Next(cursor, event) )
+   {
+      cursor = SCursor();
+      return false;
+   }
+   while ( cursor.Index < GetSize() )
+   {
+      const uint8_t order = GetOrder()[cursor.Index];
+      if ( EVENT_COUNT <= order )
+      {
+         cursor = SCursor();
+         return false;
+      }
+      const TEventType type = static_cast<TEventType>(order);
+      if ( GetCount(type) <= cursor.Rows[type] )
+      {
+         cursor = SCursor();
+         return false;
+      }
+      if ( false == ( GetTimestamps(type)[cursor.Rows[type]] < timestamp ) )
+      {
+         break;
+      }
+      ++cursor.Index;
+      ++cursor.Rows[type];
+   }
+   return true;
+}
+
+
+bool PE::CTrackFile::Next(SCursor& cursor, STrackEvent& event) const
+{
+   if ( GetSize() <= cursor.Index )
+   {
+      return false;
+   }
+   //damaged order byte must not index the rows
+   const uint8_t order = GetOrder()[cursor.Index];
+   if ( EVENT_COUNT <= order )
+   {
+      return false;
+   }
+   const TEventType type = static_cast<TEventType>(order);
+   if ( GetCount(type) <= cursor.Rows[type] )
+   {
+      return false;
+   }
+   const size_t row = cursor.Rows[type];
+   event = STrackEvent(GetTimestamps(type)[row], type, 0);
+   for ( uint32_t v = 0; v < m_Blocks[type]->ValueCount; ++v )
+   {
+      event.Values[v] = IsValid(type, v, row) ? GetValues(type, v)[row] : std::numeric_limits<double>::quiet_NaN();
+   }
+   ++cursor.Index;
+   ++cursor.Rows[type];
+   return true;
+}
+
+
+bool PE::CTrackFile::IsLittleEndian()
+{
+   const uint16_t probe = 1;
+   return 1 == *reinterpret_cast<const uint8_t*>(&probe);
+}
+
+
+uint64_t PE::CTrackFile::GetValiditySize(uint64_t count)
+{
+   return ( ( count + 63 ) / 64 ) * sizeof(uint64_t);
+}
+
+
+uint64_t PE::CTrackFile::GetOrderSize(uint64_t count)
+{
+   return ( ( count + 7 ) / 8 ) * 8;
+}
+
+
+uint64_t PE::CTrackFile::GetSeekCount(uint64_t count, uint64_t interval)
+{
+   return count / interval + ( ( 0 != count % interval ) ? 1 : 0 );
+}
+
+
+void PE::CTrackFile::WriteSeekIndex()
+{
+   SSeekEntry* entries = const_cast<SSeekEntry*>(GetSeekIndex());
+   if ( NULL == entries )
+   {
+      return;
+   }
+   const uint64_t interval = reinterpret_cast<const SHeader*>(m_Data)->SeekInterval;
+   const uint8_t* order = GetOrder();
+   SSeekEntry entry;
+   memset(&entry, 0, sizeof(entry));
+   entry.Timestamp = -std::numeric_limits<double>::infinity();
+   for ( size_t i = 0; i < GetSize(); ++i )
+   {
+      //events not set by SetEvent() and unknown types are skipped
+      const TEventType type = static_cast<TEventType>(order[i]);
+      const bool isSet = ( EVENT_COUNT > order[i] && entry.Rows[type] < GetCount(type) );
+      if ( isSet && GetTimestamps(type)[entry.Rows[type]] > entry.Timestamp )
+      {
+         entry.Timestamp = GetTimestamps(type)[entry.Rows[type]];
+      }
+      if ( 0 == i % interval )
+      {
+         entries[i / interval] = entry;
+         entries[i / interval].Index = i;
+      }
+      if ( isSet )
+      {
+         ++entry.Rows[type];
+      }
+   }
+}
+
+
+const PE::CTrackFile::SSeekEntry* PE::CTrackFile::GetSeekIndex() const
+{
+   if ( 0 == GetSize() )
+   {
+      return NULL;
+   }
+   return reinterpret_cast<const SSeekEntry*>(m_Data + reinterpret_cast<const SHeader*>(m_Data)->SeekOffset);
+}
+
+
+bool PE::CTrackFile::ReadIndex()
+{
+   const SHeader* header = reinterpret_cast<const SHeader*>(m_Data);
+   if ( false == IsLittleEndian() || 0 != memcmp(header->Magic, MAGIC, sizeof(header->Magic)) || VERSION != header->Version || m_Size != header->FileSize )
+   {
+      return false;
+   }
+   if ( EVENT_COUNT < header->BlockCount || 0 != header->IndexOffset % 8 || sizeof(SHeader) > header->IndexOffset || m_Size < header->IndexOffset
+        || ( m_Size - header->IndexOffset ) != header->BlockCount * sizeof(SBlock) )
+   {
+      return false;
+   }
+
+   if ( m_Size < header->EventCount || false == IsColumn(header->OrderOffset, GetOrderSize(header->EventCount)) )
+   {
+      return false;
+   }
+   if ( 0 == header->SeekInterval || false == IsColumn(header->SeekOffset, GetSeekCount(header->EventCount, header->SeekInterval) * sizeof(SSeekEntry)) )
+   {
+      return false;
+   }
+
+   uint64_t eventCount = 0;
+   const SBlock* blocks = reinterpret_cast<const SBlock*>(m_Data + header->IndexOffset);
+   for ( uint32_t b = 0; b < header->BlockCount; ++b )
+   {
+      const SBlock& block = blocks[b];
+      if ( EVENT_COUNT <= block.Type || NULL != m_Blocks[block.Type] || 0 == block.ValueCount
+           || GetValueCount(static_cast<TEventType>(block.Type)) != block.ValueCount || m_Size / sizeof(double) < block.Count )
+      {
+         return false;
+      }
+      bool columns = IsColumn(block.TimestampsOffset, block.Count * sizeof(double));
+      for ( uint32_t v = 0; v < block.ValueCount; ++v )
+      {
+         columns = columns && IsColumn(block.ValuesOffset[v], block.Count * sizeof(double));
+         columns = columns && IsColumn(block.ValidityOffset[v], GetValiditySize(block.Count));
+      }
+      if ( false == columns )
+      {
+         return false;
+      }
+      m_Blocks[block.Type] = &block;
+      eventCount += block.Count;
+   }
+   //order column itself is checked by reading only, not to touch the whole file:
+   //types out of range and types without more events are rejected by Next()
+   return header->EventCount == eventCount;
+}
+
+
+bool PE::CTrackFile::IsColumn(uint64_t offset, uint64_t size) const
+{
+   const uint64_t indexOffset = reinterpret_cast<const SHeader*>(m_Data)->IndexOffset;
+   return 0 == offset % 8 && sizeof(SHeader) <= offset && offset <= indexOffset && size <= indexOffset - offset;
+}
@@ -0,0 +1,482 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "PECTrackReader.h"
+
+
+using namespace PE;
+
+
+const uint32_t PE::CTrackReader::DEFAULT_CHUNK_SIZE;
+const uint32_t PE::CTrackReader::MAX_LINE_LENGTH;
+const uint32_t PE::CTrackReader::MAX_FIELDS;
+
+
+PE::CTrackReader::CTrackReader(uint32_t chunkSize)
+: m_ChunkSize(0 < chunkSize ? chunkSize : DEFAULT_CHUNK_SIZE)
+, m_File(-1)
+, m_IsStopped(false)
+, m_IsRewinding(false)
+, m_Current(0)
+, m_IsHeld(false)
+, m_IsEnd(false)
+, m_Pos(NULL)
+, m_End(NULL)
+, m_LineLength(0)
+, m_PendingSpeedSeq(-1)
+, m_RecordCount(0)
+, m_EventCount(0)
+, m_ByteCount(0)
+, m_Error(0)
+{
+   for ( uint32_t i = 0; i < 2; ++i )
+   {
+      m_Buffers[i].Size = 0;
+      m_Buffers[i].IsFull = false;
+      m_Buffers[i].IsLast = false;
+      m_Buffers[i].Error = 0;
+   }
+}
+
+
+PE::CTrackReader::~CTrackReader()
+{
+   Close();
+}
+
+
+bool PE::CTrackReader::Open(const std::string& fileName)
+{
+   Close();
+   m_File = open(fileName.c_str(), O_RDONLY);
+   if ( 0 > m_File )
+   {
+      return false;
+   }
+   for ( uint32_t i = 0; i < 2; ++i )
+   {
+      m_Buffers[i].Data.resize(m_ChunkSize);
+   }
+   m_IsStopped = false;
+   m_IsRewinding = false;
+   m_Thread = std::thread(&CTrackReader::Reader, this);
+   return true;
+}
+
+
+bool PE::CTrackReader::Rewind()
+{
+   if ( false == IsOpen() )
+   {
+      return false;
+   }
+   //parser does not hold any buffer while reading thread moves to the beginning
+   {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_IsRewinding = true;
+      m_Changed.notify_all();
+      m_Changed.wait(lock, [this]() { return false == m_IsRewinding; });
+   }
+   m_Current = 0;
+   m_IsHeld = false;
+   m_IsEnd = false;
+   m_Pos = NULL;
+   m_End = NULL;
+   m_LineLength = 0;
+   m_PendingSpeedSeq = -1;
+   m_RecordCount = 0;
+   m_EventCount = 0;
+   m_ByteCount = 0;
+   m_Error = 0;
+   return true;
+}
+
+
+void PE::CTrackReader::Close()
+{
+   if ( m_Thread.joinable() )
+   {
+      {
+         std::lock_guard<std::mutex> lock(m_Mutex);
+         m_IsStopped = true;
+      }
+      m_Changed.notify_all();
+      m_Thread.join();
+   }
+   if ( 0 <= m_File )
+   {
+      close(m_File);
+   }
+   m_File = -1;
+   for ( uint32_t i = 0; i < 2; ++i )
+   {
+      m_Buffers[i].Size = 0;
+      m_Buffers[i].IsFull = false;
+      m_Buffers[i].IsLast = false;
+      m_Buffers[i].Error = 0;
+   }
+   m_Current = 0;
+   m_IsHeld = false;
+   m_IsEnd = false;
+   m_Pos = NULL;
+   m_End = NULL;
+   m_LineLength = 0;
+   m_PendingSpeedSeq = -1;
+   m_RecordCount = 0;
+   m_EventCount = 0;
+   m_ByteCount = 0;
+   m_Error = 0;
+}
+
+
+bool PE::CTrackReader::IsOpen() const
+{
+   return 0 <= m_File;
+}
+
+
+bool PE::CTrackReader::Next(STrackEvent& event)
+{
+   const char* begin = NULL;
+   const char* end = NULL;
+   while ( ReadLine(begin, end) )
+   {
+      ++m_RecordCount;
+      if ( Parse(begin, end, event) )
+      {
+         ++m_EventCount;
+         return true;
+      }
+   }
+   return false;
+}
+
+
+bool PE::CTrackReader::Parse(const char* begin, const char* end, STrackEvent& event)
+{
+   if ( begin < end && '\r' == *(end - 1) )
+   {
+      --end;
+   }
+   if ( begin == end )
+   {
+      return false;
+   }
+
+   //field i is [fields[i], fields[i + 1] - 1)
+   const char* fields[MAX_FIELDS + 1];
+   uint32_t count = 0;
+   fields[count++] = begin;
+   for ( const char* pos = begin; pos < end && count <= MAX_FIELDS; ++pos )
+   {
+      if ( ',' == *pos )
+      {
+         fields[count++] = pos + 1;
+      }
+   }
+   if ( count <= MAX_FIELDS )
+   {
+      fields[count] = end + 1;
+   }
+   else
+   {
+      //fields behind the known ones are ignored
+      count = MAX_FIELDS;
+   }
+   if ( 4 > count )
+   {
+      return false;
+   }
+
+   const char* type = fields[1];
+   const char* typeEnd = fields[2] - 1;
+   const double ts = ToNumber(fields[0], fields[1] - 1) / 1000.0;
+   const int32_t seq = static_cast<int32_t>(ToNumber(fields[2], fields[3] - 1));
+   const double value = ToNumber(fields[3], fields[4] - 1);
+
+   if ( IsField(type, typeEnd, "ODO") )
+   {
+      event = STrackEvent(ts, EVENT_ODO, value);
+      return true;
+   }
+   if ( IsField(type, typeEnd, "SPEED") )
+   {
+      m_PendingSpeed = STrackEvent(ts, EVENT_SPEED, value / 100.0);
+      m_PendingSpeedSeq = seq;
+      return false;
+   }
+   if ( IsField(type, typeEnd, "ACC") )
+   {
+      if ( seq == m_PendingSpeedSeq )
+      {
+         m_PendingSpeed.Values[1] = value / 100.0;
+         m_PendingSpeedSeq = -1;
+         event = m_PendingSpeed;
+         return true;
+      }
+      return false;
+   }
+   if ( IsField(type, typeEnd, "GYRO") )
+   {
+      event = STrackEvent(ts, EVENT_GYRO, value);
+      return true;
+   }
+   if ( IsField(type, typeEnd, "HEADING") && 5 <= count )
+   {
+      event = STrackEvent(ts, EVENT_HEADING, value / 100.0, ToNumber(fields[4], fields[5] - 1) / 100.0);
+      return true;
+   }
+   if ( IsField(type, typeEnd, "POSITION") && 6 <= count )
+   {
+      event = STrackEvent(ts, EVENT_POSITION, value / 10000000.0, ToNumber(fields[4], fields[5] - 1) / 10000000.0,
+                          ToNumber(fields[5], fields[6] - 1) / 100.0);
+      return true;
+   }
+   return false;
+}
+
+
+uint64_t PE::CTrackReader::GetRecordCount() const
+{
+   return m_RecordCount;
+}
+
+
+uint64_t PE::CTrackReader::GetEventCount() const
+{
+   return m_EventCount;
+}
+
+
+uint64_t PE::CTrackReader::GetByteCount() const
+{
+   return m_ByteCount;
+}
+
+
+int PE::CTrackReader::GetError() const
+{
+   return m_Error;
+}
+
+
+void PE::CTrackReader::Reader()
+{
+   uint32_t index = 0;
+   bool isLast = false;
+   for ( ;; )
+   {
+      SBuffer& buffer = m_Buffers[index];
+      {
+         std::unique_lock<std::mutex> lock(m_Mutex);
+         //after the last chunk thread waits for rewind or stop
+         m_Changed.wait(lock, [this, &buffer, &isLast]()
+         {
+            return m_IsStopped || m_IsRewinding || ( false == isLast && false == buffer.IsFull );
+         });
+         if ( m_IsStopped )
+         {
+            return;
+         }
+         if ( m_IsRewinding )
+         {
+            for ( uint32_t i = 0; i < 2; ++i )
+            {
+               m_Buffers[i].Size = 0;
+               m_Buffers[i].IsFull = false;
+               m_Buffers[i].IsLast = false;
+               m_Buffers[i].Error = 0;
+            }
+            index = 0;
+            isLast = false;
+            if ( 0 > lseek(m_File, 0, SEEK_SET) )
+            {
+               //parser gets the error with empty last chunk
+               m_Buffers[0].IsFull = true;
+               m_Buffers[0].IsLast = true;
+               m_Buffers[0].Error = errno;
+               isLast = true;
+            }
+            m_IsRewinding = false;
+            m_Changed.notify_all();
+            continue;
+         }
+      }
+
+      //buffer is not used by parser till it is marked as full
+      const int error = ReadChunk(buffer);
+
+      {
+         std::lock_guard<std::mutex> lock(m_Mutex);
+         buffer.IsLast = ( buffer.Size < buffer.Data.size() );
+         buffer.Error = error;
+         buffer.IsFull = true;
+         isLast = buffer.IsLast;
+      }
+      m_Changed.notify_all();
+      index ^= 1;
+   }
+}
+
+
+int PE::CTrackReader::ReadChunk(SBuffer& buffer)
+{
+   buffer.Size = 0;
+   while ( buffer.Size < buffer.Data.size() )
+   {
+      ssize_t result = read(m_File, &buffer.Data[buffer.Size], buffer.Data.size() - buffer.Size);
+      if ( 0 < result )
+      {
+         buffer.Size += result;
+      }
+      else if ( 0 == result )
+      {
+         break;
+      }
+      else if ( EINTR != errno )
+      {
+         return errno;
+      }
+   }
+   return 0;
+}
+
+
+void PE::CTrackReader::FetchChunk()
+{
+   {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      if ( m_IsHeld )
+      {
+         m_Buffers[m_Current].IsFull = false;
+         m_Current ^= 1;
+      }
+      m_IsHeld = false;
+   }
+   m_Changed.notify_all();
+
+   std::unique_lock<std::mutex> lock(m_Mutex);
+   SBuffer& buffer = m_Buffers[m_Current];
+   m_Changed.wait(lock, [&buffer]() { return buffer.IsFull; });
+   m_IsHeld = true;
+   m_IsEnd = buffer.IsLast;
+   m_Error = buffer.Error;
+   m_Pos = buffer.Data.data();
+   m_End = m_Pos + buffer.Size;
+   m_ByteCount += buffer.Size;
+}
+
+
+bool PE::CTrackReader::ReadLine(const char*& begin, const char*& end)
+{
+   if ( false == IsOpen() )
+   {
+      return false;
+   }
+   m_LineLength = 0;
+   for ( ;; )
+   {
+      if ( m_Pos == m_End )
+      {
+         if ( m_IsEnd )
+         {
+            //the last line without line end, it is not complete if reading failed
+            begin = m_Line;
+            end = m_Line + m_LineLength;
+            return 0 < m_LineLength && 0 == m_Error;
+         }
+         FetchChunk();
+         continue;
+      }
+
+      const char* lineEnd = static_cast<const char*>(memchr(m_Pos, '\n', m_End - m_Pos));
+      if ( NULL == lineEnd )
+      {
+         AppendLine(m_Pos, m_End);
+         m_Pos = m_End;
+         continue;
+      }
+
+      if ( 0 == m_LineLength )
+      {
+         begin = m_Pos;
+         end = lineEnd;
+      }
+      else
+      {
+         AppendLine(m_Pos, lineEnd);
+         begin = m_Line;
+         end = m_Line + m_LineLength;
+      }
+      m_Pos = lineEnd + 1;
+      return true;
+   }
+}
+
+
+void PE::CTrackReader::AppendLine(const char* begin, const char* end)
+{
+   size_t length = end - begin;
+   if ( MAX_LINE_LENGTH - m_LineLength < length )
+   {
+      length = MAX_LINE_LENGTH - m_LineLength;
+   }
+   memcpy(m_Line + m_LineLength, begin, length);
+   m_LineLength += static_cast<uint32_t>(length);
+}
+
+
+double PE::CTrackReader::ToNumber(const char* begin, const char* end)
+{
+   //up to 15 digits are exact in double, so result is the same like by strtod()
+   const char* pos = begin;
+   bool negative = false;
+   if ( pos < end && ( '-' == *pos || '+' == *pos ) )
+   {
+      negative = ( '-' == *pos );
+      ++pos;
+   }
+   if ( pos < end && end - pos <= 15 )
+   {
+      int64_t value = 0;
+      while ( pos < end && '0' <= *pos && '9' >= *pos )
+      {
+         value = value * 10 + ( *pos - '0' );
+         ++pos;
+      }
+      if ( pos == end )
+      {
+         return negative ? -static_cast<double>(value) : static_cast<double>(value);
+      }
+   }
+
+   char number[64];
+   size_t length = end - begin;
+   length = ( sizeof(number) - 1 < length ) ? sizeof(number) - 1 : length;
+   memcpy(number, begin, length);
+   number[length] = '\0';
+   return strtod(number, NULL);
+}
+
+
+bool PE::CTrackReader::IsField(const char* begin, const char* end, const char* name)
+{
+   const size_t length = strlen(name);
+   return static_cast<size_t>(end - begin) == length && 0 == memcmp(begin, name, length);
+}
@@ -0,0 +1,165 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+#ifndef __PE_CParameterSweep_H__
+#define __PE_CParameterSweep_H__
+
+#include "PETypes.h"
+#include "PECTrack.h"
+
+class PECParameterSweepTest; //to get possibility for test class
+
+namespace PE
+{
+
+/**
+ * Runs one track through many sensor configurations in parallel and ranks them
+ * by convergence time and final calibration status.
+ *
+ * Track is shared read-only between all workers, each configuration gets its own sensor object.
+ */
+class CParameterSweep
+{
+   friend class ::PECParameterSweepTest;
+
+public:
+   /**
+    * Sensor under tuning
+    */
+   enum TSensorType
+   {
+      SENSOR_ODOMETER  = 0,   ///< COdometerEx: reference EVENT_SPEED, sensor EVENT_ODO
+      SENSOR_GYROSCOPE = 1    ///< CGyroscope: reference EVENT_HEADING, sensor EVENT_GYRO
+   };
+   /**
+    * Constructor limits of CGyroscope and COdometerEx
+    */
+   struct SLimits
+   {
+      double RefInterval;
+      double RefHysteresis;
+      double RefMin;
+      double RefMax;
+      double RefAccuracyRatio;
+      double SenInterval;
+      double SenHysteresis;
+      double SenMin;
+      double SenMax;
+   };
+   /**
+    * Result of one configuration
+    */
+   struct SResult
+   {
+      /**
+       * Index of the configuration in order of adding
+       */
+      uint32_t Index;
+      /**
+       * Time from the track begin till calibration status reached convergence level in [s],
+       * MAX_TIMESTAMP if level was never reached
+       */
+      double ConvergenceTime;
+      /**
+       * Calibration status at the end of the track in %
+       */
+      double CalibratedTo;
+      /**
+       * Calibrated base at the end of the track
+       */
+      double Base;
+      /**
+       * Calibrated scale at the end of the track
+       */
+      double Scale;
+      /**
+       * Count of accepted sensor values
+       */
+      uint32_t Accepted;
+   };
+
+   /**
+    * Constructor
+    *
+    * @param  track              track with reference and sensor events, has to live longer then sweep
+    * @param  type               sensor under tuning
+    * @param  convergenceLevel   calibration status in % which is treated as converged
+    */
+   CParameterSweep(const CTrack& track, TSensorType type, const double& convergenceLevel);
+   /**
+    * Adds new configuration
+    *
+    * @param  limits   sensor limits
+    */
+   void AddLimits(const SLimits& limits);
+   /**
+    * Returns count of configurations
+    */
+   size_t GetSize() const;
+   /**
+    * Runs all configurations and ranks results
+    *
+    * @param  threadCount   count of worker threads, 0 means count of hardware threads
+    */
+   void Run(uint32_t threadCount = 0);
+   /**
+    * Returns results ranked from the best one: converged configurations by convergence time,
+    * then all others by final calibration status
+    */
+   const std::vector<SResult>& GetResults() const;
+   /**
+    * Returns configuration by index
+    */
+   const SLimits& GetLimits(uint32_t index) const;
+   /**
+    * Runs one configuration over the track
+    * @return   result of the configuration
+    *
+    * @param  track              track with reference and sensor events
+    * @param  type               sensor under tuning
+    * @param  convergenceLevel   calibration status in % which is treated as converged
+    * @param  limits             sensor limits
+    */
+   static SResult Evaluate(const CTrack& track, TSensorType type, const double& convergenceLevel, const SLimits& limits);
+
+private:
+   /**
+    * Ranking order of two results
+    */
+   static bool IsBetter(const SResult& lhs, const SResult& rhs);
+
+   /**
+    * Shared track
+    */
+   const CTrack& m_Track;
+   /**
+    * Sensor under tuning
+    */
+   TSensorType m_Type;
+   /**
+    * Convergence level in %
+    */
+   double m_ConvergenceLevel;
+   /**
+    * Configurations
+    */
+   std::vector<SLimits> m_Limits;
+   /**
+    * Ranked results
+    */
+   std::vector<SResult> m_Results;
+};
+
+} //namespace PE
+
+#endif //__PE_CParameterSweep_H__
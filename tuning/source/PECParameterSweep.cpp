@@ -0,0 +1,163 @@
+/**
+ * Position Engine provides dead reckoning engine to obtain position
+ * information based on fusion of different kind of sensors.
+ *
+ * Copyright 2020 Pavlo Kleymonov <pavlo.kleymonov@gmail.com>
+ *
+ * Distributed under the OSI-approved BSD License (the "License");
+ * see accompanying file LICENSE.txt for details.
+ *
+ * This software is distributed WITHOUT ANY WARRANTY; without even the
+ * implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the License for more information.
+ */
+
+#include <algorithm>
+#include "PECParameterSweep.h"
+#include "PECThreadPool.h"
+#include "PECOdometerEx.h"
+#include "PECGyroscope.h"
+
+
+using namespace PE;
+
+
+PE::CParameterSweep::CParameterSweep(const CTrack& track, TSensorType type, const double& convergenceLevel)
+: m_Track(track)
+, m_Type(type)
+, m_ConvergenceLevel(convergenceLevel)
+{
+}
+
+
+void PE::CParameterSweep::AddLimits(const SLimits& limits)
+{
+   m_Limits.push_back(limits);
+}
+
+
+size_t PE::CParameterSweep::GetSize() const
+{
+   return m_Limits.size();
+}
+
+
+void PE::CParameterSweep::Run(uint32_t threadCount)
+{
+   m_Results.assign(m_Limits.size(), SResult());
+   {
+      CThreadPool pool(threadCount);
+      for ( uint32_t i = 0; i < m_Limits.size(); ++i )
+      {
+         //each task owns its result slot, no synchronisation is needed
+         pool.Add([this, i]()
+         {
+            m_Results[i] = Evaluate(m_Track, m_Type, m_ConvergenceLevel, m_Limits[i]);
+            m_Results[i].Index = i;
+         });
+      }
+      pool.Wait();
+   }
+   std::stable_sort(m_Results.begin(), m_Results.end(), IsBetter);
+}
+
+
+const std::vector<CParameterSweep::SResult>& PE::CParameterSweep::GetResults() const
+{
+   return m_Results;
+}
+
+
+const CParameterSweep::SLimits& PE::CParameterSweep::GetLimits(uint32_t index) const
+{
+   return m_Limits[index];
+}
+
+
+CParameterSweep::SResult PE::CParameterSweep::Evaluate(const CTrack& track, TSensorType type, const double& convergenceLevel, const SLimits& limits)
+{
+   SResult result;
+   result.Index           = 0;
+   result.ConvergenceTime = MAX_TIMESTAMP;
+   result.CalibratedTo    = 0;
+   result.Base            = 0;
+   result.Scale           = 0;
+   result.Accepted        = 0;
+   if ( 0 == track.GetSize() )
+   {
+      return result;
+   }
+
+   COdometerEx<> odo ( limits.RefInterval, limits.RefHysteresis, limits.RefMin, limits.RefMax, limits.RefAccuracyRatio,
+                       limits.SenInterval, limits.SenHysteresis, limits.SenMin, limits.SenMax );
+   CGyroscope<>  gyro( limits.RefInterval, limits.RefHysteresis, limits.RefMin, limits.RefMax, limits.RefAccuracyRatio,
+                       limits.SenInterval, limits.SenHysteresis, limits.SenMin, limits.SenMax );
+
+   const double& startTs = track[0].Timestamp;
+   for ( size_t i = 0; i < track.GetSize(); ++i )
+   {
+      const STrackEvent& event = track[i];
+      bool isSensor = false;
+      bool isAccepted = false;
+      if ( SENSOR_ODOMETER == type )
+      {
+         if ( EVENT_SPEED == event.Type )
+         {
+            odo.AddSpeed(event.Timestamp, event.Values[0], event.Values[1]);
+         }
+         else if ( EVENT_ODO == event.Type )
+         {
+            isSensor = true;
+            isAccepted = odo.AddTicks(event.Timestamp, event.Values[0], true);
+         }
+      }
+      else
+      {
+         if ( EVENT_HEADING == event.Type )
+         {
+            gyro.AddHeading(event.Timestamp, event.Values[0], event.Values[1]);
+         }
+         else if ( EVENT_GYRO == event.Type )
+         {
+            isSensor = true;
+            isAccepted = gyro.AddGyro(event.Timestamp, event.Values[0], true);
+         }
+      }
+      if ( isAccepted )
+      {
+         ++result.Accepted;
+      }
+      if ( isSensor && MAX_TIMESTAMP == result.ConvergenceTime )
+      {
+         const double& calibratedTo = ( SENSOR_ODOMETER == type ) ? odo.CalibratedTo() : gyro.CalibratedTo();
+         if ( convergenceLevel <= calibratedTo )
+         {
+            result.ConvergenceTime = event.Timestamp - startTs;
+         }
+      }
+   }
+
+   if ( SENSOR_ODOMETER == type )
+   {
+      result.CalibratedTo = odo.CalibratedTo();
+      result.Base         = odo.Base();
+      result.Scale        = odo.Scale();
+   }
+   else
+   {
+      result.CalibratedTo = gyro.CalibratedTo();
+      result.Base         = gyro.Base();
+      result.Scale        = gyro.Scale();
+   }
+   return result;
+}
+
+
+bool PE::CParameterSweep::IsBetter(const SResult& lhs, const SResult& rhs)
+{
+   if ( lhs.ConvergenceTime != rhs.ConvergenceTime )
+   {
+      return lhs.ConvergenceTime < rhs.ConvergenceTime;
+   }
+   return lhs.CalibratedTo > rhs.CalibratedTo;
+}